@@ -164,10 +164,132 @@
 //		21.07.26 - Prevent the bottom of the dialog going past work area height
 //		18.08.26 - Remove using spoututils namespace from header
 //				   Retain manifest for comctl32.dll version 6
+//		18.10.26 - Add streaming picture button with persistent double-buffered
+//				   surfaces - ButtonStream, UpdateButtonStream, CloseButtonStream
+//				   and GetButtonStreamStats for frame time and allocations
+//				   SetButtonPicture - release the previous bitmap
+//				   CreateButtonBitmap - align DIB rows to 4 bytes
+//				   Add ofxWinDialogPixels.h for pixel copy and conversion
+//		18.10.26 - Add picture button atlas - ButtonAtlas, GetButtonAtlasStats
+//				   Button images are packed into shared atlas pages
+//				   Add ofxWinDialogAtlas.h for rectangle packing
+//		18.10.26 - Add GDI object cache for owner draw brushes, hand cursor
+//				   and dialog font - GetGdiCacheStats for created and reused
+//				   WM_SETCURSOR - ReleaseDC instead of DeleteObject
+//				   Add ofxWinDialogCache.h
+//		18.10.26 - Owner draw button hover state from a hit test index
+//				   and mouse leave tracking instead of WM_SETCURSOR scans
+//				   Remove static "bOver" flag
+//				   Add ofxWinDialogHover.h
+//		18.10.26 - Add DoubleBuffer option for flicker-free painting
+//				   Background and group frames from a cached back buffer
+//				   Owner draw buttons drawn off-screen
+//				   WM_PAINT - background colour instead of GetPixel
+//				   Add ofxWinDialogPaint.h
+//		18.10.26 - Add virtual list box - AddVirtualList, AppendListItem,
+//				   ReplaceListItem, GetListCount. Items are held once in
+//				   contiguous storage and only visible rows are drawn.
+//				   Add ofxWinDialogItems.h
+//		18.10.26 - Add LoadCombo, LoadList for bulk item loading
+//				   Combo and list items are converted from UTF-8 in one
+//				   pass and inserted with storage reserved and redraw
+//				   suspended (Open, SetCombo, SetList)
+//		18.10.26 - Add FindComboItem, FindListItem, SetListFilter and
+//				   SetListFilterEdit. Items are found with a search index
+//				   updated as items change instead of a scan of all items.
+//				   Add ofxWinDialogSearch.h
+//		18.10.26 - Add AddPage, EndPage, ShowPage, GetPage, SetPageCache
+//				   Control windows on a page are created when the page
+//				   is first shown. Open creates controls with CreateControl.
+//				   Add ofxWinDialogPages.h
+//		18.10.26 - Add KeepAlive option. Close hides the dialog and Open
+//				   shows it again without creating the controls.
+//				   Set functions while hidden are applied by Open.
+//				   Add GetOpenTime. Refresh uses RefreshControl.
+//		18.10.26 - Add UseTemplate option. Controls are compiled to an
+//				   in-memory dialog template and created together by
+//				   CreateDialogIndirectParam. The template is re-used
+//				   until the controls change. Add ofxWinDialogTemplate.h
+//		18.10.26 - Add LoadDialog and ParseDialog to add controls from a
+//				   dialog description. GetParseError, GetParseTime.
+//				   Add ofxWinDialogDescription.h
+//		18.10.26 - Add WatchIni, WatchDialog, StopWatch, SetWatchDebounce
+//				   for hot reload. Changed files are read and compared by
+//				   a background thread and only the differences are
+//				   applied with the Set functions. Add ofxWinDialogWatch.h
+//		18.10.26 - Add LayoutRow, LayoutColumn, LayoutGrid, LayoutPair,
+//				   LayoutEnd, LayoutStretch, LayoutMargin, GetLayoutTime
+//				   for automatic layout of controls on open and resize.
+//				   Add ofxWinDialogLayout.h
+//		18.10.26 - Scale the dialog and controls for the monitor DPI at
+//				   Open and on WM_DPICHANGED. Font height for the dialog
+//				   DPI. Add GetDpi, GetScale. Add ofxWinDialogDpi.h
+//		18.10.26 - Move slider positions and value text, control lookup
+//				   and initialization file text to ofxWinDialogCore.h.
+//				   Get and Set functions use a control index. Save and
+//				   Load read and write the file once. Slider positions
+//				   are rounded. BEHAVIOUR CHANGE - positions were
+//				   truncated, so a saved value such as 0.29 now restores
+//				   position 29 rather than 28. Save and Load share
+//				   IniValue. Add ofxWinDialogHeadless.h and tests of the
+//				   dialog core.
+//		18.10.26 - Add Benchmark for timing of the dialog hot paths with
+//				   JSON results and baseline comparison.
+//				   Add ofxWinDialogBench.h
+//		18.10.26 - Add statsWinDialog define for latency histograms of
+//				   messages, controls and the ofApp callback function.
+//				   Add GetMessageStats, GetStatsMessages, GetControlStats,
+//				   GetCallbackStats, GetStatsOverhead, ResetStats.
+//				   Add ofxWinDialogStats.h
+//		18.10.26 - Add StartRecording, StopRecording, IsRecording, Replay,
+//				   GetReplayTime to record control events and Set functions
+//				   to a trace file and replay them. Add ofxWinDialogRecord.h
+//		18.10.26 - Add StartTrace, StopTrace, IsTracing, GetTraceDropped
+//				   for a Chrome trace file of Open, Close, Refresh, Load,
+//				   Save, image decode and ofApp callback spans.
+//				   Add ofxWinDialogTrace.h
+//		18.10.26 - Key messages are passed to the dialog that contains
+//				   the window with the focus instead of the last dialog
+//				   opened. One message hook for each thread with a
+//				   reference for each dialog. Add ofxWinDialogHooks.h
+//		18.10.26 - Add UseThread and PollEvents to run the dialog on a
+//				   thread of its own with queued Set functions and
+//				   control events. Add ofxWinDialogThread.h
+//		18.10.26 - Add QueueSet for Set functions called by other threads.
+//				   Queued commands have no locks and are applied in
+//				   batches with the last value for each control and one
+//				   redraw. The trackbar drag flag is for each dialog.
+//		18.10.26 - Add BindParameter and UnbindParameter to share values
+//				   between the controls of several dialogs with a
+//				   process-wide store. Benchmark "params" scenario.
+//				   Add ofxWinDialogParams.h
+//		18.10.26 - Add StartOsc and StopOsc for an OSC control surface.
+//				   Received messages are applied in batches with one
+//				   redraw. Slider and checkbox changes are sent with a
+//				   rate limit. Benchmark "osc" scenario.
+//				   Winsock is included by ofxWinDialog.cpp only.
+//				   Add ofxWinDialogOsc.h
+//		18.10.26 - Control lookup, Set and Get functions, Refresh,
+//				   GetControls, Save and Load, control events, replay,
+//				   keep-alive changes and layout are in DialogCore
+//				   (ofxWinDialogCore.h). The dialog changes control
+//				   windows for the core with a Win32 backend.
+//				   Save and Load still use the profile functions.
+//				   Slider positions are truncated again.
+//				   Replay at the recorded speed uses a timer instead
+//				   of waiting for each event.
 //
+// Winsock for the OSC bridge. Included before windows.h,
+// which would otherwise include the older winsock.h.
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+
 #include "ofxWinDialog.h"
 #include <windows.h>
 #include <stdio.h>
+#include <algorithm>
+#include <windowsx.h> // GET_X_LPARAM
 
 // To load bmp, jpg, png, tga
 // Must be in the cpp file, not the header
@@ -181,15 +303,173 @@ LRESULT CALLBACK MainWndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 // Message hook to enable the tab key
 // https://learn.microsoft.com/en-us/windows/win32/winmsg/getmsgproc
 LRESULT CALLBACK GetKeyMsgProc(int nCode, WPARAM wParam, LPARAM lParam);
-static HHOOK hMsgHook = NULL;
 
-// Static window handle for GetKeyMsgProc
-static HWND hwndDialog = NULL;
+// Dialog windows and the message hook of each thread for GetKeyMsgProc
+static HookRegistry<ofxWinDialog> g_Hooks;
+
+// Owner draw button subclass for mouse leave
+static LRESULT CALLBACK ButtonHoverProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam, UINT_PTR uIdSubclass, DWORD_PTR dwRefData);
+// Child dialog created from the dialog template (UseTemplate)
+static INT_PTR CALLBACK TemplateDialogProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
+// Differences read by the watch thread are ready (WatchIni, WatchDialog)
+static const UINT WM_DIALOG_RELOAD = WM_APP + 1;
+// Set functions queued for the dialog thread (UseThread)
+static const UINT WM_DIALOG_COMMAND = WM_APP + 2;
+// Function to run on the dialog thread (UseThread)
+static const UINT WM_DIALOG_CALL = WM_APP + 3;
+// Messages received by the OSC thread (StartOsc)
+static const UINT WM_DIALOG_OSC = WM_APP + 4;
+// Shared parameters changed by other threads (BindParameter)
+static const UINT WM_DIALOG_PARAMS = WM_APP + 5;
+// Rate limited OSC messages waiting to be sent (StartOsc)
+static const UINT_PTR IDT_DIALOG_OSC = 1;
+
+// Events of a trace replayed at the recorded speed (Replay)
+static const UINT_PTR IDT_DIALOG_REPLAY = 2;
+
+//
+// Win32 backend of the dialog core (ControlBackend)
+// Control values are changed by the core (g_Core) and
+// the control windows by window messages.
+//
+struct ofxWinDialog::winbackend : public ControlBackend {
+
+	ofxWinDialog* d = nullptr;
+
+	explicit winbackend(ofxWinDialog* dialog) : d(dialog) {}
+
+	// Controls on pages that are not shown are created by ShowPage
+	// when the page is first shown (AddPage)
+	void Create(size_t i) override {
+		if (d->g_Pages.IsShown(d->controls[i].Page))
+			d->CreateControl(i, d->m_hDialog, d->g_NextID);
+	}
+
+	bool HasWindow(size_t i) override {
+		return d->controls[i].hwndControl != NULL;
+	}
+
+	void SetCheck(size_t i, bool bChecked) override {
+		SendMessage(d->controls[i].hwndControl, BM_SETCHECK, bChecked ? BST_CHECKED : BST_UNCHECKED, 0);
+	}
+
+	void SetPosition(size_t i, int pos) override {
+		SendMessage(d->controls[i].hwndControl, TBM_SETPOS, TRUE, pos);
+		InvalidateRect(d->controls[i].hwndControl, NULL, TRUE);
+	}
+
+	// Slider value text display
+	void SetValueText(size_t i, const char* text) override {
+		if (d->controls[i].hwndSliderVal)
+			SetWindowTextA(d->controls[i].hwndSliderVal, (LPCSTR)text);
+	}
+
+	void SetText(size_t i, const std::string &text) override {
+		SetWindowTextA(d->controls[i].hwndControl, (LPCSTR)text.c_str());
+	}
+
+	void SetSpin(size_t i, int value) override {
+		SendMessageA(d->controls[i].hwndControl, (UINT)UDM_SETPOS, 0, (LPARAM)value);
+	}
+
+	bool SetSelection(size_t i, int item, bool bRefresh) override {
+		ctl &c = d->controls[i];
+		if (c.Type == "Combo") {
+			if (bRefresh && !c.Text.empty()) {
+				// Replace the existing item text
+				SendMessage(c.hwndControl, CB_DELETESTRING, item, 0);
+				SendMessage(c.hwndControl, CB_INSERTSTRING, item, (LPARAM)c.Text.c_str());
+			}
+			// Make the item current
+			SendMessage(c.hwndControl, (UINT)CB_SETCURSEL, (WPARAM)item, 0L);
+			// Select all text in the edit field
+			if (bRefresh)
+				SendMessage(c.hwndControl, CB_SETEDITSEL, 0, MAKELONG(0, -1));
+			return true;
+		}
+		if (bRefresh) {
+			if (!c.Text.empty() && c.Store < 0) {
+				SendMessage(c.hwndControl, LB_DELETESTRING, item, 0);
+				SendMessage(c.hwndControl, LB_INSERTSTRING, item, (LPARAM)c.Text.c_str());
+			}
+		}
+		else {
+			// No selection if the item is not shown
+			int listsize = (int)SendMessage(c.hwndControl, (UINT)LB_GETCOUNT, (WPARAM)0, 0L);
+			if (d->ListRowFromItem(c, item) >= listsize)
+				return false;
+		}
+		// Row of the item if the list is filtered
+		SendMessage(c.hwndControl, (UINT)LB_SETCURSEL, (WPARAM)d->ListRowFromItem(c, item), 0L);
+		return true;
+	}
+
+	// Items reset while a kept dialog was hidden (KeepAlive)
+	void SetItems(size_t i) override {
+		ctl &c = d->controls[i];
+		HWND hwndList = c.hwndControl;
+		if (c.Type == "Combo") {
+			SendMessage(hwndList, CB_RESETCONTENT, 0, 0L);
+			d->InsertItems(hwndList, true, c.Items);
+		}
+		else if (c.Type == "List" && c.Store >= 0) {
+			SendMessage(hwndList, LB_SETCOUNT, (WPARAM)d->g_Stores[c.Store].Size(), 0L);
+		}
+		else if (c.Type == "List") {
+			SendMessage(hwndList, LB_RESETCONTENT, 0, 0L);
+			d->InsertItems(hwndList, false, c.Items);
+		}
+		// Rebuild the search index and apply the list filter
+		d->UpdateSearch(c);
+	}
+
+	void Move(const std::vector<size_t> &moved) override {
+		d->MoveControlWindows(moved);
+	}
+
+	bool GetText(size_t i, std::string &text) override {
+		if (!d->m_hDialog || !d->controls[i].hwndControl)
+			return false;
+		char tmp[MAX_PATH]{};
+		GetWindowTextA(d->controls[i].hwndControl, (LPSTR)tmp, MAX_PATH);
+		text = tmp;
+		return true;
+	}
+
+	// Not read while the dialog is closed
+	bool GetSpin(size_t i, int &value) override {
+		if (!d->m_hDialog)
+			return false;
+		if (d->controls[i].hwndControl)
+			value = (int)SendMessage(d->controls[i].hwndControl, UDM_GETPOS, 0, 0);
+		return true;
+	}
+
+	// Virtual list items (AddVirtualList)
+	int GetItemCount(size_t i) override {
+		const ctl &c = d->controls[i];
+		return c.Store >= 0 ? (int)d->g_Stores[c.Store].Size() : -1;
+	}
+
+	std::string GetItemText(size_t i, int item) override {
+		return d->GetListText(d->controls[i], item);
+	}
+
+	bool ReadValue(const std::string &file, const std::string &section,
+		const std::string &key, std::string &value) override {
+		char tmp[MAX_PATH]{};
+		if (GetPrivateProfileStringA((LPCSTR)section.c_str(), (LPCSTR)key.c_str(), NULL, (LPSTR)tmp, MAX_PATH, (LPCSTR)file.c_str()) <= 0 || !tmp[0])
+			return false;
+		value = tmp;
+		return true;
+	}
+
+	void WriteValue(const std::string &file, const std::string &section,
+		const std::string &key, const std::string &value) override {
+		WritePrivateProfileStringA((LPCSTR)section.c_str(), (LPCSTR)key.c_str(), (LPCSTR)value.c_str(), (LPCSTR)file.c_str());
+	}
 
-// Flag set to restore border colour for an owner draw button
-static bool bOver = false;
-// Flag to indicat the trackbar thumb is being dragged by the user
-static bool bDrag = false;
+};
 
 ofxWinDialog::ofxWinDialog(ofApp* app, HINSTANCE hInstance,
 	HWND hWnd, std::string className, int background)
@@ -198,17 +478,21 @@ ofxWinDialog::ofxWinDialog(ofApp* app, HINSTANCE hInstance,
 	m_hwnd = hWnd;
 	pApp = app; // The ofApp class pointer
 
-	SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
+	// Control windows for the dialog core
+	g_Backend.reset(new winbackend(this));
+	g_Core.SetBackend(g_Backend.get());
+
+	// Layout space from the dialog edges
+	g_Layout.SetMargin(10);
 
-	// TODO
-	// Make sure the program is per-monitor DPI aware
-	// Get the window scaling factor (100/125/150% etc)
+	// Per-monitor DPI aware. The dialog is scaled for the DPI
+	// of its monitor at Open and on WM_DPICHANGED (GetDpi).
 	// 96 DPI = 100%, 120 DPI = 125%, 144 DPI = 150% etc
-	// g_Scale = (double)GetDpiForWindow(hWnd)/96.0;
-	// printf("ofxWinDialog - scale = %.2f\n", g_Scale);
+	SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
 
 	// Default background brush is CTLCOLOR_DLG (light grey)
-	g_hBrush = CreateSolidBrush(GetSysColor(CTLCOLOR_DLG));
+	g_BackColor = GetSysColor(CTLCOLOR_DLG);
+	g_hBrush = CreateSolidBrush(g_BackColor);
 
 	//
 	// ofApp callback function for return of control values/
@@ -238,8 +522,11 @@ ofxWinDialog::ofxWinDialog(ofApp* app, HINSTANCE hInstance,
 	#endif
 
 	// Create the message hook to enable the tab key
-	if (!hMsgHook) {
-		hMsgHook = SetWindowsHookEx(WH_GETMESSAGE, GetKeyMsgProc, NULL, GetCurrentThreadId());
+	// One hook for all dialogs of the thread
+	m_HookThread = GetCurrentThreadId();
+	if (g_Hooks.Acquire(m_HookThread)) {
+		HHOOK hHook = SetWindowsHookEx(WH_GETMESSAGE, GetKeyMsgProc, NULL, m_HookThread);
+		g_Hooks.SetHook(m_HookThread, (uintptr_t)hHook);
 	}
 
 	// Window is registered by "RegisterDialog" in Open
@@ -247,21 +534,77 @@ ofxWinDialog::ofxWinDialog(ofApp* app, HINSTANCE hInstance,
 }
 
 ofxWinDialog::~ofxWinDialog() {
+    // No more changes from the parameter store
+    if (g_ParamSubscriber >= 0)
+        ParamStore::Global().Unsubscribe(g_ParamSubscriber);
+    // Stop the file watch thread
+    StopWatch();
+    // Stop the OSC thread
+    StopOsc();
     // Close the dialog window
+    g_Core.KeepAlive(false);
     if(m_hDialog) SendMessage(m_hDialog, WM_CLOSE, 0, 0);
+    // Wait for the dialog thread to end
+    EndDialogThread();
     // Unregister the window class
 	if(bRegistered) UnregisterClass(m_ClassName, m_hInstance);
-    // Release message hook
-    if (hMsgHook) UnhookWindowsHookEx(hMsgHook);
+    // Release the message hook if no other dialog of the thread uses it
+    g_Hooks.RemoveDialog(this);
+    uintptr_t hHook = 0;
+    if (g_Hooks.Release(m_HookThread, hHook) && hHook)
+        UnhookWindowsHookEx((HHOOK)hHook);
+	// Release streaming button surfaces
+	{
+		std::lock_guard<std::mutex> lock(g_StreamMutex);
+		for (auto &s : g_Streams) {
+			std::lock_guard<std::mutex> writelock(s.second->writemutex);
+			std::lock_guard<std::mutex> drawlock(s.second->drawmutex);
+			for (int i = 0; i < 2; i++) {
+				if (s.second->hBitmap[i]) DeleteObject(s.second->hBitmap[i]);
+				s.second->hBitmap[i] = nullptr;
+			}
+			s.second->bClosed = true;
+		}
+		g_Streams.clear();
+	}
+	// Release picture button atlas pages
+	for (size_t i = 0; i < g_AtlasPages.size(); i++) {
+		SelectObject(g_AtlasPages[i].hdcMem, g_AtlasPages[i].hOldBitmap);
+		DeleteDC(g_AtlasPages[i].hdcMem);
+		DeleteObject(g_AtlasPages[i].hBitmap);
+	}
+	g_AtlasPages.clear();
+	g_AtlasImages.clear();
+	// Release the paint buffers
+	ReleaseBackBuffer();
+	// Release cached brushes, pens, fonts and cursors
+	g_Gdi.Clear();
+	// Release button bitmaps created by ofxWinDialog
+	for (size_t i = 0; i < g_Bitmaps.size(); i++) {
+		DeleteObject(g_Bitmaps[i]);
+	}
+	g_Bitmaps.clear();
+	// Write the rest of the trace file
+	StopTrace();
 }
 
+// Decode an image file (stb_image)
+unsigned char* ofxWinDialog::LoadImagePixels(const std::string &path, int &width, int &height, int &nchannels)
+{
+	TraceScope span(g_TraceLog, "Decode", "image", path.c_str());
+	return stbi_load(path.c_str(), &width, &height, &nchannels, 0);
+}
 
 HBITMAP ofxWinDialog::CreateButtonBitmap(std::string path)
 {
 	int width, height, nchannels;
 
 	// Load image pixels
-	unsigned char * imageData = stbi_load(path.c_str(), &width, &height, &nchannels, 0);
+	unsigned char * imageData = LoadImagePixels(path, width, height, nchannels);
+	if (!imageData) {
+		printf("ofxWinDialog::CreateButtonBitmap - could not load %s\n", path.c_str());
+		return nullptr;
+	}
 
 	// Create bitmap from the pixel buffer
 	HBITMAP hBitMap = CreateButtonBitmap(imageData, width, height, nchannels, true, false);
@@ -271,59 +614,83 @@ HBITMAP ofxWinDialog::CreateButtonBitmap(std::string path)
 }
 
 // Create bitmap from pixel buffer
-// TODO check requirement for width multiple of 2 or 4
+// DIB rows are aligned to 4 bytes (see DibPitch)
 HBITMAP ofxWinDialog::CreateButtonBitmap(unsigned char *imageData, int width, int height, int nchannels, bool bInvert, bool bSwapRG)
 {
+	if (!imageData)
+		return nullptr;
+
+	unsigned char* bits = nullptr;
+	HBITMAP hBitmap = CreateDibSection(width, height, &bits);
+	if (!hBitmap) {
+		printf("ofxWinDialog::CreateButtonBitmap - could not create bitmap\n");
+		return nullptr;
+	}
+
+	// Copy the raw image data to the bitmap's bits buffer
+	// Convert from RGB to the correct memory format for the DIB.
+	// The DIB is top-down, so flip the rows if the image is not inverted.
+	CopyPixelsToDib(bits, DibPitch(width), imageData, width, height, nchannels, !bInvert, bSwapRG);
+
+	// Retain for release when replaced or in the destructor
+	g_Bitmaps.push_back(hBitmap);
+
+	return hBitmap;
+
+}
+
+// Create an empty top-down 24 bit DIB section
+HBITMAP ofxWinDialog::CreateDibSection(int width, int height, unsigned char** bits)
+{
+	if (width <= 0 || height <= 0)
+		return nullptr;
+
 	BITMAPINFO bmi{};
-	ZeroMemory(&bmi, sizeof(bmi));
 	bmi.bmiHeader.biSize = sizeof(bmi.bmiHeader);
 	bmi.bmiHeader.biWidth = width;
-	if(bInvert)
-		bmi.bmiHeader.biHeight = -height; // Negative to specify top-down bitmap
-	else
-		bmi.bmiHeader.biHeight = height;
+	bmi.bmiHeader.biHeight = -height; // Negative to specify top-down bitmap
 	bmi.bmiHeader.biPlanes = 1;
 	bmi.bmiHeader.biBitCount = 24; // 24 bits for RGB (no alpha)
 	bmi.bmiHeader.biCompression = BI_RGB;
 
 	// DIB section
-	void * bits = nullptr;
+	void* pBits = nullptr;
 	HBITMAP hBitmap = CreateDIBSection(
 		NULL, // default device context
 		&bmi, // BITMAPINFO structure
 		DIB_RGB_COLORS, // Colors are in RGB
-		&bits, // Pointer to store the bits
+		&pBits, // Pointer to store the bits
 		NULL, // No bitmap handle (using the direct memory buffer)
 		0 // Unused
 	);
 
-	if (!hBitmap) {
-		printf("ofxWinDialog::CreateButtonBitmap - could not create bitmap\n");
-		return nullptr;
-	}
+	if (bits) *bits = (unsigned char*)pBits;
+	return hBitmap;
+}
 
-	// Copy the raw image data to the bitmap's bits buffer
-	// Convert from RGB to the correct memory format for the DIB
-	unsigned char* dst = (unsigned char *)bits;
-	for (int y = 0; y < height; ++y) {
-		for (int x = 0; x < width; ++x) {
-			// Copy the RGB data (stb loads as RGB or RGBA)
-			int srcIndex = (y * width + x) * nchannels;
-			int dstIndex = (y * width + x) * 3; // 3 bytes per pixel (RGB)
-			if (bSwapRG) {
-				dst[dstIndex + 0] = imageData[srcIndex + 0]; // Blue
-				dst[dstIndex + 1] = imageData[srcIndex + 1]; // Green
-				dst[dstIndex + 2] = imageData[srcIndex + 2]; // Red
-			}
-			else {
-				dst[dstIndex + 0] = imageData[srcIndex + 2]; // Red
-				dst[dstIndex + 1] = imageData[srcIndex + 1]; // Green
-				dst[dstIndex + 2] = imageData[srcIndex + 0]; // Blue
-			}
-		}
+// Release a bitmap created by ofxWinDialog
+// if it is not used by working, original or restore controls
+void ofxWinDialog::ReleaseButtonBitmap(HBITMAP hBitmap)
+{
+	if (!hBitmap)
+		return;
+
+	auto it = std::find(g_Bitmaps.begin(), g_Bitmaps.end(), hBitmap);
+	if (it == g_Bitmaps.end())
+		return; // Not created by ofxWinDialog (ButtonPicture(HBITMAP))
+
+	for (size_t i = 0; i < controls.size(); i++) {
+		if ((HBITMAP)controls[i].hwndType == hBitmap) return;
+	}
+	for (size_t i = 0; i < newcontrols.size(); i++) {
+		if ((HBITMAP)newcontrols[i].hwndType == hBitmap) return;
+	}
+	for (size_t i = 0; i < oldcontrols.size(); i++) {
+		if ((HBITMAP)oldcontrols[i].hwndType == hBitmap) return;
 	}
-	return hBitmap;
 
+	DeleteObject(hBitmap);
+	g_Bitmaps.erase(it);
 }
 
 // Get executable or dll path
@@ -398,15 +765,23 @@ HFONT ofxWinDialog::GetFont() {
 	return g_hFont;
 }
 
+// Drawing objects created and re-used by the GDI object cache
+void ofxWinDialog::GetGdiCacheStats(uint64_t &created, uint64_t &reused)
+{
+	created = g_Gdi.GetCreated();
+	reused = g_Gdi.GetReused();
+}
+
 // Dialog background colour
 // Set before Open
 void ofxWinDialog::BackGroundColor(int hexcode) {
-	g_hBrush = CreateSolidBrush(Hex2Rgb(hexcode));
+	BackGroundColor(Hex2Rgb(hexcode));
 }
 void ofxWinDialog::BackGroundColor(int red, int grn, int blu) {
-	g_hBrush = CreateSolidBrush(RGB(red, grn, blu));
+	BackGroundColor(RGB(red, grn, blu));
 }
 void ofxWinDialog::BackGroundColor(COLORREF rgb) {
+	g_BackColor = rgb;
 	g_hBrush = CreateSolidBrush(rgb);
 }
 
@@ -433,6 +808,148 @@ void ofxWinDialog::Hide() {
 	bHide = true;
 }
 
+// Double buffered painting
+// Background, group frames and owner draw buttons are drawn
+// to off-screen buffers and copied to the window when complete.
+// Set before Open.
+void ofxWinDialog::DoubleBuffer() {
+	bDoubleBuffer = true;
+}
+
+// Create all controls with one dialog template
+void ofxWinDialog::UseTemplate(bool bTemplate) {
+	bUseTemplate = bTemplate;
+}
+
+// Create or re-size the back buffer for the window size
+// The whole buffer is rendered at the next paint
+void ofxWinDialog::AllocateBackBuffer(HDC hdc, int width, int height)
+{
+	if (!g_hdcBack) {
+		g_hdcBack = CreateCompatibleDC(hdc);
+		g_BackSize.Reset();
+		g_BackSize.Resize(width, height);
+	}
+	HBITMAP hBitmap = CreateCompatibleBitmap(hdc, g_BackSize.GetBufferWidth(), g_BackSize.GetBufferHeight());
+	if (!hBitmap) {
+		ReleaseBackBuffer();
+		return;
+	}
+	HBITMAP hOld = (HBITMAP)SelectObject(g_hdcBack, hBitmap);
+	if (g_hbmBack)
+		DeleteObject(hOld);
+	else
+		g_hbmBackOld = hOld;
+	g_hbmBack = hBitmap;
+	g_Dirty.Clear();
+	g_Dirty.Add(0, 0, g_BackSize.GetBufferWidth(), g_BackSize.GetBufferHeight());
+}
+
+// Release the back buffer and item buffer
+void ofxWinDialog::ReleaseBackBuffer()
+{
+	if (g_hdcBack) {
+		SelectObject(g_hdcBack, g_hbmBackOld);
+		DeleteObject(g_hbmBack);
+		DeleteDC(g_hdcBack);
+	}
+	g_hdcBack = NULL;
+	g_hbmBack = nullptr;
+	g_hbmBackOld = nullptr;
+	if (g_hdcItem) {
+		SelectObject(g_hdcItem, g_hbmItemOld);
+		DeleteObject(g_hbmItem);
+		DeleteDC(g_hdcItem);
+	}
+	g_hdcItem = NULL;
+	g_hbmItem = nullptr;
+	g_hbmItemOld = nullptr;
+	g_ItemSize.Reset();
+	g_Dirty.Clear();
+}
+
+// Render the dirty areas of the back buffer
+// Dialog background and group box frames and captions
+void ofxWinDialog::RenderBackBuffer()
+{
+	if (!g_hdcBack || g_Dirty.IsEmpty())
+		return;
+
+	HDC hdc = g_hdcBack;
+	g_Dirty.Clip(g_BackSize.GetBufferWidth(), g_BackSize.GetBufferHeight());
+
+	HFONT hOldFont = (HFONT)SelectObject(hdc, g_hFont ? g_hFont : (HFONT)GetStockObject(SYSTEM_FONT));
+	SetBkColor(hdc, g_BackColor);
+	SetBkMode(hdc, OPAQUE);
+
+	const std::vector<PaintRect> &rects = g_Dirty.GetRects();
+	for (size_t r = 0; r < rects.size(); r++) {
+
+		RECT dirty = { rects[r].left, rects[r].top, rects[r].right, rects[r].bottom };
+		IntersectClipRect(hdc, dirty.left, dirty.top, dirty.right, dirty.bottom);
+
+		// Background
+		FillRect(hdc, &dirty, g_hBrush);
+
+		// Group boxes in the dirty area
+		for (size_t i = 0; i < controls.size(); i++) {
+			if (controls[i].Type != "Group" || !g_Pages.IsShown(controls[i].Page))
+				continue;
+			PaintRect group;
+			group.left = controls[i].X;
+			group.top = controls[i].Y;
+			group.right = controls[i].X + controls[i].Width;
+			group.bottom = controls[i].Y + controls[i].Height;
+			if (!group.Intersects(rects[r]))
+				continue;
+
+			// Grey frame centred on the caption
+			RECT rect = { group.left, group.top + 10, group.right, group.bottom };
+			FrameRect(hdc, &rect, (HBRUSH)g_Gdi.Brush(GetSysColor(CTLCOLOR_MSGBOX)));
+
+			// Caption text on the background colour
+			// Colour set by TextColor in control.Index (default 0)
+			if (controls[i].Index > 0)
+				SetTextColor(hdc, Hex2Rgb(controls[i].Index));
+			else
+				SetTextColor(hdc, GetSysColor(COLOR_WINDOWTEXT));
+			rect.left += 8;
+			rect.top -= 10;
+			std::string caption = " " + controls[i].Text + " ";
+			DrawTextA(hdc, caption.c_str(), -1, &rect, DT_SINGLELINE | DT_LEFT | DT_TOP);
+		}
+
+		SelectClipRgn(hdc, NULL);
+	}
+
+	SelectObject(hdc, hOldFont);
+	g_Dirty.Clear();
+}
+
+// Off-screen buffer for owner draw buttons
+// Grows to the largest button size drawn
+HDC ofxWinDialog::GetItemBuffer(HDC hdc, int width, int height)
+{
+	if (!g_hdcItem)
+		g_hdcItem = CreateCompatibleDC(hdc);
+	if (!g_hdcItem)
+		return NULL;
+	int w = (std::max)(width, g_ItemSize.GetWidth());
+	int h = (std::max)(height, g_ItemSize.GetHeight());
+	if (g_ItemSize.Resize(w, h) || !g_hbmItem) {
+		HBITMAP hBitmap = CreateCompatibleBitmap(hdc, g_ItemSize.GetBufferWidth(), g_ItemSize.GetBufferHeight());
+		if (!hBitmap)
+			return NULL;
+		HBITMAP hOld = (HBITMAP)SelectObject(g_hdcItem, hBitmap);
+		if (g_hbmItem)
+			DeleteObject(hOld);
+		else
+			g_hbmItemOld = hOld;
+		g_hbmItem = hBitmap;
+	}
+	return g_hdcItem;
+}
+
 // Checkbox
 // Text in the checkbox is independent of the title
 // Style can be : BS_LEFT, BS_CENTER, BS_RIGHT - default BS_LEFT.
@@ -588,833 +1105,2602 @@ void ofxWinDialog::AddList(std::string title, int x, int y, int width, int heigh
 }
 
 //
-// Spin control
+// Virtual list box control
 //
-// x, y, width, height - position and dimensions
-// min, max, - range. value - starting value
-// Style can be UDS_ALIGNLEFT or UDS_ALIGNRIGHT (default)
+// Items are held once, in contiguous storage (ItemStore), and not
+// in the list box or the control items vector. The list box has
+// no item data (LBS_NODATA) and only the visible rows are drawn.
 //
-void ofxWinDialog::AddSpin(std::string title, int x, int y, int width, int height,
-	int min, int max, int value, DWORD dwStyle)
-{
-
+void ofxWinDialog::AddVirtualList(std::string title, int x, int y, int width, int height, std::vector<std::string> items, int index) {
 	ctl control {};
-	control.Type = "Spin";
+	control.Type = "List";
 	control.Title = title;
-	control.Min = (float)min; // min value
-	control.Max = (float)max; // max value
-	control.Val = value; // initial value
-	control.Style = dwStyle;
+	control.Index = index;
 	control.X = x;
 	control.Y = y;
 	control.Width = width;
 	control.Height = height;
-	controls.push_back(control);
-}
-
-// Push button
-// Text in the button is independent of the title
-void ofxWinDialog::AddButton(std::string title, std::string text, int x, int y, int width, int height, DWORD dwStyle) {
-	ctl control {};
-	control.Type = "Button";
-	control.Title = title;
-	control.Text = text;
-	control.Style = dwStyle;
-    control.X=x;
-    control.Y=y;
-    control.Width=width;
-    control.Height=height;
-
-	//
-	// Custom values used in WM_DRAWITEM
-	//
 
-	// Picture button bitmap (ButtonPicture)
-	if (g_hBitmap) {
-		control.hwndType = (HWND)g_hBitmap;
-		control.Style |= BS_OWNERDRAW;
-		g_hBitmap = nullptr;
-	}
+	// Item storage for the control
+	g_Stores.emplace_back();
+	ItemStore &store = g_Stores.back();
+	size_t bytes = 0;
+	for (size_t i = 0; i < items.size(); i++)
+		bytes += items[i].size();
+	store.Reserve(items.size(), bytes);
+	for (size_t i = 0; i < items.size(); i++)
+		store.Append(items[i]);
+	control.Store = (int)g_Stores.size() - 1;
 
-	// Button background colour (ButtonColor)
-	// Use control Val (default 0);
-	if (g_ButtonColor != 0) {
-		control.Val = Rgb2Hex(GetRValue(g_ButtonColor),
-			GetGValue(g_ButtonColor), GetBValue(g_ButtonColor));
-		control.Style |= BS_OWNERDRAW;
-		g_ButtonColor = 0;
-	}
+	controls.push_back(control);
+}
 
-	// Button text colour (TextColor)
-	// Use control index (default 0)
-	if (g_TextColor != 0) {
-		control.Index = Rgb2Hex(GetRValue(g_TextColor),
-			GetGValue(g_TextColor), GetBValue(g_TextColor));
-		control.Style |= BS_OWNERDRAW;
-		// If not a colour or image button retain the default
-		// button background to avoid text over-write in WM_DRAWITEM
-		if (control.Val == 0 && !control.hwndType) {
-			control.Val = Rgb2Hex(RGB(224, 224, 224));
+// Append a virtual list item
+void ofxWinDialog::AppendListItem(std::string title, std::string text)
+{
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Type == "List" && controls[i].Title == title && controls[i].Store >= 0) {
+			size_t item = g_Stores[controls[i].Store].Append(text);
+			bool bShow = true;
+			if (controls[i].Search >= 0) {
+				itemsearch &search = g_Search[controls[i].Search];
+				search.index.Append(text);
+				// Filtered - add a row only if the item matches
+				if (search.bFiltered) {
+					bShow = search.index.Matches(item, search.filter, search.bContains);
+					if (bShow)
+						search.rows.push_back((uint32_t)item);
+				}
+			}
+			// A no-data list box adds an item without data
+			if (controls[i].hwndControl && bShow)
+				SendMessageA(controls[i].hwndControl, LB_ADDSTRING, 0, 0L);
+			return;
 		}
-		g_TextColor = 0;
 	}
-
-    controls.push_back(control);
 }
 
-// Change button size
-void ofxWinDialog::SetButton(std::string title, int width, int height) {
+// Replace a virtual list item
+// The item is redrawn only if it is visible
+void ofxWinDialog::ReplaceListItem(std::string title, int item, std::string text)
+{
 	for (size_t i = 0; i < controls.size(); i++) {
-		// Update the button width and height
-		if (controls[i].Type == "Button") {
-			if (controls[i].Title == title) {
-				if(width  > 0) controls[i].Width  = width;
-				if(height > 0) controls[i].Height = height;
-				SetWindowPos(controls[i].hwndControl, HWND_TOP,
-					controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height, SWP_NOMOVE);
-				// Change button bitmap if set by ButtonPicture
-				if (g_hBitmap != nullptr) {
-					controls[i].hwndType = (HWND)g_hBitmap;
-					g_hBitmap = nullptr;
+		if (controls[i].Type == "List" && controls[i].Title == title && controls[i].Store >= 0) {
+			if (!g_Stores[controls[i].Store].Replace((size_t)item, text))
+				return;
+			if (controls[i].Search >= 0) {
+				itemsearch &search = g_Search[controls[i].Search];
+				bool bShown = ListRowFromItem(controls[i], item) >= 0;
+				search.index.Replace((size_t)item, text);
+				// Filtered - the item may now be shown or hidden
+				if (search.bFiltered && bShown != search.index.Matches((size_t)item, search.filter, search.bContains)) {
+					ApplyListFilter(controls[i]);
+					return;
 				}
-				// Update the control
-				RedrawWindow(controls[i].hwndControl, NULL, NULL, RDW_INVALIDATE | RDW_UPDATENOW | RDW_ERASENOW | RDW_INTERNALPAINT);
 			}
+			HWND hwndList = controls[i].hwndControl;
+			int row = ListRowFromItem(controls[i], item);
+			if (hwndList && row >= 0) {
+				RECT client{};
+				GetClientRect(hwndList, &client);
+				int itemheight = (int)SendMessage(hwndList, LB_GETITEMHEIGHT, 0, 0L);
+				int top = (int)SendMessage(hwndList, LB_GETTOPINDEX, 0, 0L);
+				ListWindow window(itemheight, client.bottom - client.top);
+				if (window.IsVisible(row, top)) {
+					RECT rect{};
+					SendMessage(hwndList, LB_GETITEMRECT, (WPARAM)row, (LPARAM)&rect);
+					InvalidateRect(hwndList, &rect, FALSE);
+				}
+			}
+			return;
 		}
 	}
 }
-	// Change button text
-// Style can be BS_TOP or BS_BOTTOM (default center)
-void ofxWinDialog::ButtonText(std::string title, std::string text, DWORD dwStyle) {
+
+// Get the number of list items
+int ofxWinDialog::GetListCount(std::string title)
+{
 	for (size_t i = 0; i < controls.size(); i++) {
-		// Update the button text
-		if (controls[i].Type == "Button") {
-			if (controls[i].Title == title) {
-				SetWindowTextA(controls[i].hwndControl, text.c_str());
-				// Set control text for owner draw
-				controls[i].Text = text;
-				controls[i].Min = (float)dwStyle; // Min is normally unused for a button
-				// Change button text colour if set by TextColor
-				if (g_TextColor != 0) {
-					controls[i].Index = Rgb2Hex(g_TextColor);
-					g_TextColor = 0;
-				}
-				// Update the control
-				RedrawWindow(controls[i].hwndControl, NULL, NULL, RDW_INVALIDATE | RDW_UPDATENOW | RDW_ERASENOW | RDW_INTERNALPAINT);
-			}
+		if (controls[i].Type == "List" && controls[i].Title == title) {
+			if (controls[i].Store >= 0)
+				return (int)g_Stores[controls[i].Store].Size();
+			return (int)controls[i].Items.size();
 		}
 	}
+	return 0;
 }
 
-// Get button text
-std::string ofxWinDialog::GetButtonText(std::string title) {
+//
+// Bulk item loading
+//
+// Items are passed as one UTF-8 buffer and an offsets array
+// (see ofxWinDialogItems.h) so that a large batch needs no
+// per-item allocation by the caller.
+//
+void ofxWinDialog::LoadCombo(std::string title, const char* data, const size_t* offsets, size_t count, int index)
+{
+	if (!CheckItemBatch(data, offsets, count))
+		return;
+	auto start = std::chrono::steady_clock::now();
 	for (size_t i = 0; i < controls.size(); i++) {
-		if (controls[i].Type == "Button") {
-			if (controls[i].Title == title) {
-				return controls[i].Text;
+		if (controls[i].Type == "Combo" && controls[i].Title == title) {
+			controls[i].Items.clear();
+			controls[i].Items.reserve(count);
+			for (size_t j = 0; j < count; j++)
+				controls[i].Items.emplace_back(data + offsets[j], offsets[j + 1] - offsets[j]);
+			controls[i].Index = index;
+			HWND hwndList = controls[i].hwndControl;
+			// Kept dialog hidden - items are added by Open
+			if (hwndList && !g_Core.Defer(i, ChangedItems)) {
+				SendMessage(hwndList, CB_RESETCONTENT, 0, 0L);
+				InsertItems(hwndList, true, data, offsets, count, nullptr, true);
+				SendMessage(hwndList, CB_SETCURSEL, (WPARAM)index, 0L);
 			}
+			UpdateSearch(controls[i]);
 		}
 	}
-	return "";
+	g_LoadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
 }
 
-// Change button background color
-// Set before AddButton
-//     Reference :
-//     https://www.html-color-codes.info/color-names/
-//     https://www.computerhope.com/htmcolor.htm
-void ofxWinDialog::ButtonColor(int hexcode) {
-	ButtonColor(Hex2Rgb(hexcode));
-}
-void ofxWinDialog::ButtonColor(int red, int grn, int blu) {
-	ButtonColor(RGB(red, grn, blu));
-}
-void ofxWinDialog::ButtonColor(COLORREF rgb) {
-	g_ButtonColor = rgb;
-}
-
-// Image file for picture button (bmp, jpg, png, tga)
-// Call before AddButton
-// TextColor can also be used to change the button text
-void ofxWinDialog::ButtonPicture(std::string path)
+void ofxWinDialog::LoadList(std::string title, const char* data, const size_t* offsets, size_t count, int index)
 {
-	if (_access(path.c_str(), 0) != -1) {
-		// Set the global bitmap handle for AddButton and SetButton
-		g_hBitmap = CreateButtonBitmap(path);
+	if (!CheckItemBatch(data, offsets, count))
+		return;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Type == "List" && controls[i].Title == title) {
+			controls[i].Index = index;
+			HWND hwndList = controls[i].hwndControl;
+			// Virtual list - replace the item store and set the list count
+			if (controls[i].Store >= 0) {
+				ItemStore &store = g_Stores[controls[i].Store];
+				store.Clear();
+				store.Reserve(count, count > 0 ? offsets[count] - offsets[0] : 0);
+				for (size_t j = 0; j < count; j++)
+					store.Append(data + offsets[j], offsets[j + 1] - offsets[j]);
+				// A filtered list is reset by UpdateSearch
+				// and a hidden kept dialog by Open
+				if (hwndList && !g_Core.Defer(i, ChangedItems) && !IsListFiltered(controls[i])) {
+					SendMessage(hwndList, LB_SETCOUNT, (WPARAM)count, 0L);
+					SendMessage(hwndList, LB_SETCURSEL, (WPARAM)index, 0L);
+				}
+				UpdateSearch(controls[i]);
+				continue;
+			}
+			controls[i].Items.clear();
+			controls[i].Items.reserve(count);
+			for (size_t j = 0; j < count; j++)
+				controls[i].Items.emplace_back(data + offsets[j], offsets[j + 1] - offsets[j]);
+			if (hwndList && !g_Core.Defer(i, ChangedItems) && !IsListFiltered(controls[i])) {
+				SendMessage(hwndList, LB_RESETCONTENT, 0, 0L);
+				InsertItems(hwndList, false, data, offsets, count, nullptr, true);
+				SendMessage(hwndList, LB_SETCURSEL, (WPARAM)index, 0L);
+			}
+			UpdateSearch(controls[i]);
+		}
 	}
+	g_LoadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
 }
 
-// Button picture from image pixels
-void ofxWinDialog::ButtonPicture(unsigned char *imageData, int width, int height, int nchannels, bool bInvert, bool bSwapRG)
-{
-	g_hBitmap = CreateButtonBitmap(imageData, width, height, nchannels, bInvert, bSwapRG);
-}
-
-// Button picture from bitmap
-void ofxWinDialog::ButtonPicture(HBITMAP hBitmap)
+// Time taken by the last LoadCombo or LoadList (msec)
+double ofxWinDialog::GetLoadTime()
 {
-	g_hBitmap = hBitmap;
+	return g_LoadTime;
 }
 
-// Static Group box
-// A group box is not a control and has no title
-void ofxWinDialog::AddGroup(std::string text, int x, int y, int width, int height)
+// Convert an item batch from the ANSI code page to null terminated
+// UTF-16 items, as for the titles and other text of the dialog
+// (see Utf8ToUtf16 in ofxWinDialogItems.h for the arguments)
+static bool AnsiToUtf16(const char* data, const size_t* offsets, size_t count,
+	std::vector<uint16_t> &wide, std::vector<size_t> &woffsets)
 {
-    ctl control{};
-    control.Type = "Group";
-    control.Title = text;
-    control.Text = text;
-    control.X=x;
-    control.Y=y;
-    control.Width=width;
-    control.Height=height;
+	wide.clear();
+	woffsets.clear();
+	if (count == 0)
+		return true;
+	if (!CheckItemBatch(data, offsets, count))
+		return false;
 
-	// Group box caption text colour (TextColor)
-	// Use control index (default 0);
-	if (g_TextColor != 0) {
-		control.Index = Rgb2Hex(GetRValue(g_TextColor),
-			GetGValue(g_TextColor), GetBValue(g_TextColor));
-		g_TextColor = 0;
+	// A character is never more UTF-16 units than bytes
+	wide.resize(offsets[count] - offsets[0] + count);
+	woffsets.reserve(count);
+	size_t pos = 0;
+	for (size_t i = 0; i < count; i++) {
+		woffsets.push_back(pos);
+		int len = (int)(offsets[i + 1] - offsets[i]);
+		if (len > 0) {
+			int n = MultiByteToWideChar(CP_ACP, 0, data + offsets[i], len,
+				reinterpret_cast<wchar_t*>(&wide[pos]), (int)(wide.size() - pos - 1));
+			if (n > 0)
+				pos += (size_t)n;
+		}
+		wide[pos++] = 0;
 	}
-
-    controls.push_back(control);
+	wide.resize(pos);
+	return true;
 }
 
-//
-// Static text
-//
-// Default style left aligned (SS_LEFT)
-// Additional styles can be specified
-//	  SS_CENTER - centered
-//	  SS_RIGHT  - right aligned
-//	  WS_BORDER - outlined
-//	  SS_SUNKEN - sunken edge
-
-
-// Static text that is not a updated
-void ofxWinDialog::AddText(std::string text, int x, int y, int width, int height, DWORD dwStyle) {
-	AddText(text, text, x, y, width, height, dwStyle);
-}
+// Insert a batch of items in a combo or list box
+// Storage is reserved for the whole batch and the list
+// is not redrawn until all items have been inserted.
+// The index of each item in the batch, or "itemdata"
+// if specified, is set as its item data.
+// Items are ANSI text as for the rest of the dialog,
+// or UTF-8 for LoadCombo and LoadList (bUtf8).
+void ofxWinDialog::InsertItems(HWND hwndList, bool bCombo, const char* data, const size_t* offsets, size_t count, const uint32_t* itemdata, bool bUtf8)
+{
+	if (!hwndList || count == 0)
+		return;
 
-// Static text with an idependent title that can be updated with SetText
-// If the text is empty, the title is used for text display
-void ofxWinDialog::AddText(std::string title, std::string text, int x, int y, int width, int height, DWORD dwStyle) {
-	ctl control {};
-	control.Type = "Static";
-	control.Title = title;
-	control.Text = text;
-	control.Style = dwStyle;
-	control.X = x;
-	control.Y = y;
-	control.Width = width;
-	control.Height = height;
+	// Convert all items to wide chars in one pass
+	// wchar_t is 16 bit UTF-16 on Windows
+	std::vector<uint16_t> wide;
+	std::vector<size_t> woffsets;
+	if (bUtf8 ? !Utf8ToUtf16(data, offsets, count, wide, woffsets)
+		: !AnsiToUtf16(data, offsets, count, wide, woffsets))
+		return;
 
-	// Static text colour
-	// Use control index (default 0);
-	if (g_TextColor != 0) {
-		control.Index = Rgb2Hex(GetRValue(g_TextColor),
-			GetGValue(g_TextColor), GetBValue(g_TextColor));
-		g_TextColor = 0;
+	UINT addmsg  = bCombo ? CB_ADDSTRING : LB_ADDSTRING;
+	UINT datamsg = bCombo ? CB_SETITEMDATA : LB_SETITEMDATA;
+
+	SendMessage(hwndList, WM_SETREDRAW, FALSE, 0L);
+	SendMessage(hwndList, bCombo ? CB_INITSTORAGE : LB_INITSTORAGE,
+		(WPARAM)count, (LPARAM)(wide.size() * sizeof(wchar_t)));
+	for (size_t j = 0; j < count; j++) {
+		const wchar_t* itemstr = reinterpret_cast<const wchar_t*>(&wide[woffsets[j]]);
+		int pos = (int)SendMessageW(hwndList, addmsg, (WPARAM)0, (LPARAM)itemstr);
+		if (pos < 0) break; // CB_ERR/LB_ERR or out of space
+		SendMessage(hwndList, datamsg, (WPARAM)pos, (LPARAM)(itemdata ? itemdata[j] : j));
 	}
-
-	controls.push_back(control);
+	SendMessage(hwndList, WM_SETREDRAW, TRUE, 0L);
+	InvalidateRect(hwndList, NULL, TRUE);
 }
 
-// Static text color
-// Set before AddText
-// Reference :
-//     https://www.html-color-codes.info/color-names/
-//     https://www.computerhope.com/htmcolor.htm
-// If setting text for a button, the background
-// also has to be specified with ButtonColor
-void ofxWinDialog::TextColor(int hexcode) {
-	TextColor(Hex2Rgb(hexcode));
-}
-void ofxWinDialog::TextColor(int red, int grn, int blu) {
-	TextColor(RGB(red, grn, blu));
-}
-void ofxWinDialog::TextColor(COLORREF rgb) {
-	g_TextColor = rgb;
-}
-
-
-// Hyperlink
-// Title is the text displayed, control text is the action taken
-// If the text is empty, ofApp is notified when the title is clicked
-void ofxWinDialog::AddHyperlink(std::string title, std::string text, int x, int y, int width, int height, DWORD dwStyle)
+void ofxWinDialog::InsertItems(HWND hwndList, bool bCombo, const std::vector<std::string> &items, const uint32_t* itemdata)
 {
-    ctl control{};
-    control.Type = "Static";
-    control.Title = title; // The title that appears in the dialog
-    control.Text  = text; // The action to be taken.
-    // Enable notifications for action and owner draw for text colour
-    control.Style = SS_NOTIFY | SS_OWNERDRAW | dwStyle;
-    control.Index = 1; // To identify a hyperlink from static text
-    control.X=x;
-    control.Y=y;
-    control.Width=width;
-    control.Height=height;
-    controls.push_back(control);
+	std::string data;
+	std::vector<size_t> offsets;
+	BuildItemBatch(items, data, offsets);
+	InsertItems(hwndList, bCombo, data.data(), offsets.data(), items.size(), itemdata);
 }
 
-// Get checkbox state
-int ofxWinDialog::GetCheckBox(std::string title)
-{
-    int state = 0;
-    for (size_t i=0; i<controls.size(); i++) {
-        if (controls[i].Type == "Checkbox") {
-            if (controls[i].Title == title) {
-                state = controls[i].Val;
-            }
-        }
-    }
-    return state;
-}
+//
+// Item search
+//
+// A search index (ItemIndex) is created for a combo or list box
+// the first time it is searched or filtered. It is then rebuilt
+// when all items are reset and updated in place when a virtual
+// list item is appended or replaced.
+//
 
-// Get radio button state
-int ofxWinDialog::GetRadioButton(std::string title)
+// Find a combo item by text
+int ofxWinDialog::FindComboItem(std::string title, std::string text)
 {
-    int state = 0;
-    for (size_t i=0; i<controls.size(); i++) {
-        if (controls[i].Type == "Radio") {
-            if (controls[i].Title == title) {
-                state = controls[i].Val;
-            }
-        }
-    }
-    return state;
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Type == "Combo" && controls[i].Title == title)
+			return GetSearchIndex(controls[i]).Find(text);
+	}
+	return -1;
 }
 
-// Get slider value
-float ofxWinDialog::GetSlider(std::string title)
+// Find a list item by text
+int ofxWinDialog::FindListItem(std::string title, std::string text)
 {
-    float value = 0.0f;
-    for (size_t i=0; i<controls.size(); i++) {
-        if (controls[i].Type == "Slider") {
-            if (controls[i].Title == title) {
-                value = controls[i].SliderVal;
-            }
-        }
-    }
-    return value;
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Type == "List" && controls[i].Title == title)
+			return GetSearchIndex(controls[i]).Find(text);
+	}
+	return -1;
 }
 
-// Get edit control text
-std::string ofxWinDialog::GetEdit(std::string title)
+// Show only list items that start with or contain the text
+void ofxWinDialog::SetListFilter(std::string title, std::string text, bool bContains)
 {
-    std::string str;
-    for (size_t i=0; i<controls.size(); i++) {
-        if (controls[i].Type == "Edit") {
-            if (controls[i].Title == title) {
-                // Get the current text from the edit control
-                char buffer[256]{};
-                GetWindowTextA(controls[i].hwndControl, buffer, sizeof(buffer));
-                str = buffer;
-                // Update the control 'Text' string
-                controls[i].Text = str;
-            }
-        }
-    }
-    // Return the control text if found
-    return str;
-}
-
-// Get current combo box item index and text
-int ofxWinDialog::GetComboItem(std::string title, std::string* text) {
-	int index = 0;
 	for (size_t i = 0; i < controls.size(); i++) {
-		if (controls[i].Type == "Combo") {
-			if (controls[i].Title == title) {
-				index = controls[i].Index;
-				if (text) *text = controls[i].Items[index];
-			}
+		if (controls[i].Type == "List" && controls[i].Title == title) {
+			// Substring search uses the trigram index
+			GetSearchIndex(controls[i], bContains);
+			itemsearch &search = g_Search[controls[i].Search];
+			search.filter = text;
+			search.bContains = bContains;
+			ApplyListFilter(controls[i]);
 		}
 	}
-	return index;
 }
 
-// Get combo box edit text
-std::string ofxWinDialog::GetComboEdit(std::string title)
+// Filter a list with the text of an edit control
+// The filter is applied for each EN_CHANGE from the edit control
+void ofxWinDialog::SetListFilterEdit(std::string title, std::string edit, bool bContains)
 {
-	std::string str;
 	for (size_t i = 0; i < controls.size(); i++) {
-		if (controls[i].Type == "Combo") {
-			if (controls[i].Title == title) {
-				char tmp[256]{};
-				int len = GetWindowTextA(controls[i].hwndControl, tmp, 256);
-				if (len > 0) str = tmp;
-			}
+		if (controls[i].Type == "List" && controls[i].Title == title) {
+			GetSearchIndex(controls[i], bContains);
+			itemsearch &search = g_Search[controls[i].Search];
+			search.edit = edit;
+			search.bContains = bContains;
 		}
 	}
-	// Return the current edit text
-	return str;
 }
 
-// Get current list box item index and text
-int ofxWinDialog::GetListItem(std::string title, std::string * text) {
-	int index = 0;
-	for (size_t i = 0; i < controls.size(); i++) {
-		if (controls[i].Type == "List") {
-			if (controls[i].Title == title) {
-				index = controls[i].Index;
-				if (text) *text = controls[i].Items[index];
-			}
+// Search index of a combo or list box
+// Created on first use
+ItemIndex &ofxWinDialog::GetSearchIndex(ctl &control, bool bNgrams)
+{
+	if (control.Search < 0) {
+		g_Search.emplace_back();
+		control.Search = (int)g_Search.size() - 1;
+	}
+	itemsearch &search = g_Search[control.Search];
+	size_t count = control.Store >= 0 ? g_Stores[control.Store].Size() : control.Items.size();
+	bool bBuild = search.index.Size() != count || (bNgrams && !search.index.HasNgrams());
+	if (bBuild) {
+		search.index = ItemIndex(bNgrams || search.index.HasNgrams());
+		if (control.Store >= 0) {
+			const ItemStore &store = g_Stores[control.Store];
+			search.index.Build(store.Size(), [&store](size_t i) { return store.GetString(i); });
+		}
+		else {
+			search.index.Build(control.Items);
 		}
 	}
-	return index;
+	return search.index;
 }
 
-
-// Set a section name for the control in an initialization file
-void ofxWinDialog::SetSection(std::string title, std::string section)
+// Rebuild the search index after the items are reset
+// and apply the list filter to the new items
+void ofxWinDialog::UpdateSearch(ctl &control)
 {
-    for (size_t i=0; i<controls.size(); i++) {
-        if (controls[i].Title == title) {
-            controls[i].Section = section;
-        }
-    }
+	if (control.Search < 0)
+		return;
+	itemsearch &search = g_Search[control.Search];
+	search.index.Clear();
+	GetSearchIndex(control);
+	// The filter of a hidden kept dialog is applied by Open
+	if (control.Type == "List" && !search.filter.empty() && !(control.Changed & ChangedItems))
+		ApplyListFilter(control);
 }
 
-// Set checkbox state
-void ofxWinDialog::SetCheckBox(std::string title, int value)
+// Show the list items that match the filter
+void ofxWinDialog::ApplyListFilter(ctl &control)
 {
-    for (size_t i=0; i<controls.size(); i++) {
-        // Update the checkbox state
-        if (controls[i].Type == "Checkbox") {
-            if (controls[i].Title == title) {
-                controls[i].Val = value;
-                if (value == 1)
-                    SendMessage(controls[i].hwndControl, BM_SETCHECK, BST_CHECKED, 0);
-                else
-                    SendMessage(controls[i].hwndControl, BM_SETCHECK, BST_UNCHECKED, 0);
-            }
-        }
-    }
-}
+	if (control.Search < 0)
+		return;
+	itemsearch &search = g_Search[control.Search];
+	ItemIndex &index = GetSearchIndex(control, search.bContains);
+
+	search.bFiltered = !search.filter.empty();
+	search.rows.clear();
+	if (search.bFiltered) {
+		if (search.bContains)
+			index.FindContains(search.filter, search.rows);
+		else
+			index.FindPrefix(search.filter, search.rows);
+	}
 
-// Set radio button state
-// The application must set all buttons in the group
-void ofxWinDialog::SetRadioButton(std::string title, int value)
-{
-    for (size_t i=0; i<controls.size(); i++) {
-        if (controls[i].Type == "Radio") {
-            if (controls[i].Title == title) {
-               // Update the Radio button state
-               controls[i].Val = value;
-               if(value == 1)
-                    SendMessage(controls[i].hwndControl, BM_SETCHECK, BST_CHECKED, 0);
-               else
-                   SendMessage(controls[i].hwndControl, BM_SETCHECK, BST_UNCHECKED, 0);
-            } // End matching title
-        } // End radio button controls
-    } // End all controls
-}
+	HWND hwndList = control.hwndControl;
+	if (!hwndList)
+		return;
 
-// Enable or disable a control
-// Except Hyperlink and Group
-void ofxWinDialog::EnableControl(std::string title, bool bEnabled) {
-	for (size_t i = 0; i < controls.size(); i++) {
-		if (controls[i].Type    != "Hyperlink"
-			&& controls[i].Type != "Group") {
-			if (controls[i].Title == title) {
-				HWND hwnd = controls[i].hwndControl;
-				EnableWindow(hwnd, (BOOL)bEnabled);
-				// Redraw immediately
-				RedrawWindow(hwnd, NULL, NULL, RDW_INVALIDATE | RDW_UPDATENOW | RDW_ERASENOW | RDW_INTERNALPAINT);
-			}
+	if (control.Store >= 0) {
+		// Virtual list - rows are drawn from the filtered items
+		size_t count = search.bFiltered ? search.rows.size() : g_Stores[control.Store].Size();
+		SendMessage(hwndList, LB_SETCOUNT, (WPARAM)count, 0L);
+	}
+	else {
+		SendMessage(hwndList, LB_RESETCONTENT, 0, 0L);
+		if (!search.bFiltered) {
+			InsertItems(hwndList, false, control.Items);
+		}
+		else if (!search.rows.empty()) {
+			std::vector<std::string> items;
+			items.reserve(search.rows.size());
+			for (size_t j = 0; j < search.rows.size(); j++)
+				items.push_back(control.Items[search.rows[j]]);
+			InsertItems(hwndList, false, items, search.rows.data());
 		}
 	}
+
+	// Keep the current item selected if it is shown
+	SendMessage(hwndList, LB_SETCURSEL, (WPARAM)ListRowFromItem(control, control.Index), 0L);
+	InvalidateRect(hwndList, NULL, TRUE);
 }
 
-void ofxWinDialog::SetControlFocus(std::string title, bool bPress)
+// Whether a list shows filtered items
+bool ofxWinDialog::IsListFiltered(const ctl &control)
 {
-	for (size_t i = 0; i < controls.size(); i++) {
-		if (controls[i].Title == title) {
-			HWND hwnd = controls[i].hwndControl;
-			SetFocus(hwnd);
-			if (bPress) {
-				// Send mouse down/up
-				PostMessage(hwnd, WM_LBUTTONDOWN, 0, 0);
-				PostMessage(hwnd, WM_LBUTTONUP, 0, 0);
-			}
-		}
-	}
+	return control.Search >= 0 && g_Search[control.Search].bFiltered;
 }
 
-// Set slider value
-void ofxWinDialog::SetSlider(std::string title, float value)
+// Item shown in a list box row
+int ofxWinDialog::ListItemFromRow(const ctl &control, int row)
 {
-    for (size_t i=0; i<controls.size(); i++) {
-        if (controls[i].Type == "Slider") {
-            if (controls[i].Title == title) {
+	if (!IsListFiltered(control))
+		return row;
+	const std::vector<uint32_t> &rows = g_Search[control.Search].rows;
+	if (row < 0 || row >= (int)rows.size())
+		return -1;
+	return (int)rows[row];
+}
 
-				// Quit if the slider is currently being moved
-				if (bDrag)
-					break;
-
-                // Update the Slider value
-                controls[i].SliderVal = value;
-                if ((controls[i].Max - controls[i].Min) > 1000.0)
-                    SendMessage(controls[i].hwndControl, TBM_SETPOS, TRUE, (int)controls[i].SliderVal);
-                else
-                    SendMessage(controls[i].hwndControl, TBM_SETPOS, TRUE, (int)(value*100.0f));
-                InvalidateRect(controls[i].hwndControl, NULL, TRUE);
-
-                // Slider value text display
-                if (controls[i].hwndSliderVal) {
-                    char tmp[8]{};
-                    if (controls[i].Max >= 100.0f)
-                        sprintf_s(tmp, 8, "%.0f", controls[i].SliderVal);
-                    else if (controls[i].Max >= 10.0f)
-                        sprintf_s(tmp, 8, "%.1f", controls[i].SliderVal);
-                    else
-                        sprintf_s(tmp, 8, "%.2f", controls[i].SliderVal);
-                    SetWindowTextA(controls[i].hwndSliderVal, (LPCSTR)tmp);
-                }
-				break;
-            }
-        }
-    }
+// List box row of an item or -1 if it is not shown
+int ofxWinDialog::ListRowFromItem(const ctl &control, int item)
+{
+	if (!IsListFiltered(control))
+		return item;
+	const std::vector<uint32_t> &rows = g_Search[control.Search].rows;
+	auto it = std::lower_bound(rows.begin(), rows.end(), (uint32_t)item);
+	if (item < 0 || it == rows.end() || *it != (uint32_t)item)
+		return -1;
+	return (int)(it - rows.begin());
 }
 
-void ofxWinDialog::SetEdit(std::string title, std::string text)
+// Text of a list item
+// From the item store of a virtual list or the control items
+std::string ofxWinDialog::GetListText(const ctl &control, int item)
 {
-    for (size_t i=0; i<controls.size(); i++) {
-        if (controls[i].Type == "Edit") {
-            if (controls[i].Title == title) {
-                // Update the edit control
-                SetWindowTextA(controls[i].hwndControl, (LPCSTR)text.c_str());
-                controls[i].Text=text;
-            }
-        }
-    }
+	if (control.Store >= 0)
+		return g_Stores[control.Store].GetString((size_t)item);
+	if (item >= 0 && item < (int)control.Items.size())
+		return control.Items[item];
+	return "";
 }
 
-void ofxWinDialog::SetText(std::string title, std::string text) {
-	for (size_t i = 0; i < controls.size(); i++) {
-		if (controls[i].Type == "Static") {
-			if (controls[i].Title == title) {
-				SetWindowTextA(controls[i].hwndControl, (LPCSTR)text.c_str());
-				controls[i].Text = text;
-			}
-		}
-	}
+//
+// Spin control
+//
+// x, y, width, height - position and dimensions
+// min, max, - range. value - starting value
+// Style can be UDS_ALIGNLEFT or UDS_ALIGNRIGHT (default)
+//
+void ofxWinDialog::AddSpin(std::string title, int x, int y, int width, int height,
+	int min, int max, int value, DWORD dwStyle)
+{
+
+	ctl control {};
+	control.Type = "Spin";
+	control.Title = title;
+	control.Min = (float)min; // min value
+	control.Max = (float)max; // max value
+	control.Val = value; // initial value
+	control.Style = dwStyle;
+	control.X = x;
+	control.Y = y;
+	control.Width = width;
+	control.Height = height;
+	controls.push_back(control);
 }
 
-// Set the combo items of an existing combo box
-void ofxWinDialog::SetCombo(std::string title, std::vector<std::string> items, int index)
-{
-	for (size_t i = 0; i < controls.size(); i++) {
-		if (controls[i].Type == "Combo" && controls[i].Title == title) {
-			HWND hwndList = controls[i].hwndControl;
-			SendMessageA(hwndList, CB_RESETCONTENT, 0, 0L);
-			if (items.size() > 0) {
-				for (size_t i = 0; i < items.size(); i++) {
-					int pos = (int)SendMessageA(hwndList, CB_ADDSTRING, 0, (LPARAM)items[i].c_str());
-					SendMessageA(hwndList, CB_SETITEMDATA, pos, (LPARAM)i);
-				}
-				// Reset the list items
-				controls[i].Items.clear();
-				controls[i].Items = items;
-				// Highlight the current item
-				SendMessageA(hwndList, CB_SETCURSEL, (WPARAM)index, 0L);
-			}
-		}
+// Push button
+// Text in the button is independent of the title
+void ofxWinDialog::AddButton(std::string title, std::string text, int x, int y, int width, int height, DWORD dwStyle) {
+	ctl control {};
+	control.Type = "Button";
+	control.Title = title;
+	control.Text = text;
+	control.Style = dwStyle;
+    control.X=x;
+    control.Y=y;
+    control.Width=width;
+    control.Height=height;
+
+	//
+	// Custom values used in WM_DRAWITEM
+	//
+
+	// Picture button bitmap (ButtonPicture)
+	if (g_hBitmap) {
+		control.hwndType = (HWND)g_hBitmap;
+		control.Style |= BS_OWNERDRAW;
+		g_hBitmap = nullptr;
+	}
+	// Picture button atlas image (ButtonAtlas)
+	else if (g_AtlasImage >= 0) {
+		control.Atlas = g_AtlasImage;
+		control.hwndType = (HWND)g_AtlasPages[g_AtlasImages[g_AtlasImage].page].hBitmap;
+		control.Style |= BS_OWNERDRAW;
+		g_AtlasImage = -1;
 	}
-}
 
+	// Button background colour (ButtonColor)
+	// Use control Val (default 0);
+	if (g_ButtonColor != 0) {
+		control.Val = Rgb2Hex(GetRValue(g_ButtonColor),
+			GetGValue(g_ButtonColor), GetBValue(g_ButtonColor));
+		control.Style |= BS_OWNERDRAW;
+		g_ButtonColor = 0;
+	}
 
-// Set the current combo item
-void ofxWinDialog::SetComboItem(std::string title, int item)
-{
-	for (size_t i = 0; i < controls.size(); i++) {
-		if (controls[i].Type == "Combo") {
-			// Allow for user set of index for future combo reset
-			// The dialog must then be re-created
-			if (controls[i].Title == title) {
-				// Make the item current if less than the current list size
-				controls[i].Index = item;
-				if (item < (int)controls[i].Items.size())
-					SendMessage(controls[i].hwndControl, (UINT)CB_SETCURSEL, (WPARAM)item, 0L);
-			}
+	// Button text colour (TextColor)
+	// Use control index (default 0)
+	if (g_TextColor != 0) {
+		control.Index = Rgb2Hex(GetRValue(g_TextColor),
+			GetGValue(g_TextColor), GetBValue(g_TextColor));
+		control.Style |= BS_OWNERDRAW;
+		// If not a colour or image button retain the default
+		// button background to avoid text over-write in WM_DRAWITEM
+		if (control.Val == 0 && !control.hwndType) {
+			control.Val = Rgb2Hex(RGB(224, 224, 224));
 		}
+		g_TextColor = 0;
 	}
+
+    controls.push_back(control);
 }
 
-// Reset the list items
-void ofxWinDialog::SetList(std::string title, std::vector<std::string> items, int index)
-{
-	// Addlist
+// Change button size
+void ofxWinDialog::SetButton(std::string title, int width, int height) {
 	for (size_t i = 0; i < controls.size(); i++) {
-		if (controls[i].Type == "List" && controls[i].Title == title) {
-			HWND hwndList = controls[i].hwndControl;
-			SendMessageA(hwndList, LB_RESETCONTENT, 0, 0L);
-			if (items.size() > 0) {
-				for (size_t i = 0; i < items.size(); i++) {
-					int pos = (int)SendMessageA(hwndList, LB_ADDSTRING, 0, (LPARAM)items[i].c_str());
-					SendMessageA(hwndList, LB_SETITEMDATA, pos, (LPARAM)i);
+		// Update the button width and height
+		if (controls[i].Type == "Button") {
+			if (controls[i].Title == title) {
+				if (controls[i].Dpi != 0) {
+					// Scaled for the dialog DPI
+					if (width  > 0) controls[i].DesignWidth  = width;
+					if (height > 0) controls[i].DesignHeight = height;
+					controls[i].Dpi = -1;
+					g_Core.ScaleControl(i, g_Dpi);
 				}
-				// Reset the list items
-				controls[i].Items.clear();
-				controls[i].Items = items;
-				// Highlight the current item
-				SendMessageA(hwndList, LB_SETCURSEL, (WPARAM)index, 0L);
+				else {
+					if (width  > 0) controls[i].Width  = width;
+					if (height > 0) controls[i].Height = height;
+				}
+				SetWindowPos(controls[i].hwndControl, HWND_TOP,
+					controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height, SWP_NOMOVE);
+				// Change button bitmap if set by ButtonPicture
+				if (g_hBitmap != nullptr) {
+					int oldimage = controls[i].Atlas;
+					controls[i].hwndType = (HWND)g_hBitmap;
+					controls[i].Atlas = -1;
+					AtlasRelease(oldimage);
+					g_hBitmap = nullptr;
+				}
+				else if (g_AtlasImage >= 0) {
+					int oldimage = controls[i].Atlas;
+					controls[i].Atlas = g_AtlasImage;
+					controls[i].hwndType = (HWND)g_AtlasPages[g_AtlasImages[g_AtlasImage].page].hBitmap;
+					AtlasRelease(oldimage);
+					g_AtlasImage = -1;
+				}
+				// Update the control
+				RedrawWindow(controls[i].hwndControl, NULL, NULL, RDW_INVALIDATE | RDW_UPDATENOW | RDW_ERASENOW | RDW_INTERNALPAINT);
+				// Update the hover rectangle
+				UpdateHoverIndex();
 			}
 		}
 	}
 }
-
-// Set the current list item
-void ofxWinDialog::SetListItem(std::string title, int item)
-{
+	// Change button text
+// Style can be BS_TOP or BS_BOTTOM (default center)
+void ofxWinDialog::ButtonText(std::string title, std::string text, DWORD dwStyle) {
 	for (size_t i = 0; i < controls.size(); i++) {
-		if (controls[i].Type == "List") {
+		// Update the button text
+		if (controls[i].Type == "Button") {
 			if (controls[i].Title == title) {
-
-				int listsize = (int)SendMessage(controls[i].hwndControl, (UINT)LB_GETCOUNT, (WPARAM)0, 0L);
-				int current = (int)SendMessage(controls[i].hwndControl, (UINT)LB_GETCURSEL, (WPARAM)0, 0L);
-				if (item < listsize) {
-					// Make the item current
-					controls[i].Index = item;
-					SendMessage(controls[i].hwndControl, (UINT)LB_SETCURSEL, (WPARAM)item, 0L);
+				SetWindowTextA(controls[i].hwndControl, text.c_str());
+				// Set control text for owner draw
+				controls[i].Text = text;
+				controls[i].Min = (float)dwStyle; // Min is normally unused for a button
+				// Change button text colour if set by TextColor
+				if (g_TextColor != 0) {
+					controls[i].Index = Rgb2Hex(g_TextColor);
+					g_TextColor = 0;
 				}
+				// Update the control
+				RedrawWindow(controls[i].hwndControl, NULL, NULL, RDW_INVALIDATE | RDW_UPDATENOW | RDW_ERASENOW | RDW_INTERNALPAINT);
 			}
 		}
 	}
 }
 
-// Set spin control value
-void ofxWinDialog::SetSpin(std::string title, int value) {
+// Get button text
+std::string ofxWinDialog::GetButtonText(std::string title) {
 	for (size_t i = 0; i < controls.size(); i++) {
-		if (controls[i].Type == "Spin") {
+		if (controls[i].Type == "Button") {
 			if (controls[i].Title == title) {
-				controls[i].Val = value;
-				SendMessageA(controls[i].hwndControl, (UINT)UDM_SETPOS, 0, (LPARAM)controls[i].Val);
+				return controls[i].Text;
 			}
 		}
 	}
+	return "";
 }
 
-// Change button picture to image path
-void ofxWinDialog::SetButtonPicture(std::string title, std::string path) {
-
-	if (_access(path.c_str(), 0) == -1)
-		return;
+// Change button background color
+// Set before AddButton
+//     Reference :
+//     https://www.html-color-codes.info/color-names/
+//     https://www.computerhope.com/htmcolor.htm
+void ofxWinDialog::ButtonColor(int hexcode) {
+	ButtonColor(Hex2Rgb(hexcode));
+}
+void ofxWinDialog::ButtonColor(int red, int grn, int blu) {
+	ButtonColor(RGB(red, grn, blu));
+}
+void ofxWinDialog::ButtonColor(COLORREF rgb) {
+	g_ButtonColor = rgb;
+}
 
-	// Find the button
-	int index = -1;
-	for (size_t i = 0; i < controls.size(); i++) {
-		if (controls[i].Type == "Button") {
-			if (controls[i].Title == title) {
-				// Must be owner draw with a bitmap
-				if (controls[i].hwndType && controls[i].Style == BS_OWNERDRAW) {
-					index = (int)i;
-					break;
-				}
+// Image file for picture button (bmp, jpg, png, tga)
+// Call before AddButton
+// TextColor can also be used to change the button text
+void ofxWinDialog::ButtonPicture(std::string path)
+{
+	if (_access(path.c_str(), 0) != -1) {
+		// Atlas image if atlas mode is set
+		if (bAtlas) {
+			int width, height, nchannels;
+			unsigned char* imageData = LoadImagePixels(path, width, height, nchannels);
+			if (imageData) {
+				g_AtlasImage = AtlasInsert(imageData, width, height, nchannels, true, false);
+				stbi_image_free(imageData);
+				if (g_AtlasImage >= 0)
+					return;
 			}
 		}
+		// Set the global bitmap handle for AddButton and SetButton
+		g_hBitmap = CreateButtonBitmap(path);
 	}
+}
 
-	// Button not found
-	if (index < 0)
-		return;
-
-	// Bitmap for the button
-	HBITMAP hBitmap = CreateButtonBitmap(path);
-	if (!hBitmap)
-		return;
+// Button picture from image pixels
+void ofxWinDialog::ButtonPicture(unsigned char *imageData, int width, int height, int nchannels, bool bInvert, bool bSwapRG)
+{
+	// Atlas image if atlas mode is set
+	if (bAtlas) {
+		g_AtlasImage = AtlasInsert(imageData, width, height, nchannels, bInvert, bSwapRG);
+		if (g_AtlasImage >= 0)
+			return;
+	}
+	g_hBitmap = CreateButtonBitmap(imageData, width, height, nchannels, bInvert, bSwapRG);
+}
 
-	// Set the new button control handle for draw
-	controls[index].hwndType = (HWND)hBitmap;
+//
+// Picture button atlas
+//
+// Button images are packed into shared atlas pages (AtlasPacker).
+// Each page is a single DIB section that stays selected into its
+// own memory DC, so a picture button draw is one StretchBlt from
+// the image rectangle with no bitmap or DC setup.
+// Images larger than the atlas size use their own bitmap.
+//
+void ofxWinDialog::ButtonAtlas(bool bEnable, int size)
+{
+	bAtlas = bEnable;
+	// Page size applies to new pages
+	if (size > 0)
+		g_AtlasSize = size;
+}
 
+// Atlas pages, images and occupancy of all pages
+void ofxWinDialog::GetButtonAtlasStats(int &pages, int &images, double &occupancy)
+{
+	pages = (int)g_AtlasPages.size();
+	images = 0;
+	occupancy = 0.0;
+	for (size_t i = 0; i < g_AtlasPages.size(); i++) {
+		images += g_AtlasPages[i].packer.GetCount();
+		occupancy += g_AtlasPages[i].packer.GetOccupancy();
+	}
+	if (pages > 0)
+		occupancy /= (double)pages;
 }
 
-// Change button picture from image pixels
-void ofxWinDialog::SetButtonPicture(std::string title, unsigned char *imageData, int width, int height, int nchannels, bool bInvert, bool bSwapRG)
+// Copy an image into an atlas page
+// Returns the atlas image index or -1 if it does not fit
+int ofxWinDialog::AtlasInsert(unsigned char* imageData, int width, int height, int nchannels, bool bInvert, bool bSwapRG)
 {
-	// Find the button
-	int index = -1;
-	for (size_t i = 0; i < controls.size(); i++) {
-		if (controls[i].Type == "Button") {
-			if (controls[i].Title == title) {
-				// Must be owner draw with a bitmap
-				if (controls[i].hwndType && controls[i].Style == BS_OWNERDRAW) {
-					index = (int)i;
-					break;
-				}
-			}
+	if (!imageData || width > g_AtlasSize || height > g_AtlasSize)
+		return -1;
+
+	// Find space in an existing page
+	AtlasRect rect;
+	int page = -1;
+	for (size_t i = 0; i < g_AtlasPages.size(); i++) {
+		if (g_AtlasPages[i].packer.Insert(width, height, rect)) {
+			page = (int)i;
+			break;
 		}
 	}
 
-	// Button not found
-	if (index < 0) {
-		printf("ofxWinDialog::SetButtonPicture - button not found\n");
-		return;
+	// Create a new page
+	if (page < 0) {
+		atlaspage newpage;
+		newpage.hBitmap = CreateDibSection(g_AtlasSize, g_AtlasSize, &newpage.bits);
+		if (!newpage.hBitmap) {
+			printf("ofxWinDialog::AtlasInsert - could not create atlas page\n");
+			return -1;
+		}
+		newpage.pitch = DibPitch(g_AtlasSize);
+		newpage.hdcMem = CreateCompatibleDC(NULL);
+		newpage.hOldBitmap = (HBITMAP)SelectObject(newpage.hdcMem, newpage.hBitmap);
+		newpage.packer.Reset(g_AtlasSize, g_AtlasSize);
+		newpage.packer.Insert(width, height, rect);
+		g_AtlasPages.push_back(newpage);
+		page = (int)g_AtlasPages.size() - 1;
 	}
 
-	// Bitmap for the button
-	HBITMAP hBitmap = CreateButtonBitmap(imageData, width, height, nchannels, bInvert, bSwapRG);
-	if (!hBitmap) {
-		printf("ofxWinDialog::SetButtonPicture - could not create button bitmap\n");
-		return;
+	// Copy the pixels into the image rectangle
+	// The DIB is top-down, so flip the rows if the image is not inverted.
+	GdiFlush();
+	atlaspage &p = g_AtlasPages[page];
+	unsigned char* dst = p.bits + (size_t)rect.y * p.pitch + (size_t)rect.x * 3;
+	CopyPixelsToDib(dst, p.pitch, imageData, width, height, nchannels, !bInvert, bSwapRG);
+
+	// Re-use a free image entry
+	atlasimage image;
+	image.page = page;
+	image.rect = rect;
+	for (size_t i = 0; i < g_AtlasImages.size(); i++) {
+		if (g_AtlasImages[i].page < 0) {
+			g_AtlasImages[i] = image;
+			return (int)i;
+		}
 	}
+	g_AtlasImages.push_back(image);
+	return (int)g_AtlasImages.size() - 1;
+}
 
-	// Set the new button control handle for draw
-	controls[index].hwndType = (HWND)hBitmap;
+// Return the space of an atlas image
+// if it is not used by working, original or restore controls
+void ofxWinDialog::AtlasRelease(int index)
+{
+	if (index < 0 || index >= (int)g_AtlasImages.size())
+		return;
+	if (g_AtlasImages[index].page < 0)
+		return;
+
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Atlas == index) return;
+	}
+	for (size_t i = 0; i < newcontrols.size(); i++) {
+		if (newcontrols[i].Atlas == index) return;
+	}
+	for (size_t i = 0; i < oldcontrols.size(); i++) {
+		if (oldcontrols[i].Atlas == index) return;
+	}
 
+	atlasimage &image = g_AtlasImages[index];
+	g_AtlasPages[image.page].packer.Remove(image.rect);
+	image.page = -1;
 }
 
+// Button picture from bitmap
+void ofxWinDialog::ButtonPicture(HBITMAP hBitmap)
+{
+	g_hBitmap = hBitmap;
+}
 
-// Get current controls
-// This function is called from ofApp to return control values
-void ofxWinDialog::GetControls()
+// Static Group box
+// A group box is not a control and has no title
+void ofxWinDialog::AddGroup(std::string text, int x, int y, int width, int height)
+{
+    ctl control{};
+    control.Type = "Group";
+    control.Title = text;
+    control.Text = text;
+    control.X=x;
+    control.Y=y;
+    control.Width=width;
+    control.Height=height;
+
+	// Group box caption text colour (TextColor)
+	// Use control index (default 0);
+	if (g_TextColor != 0) {
+		control.Index = Rgb2Hex(GetRValue(g_TextColor),
+			GetGValue(g_TextColor), GetBValue(g_TextColor));
+		g_TextColor = 0;
+	}
+
+    controls.push_back(control);
+}
+
+//
+// Static text
+//
+// Default style left aligned (SS_LEFT)
+// Additional styles can be specified
+//	  SS_CENTER - centered
+//	  SS_RIGHT  - right aligned
+//	  WS_BORDER - outlined
+//	  SS_SUNKEN - sunken edge
+
+
+// Static text that is not a updated
+void ofxWinDialog::AddText(std::string text, int x, int y, int width, int height, DWORD dwStyle) {
+	AddText(text, text, x, y, width, height, dwStyle);
+}
+
+// Static text with an idependent title that can be updated with SetText
+// If the text is empty, the title is used for text display
+void ofxWinDialog::AddText(std::string title, std::string text, int x, int y, int width, int height, DWORD dwStyle) {
+	ctl control {};
+	control.Type = "Static";
+	control.Title = title;
+	control.Text = text;
+	control.Style = dwStyle;
+	control.X = x;
+	control.Y = y;
+	control.Width = width;
+	control.Height = height;
+
+	// Static text colour
+	// Use control index (default 0);
+	if (g_TextColor != 0) {
+		control.Index = Rgb2Hex(GetRValue(g_TextColor),
+			GetGValue(g_TextColor), GetBValue(g_TextColor));
+		g_TextColor = 0;
+	}
+
+	controls.push_back(control);
+}
+
+// Static text color
+// Set before AddText
+// Reference :
+//     https://www.html-color-codes.info/color-names/
+//     https://www.computerhope.com/htmcolor.htm
+// If setting text for a button, the background
+// also has to be specified with ButtonColor
+void ofxWinDialog::TextColor(int hexcode) {
+	TextColor(Hex2Rgb(hexcode));
+}
+void ofxWinDialog::TextColor(int red, int grn, int blu) {
+	TextColor(RGB(red, grn, blu));
+}
+void ofxWinDialog::TextColor(COLORREF rgb) {
+	g_TextColor = rgb;
+}
+
+
+// Hyperlink
+// Title is the text displayed, control text is the action taken
+// If the text is empty, ofApp is notified when the title is clicked
+void ofxWinDialog::AddHyperlink(std::string title, std::string text, int x, int y, int width, int height, DWORD dwStyle)
+{
+    ctl control{};
+    control.Type = "Static";
+    control.Title = title; // The title that appears in the dialog
+    control.Text  = text; // The action to be taken.
+    // Enable notifications for action and owner draw for text colour
+    control.Style = SS_NOTIFY | SS_OWNERDRAW | dwStyle;
+    control.Index = 1; // To identify a hyperlink from static text
+    control.X=x;
+    control.Y=y;
+    control.Width=width;
+    control.Height=height;
+    controls.push_back(control);
+}
+
+// Get checkbox state
+int ofxWinDialog::GetCheckBox(std::string title)
+{
+    int state = 0;
+    if (CallDialogThread([&] { state = GetCheckBox(title); }))
+        return state;
+    return g_Core.GetCheckBox(title);
+}
+
+// Get radio button state
+int ofxWinDialog::GetRadioButton(std::string title)
+{
+    int state = 0;
+    if (CallDialogThread([&] { state = GetRadioButton(title); }))
+        return state;
+    return g_Core.GetRadioButton(title);
+}
+
+// Get slider value
+float ofxWinDialog::GetSlider(std::string title)
+{
+    float value = 0.0f;
+    if (CallDialogThread([&] { value = GetSlider(title); }))
+        return value;
+    return g_Core.GetSlider(title);
+}
+
+// Get edit control text
+std::string ofxWinDialog::GetEdit(std::string title)
+{
+    std::string str;
+    if (CallDialogThread([&] { str = GetEdit(title); }))
+        return str;
+    // The current text of the edit control or the stored
+    // text if the window has not been created (AddPage)
+    return g_Core.GetEdit(title);
+}
+
+// Get current combo box item index and text
+int ofxWinDialog::GetComboItem(std::string title, std::string* text) {
+	int index = 0;
+	if (CallDialogThread([&] { index = GetComboItem(title, text); }))
+		return index;
+	index = g_Core.GetComboItem(title);
+	size_t i = g_Core.FindLast("Combo", title);
+	if (text && i < controls.size())
+		*text = GetListText(controls[i], index);
+	return index;
+}
+
+// Get combo box edit text
+std::string ofxWinDialog::GetComboEdit(std::string title)
+{
+	std::string str;
+	if (CallDialogThread([&] { str = GetComboEdit(title); }))
+		return str;
+	for (size_t i = g_Core.Find("Combo", title); i < controls.size(); i = g_Core.Next(i)) {
+		// Current item if the control window has not been created (AddPage)
+		if (!controls[i].hwndControl) {
+			if (controls[i].Index >= 0 && controls[i].Index < (int)controls[i].Items.size())
+				str = controls[i].Items[controls[i].Index];
+			continue;
+		}
+		char tmp[256]{};
+		int len = GetWindowTextA(controls[i].hwndControl, tmp, 256);
+		if (len > 0) str = tmp;
+	}
+	// Return the current edit text
+	return str;
+}
+
+// Get current list box item index and text
+int ofxWinDialog::GetListItem(std::string title, std::string * text) {
+	int index = 0;
+	if (CallDialogThread([&] { index = GetListItem(title, text); }))
+		return index;
+	index = g_Core.GetListItem(title);
+	size_t i = g_Core.FindLast("List", title);
+	if (text && i < controls.size())
+		*text = GetListText(controls[i], index);
+	return index;
+}
+
+
+// Set a section name for the control in an initialization file
+void ofxWinDialog::SetSection(std::string title, std::string section)
 {
-    char tmp[MAX_PATH]{};
     for (size_t i=0; i<controls.size(); i++) {
-        if (controls[i].Type    != "Static"
-            && controls[i].Type != "Group"
-            && controls[i].Type != "Button"
-            && controls[i].Type != "OK"
-            && controls[i].Type != "CANCEL") {
-			if (controls[i].Type == "Combo" || controls[i].Type == "List") {
-				// Test for empty items in the combo or list control
-				if (!controls[i].Items.empty()) {
-					DialogFunction(controls[i].Title, controls[i].Items[controls[i].Index], controls[i].Index);
-				}
-            }
-            else if (controls[i].Type == "Slider") {
-                DialogFunction(controls[i].Title, "", (int)(controls[i].SliderVal*100.0f));
-            }
-            else if (controls[i].Type == "Edit") {
-                if (m_hDialog) {
-                    GetWindowTextA(controls[i].hwndControl, (LPSTR)tmp, MAX_PATH);
-                    controls[i].Text = tmp;
-                }
-                DialogFunction(controls[i].Title, controls[i].Text, true);
-            }
-			else if (controls[i].Type == "Spin") {
-				if (m_hDialog) {
-					controls[i].Val = (int)SendMessage(controls[i].hwndControl, UDM_GETPOS, 0, 0);
-					DialogFunction(controls[i].Title, "", controls[i].Val);
-				}
-			}
-            else
-                DialogFunction(controls[i].Title, "", controls[i].Val);
+        if (controls[i].Title == title) {
+            controls[i].Section = section;
         }
     }
 }
 
-// Get the number of controls
-// Can be used to find whether controls have been created
-int ofxWinDialog::GetControlNumber()
+// Set checkbox state
+void ofxWinDialog::SetCheckBox(std::string title, int value)
 {
-    return static_cast<int>(controls.size());
+    // Queued by another thread (UseThread)
+    if (QueueCommand(EventTrace::SetCheckBox, title, "", value))
+        return;
+    if (bRecording)
+        RecordEvent(EventTrace::SetCheckBox, title, "", value);
+    // Update the checkbox state
+    g_Core.SetCheckBox(title, value);
 }
 
-// Get the dialog window handle
-HWND ofxWinDialog::GetDialogWindow() {
-	return m_hDialog;
+// Set radio button state
+// The application must set all buttons in the group
+void ofxWinDialog::SetRadioButton(std::string title, int value)
+{
+    // Queued by another thread (UseThread)
+    if (QueueCommand(EventTrace::SetRadioButton, title, "", value))
+        return;
+    if (bRecording)
+        RecordEvent(EventTrace::SetRadioButton, title, "", value);
+    // Update the Radio button state
+    g_Core.SetRadioButton(title, value);
 }
 
-// Get control handle
-HWND ofxWinDialog::GetControlWindow(std::string title) {
+// Enable or disable a control
+// Except Hyperlink and Group
+void ofxWinDialog::EnableControl(std::string title, bool bEnabled) {
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Type    != "Hyperlink"
+			&& controls[i].Type != "Group") {
+			if (controls[i].Title == title) {
+				HWND hwnd = controls[i].hwndControl;
+				EnableWindow(hwnd, (BOOL)bEnabled);
+				// Redraw immediately
+				RedrawWindow(hwnd, NULL, NULL, RDW_INVALIDATE | RDW_UPDATENOW | RDW_ERASENOW | RDW_INTERNALPAINT);
+			}
+		}
+	}
+}
+
+void ofxWinDialog::SetControlFocus(std::string title, bool bPress)
+{
 	for (size_t i = 0; i < controls.size(); i++) {
 		if (controls[i].Title == title) {
-			return controls[i].hwndControl;
+			HWND hwnd = controls[i].hwndControl;
+			SetFocus(hwnd);
+			if (bPress) {
+				// Send mouse down/up
+				PostMessage(hwnd, WM_LBUTTONDOWN, 0, 0);
+				PostMessage(hwnd, WM_LBUTTONUP, 0, 0);
+			}
 		}
 	}
-	return nullptr;
 }
 
+// Set slider value
+void ofxWinDialog::SetSlider(std::string title, float value)
+{
+    // Queued by another thread (UseThread)
+    if (QueueCommand(EventTrace::SetSlider, title, "", 0, value))
+        return;
+    if (bRecording)
+        RecordEvent(EventTrace::SetSlider, title, "", 0, value);
+    // The first slider with the title
+    // Not changed while the slider is being moved by the user
+    g_Core.SetSlider(title, value);
+}
 
-// Reset controls with orignal values
-// ofApp calls GetControls to get the updated values
-// and closes the dialog.
-void ofxWinDialog::Reset()
+void ofxWinDialog::SetEdit(std::string title, std::string text)
 {
-    // Reset controls
-	if (!newcontrols.empty()) {
-		controls = newcontrols;
-	}
-    Refresh();
+    // Queued by another thread (UseThread)
+    if (QueueCommand(EventTrace::SetEdit, title, text, 0))
+        return;
+    if (bRecording)
+        RecordEvent(EventTrace::SetEdit, title, text, 0);
+    // Update the edit control
+    g_Core.SetEdit(title, text);
 }
 
-// Restore controls with old values
-void ofxWinDialog::Restore()
+void ofxWinDialog::SetText(std::string title, std::string text) {
+	// Queued by another thread (UseThread)
+	if (QueueCommand(EventTrace::SetText, title, text, 0))
+		return;
+	if (bRecording)
+		RecordEvent(EventTrace::SetText, title, text, 0);
+	g_Core.SetText(title, text);
+}
+
+// Set the combo items of an existing combo box
+void ofxWinDialog::SetCombo(std::string title, std::vector<std::string> items, int index)
 {
-    controls = oldcontrols;
-    Refresh();
+	// Dialog thread (UseThread)
+	if (CallDialogThread([&] { SetCombo(title, items, index); }))
+		return;
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Type == "Combo" && controls[i].Title == title) {
+			// Kept dialog hidden - items are added by Open
+			if (!items.empty() && g_Core.Defer(i, ChangedItems)) {
+				controls[i].Items = items;
+				controls[i].Index = index;
+				UpdateSearch(controls[i]);
+				continue;
+			}
+			HWND hwndList = controls[i].hwndControl;
+			SendMessageA(hwndList, CB_RESETCONTENT, 0, 0L);
+			if (items.size() > 0) {
+				InsertItems(hwndList, true, items);
+				// Reset the list items
+				controls[i].Items.clear();
+				controls[i].Items = items;
+				// Highlight the current item
+				SendMessageA(hwndList, CB_SETCURSEL, (WPARAM)index, 0L);
+			}
+			UpdateSearch(controls[i]);
+		}
+	}
+}
+
+
+// Set the current combo item
+void ofxWinDialog::SetComboItem(std::string title, int item)
+{
+	// Queued by another thread (UseThread)
+	if (QueueCommand(EventTrace::SetComboItem, title, "", item))
+		return;
+	if (bRecording)
+		RecordEvent(EventTrace::SetComboItem, title, "", item);
+	// Allow for user set of index for future combo reset
+	// The dialog must then be re-created
+	// The item is made current if less than the current list size
+	g_Core.SetComboItem(title, item);
+}
+
+// Reset the list items
+void ofxWinDialog::SetList(std::string title, std::vector<std::string> items, int index)
+{
+	// Dialog thread (UseThread)
+	if (CallDialogThread([&] { SetList(title, items, index); }))
+		return;
+	// Addlist
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Type == "List" && controls[i].Title == title) {
+			HWND hwndList = controls[i].hwndControl;
+			// Virtual list - replace the item store and set the list count
+			if (controls[i].Store >= 0) {
+				ItemStore &store = g_Stores[controls[i].Store];
+				store.Clear();
+				size_t bytes = 0;
+				for (size_t j = 0; j < items.size(); j++)
+					bytes += items[j].size();
+				store.Reserve(items.size(), bytes);
+				for (size_t j = 0; j < items.size(); j++)
+					store.Append(items[j]);
+				controls[i].Index = index;
+				// Kept dialog hidden - the list is reset by Open
+				if (g_Core.Defer(i, ChangedItems)) {
+					UpdateSearch(controls[i]);
+					continue;
+				}
+				// A filtered list is reset by UpdateSearch
+				if (!IsListFiltered(controls[i])) {
+					SendMessageA(hwndList, LB_SETCOUNT, (WPARAM)items.size(), 0L);
+					SendMessageA(hwndList, LB_SETCURSEL, (WPARAM)index, 0L);
+				}
+				UpdateSearch(controls[i]);
+				continue;
+			}
+			// Kept dialog hidden - items are added by Open
+			if (IsListFiltered(controls[i]) || (!items.empty() && g_Core.Defer(i, ChangedItems))) {
+				controls[i].Items = items;
+				controls[i].Index = index;
+				UpdateSearch(controls[i]);
+				continue;
+			}
+			SendMessageA(hwndList, LB_RESETCONTENT, 0, 0L);
+			if (items.size() > 0) {
+				InsertItems(hwndList, false, items);
+				// Reset the list items
+				controls[i].Items.clear();
+				controls[i].Items = items;
+				// Highlight the current item
+				SendMessageA(hwndList, LB_SETCURSEL, (WPARAM)index, 0L);
+			}
+			UpdateSearch(controls[i]);
+		}
+	}
+}
+
+// Set the current list item
+void ofxWinDialog::SetListItem(std::string title, int item)
+{
+	// Queued by another thread (UseThread)
+	if (QueueCommand(EventTrace::SetListItem, title, "", item))
+		return;
+	if (bRecording)
+		RecordEvent(EventTrace::SetListItem, title, "", item);
+	// Row of the item if the list is filtered
+	// No selection if the item is not shown
+	g_Core.SetListItem(title, item);
+}
+
+// Set spin control value
+void ofxWinDialog::SetSpin(std::string title, int value) {
+	// Queued by another thread (UseThread)
+	if (QueueCommand(EventTrace::SetSpin, title, "", value))
+		return;
+	if (bRecording)
+		RecordEvent(EventTrace::SetSpin, title, "", value);
+	g_Core.SetSpin(title, value);
+}
+
+// Change button picture to image path
+void ofxWinDialog::SetButtonPicture(std::string title, std::string path) {
+
+	if (_access(path.c_str(), 0) == -1)
+		return;
+
+	// Find the button
+	int index = -1;
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Type == "Button") {
+			if (controls[i].Title == title) {
+				// Must be owner draw with a bitmap
+				if (controls[i].hwndType && controls[i].Style == BS_OWNERDRAW) {
+					index = (int)i;
+					break;
+				}
+			}
+		}
+	}
+
+	// Button not found
+	if (index < 0)
+		return;
+
+	// Atlas picture button - replace the atlas image
+	if (controls[index].Atlas >= 0) {
+		int width, height, nchannels;
+		unsigned char* imageData = LoadImagePixels(path, width, height, nchannels);
+		if (!imageData)
+			return;
+		SetAtlasPicture(index, imageData, width, height, nchannels, true, false);
+		stbi_image_free(imageData);
+		return;
+	}
+
+	// Bitmap for the button
+	HBITMAP hBitmap = CreateButtonBitmap(path);
+	if (!hBitmap)
+		return;
+
+	// Set the new button control handle for draw
+	// and release the previous bitmap
+	HBITMAP hOldBitmap = (HBITMAP)controls[index].hwndType;
+	controls[index].hwndType = (HWND)hBitmap;
+	ReleaseButtonBitmap(hOldBitmap);
+	InvalidateRect(controls[index].hwndControl, NULL, FALSE);
+
+}
+
+// Change button picture from image pixels
+void ofxWinDialog::SetButtonPicture(std::string title, unsigned char *imageData, int width, int height, int nchannels, bool bInvert, bool bSwapRG)
+{
+	// Find the button
+	int index = -1;
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Type == "Button") {
+			if (controls[i].Title == title) {
+				// Must be owner draw with a bitmap
+				if (controls[i].hwndType && controls[i].Style == BS_OWNERDRAW) {
+					index = (int)i;
+					break;
+				}
+			}
+		}
+	}
+
+	// Button not found
+	if (index < 0) {
+		printf("ofxWinDialog::SetButtonPicture - button not found\n");
+		return;
+	}
+
+	// Atlas picture button - replace the atlas image
+	if (controls[index].Atlas >= 0) {
+		SetAtlasPicture(index, imageData, width, height, nchannels, bInvert, bSwapRG);
+		return;
+	}
+
+	// Bitmap for the button
+	HBITMAP hBitmap = CreateButtonBitmap(imageData, width, height, nchannels, bInvert, bSwapRG);
+	if (!hBitmap) {
+		printf("ofxWinDialog::SetButtonPicture - could not create button bitmap\n");
+		return;
+	}
+
+	// Set the new button control handle for draw
+	// and release the previous bitmap
+	HBITMAP hOldBitmap = (HBITMAP)controls[index].hwndType;
+	controls[index].hwndType = (HWND)hBitmap;
+	ReleaseButtonBitmap(hOldBitmap);
+	InvalidateRect(controls[index].hwndControl, NULL, FALSE);
+
+}
+
+// Replace the atlas image of a picture button
+// The image is copied in place if the size is unchanged
+void ofxWinDialog::SetAtlasPicture(int index, unsigned char* imageData, int width, int height, int nchannels, bool bInvert, bool bSwapRG)
+{
+	int oldimage = controls[index].Atlas;
+	atlasimage &image = g_AtlasImages[oldimage];
+
+	// Same size and not shared with Reset or Restore controls
+	bool bShared = false;
+	for (size_t i = 0; i < newcontrols.size(); i++) {
+		if (newcontrols[i].Atlas == oldimage) bShared = true;
+	}
+	for (size_t i = 0; i < oldcontrols.size(); i++) {
+		if (oldcontrols[i].Atlas == oldimage) bShared = true;
+	}
+	if (!bShared && image.rect.width == width && image.rect.height == height) {
+		GdiFlush();
+		atlaspage &p = g_AtlasPages[image.page];
+		unsigned char* dst = p.bits + (size_t)image.rect.y * p.pitch + (size_t)image.rect.x * 3;
+		CopyPixelsToDib(dst, p.pitch, imageData, width, height, nchannels, !bInvert, bSwapRG);
+	}
+	else {
+		int newimage = AtlasInsert(imageData, width, height, nchannels, bInvert, bSwapRG);
+		if (newimage >= 0) {
+			controls[index].Atlas = newimage;
+			controls[index].hwndType = (HWND)g_AtlasPages[g_AtlasImages[newimage].page].hBitmap;
+		}
+		else {
+			// Too large for the atlas
+			HBITMAP hBitmap = CreateButtonBitmap(imageData, width, height, nchannels, bInvert, bSwapRG);
+			if (!hBitmap)
+				return;
+			controls[index].Atlas = -1;
+			controls[index].hwndType = (HWND)hBitmap;
+		}
+		AtlasRelease(oldimage);
+	}
+	InvalidateRect(controls[index].hwndControl, NULL, FALSE);
+}
+
+//
+// Streaming picture button
+//
+// Two DIB sections are created once for the button. Each frame is
+// copied into the back buffer in place, the buffers are swapped
+// and only the button is invalidated. There is no allocation per
+// frame unless the frame size changes.
+//
+bool ofxWinDialog::ButtonStream(std::string title, int width, int height)
+{
+	// Find the picture button
+	int index = -1;
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Type == "Button" && controls[i].Title == title) {
+			// Must be owner draw with a bitmap
+			if (controls[i].hwndType && (controls[i].Style & BS_OWNERDRAW) == BS_OWNERDRAW) {
+				index = (int)i;
+				break;
+			}
+		}
+	}
+
+	if (index < 0) {
+		printf("ofxWinDialog::ButtonStream - picture button not found\n");
+		return false;
+	}
+
+	// Find or insert with one lock so that two threads
+	// cannot each insert a stream for the same button
+	std::shared_ptr<buttonstream> stream;
+	{
+		std::lock_guard<std::mutex> lock(g_StreamMutex);
+		std::shared_ptr<buttonstream> &s = g_Streams[title];
+		if (!s)
+			s = std::make_shared<buttonstream>();
+		stream = s;
+	}
+	std::lock_guard<std::mutex> lock(stream->writemutex);
+	stream->hwndControl = controls[index].hwndControl;
+	return AllocateButtonStream(*stream, width, height);
+}
+
+// Stream of a picture button or nullptr
+std::shared_ptr<ofxWinDialog::buttonstream> ofxWinDialog::FindButtonStream(const std::string &title)
+{
+	std::lock_guard<std::mutex> lock(g_StreamMutex);
+	auto it = g_Streams.find(title);
+	if (it == g_Streams.end())
+		return nullptr;
+	return it->second;
+}
+
+// Copy a new frame to the stream and redraw the button
+bool ofxWinDialog::UpdateButtonStream(std::string title, unsigned char* imageData,
+	int width, int height, int nchannels, bool bInvert, bool bSwapRG)
+{
+	if (!imageData)
+		return false;
+	std::shared_ptr<buttonstream> ref = FindButtonStream(title);
+	if (!ref)
+		return false;
+
+	buttonstream &stream = *ref;
+	std::lock_guard<std::mutex> lock(stream.writemutex);
+	// Closed while waiting for the lock
+	if (stream.bClosed)
+		return false;
+
+	auto start = std::chrono::steady_clock::now();
+
+	// Re-allocate only if the frame size changes
+	if (width != stream.width || height != stream.height) {
+		if (!AllocateButtonStream(stream, width, height))
+			return false;
+	}
+
+	// Make sure GDI has finished with the surface
+	GdiFlush();
+
+	// Copy to the back buffer in place
+	// The DIB is top-down, so flip the rows if the image is not inverted
+	int back = 1 - stream.front;
+	if (!CopyPixelsToDib(stream.bits[back], stream.pitch, imageData,
+		width, height, nchannels, !bInvert, bSwapRG))
+		return false;
+
+	// Swap buffers
+	{
+		std::lock_guard<std::mutex> drawlock(stream.drawmutex);
+		stream.front = back;
+	}
+
+	// Frame time
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	stream.stats.frames++;
+	stream.stats.lastms = ms;
+	stream.stats.avgms += (ms - stream.stats.avgms) / (double)stream.stats.frames;
+	if (ms > stream.stats.maxms) stream.stats.maxms = ms;
+
+	// Redraw only the button
+	// InvalidateRect can be called from any thread
+	if (stream.hwndControl)
+		InvalidateRect(stream.hwndControl, NULL, FALSE);
+
+	return true;
+}
+
+// Release the stream surfaces
+// The button returns to the picture set by ButtonPicture or SetButtonPicture
+void ofxWinDialog::CloseButtonStream(std::string title)
+{
+	// Removed from the map first so that no new writer finds it.
+	// A writer that already has the stream sees bClosed.
+	std::shared_ptr<buttonstream> stream;
+	{
+		std::lock_guard<std::mutex> lock(g_StreamMutex);
+		auto it = g_Streams.find(title);
+		if (it == g_Streams.end())
+			return;
+		stream = it->second;
+		g_Streams.erase(it);
+	}
+	HWND hwnd = NULL;
+	{
+		std::lock_guard<std::mutex> lock(stream->writemutex);
+		std::lock_guard<std::mutex> drawlock(stream->drawmutex);
+		for (int i = 0; i < 2; i++) {
+			if (stream->hBitmap[i]) DeleteObject(stream->hBitmap[i]);
+			stream->hBitmap[i] = nullptr;
+		}
+		stream->bClosed = true;
+		hwnd = stream->hwndControl;
+	}
+	if (hwnd) InvalidateRect(hwnd, NULL, FALSE);
+}
+
+// Frame time and allocation statistics
+bool ofxWinDialog::GetButtonStreamStats(std::string title, streamstats &stats)
+{
+	std::shared_ptr<buttonstream> stream = FindButtonStream(title);
+	if (!stream)
+		return false;
+	std::lock_guard<std::mutex> lock(stream->writemutex);
+	stats = stream->stats;
+	return true;
+}
+
+// Allocate both stream surfaces
+// The caller holds the write lock
+bool ofxWinDialog::AllocateButtonStream(buttonstream &stream, int width, int height)
+{
+	unsigned char* bits[2]{};
+	HBITMAP hBitmap[2]{};
+	hBitmap[0] = CreateDibSection(width, height, &bits[0]);
+	hBitmap[1] = CreateDibSection(width, height, &bits[1]);
+	if (!hBitmap[0] || !hBitmap[1]) {
+		if (hBitmap[0]) DeleteObject(hBitmap[0]);
+		if (hBitmap[1]) DeleteObject(hBitmap[1]);
+		printf("ofxWinDialog::ButtonStream - could not create surfaces\n");
+		return false;
+	}
+
+	// Replace the existing surfaces
+	std::lock_guard<std::mutex> drawlock(stream.drawmutex);
+	for (int i = 0; i < 2; i++) {
+		if (stream.hBitmap[i]) DeleteObject(stream.hBitmap[i]);
+		stream.hBitmap[i] = hBitmap[i];
+		stream.bits[i] = bits[i];
+	}
+	stream.width = width;
+	stream.height = height;
+	stream.pitch = DibPitch(width);
+	stream.front = 0;
+	stream.stats.allocations++;
+
+	return true;
+}
+
+
+// Get current controls
+// This function is called from ofApp to return control values
+void ofxWinDialog::GetControls()
+{
+    // Dialog thread (UseThread)
+    if (CallDialogThread([&] { GetControls(); }))
+        return;
+    // Values of controls except static text, group and push buttons
+    // The edit control text and spin control position are read from
+    // the windows while the dialog is open.
+    g_Core.GetControls([this](const std::string &title, const std::string &text, int value) {
+        DialogFunction(title, text, value);
+    });
+}
+
+// Get the number of controls
+// Can be used to find whether controls have been created
+int ofxWinDialog::GetControlNumber()
+{
+    return static_cast<int>(controls.size());
+}
+
+// Get the dialog window handle
+HWND ofxWinDialog::GetDialogWindow() {
+	return m_hDialog;
+}
+
+// Get control handle
+HWND ofxWinDialog::GetControlWindow(std::string title) {
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Title == title) {
+			return controls[i].hwndControl;
+		}
+	}
+	return nullptr;
+}
+
+
+// Owner draw button rectangles for hover hit test
+// and subclass for mouse leave
+void ofxWinDialog::UpdateHoverIndex()
+{
+	g_Hover.Clear();
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Type == "Button"
+			&& controls[i].Index != 1 // not a hyperlink
+			&& (controls[i].Style & BS_OWNERDRAW) == BS_OWNERDRAW
+			&& controls[i].hwndControl) {
+			g_Hover.Add((int)i, controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height);
+			SetWindowSubclass(controls[i].hwndControl, ButtonHoverProc, (UINT_PTR)i, (DWORD_PTR)this);
+		}
+	}
+}
+
+// The mouse has left an owner draw button
+void ofxWinDialog::HoverLeave(int index)
+{
+	int left = -1;
+	if (g_Hover.Leave(index, left) && left >= 0 && left < (int)controls.size())
+		InvalidateRect(controls[left].hwndControl, NULL, FALSE);
+}
+
+// Reset controls with orignal values
+// ofApp calls GetControls to get the updated values
+// and closes the dialog.
+void ofxWinDialog::Reset()
+{
+    // Dialog thread (UseThread)
+    if (CallDialogThread([&] { Reset(); }))
+        return;
+    // Reset controls
+	if (!newcontrols.empty()) {
+		controls = newcontrols;
+		g_Core.Reindex();
+	}
+	g_Core.UserChanged();
+    Refresh();
+}
+
+// Restore controls with old values
+void ofxWinDialog::Restore()
+{
+    // Dialog thread (UseThread)
+    if (CallDialogThread([&] { Restore(); }))
+        return;
+    controls = oldcontrols;
+    g_Core.Reindex();
+	g_Core.UserChanged();
+    Refresh();
+}
+
+// Refresh the dialog controls with new values
+void ofxWinDialog::Refresh()
+{
+    // Dialog thread (UseThread)
+    if (CallDialogThread([&] { Refresh(); }))
+        return;
+    TraceScope span(g_TraceLog, "Refresh", "dialog");
+    g_Core.Refresh();
+}
+
+// Save controls to an initialization file
+void ofxWinDialog::Save(std::string filename, bool bOverWrite)
+{
+    // Dialog thread (UseThread)
+    if (CallDialogThread([&] { Save(filename, bOverWrite); }))
+        return;
+    TraceScope span(g_TraceLog, "Save", "file", filename.c_str());
+    char tmp[MAX_PATH]{};
+    std::string inipath;
+
+	// If no filename, create ini file from exe path
+	if (filename.empty()) {
+		inipath = GetExePath(true);
+		// Strip ".exe" and replace with ".ini"
+		inipath = inipath.substr(0, inipath.rfind(".")) + ".ini";
+	}
+	else {
+
+		// Check extension
+		size_t pos = filename.rfind(".ini");
+		if (pos == std::string::npos) {
+			// No extension or not ".ini"
+			pos = filename.rfind(".");
+			if (pos == std::string::npos) {
+				// No extension - add ".ini"
+				filename = filename + ".ini";
+			} else {
+				// Extension not "ini"
+				// Strip extension
+				filename = filename.substr(0, pos);
+				// Add ".ini"
+				filename = filename + ".ini";
+			}
+		}
+
+		// Check for full path
+		if (filename.find('/') != std::string::npos || filename.find('\\') != std::string::npos) {
+			inipath = filename;
+		}
+		else {
+			// filename only - add full path - (bin\data or executable directory)
+			std::string path = GetExePath();
+			// First try the bin\data folder
+			inipath = path;
+			inipath += "\\data\\";
+			// Does the folder exist ?
+			if (_access(inipath.c_str(), 0) != -1) {
+				// Openframeworks application
+				inipath += filename;
+			}
+			else {
+				// Executable folder
+				inipath = path;
+				inipath += "\\";
+				inipath += filename;
+			}
+		}
+	}
+
+    // Check if file exists if bOverWrite is false
+    if (!bOverWrite && _access(inipath.c_str(), 0) != -1) {
+        sprintf_s(tmp, MAX_PATH, "%s\nexists - overwrite?", inipath.c_str());
+        if(MessageBoxA(NULL, tmp, "Warning", MB_YESNO | MB_TOPMOST) == IDNO)
+            return;
+    }
+
+    // Save control values (IniValue)
+    // A control section name is used if assigned using SetSection
+    // Default section name is the control type
+    g_Core.Save(inipath);
+
+}
+
+// Load controls from an initialization file
+// ofApp calls GetControls to get the updated values
+bool ofxWinDialog::Load(std::string filename, std::string section)
+{
+    // Dialog thread (UseThread)
+    bool bLoaded = false;
+    if (CallDialogThread([&] { bLoaded = Load(filename, section); }))
+        return bLoaded;
+    TraceScope span(g_TraceLog, "Load", "file", filename.c_str());
+    std::string inipath="";
+
+	// If no filename, create ini file from exe path
+	if (filename.empty()) {
+		inipath = GetExePath(true);
+		// Strip ".exe" and replace with ".ini"
+		inipath = inipath.substr(0, inipath.rfind(".")) + ".ini";
+	}
+	else {
+		// Check extension
+		size_t pos = filename.rfind(".ini");
+		if (pos == std::string::npos) {
+			// No extension or not ".ini"
+			pos = filename.rfind(".");
+			if (pos == std::string::npos) {
+				// No extension - add ".ini"
+				filename = filename + ".ini";
+			} else {
+				// Extension not "ini"
+				printf("ofxWinDialog::Load\n%s is not an initialization file\n", filename.c_str());
+				return false;
+			}
+		}
+		// Check for full path
+		if (filename.find('/') != std::string::npos || filename.find('\\') != std::string::npos) {
+			inipath = filename;
+		}
+		else {
+			// filename only - add full path - (bin\data or executable directory)
+			std::string path = GetExePath();
+			// First try the bin\data folder
+			inipath = path;
+			inipath += "\\data\\";
+			// Does the folder exist ?
+			if (_access(inipath.c_str(), 0) != -1) {
+				// Openframeworks application
+				inipath += filename;
+			} else {
+				// Executable folder
+				inipath = path;
+				inipath += "\\";
+				inipath += filename;
+			}
+		}
+	}
+
+    // Check that the file exists in case an extension was added
+    if (_access(inipath.c_str(), 0) == -1) {
+        printf("ofxWinDialog::Load\nInitialization file \"%s\" not found.", inipath.c_str());
+        return false;
+    }
+
+	// Set newcontrols first if Load is before Open
+    // hwnd and ID are not yet set
+	newcontrols = controls;
+
+    // Load control values
+    // Only those saved in the ini file are changed
+    // Use the section name argument if specified
+    // Use the control section name if assigned by SetSection
+    // Default section name is the control type
+    // The dialog is refreshed with the new controls
+    g_Core.Load(inipath, section);
+
+    return true;
+
+}
+
+// Time the dialog hot paths with the controls of the dialog
+// Results are printed and written to "jsonfile" if specified.
+// Returns false if a scenario is slower than the baseline.
+bool ofxWinDialog::Benchmark(std::string jsonfile, std::string baseline, int runs, double tolerance)
+{
+	BenchResults results;
+
+	// Control lookup by type and title
+	results.Run("lookup", runs, controls.size(), [this]() {
+		for (size_t i = 0; i < controls.size(); i++)
+			g_Core.Find(controls[i].Type, controls[i].Title);
+	});
+
+	// Slider set with the current value
+	std::vector<std::string> sliders;
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Type == "Slider")
+			sliders.push_back(controls[i].Title);
+	}
+	if (!sliders.empty()) {
+		results.Run("slider", runs, sliders.size(), [this, &sliders]() {
+			for (size_t i = 0; i < sliders.size(); i++)
+				SetSlider(sliders[i], GetSlider(sliders[i]));
+		});
+	}
+
+	// Values of all controls to the ofApp callback
+	results.Run("getcontrols", runs, controls.size(), [this]() { GetControls(); });
+
+	// Save and Load of all values with a temporary file
+	// Load replaces the controls used by Reset
+	char temp[MAX_PATH]{};
+	if (GetTempPathA(MAX_PATH, temp) > 0) {
+		std::string inipath = std::string(temp) + "ofxWinDialogBench.ini";
+		std::vector<ctl> resetcontrols = newcontrols;
+		results.Run("save", runs, controls.size(), [this, &inipath]() { Save(inipath, true); });
+		results.Run("load", runs, controls.size(), [this, &inipath]() { Load(inipath); });
+		newcontrols = resetcontrols;
+		DeleteFileA(inipath.c_str());
+	}
+
+	if (m_hDialog) {
+		// Control windows from the control values (preset recall)
+		results.Run("refresh", runs, controls.size(), [this]() { Refresh(); });
+
+		// Combo and list population with the current items
+		// Virtual and filtered lists are not populated from items
+		std::vector<size_t> lists;
+		size_t items = 0;
+		for (size_t i = 0; i < controls.size(); i++) {
+			if ((controls[i].Type == "Combo" || (controls[i].Type == "List" && controls[i].Store < 0))
+				&& controls[i].hwndControl && !controls[i].Items.empty() && !IsListFiltered(controls[i])) {
+				lists.push_back(i);
+				items += controls[i].Items.size();
+			}
+		}
+		if (!lists.empty()) {
+			results.Run("items", runs, items, [this, &lists]() {
+				for (size_t k = 0; k < lists.size(); k++) {
+					ctl &c = controls[lists[k]];
+					bool bCombo = c.Type == "Combo";
+					SendMessage(c.hwndControl, bCombo ? CB_RESETCONTENT : LB_RESETCONTENT, 0, 0L);
+					InsertItems(c.hwndControl, bCombo, c.Items);
+					SendMessage(c.hwndControl, bCombo ? CB_SETCURSEL : LB_SETCURSEL, (WPARAM)c.Index, 0L);
+				}
+			});
+		}
+
+		// Bulk loading of 10k, 100k and 1M UTF-8 items (LoadList)
+		// into a hidden list box that is destroyed afterwards
+		HWND hwndBulk = CreateWindowExA(0, "LISTBOX", "", WS_CHILD | LBS_NOINTEGRALHEIGHT,
+			0, 0, 100, 100, m_hDialog, NULL, m_hInstance, NULL);
+		if (hwndBulk) {
+			const size_t counts[3] = { 10000, 100000, 1000000 };
+			const char* names[3] = { "bulk10k", "bulk100k", "bulk1m" };
+			for (int k = 0; k < 3; k++) {
+				std::vector<std::string> bulk(counts[k]);
+				for (size_t j = 0; j < bulk.size(); j++)
+					bulk[j] = "Item " + std::to_string(j);
+				std::string data;
+				std::vector<size_t> offsets;
+				BuildItemBatch(bulk, data, offsets);
+				// Fewer runs for the larger batches
+				int bulkruns = k == 0 ? runs : (runs < 3 ? runs : 3);
+				results.Run(names[k], bulkruns, bulk.size(), [this, hwndBulk, &data, &offsets, &bulk]() {
+					SendMessage(hwndBulk, LB_RESETCONTENT, 0, 0L);
+					InsertItems(hwndBulk, false, data.data(), offsets.data(), bulk.size(), nullptr, true);
+				});
+			}
+			DestroyWindow(hwndBulk);
+		}
+	}
+
+	// Shared parameter change passed to 64 bound controls
+	{
+		ParamStore store;
+		int id = store.Add("fanout", ParamStore::Float);
+		size_t changes = 0;
+		int subscriber = store.Subscribe([&changes](const std::vector<ParamStore::change> &c) { changes += c.size(); });
+		for (int b = 0; b < 64; b++)
+			store.Bind(id, subscriber, b);
+		double value = 0.0;
+		results.Run("params", runs, 100 * 64, [&store, id, &value]() {
+			for (int k = 0; k < 100; k++)
+				store.SetNumber(id, value += 1.0);
+		});
+	}
+
+	// OSC slider message written and read
+	{
+		OscMessage msg;
+		msg.address = OscAddress("", "Line width");
+		msg.AddFloat(0.5f);
+		std::vector<uint8_t> packet;
+		std::vector<OscMessage> messages;
+		results.Run("osc", runs, 100, [&msg, &packet, &messages]() {
+			for (int k = 0; k < 100; k++) {
+				OscPacket::Encode(msg, packet);
+				messages.clear();
+				OscPacket::Decode(packet.data(), packet.size(), messages);
+			}
+		});
+	}
+
+	// Picture button pixel copy of a 256 x 256 RGBA image
+	{
+		const int size = 256;
+		std::vector<unsigned char> image((size_t)size * size * 4, 128);
+		std::vector<unsigned char> dib((size_t)DibPitch(size) * size);
+		results.Run("pixels", runs, 1, [&image, &dib, size]() {
+			CopyPixelsToDib(dib.data(), DibPitch(size), image.data(), size, size, 4, true, false);
+		});
+	}
+
+	// Results
+	printf("ofxWinDialog::Benchmark - %d controls, %d runs\n", (int)controls.size(), runs);
+	for (size_t i = 0; i < results.Size(); i++) {
+		const BenchResults::result &r = results.GetResults()[i];
+		printf("  %-12s median %9.4f  p95 %9.4f  min %9.4f msec  (%d ops)\n",
+			r.name.c_str(), r.median, r.p95, r.min, (int)r.ops);
+	}
+
+	if (!jsonfile.empty()) {
+		std::string json = results.ToJson();
+		std::ofstream out(jsonfile.c_str(), std::ios::binary | std::ios::trunc);
+		if (!out || !out.write(json.data(), (std::streamsize)json.size()))
+			printf("ofxWinDialog::Benchmark - could not write \"%s\"\n", jsonfile.c_str());
+	}
+
+	// Compare with the baseline
+	if (baseline.empty())
+		return true;
+	std::ifstream in(baseline.c_str(), std::ios::binary);
+	std::stringstream buffer;
+	if (in)
+		buffer << in.rdbuf();
+	BenchResults base;
+	if (!in || !base.ParseJson(buffer.str())) {
+		printf("ofxWinDialog::Benchmark - baseline \"%s\" not read\n", baseline.c_str());
+		return false;
+	}
+	std::vector<BenchResults::comparison> changes;
+	size_t slower = results.Compare(base, tolerance, changes);
+	for (size_t i = 0; i < changes.size(); i++) {
+		printf("  %-12s %+6.1f%%%s\n", changes[i].name.c_str(), changes[i].change * 100.0,
+			changes[i].change > tolerance ? "  SLOWER" : "");
+	}
+	if (slower > 0)
+		printf("ofxWinDialog::Benchmark - %d scenarios slower than the baseline\n", (int)slower);
+	return slower == 0;
+}
+
+//
+// Shared parameters (BindParameter)
+//
+// A bound control is a binding of the dialog to an entry of the
+// process-wide ParamStore, with the binding number as the tag. A
+// change by the user reaches the store by DialogFunction, or EN_CHANGE
+// for an edit control, and is passed to the other bound controls of
+// all dialogs. The store calls ParamsChanged once for the changes of
+// a pass, by the thread that changed the store. The controls are set
+// with the Set functions by the thread that owns the dialog : the
+// dialog thread (UseThread), the window thread while the dialog is
+// open, or the thread that created the dialog while it is closed.
+// Other threads queue the changes and post WM_DIALOG_PARAMS for the
+// first change of a batch. Changes queued while the dialog is closed
+// are applied by the next Open or PollEvents. The bindings are locked
+// because BindParameter can be called while the owning thread applies
+// changes. A control set from the store does not set the store again
+// because the value is not changed.
+//
+
+// Bind a control to a shared parameter
+bool ofxWinDialog::BindParameter(std::string title, std::string key)
+{
+	if (key.empty())
+		key = title;
+
+	// The first control with the title that has a value
+	size_t i = 0;
+	for (; i < controls.size(); i++) {
+		const std::string &type = controls[i].Type;
+		if (controls[i].Title == title
+			&& (type == "Checkbox" || type == "Radio" || type == "Slider" || type == "Spin"
+				|| type == "Combo" || type == "List" || type == "Edit" || type == "Static"))
+			break;
+	}
+	if (i >= controls.size()) {
+		printf("ofxWinDialog::BindParameter - control \"%s\" not found\n", title.c_str());
+		return false;
+	}
+
+	// Entry created with the value of the control if new
+	ParamStore &store = ParamStore::Global();
+	const ctl &control = controls[i];
+	ParamStore::Type type = ParamStore::Int;
+	if (control.Type == "Slider")
+		type = ParamStore::Float;
+	else if (control.Type == "Edit" || control.Type == "Static")
+		type = ParamStore::Text;
+	bool bCreated = false;
+	int id = store.Add(key, type, ControlNumber(control), control.Text, &bCreated);
+	if (id < 0) {
+		printf("ofxWinDialog::BindParameter - parameter store is full\n");
+		return false;
+	}
+
+	if (g_ParamSubscriber < 0) {
+		g_ParamSubscriber = store.Subscribe([this](const std::vector<ParamStore::change> &changes) {
+			ParamsChanged(changes);
+		});
+	}
+
+	parambinding b;
+	b.title = title;
+	b.type = control.Type;
+	b.param = id;
+	{
+		std::lock_guard<std::mutex> lock(g_ParamMutex);
+		b.binding = store.Bind(id, g_ParamSubscriber, (int)g_ParamBindings.size());
+		g_ParamBindings.push_back(b);
+	}
+	bParams = true;
+
+	// The store can be changed by any thread
+	bQueueSet = true;
+
+	// The control takes the value of an existing entry
+	if (!bCreated)
+		ApplyParameter(b, store.GetNumber(id), store.GetText(id));
+	return true;
+}
+
+// Remove the bindings of a control
+void ofxWinDialog::UnbindParameter(std::string title)
+{
+	std::lock_guard<std::mutex> lock(g_ParamMutex);
+	for (size_t k = 0; k < g_ParamBindings.size(); k++) {
+		if (g_ParamBindings[k].title == title && g_ParamBindings[k].param >= 0) {
+			ParamStore::Global().Unbind(g_ParamBindings[k].binding);
+			g_ParamBindings[k].param = -1;
+		}
+	}
+}
+
+// Number value of a control for the store
+double ofxWinDialog::ControlNumber(const ctl &control)
+{
+	if (control.Type == "Slider")
+		return (double)control.SliderVal;
+	if (control.Type == "Combo" || control.Type == "List")
+		return (double)control.Index;
+	if (control.Type == "Edit" || control.Type == "Static")
+		return atof(control.Text.c_str());
+	return (double)control.Val;
+}
+
+// Pass the value of a control changed by the user to the store
+void ofxWinDialog::PublishParameters(const std::string &title)
+{
+	// The store is not changed with the bindings locked
+	// because it can call ParamsChanged
+	std::vector<parambinding> bindings;
+	{
+		std::lock_guard<std::mutex> lock(g_ParamMutex);
+		for (size_t k = 0; k < g_ParamBindings.size(); k++) {
+			if (g_ParamBindings[k].param >= 0 && g_ParamBindings[k].title == title)
+				bindings.push_back(g_ParamBindings[k]);
+		}
+	}
+	ParamStore &store = ParamStore::Global();
+	for (size_t k = 0; k < bindings.size(); k++) {
+		const parambinding &b = bindings[k];
+		for (size_t i = g_Core.Find(b.type, title); i < controls.size(); i = g_Core.Next(i)) {
+			if (b.type == "Edit" || b.type == "Static")
+				store.SetText(b.param, controls[i].Text, b.binding);
+			else
+				store.SetNumber(b.param, ControlNumber(controls[i]), b.binding);
+			break;
+		}
+	}
+}
+
+// Set a bound control from the store
+void ofxWinDialog::ApplyParameter(const parambinding &b, double number, const std::string &text)
+{
+	if (b.type == "Checkbox")
+		SetCheckBox(b.title, (int)number);
+	else if (b.type == "Radio")
+		SetRadioButton(b.title, (int)number);
+	else if (b.type == "Slider")
+		SetSlider(b.title, (float)number);
+	else if (b.type == "Spin")
+		SetSpin(b.title, (int)number);
+	else if (b.type == "Combo")
+		SetComboItem(b.title, (int)number);
+	else if (b.type == "List")
+		SetListItem(b.title, (int)number);
+	else if (b.type == "Edit")
+		SetEdit(b.title, text);
+	else if (b.type == "Static")
+		SetText(b.title, text);
+}
+
+// Thread that sets the controls from the store
+DWORD ofxWinDialog::ParamThread()
+{
+	DWORD id = g_DialogThreadId.load();
+	if (id == 0)
+		id = g_WindowThreadId.load();
+	if (id == 0)
+		id = m_HookThread; // The thread that created the dialog
+	return id;
+}
+
+// Changes of a pass of the parameter store
+void ofxWinDialog::ParamsChanged(const std::vector<ParamStore::change> &changes)
+{
+	// Queued for the owning thread, whether the dialog is open or not
+	if (GetCurrentThreadId() != ParamThread()) {
+		bool bFirst = false;
+		for (size_t k = 0; k < changes.size(); k++) {
+			if (g_ParamQueue.Push(changes[k]))
+				bFirst = true;
+		}
+		// Wake the window thread for the first change of a batch
+		HWND hwnd = g_hwndThread.load();
+		if (bFirst && hwnd)
+			PostMessage(hwnd, WM_DIALOG_PARAMS, 0, 0);
+		return;
+	}
+	// Changes queued before these are applied first
+	for (size_t k = 0; k < changes.size(); k++)
+		g_ParamQueue.Push(changes[k]);
+	ApplyParams();
+}
+
+// Apply the queued changes of the parameter store (owning thread)
+void ofxWinDialog::ApplyParams()
+{
+	if (g_ParamQueue.Drain(g_ParamBatch) == 0)
+		return;
+
+	// Only the last value of each binding is applied
+	g_ParamCollapse.Apply(g_ParamBatch, [](const ParamStore::change &c) {
+		return std::to_string(c.tag);
+	});
+
+	// Bindings of the changes
+	// Set functions are not called with the bindings locked
+	// because they can change the store (PublishParameters)
+	std::vector<parambinding> bindings;
+	{
+		std::lock_guard<std::mutex> lock(g_ParamMutex);
+		for (size_t k = 0; k < g_ParamBatch.size(); k++) {
+			size_t tag = (size_t)g_ParamBatch[k].tag;
+			if (tag < g_ParamBindings.size() && g_ParamBindings[tag].param == g_ParamBatch[k].id)
+				bindings.push_back(g_ParamBindings[tag]);
+			else
+				bindings.push_back(parambinding());
+		}
+	}
+
+	// The dialog is drawn once for the changes
+	// WM_SETREDRAW would show a hidden window (KeepAlive)
+	bool bRedraw = g_ParamBatch.size() > 1 && m_hDialog && IsWindowVisible(m_hDialog);
+	if (bRedraw)
+		SendMessage(m_hDialog, WM_SETREDRAW, FALSE, 0L);
+	for (size_t k = 0; k < g_ParamBatch.size(); k++) {
+		if (bindings[k].param >= 0)
+			ApplyParameter(bindings[k], g_ParamBatch[k].number, g_ParamBatch[k].text);
+	}
+	if (bRedraw) {
+		SendMessage(m_hDialog, WM_SETREDRAW, TRUE, 0L);
+		RedrawWindow(m_hDialog, NULL, NULL, RDW_ERASE | RDW_INVALIDATE | RDW_ALLCHILDREN);
+	}
+}
+
+//
+// OSC control surface (StartOsc)
+//
+// The OSC thread reads packets from a UDP socket and passes the
+// messages to the window thread with a CommandQueue, which has no
+// locks. The thread posts WM_DIALOG_OSC for the first message after
+// the queue has been read, so the window thread is woken once for the
+// messages received while it was busy. ApplyOsc keeps only the last
+// message for each address and sets the controls with one redraw.
+// Outgoing messages are sent by the window thread with the same socket.
+//
+
+// Socket of the OSC bridge
+struct ofxWinDialog::oscsocket {
+	SOCKET s = INVALID_SOCKET;
+	sockaddr_in target{}; // Send address
+};
+
+// Start the OSC bridge
+bool ofxWinDialog::StartOsc(int port, std::string host, int sendport, int interval, std::string prefix)
+{
+	bool bStarted = false;
+	if (CallDialogThread([&] { bStarted = StartOsc(port, host, sendport, interval, prefix); }))
+		return bStarted;
+
+	StopOsc();
+
+	WSADATA wsa{};
+	if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
+		printf("ofxWinDialog::StartOsc - Winsock not available\n");
+		return false;
+	}
+
+	SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (s == INVALID_SOCKET) {
+		printf("ofxWinDialog::StartOsc - could not create a socket\n");
+		WSACleanup();
+		return false;
+	}
+
+	// Port 0 is any free port for sending only
+	sockaddr_in local{};
+	local.sin_family = AF_INET;
+	local.sin_addr.s_addr = htonl(INADDR_ANY);
+	local.sin_port = htons((u_short)(port > 0 ? port : 0));
+	if (bind(s, (sockaddr*)&local, sizeof(local)) == SOCKET_ERROR) {
+		printf("ofxWinDialog::StartOsc - could not receive on port %d\n", port);
+		closesocket(s);
+		WSACleanup();
+		return false;
+	}
+
+	std::unique_ptr<oscsocket> osc(new oscsocket);
+	osc->s = s;
+	bOscSend = false;
+	if (!host.empty() && sendport > 0) {
+		osc->target.sin_family = AF_INET;
+		osc->target.sin_port = htons((u_short)sendport);
+		if (inet_pton(AF_INET, host.c_str(), &osc->target.sin_addr) != 1) {
+			printf("ofxWinDialog::StartOsc - \"%s\" is not an IP address\n", host.c_str());
+			closesocket(s);
+			WSACleanup();
+			return false;
+		}
+		bOscSend = true;
+	}
+
+	g_Osc = std::move(osc);
+	g_OscPrefix = prefix;
+	g_OscTitles.clear();
+	g_OscLimit.Clear();
+	g_OscLimit.SetInterval(interval > 0 ? (uint64_t)interval : 0);
+	if (port > 0)
+		g_OscThread = std::thread(&ofxWinDialog::OscThread, this, g_Osc.get());
+	return true;
+}
+
+// Stop the OSC bridge
+void ofxWinDialog::StopOsc()
+{
+	if (CallDialogThread([&] { StopOsc(); }))
+		return;
+	if (!g_Osc)
+		return;
+	// Closing the socket ends the wait of the OSC thread
+	closesocket(g_Osc->s);
+	if (g_OscThread.joinable())
+		g_OscThread.join();
+	bOscSend = false;
+	g_Osc.reset();
+	if (bOscTimer && m_hDialog)
+		KillTimer(m_hDialog, IDT_DIALOG_OSC);
+	bOscTimer = false;
+	g_OscLimit.Clear();
+	// Messages not yet applied
+	g_OscIn.Drain(g_OscBatch);
+	g_OscBatch.clear();
+	WSACleanup();
+}
+
+// OSC thread
+void ofxWinDialog::OscThread(oscsocket* osc)
+{
+	SOCKET s = osc->s;
+	std::vector<uint8_t> packet(65536);
+	std::vector<OscMessage> messages;
+	bool bPosted = true;
+	for (;;) {
+		int size = recv(s, (char*)packet.data(), (int)packet.size(), 0);
+		if (size == SOCKET_ERROR) {
+			// A message sent to a closed port is reported
+			// by the next receive (WSAECONNRESET)
+			int error = WSAGetLastError();
+			if (error == WSAECONNRESET || error == WSAEMSGSIZE)
+				continue;
+			break; // Closed by StopOsc
+		}
+		messages.clear();
+		if (OscPacket::Decode(packet.data(), (size_t)size, messages) == 0)
+			continue;
+		bool bFirst = false;
+		for (size_t k = 0; k < messages.size(); k++) {
+			if (g_OscIn.Push(std::move(messages[k])))
+				bFirst = true;
+		}
+		// Wake the window thread once for each batch. If the window
+		// has not been created, Open posts the message.
+		if (bFirst || !bPosted) {
+			HWND hwnd = g_hwndThread.load();
+			bPosted = hwnd && PostMessage(hwnd, WM_DIALOG_OSC, 0, 0);
+		}
+	}
+}
+
+// Apply the messages received by the OSC thread
+void ofxWinDialog::ApplyOsc()
+{
+	if (g_OscIn.Drain(g_OscBatch) == 0)
+		return;
+
+	// Only the last value received for a control is applied
+	g_OscCollapse.Apply(g_OscBatch, [](const OscMessage &msg) { return msg.address; });
+
+	// Control titles by address, made again if controls are added
+	if (g_OscTitles.empty() || g_OscControls != controls.size()) {
+		g_OscTitles.clear();
+		for (size_t i = 0; i < controls.size(); i++)
+			g_OscTitles.emplace(OscAddress(g_OscPrefix, controls[i].Title), controls[i].Title);
+		g_OscControls = controls.size();
+	}
+
+	// The dialog is drawn once for the batch
+	// WM_SETREDRAW would show a hidden window (KeepAlive)
+	bool bRedraw = g_OscBatch.size() > 1 && m_hDialog && IsWindowVisible(m_hDialog);
+	if (bRedraw)
+		SendMessage(m_hDialog, WM_SETREDRAW, FALSE, 0L);
+	// Received values are not sent back
+	bOscApplying = true;
+	for (size_t k = 0; k < g_OscBatch.size(); k++)
+		ApplyOscMessage(g_OscBatch[k]);
+	bOscApplying = false;
+	if (bRedraw) {
+		SendMessage(m_hDialog, WM_SETREDRAW, TRUE, 0L);
+		RedrawWindow(m_hDialog, NULL, NULL, RDW_ERASE | RDW_INVALIDATE | RDW_ALLCHILDREN);
+	}
+}
+
+// Set a control and inform ofApp as if changed by the user
+// ofApp is not informed if the Set function did not change the control
+void ofxWinDialog::ApplyOscMessage(const OscMessage &msg)
+{
+	auto it = g_OscTitles.find(msg.address);
+	if (it == g_OscTitles.end())
+		return;
+	const std::string title = it->second;
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Title != title)
+			continue;
+		const std::string &type = controls[i].Type;
+		if (type == "Checkbox") {
+			SetCheckBox(title, msg.Int());
+			DialogFunction(title, "", controls[i].Val);
+		}
+		else if (type == "Radio") {
+			SetRadioButton(title, msg.Int());
+			DialogFunction(title, "", controls[i].Val);
+		}
+		else if (type == "Slider") {
+			// SetSlider does not change a slider the user is dragging
+			if (g_Core.IsDragging())
+				return;
+			SetSlider(title, msg.Float());
+			DialogFunction(title, "", (int)(controls[i].SliderVal*100.0f));
+		}
+		else if (type == "Spin") {
+			SetSpin(title, msg.Int());
+			DialogFunction(title, "", controls[i].Val);
+		}
+		else if (type == "Combo" || type == "List") {
+			if (type == "Combo")
+				SetComboItem(title, msg.Int());
+			else
+				SetListItem(title, msg.Int());
+			int index = controls[i].Index;
+			// SetListItem does not select an item that is not in the list
+			if (type == "List" && index != msg.Int())
+				return;
+			if (type == "List" && controls[i].Store >= 0)
+				DialogFunction(title, GetListText(controls[i], index), index);
+			else if (index >= 0 && index < (int)controls[i].Items.size())
+				DialogFunction(title, controls[i].Items[index], index);
+		}
+		else if (type == "Edit") {
+			SetEdit(title, msg.Text());
+			DialogFunction(title, controls[i].Text, true);
+		}
+		else if (type == "Button") {
+			DialogFunction(title, title, 0);
+		}
+		else
+			continue;
+		return;
+	}
+}
+
+// Send the value of a slider or checkbox
+void ofxWinDialog::SendOsc(const std::string &title)
+{
+	OscMessage msg;
+	size_t i = g_Core.Find("Slider", title);
+	if (i < controls.size()) {
+		msg.AddFloat(controls[i].SliderVal);
+	}
+	else {
+		i = g_Core.Find("Checkbox", title);
+		if (i >= controls.size())
+			return;
+		msg.AddInt(controls[i].Val);
+	}
+	msg.address = OscAddress(g_OscPrefix, title);
+
+	if (g_OscLimit.Offer(msg, GetTickCount64())) {
+		SendOscMessage(msg);
+	}
+	else if (!bOscTimer && m_hDialog) {
+		// Sent by FlushOsc when the interval has passed
+		UINT interval = (UINT)g_OscLimit.GetInterval();
+		bOscTimer = SetTimer(m_hDialog, IDT_DIALOG_OSC, interval > 0 ? interval : 1, NULL) != 0;
+	}
+}
+
+// Send the messages whose interval has passed
+void ofxWinDialog::FlushOsc()
+{
+	g_OscLimit.Due(GetTickCount64(), g_OscDue);
+	for (size_t k = 0; k < g_OscDue.size(); k++)
+		SendOscMessage(g_OscDue[k]);
+	if (g_OscLimit.Pending() == 0 && bOscTimer) {
+		KillTimer(m_hDialog, IDT_DIALOG_OSC);
+		bOscTimer = false;
+	}
+}
+
+void ofxWinDialog::SendOscMessage(const OscMessage &msg)
+{
+	OscPacket::Encode(msg, g_OscPacket);
+	sendto(g_Osc->s, (const char*)g_OscPacket.data(), (int)g_OscPacket.size(), 0,
+		(const sockaddr*)&g_Osc->target, sizeof(g_Osc->target));
+}
+
+// Start recording control events and Set functions
+// Events recorded before are discarded
+void ofxWinDialog::StartRecording()
+{
+	g_Trace.Clear();
+	g_RecordStart = std::chrono::steady_clock::now();
+	bRecording = true;
+}
+
+// Stop recording and write the trace file
+bool ofxWinDialog::StopRecording(std::string filename)
+{
+	if (!bRecording)
+		return false;
+	bRecording = false;
+
+	std::string path = GetFilePath(filename, ".trace");
+	std::string bytes;
+	g_Trace.Write(bytes);
+	std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+	if (!out || !out.write(bytes.data(), (std::streamsize)bytes.size())) {
+		printf("ofxWinDialog::StopRecording - could not write \"%s\"\n", path.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool ofxWinDialog::IsRecording()
+{
+	return bRecording;
+}
+
+// Add an event to the trace
+void ofxWinDialog::RecordEvent(int op, const std::string &title, const std::string &text, int value, float fvalue)
+{
+	uint64_t time = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - g_RecordStart).count();
+	g_Trace.Add(time, op, title, text, value, fvalue);
+}
+
+// Replay a trace file
+int ofxWinDialog::Replay(std::string filename, double speed)
+{
+	std::string path = GetFilePath(filename, ".trace");
+	std::ifstream in(path.c_str(), std::ios::binary);
+	std::stringstream buffer;
+	if (in)
+		buffer << in.rdbuf();
+	EventTrace trace;
+	if (!in || !trace.Read(buffer.str())) {
+		printf("ofxWinDialog::Replay - \"%s\" is not a trace file\n", path.c_str());
+		return -1;
+	}
+
+	// Replayed events are not recorded again
+	bRecording = false;
+
+	// A replay that is still running ends
+	if (bReplayTimer && m_hDialog)
+		KillTimer(m_hDialog, IDT_DIALOG_REPLAY);
+	bReplayTimer = false;
+
+	size_t count = trace.Size();
+	g_ReplayStart = std::chrono::steady_clock::now();
+	g_ReplayTrace = std::move(trace);
+	g_ReplayNext = 0;
+	g_ReplayDue = 0;
+	g_ReplaySpeed = speed;
+
+	// At the recorded speed the replay timer applies the events as
+	// they become due, so that the dialog is drawn between them
+	if (speed > 0.0 && m_hDialog)
+		bReplayTimer = SetTimer(m_hDialog, IDT_DIALOG_REPLAY, 1, NULL) != 0;
+	if (!bReplayTimer) {
+		// As fast as possible
+		g_ReplaySpeed = 0.0;
+		ReplayDue();
+	}
+	return (int)count;
+}
+
+// Apply the events of the replay that are due
+// Events are applied in the order recorded by the dialog core,
+// so that a replay is the same sequence whatever the speed.
+void ofxWinDialog::ReplayDue()
+{
+	uint64_t elapsed = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - g_ReplayStart).count();
+	while (g_ReplayNext < g_ReplayTrace.Size()) {
+		uint64_t delay = g_ReplayTrace.NextDelay(g_ReplayNext, g_ReplaySpeed);
+		if (g_ReplayDue + delay > elapsed)
+			return; // Next timer message
+		g_ReplayDue += delay;
+		ReplayEvent(g_ReplayTrace.GetEvents()[g_ReplayNext++]);
+	}
+
+	// All events replayed
+	if (bReplayTimer && m_hDialog)
+		KillTimer(m_hDialog, IDT_DIALOG_REPLAY);
+	bReplayTimer = false;
+	g_ReplayTrace.Clear();
+	g_ReplayTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - g_ReplayStart).count();
+}
+
+double ofxWinDialog::GetReplayTime()
+{
+	return g_ReplayTime;
+}
+
+// Apply one recorded event (DialogCore::Apply)
+void ofxWinDialog::ReplayEvent(const EventTrace::event &e)
+{
+	// Set functions queued by another thread are recorded as they are applied
+	if (bRecording && e.op != EventTrace::Event)
+		RecordEvent(e.op, e.title, e.text, e.value, e.fvalue);
+	g_Core.Apply(e, [this](const std::string &title, const std::string &text, int value) {
+		DialogFunction(title, text, value);
+	});
+}
+
+// Start writing spans of dialog activity to a Chrome trace file
+// StartTrace again writes a new file
+bool ofxWinDialog::StartTrace(std::string filename, size_t capacity)
+{
+	StopTrace();
+	std::string path = GetFilePath(filename, ".json");
+	g_TraceFile.open(path.c_str(), std::ios::binary | std::ios::trunc);
+	if (!g_TraceFile) {
+		printf("ofxWinDialog::StartTrace - could not write \"%s\"\n", path.c_str());
+		return false;
+	}
+	g_TraceFile << "[\n";
+	bTraceFirst = true;
+	g_TraceLog.Start(capacity);
+	bTraceRun = true;
+	g_TraceThread = std::thread(&ofxWinDialog::TraceThread, this);
+	return true;
+}
+
+// Stop the trace and complete the file
+void ofxWinDialog::StopTrace()
+{
+	g_TraceLog.Stop();
+	if (g_TraceThread.joinable()) {
+		bTraceRun = false;
+		g_TraceThread.join();
+	}
+	if (g_TraceFile.is_open()) {
+		FlushTrace();
+		g_TraceFile << "\n]\n";
+		g_TraceFile.close();
+	}
+}
+
+bool ofxWinDialog::IsTracing()
+{
+	return g_TraceLog.IsEnabled();
+}
+
+// Spans dropped because a buffer was full
+uint64_t ofxWinDialog::GetTraceDropped()
+{
+	return g_TraceLog.Dropped();
 }
 
-// Refresh the dialog controls with new values
-void ofxWinDialog::Refresh()
+// Write the buffered spans every 100 msec
+void ofxWinDialog::TraceThread()
 {
-    for (size_t i=0; i<controls.size(); i++) {
-        if (controls[i].Type == "Checkbox" || controls[i].Type == "Radio") {
-            if (controls[i].Val == 1) {
-                SendMessage(controls[i].hwndControl, BM_SETCHECK, BST_CHECKED, 0);
-            }
-            else {
-                SendMessage(controls[i].hwndControl, BM_SETCHECK, BST_UNCHECKED, 0);
-            }
-        }
-        if (controls[i].Type == "Slider") {
-            if ((controls[i].Max - controls[i].Min) > 1000.0)
-                SendMessage(controls[i].hwndControl, TBM_SETPOS, TRUE, (int)controls[i].SliderVal);
-            else
-                SendMessage(controls[i].hwndControl, TBM_SETPOS, TRUE, (int)(controls[i].SliderVal*100.0f));
-            // Slider value text display
-            if (controls[i].hwndSliderVal) {
-                char tmp[8]{};
-                if (controls[i].Max >= 100.0f)
-                    sprintf_s(tmp, 8, "%.0f", controls[i].SliderVal);
-                else if (controls[i].Max >= 10.0f)
-                    sprintf_s(tmp, 8, "%.1f", controls[i].SliderVal);
-                else
-                    sprintf_s(tmp, 8, "%.2f", controls[i].SliderVal);
-                SetWindowTextA(controls[i].hwndSliderVal, (LPCSTR)tmp);
-            }
-        }
-        if (controls[i].Type == "Combo") {
-            if (!controls[i].Text.empty()) {
-                // Delete the existing item text
-                SendMessage(controls[i].hwndControl, CB_DELETESTRING, controls[i].Index, 0);
-                // Add the new item text
-                SendMessage(controls[i].hwndControl, CB_INSERTSTRING, controls[i].Index, (LPARAM)controls[i].Text.c_str());
-            }
-            // Make the new item current
-            SendMessage(controls[i].hwndControl, (UINT)CB_SETCURSEL, (WPARAM)controls[i].Index, 0L);
-            // Select all text in the edit field
-            SendMessage(controls[i].hwndControl, CB_SETEDITSEL, 0, MAKELONG(0, -1));
-        }
-
-		if (controls[i].Type == "List") {
-			if (!controls[i].Text.empty()) {
-				// Delete the existing item text
-				SendMessage(controls[i].hwndControl, LB_DELETESTRING, controls[i].Index, 0);
-				// Add the new item text
-				SendMessage(controls[i].hwndControl, LB_INSERTSTRING, controls[i].Index, (LPARAM)controls[i].Text.c_str());
-			}
-			// Make the new item current
-			SendMessage(controls[i].hwndControl, (UINT)LB_SETCURSEL, (WPARAM)controls[i].Index, 0L);
-		}
-        if (controls[i].Type == "Edit") {
-            SetWindowTextA(controls[i].hwndControl, (LPCSTR)controls[i].Text.c_str());
-        }
-		if (controls[i].Type == "Spin") {
-			SendMessageA(controls[i].hwndControl, (UINT)UDM_SETPOS, 0, (LPARAM)controls[i].Val);
-		}
-     }
+	while (bTraceRun) {
+		for (int i = 0; i < 10 && bTraceRun; i++)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		FlushTrace();
+	}
 }
 
-// Save controls to an initialization file
-void ofxWinDialog::Save(std::string filename, bool bOverWrite)
+// Write the buffered spans to the trace file
+void ofxWinDialog::FlushTrace()
 {
-    char tmp[MAX_PATH]{};
-    std::string inipath;
+	std::vector<TraceEvent> events;
+	if (g_TraceLog.Drain(events) == 0)
+		return;
+	std::string json;
+	for (size_t i = 0; i < events.size(); i++) {
+		TraceLog::AppendJson(json, events[i], bTraceFirst);
+		bTraceFirst = false;
+	}
+	g_TraceFile.write(json.data(), (std::streamsize)json.size());
+	g_TraceFile.flush();
+}
 
-    // Section for the control in the initialization file
-    std::string ControlSection;
+// Load initialization file to a string
+std::string ofxWinDialog::LoadFile(std::string filename)
+{
+	char tmp[MAX_PATH]{};
+	std::string inipath = "";
 
 	// If no filename, create ini file from exe path
 	if (filename.empty()) {
@@ -1423,24 +3709,6 @@ void ofxWinDialog::Save(std::string filename, bool bOverWrite)
 		inipath = inipath.substr(0, inipath.rfind(".")) + ".ini";
 	}
 	else {
-
-		// Check extension
-		size_t pos = filename.rfind(".ini");
-		if (pos == std::string::npos) {
-			// No extension or not ".ini"
-			pos = filename.rfind(".");
-			if (pos == std::string::npos) {
-				// No extension - add ".ini"
-				filename = filename + ".ini";
-			} else {
-				// Extension not "ini"
-				// Strip extension
-				filename = filename.substr(0, pos);
-				// Add ".ini"
-				filename = filename + ".ini";
-			}
-		}
-
 		// Check for full path
 		if (filename.find('/') != std::string::npos || filename.find('\\') != std::string::npos) {
 			inipath = filename;
@@ -1455,8 +3723,7 @@ void ofxWinDialog::Save(std::string filename, bool bOverWrite)
 			if (_access(inipath.c_str(), 0) != -1) {
 				// Openframeworks application
 				inipath += filename;
-			}
-			else {
+			} else {
 				// Executable folder
 				inipath = path;
 				inipath += "\\";
@@ -1465,230 +3732,746 @@ void ofxWinDialog::Save(std::string filename, bool bOverWrite)
 		}
 	}
 
-    // Check if file exists if bOverWrite is false
-    if (!bOverWrite && _access(inipath.c_str(), 0) != -1) {
-        sprintf_s(tmp, MAX_PATH, "%s\nexists - overwrite?", inipath.c_str());
-        if(MessageBoxA(NULL, tmp, "Warning", MB_YESNO | MB_TOPMOST) == IDNO)
-            return;
-    }
+	// Check that the file exists in case an extension was added
+	if (_access(inipath.c_str(), 0) == -1) {
+		printf("ofxWinDialog::LoadFile - file \"%s\" not found.", inipath.c_str());
+		return "";
+	}
 
-    // Save control values
-    for (size_t i=0; i<controls.size(); i++) {
-        if (controls[i].Type    != "Static"
-            && controls[i].Type != "Group"
-            && controls[i].Type != "Button"
-            && controls[i].Type != "OK"
-            && controls[i].Type != "CANCEL") {
-            
-            // A control section name is used if assigned using SetSection
-            // Default section name is the control type
-            ControlSection = controls[i].Type;
-            if (!controls[i].Section.empty()) ControlSection = controls[i].Section;
-
-            if (controls[i].Type == "Combo" || controls[i].Type == "List") {
-                sprintf_s(tmp, MAX_PATH, "%d", controls[i].Index);
-                WritePrivateProfileStringA((LPCSTR)ControlSection.c_str(), (LPCSTR)controls[i].Title.c_str(), (LPCSTR)tmp, (LPCSTR)inipath.c_str());
-            }
-            else if (controls[i].Type == "Edit") {
-                WritePrivateProfileStringA((LPCSTR)ControlSection.c_str(), (LPCSTR)controls[i].Title.c_str(), (LPCSTR)controls[i].Text.c_str(), (LPCSTR)inipath.c_str());
-            }
-			else if (controls[i].Type == "Spin") {
-				sprintf_s(tmp, MAX_PATH, "%d", controls[i].Val);
-				WritePrivateProfileStringA((LPCSTR)ControlSection.c_str(), (LPCSTR)controls[i].Title.c_str(), (LPCSTR)tmp, (LPCSTR)inipath.c_str());
-			}
-            else if (controls[i].Type == "Slider") {
-                sprintf_s(tmp, MAX_PATH, "%.2f", controls[i].SliderVal);
-                WritePrivateProfileStringA((LPCSTR)ControlSection.c_str(), (LPCSTR)controls[i].Title.c_str(), (LPCSTR)tmp, (LPCSTR)inipath.c_str());
-            }
-            else {
-				sprintf_s(tmp, MAX_PATH, "%d", controls[i].Val);
-				WritePrivateProfileStringA((LPCSTR)ControlSection.c_str(), (LPCSTR)controls[i].Title.c_str(), (LPCSTR)tmp, (LPCSTR)inipath.c_str());
-            }
-        }
-    }
+	// Open the file for reading
+	std::ifstream file(inipath.c_str());
+	if (!file) {
+		printf("ofxWinDialog::LoadFile - Error opening file\n");
+		return "";
+	}
+
+	// stringstream buffer
+	std::stringstream buffer;
+
+	// Read the entire file into the stringstream
+	buffer << file.rdbuf();
+
+	// Return the contents as a string
+	return buffer.str();
 
 }
 
-// Load controls from an initialization file
-// ofApp calls GetControls to get the updated values
-bool ofxWinDialog::Load(std::string filename, std::string section)
+//
+// Dialog description
+//
+// One statement on each line (ofxWinDialogDescription.h).
+// Arguments are in the order of the Add functions. Optional
+// arguments are shown in brackets.
+//
+//   position    x y width height
+//   font        "name" height [weight]
+//   background  colour
+//   resizeable
+//   textcolor   colour
+//   buttoncolor colour
+//   slidermode  once (1 or 0)
+//   section     "name" - section of the following controls, none for default
+//   page        "name"
+//   endpage
+//   row         [spacing]
+//   column      [spacing]
+//   grid        columns [spacing]
+//   pair        [spacing]
+//   endlayout
+//   stretch     horizontal [vertical] - control or box added last
+//   radiogroup
+//   checkbox    "title" "text" x y width height checked [style]
+//   radio       "title" "text" x y width height checked [style]
+//   button      "title" "text" x y width height [style]
+//   slider      "title" x y width height min max value [show] [tick]
+//   edit        "title" x y width height "text" [style]
+//   combo       "title" x y width height items index [style]
+//   list        "title" x y width height items index
+//   virtuallist "title" x y width height items index
+//   spin        "title" x y width height min max value [style]
+//   group       "text" x y width height
+//   text        ["title"] "text" x y width height [style]
+//   hyperlink   "title" "text" x y width height [style]
+//
+// Items are a list - [ "One" "Two" "Three" ]
+// Colours are hex - #FF8000 or 0xFF8000
+// Styles are a number or style names joined by "|" - SS_CENTER|WS_BORDER
+//
+
+// Load a dialog description file
+// The file is found as for LoadFile
+bool ofxWinDialog::LoadDialog(std::string filename)
 {
-    char tmp[MAX_PATH]{};
-    std::string inipath="";
+	std::string description = LoadFile(filename);
+	if (description.empty()) {
+		g_ParseError = "File not found or empty";
+		g_ParseTime = 0.0;
+		return false;
+	}
+	return ParseDialog(description);
+}
 
-    // Section for the control in the initialization file
-    std::string ControlSection="";
+// Add the controls of a dialog description
+bool ofxWinDialog::ParseDialog(const std::string &description)
+{
+	auto start = std::chrono::steady_clock::now();
 
-	// If no filename, create ini file from exe path
-	if (filename.empty()) {
-		inipath = GetExePath(true);
-		// Strip ".exe" and replace with ".ini"
-		inipath = inipath.substr(0, inipath.rfind(".")) + ".ini";
+	// Section of the controls added
+	std::string section;
+	DescriptionParser parser;
+	bool bOk = parser.Parse(description, [this, &section](DescStatement &st) {
+		return DescriptionStatement(st, section);
+	});
+
+	g_ParseError = bOk ? "" : parser.GetError();
+	if (!bOk)
+		printf("ofxWinDialog::ParseDialog - %s\n", g_ParseError.c_str());
+
+	g_ParseTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return bOk;
+}
+
+// Error message of the last LoadDialog or ParseDialog
+std::string ofxWinDialog::GetParseError()
+{
+	return g_ParseError;
+}
+
+// Time taken by the last LoadDialog or ParseDialog (msec)
+double ofxWinDialog::GetParseTime()
+{
+	return g_ParseTime;
+}
+
+// Apply one statement of a dialog description
+// All arguments are read before the statement is applied
+bool ofxWinDialog::DescriptionStatement(DescStatement &st, std::string &section)
+{
+	const DescToken &key = st.Keyword();
+	std::string title;
+	std::string text;
+	std::vector<std::string> items;
+	int x = 0;
+	int y = 0;
+	int width = 0;
+	int height = 0;
+	DWORD dwStyle = 0;
+	size_t first = controls.size();
+
+	// Position and size
+	auto rect = [&]() {
+		return st.Int(x) && st.Int(y) && st.Int(width) && st.Int(height);
+	};
+	// Optional style
+	auto style = [&]() {
+		return !st.More() || DescriptionStyle(st, dwStyle);
+	};
+
+	//
+	// Dialog
+	//
+	if (key.Is("position")) {
+		if (!(rect() && st.End())) return false;
+		SetPosition(x, y, width, height);
 	}
-	else {
-		// Check extension
-		size_t pos = filename.rfind(".ini");
-		if (pos == std::string::npos) {
-			// No extension or not ".ini"
-			pos = filename.rfind(".");
-			if (pos == std::string::npos) {
-				// No extension - add ".ini"
-				filename = filename + ".ini";
-			} else {
-				// Extension not "ini"
-				printf("ofxWinDialog::Load\n%s is not an initialization file\n", filename.c_str());
-				return false;
-			}
-		}
-		// Check for full path
-		if (filename.find('/') != std::string::npos || filename.find('\\') != std::string::npos) {
-			inipath = filename;
+	else if (key.Is("font")) {
+		int weight = FW_NORMAL;
+		if (!(st.Text(text) && st.Int(height))) return false;
+		if (st.More() && !st.Int(weight)) return false;
+		if (!st.End()) return false;
+		SetFont(text, height, weight);
+	}
+	else if (key.Is("background") || key.Is("textcolor") || key.Is("buttoncolor")) {
+		int hexcode = 0;
+		if (!(st.Int(hexcode) && st.End())) return false;
+		if (key.Is("background"))
+			BackGroundColor(hexcode);
+		else if (key.Is("textcolor"))
+			TextColor(hexcode);
+		else
+			ButtonColor(hexcode);
+	}
+	else if (key.Is("resizeable")) {
+		if (!st.End()) return false;
+		Resizeable();
+	}
+	else if (key.Is("slidermode")) {
+		int once = 0;
+		if (!(st.Int(once) && st.End())) return false;
+		SliderMode(once != 0);
+	}
+	else if (key.Is("section")) {
+		section.clear();
+		if (st.More() && !st.Text(section)) return false;
+		if (!st.End()) return false;
+	}
+	else if (key.Is("page")) {
+		if (!(st.Text(text) && st.End())) return false;
+		AddPage(text);
+	}
+	else if (key.Is("endpage")) {
+		if (!st.End()) return false;
+		EndPage();
+	}
+	else if (key.Is("row") || key.Is("column") || key.Is("pair")) {
+		int spacing = 4;
+		if (st.More() && !st.Int(spacing)) return false;
+		if (!st.End()) return false;
+		if (key.Is("row"))
+			LayoutRow(spacing);
+		else if (key.Is("column"))
+			LayoutColumn(spacing);
+		else
+			LayoutPair(spacing);
+	}
+	else if (key.Is("grid")) {
+		int columns = 1;
+		int spacing = 4;
+		if (!st.Int(columns)) return false;
+		if (st.More() && !st.Int(spacing)) return false;
+		if (!st.End()) return false;
+		LayoutGrid(columns, spacing);
+	}
+	else if (key.Is("endlayout")) {
+		if (!st.End()) return false;
+		LayoutEnd();
+	}
+	else if (key.Is("stretch")) {
+		float horizontal = 0.0f;
+		float vertical = 0.0f;
+		if (!st.Float(horizontal)) return false;
+		if (st.More() && !st.Float(vertical)) return false;
+		if (!st.End()) return false;
+		LayoutStretch(horizontal, vertical);
+	}
+
+	//
+	// Controls
+	//
+	else if (key.Is("radiogroup")) {
+		if (!st.End()) return false;
+		AddRadioGroup();
+	}
+	else if (key.Is("checkbox") || key.Is("radio")) {
+		int checked = 0;
+		if (!(st.Text(title) && st.Text(text) && rect() && st.Int(checked) && style() && st.End())) return false;
+		if (key.Is("checkbox"))
+			AddCheckBox(title, text, x, y, width, height, checked != 0, dwStyle);
+		else
+			AddRadioButton(title, text, x, y, width, height, checked != 0, dwStyle);
+	}
+	else if (key.Is("button")) {
+		if (!(st.Text(title) && st.Text(text) && rect() && style() && st.End())) return false;
+		AddButton(title, text, x, y, width, height, dwStyle);
+	}
+	else if (key.Is("slider")) {
+		float min = 0.0f;
+		float max = 0.0f;
+		float value = 0.0f;
+		int show = 1;
+		float tick = 0.0f;
+		if (!(st.Text(title) && rect() && st.Float(min) && st.Float(max) && st.Float(value))) return false;
+		if (st.More() && !st.Int(show)) return false;
+		if (st.More() && !st.Float(tick)) return false;
+		if (!st.End()) return false;
+		AddSlider(title, x, y, width, height, min, max, value, show != 0, tick);
+	}
+	else if (key.Is("edit")) {
+		if (!(st.Text(title) && rect() && st.Text(text) && style() && st.End())) return false;
+		AddEdit(title, x, y, width, height, text, dwStyle);
+	}
+	else if (key.Is("combo") || key.Is("list") || key.Is("virtuallist")) {
+		int index = 0;
+		if (!(st.Text(title) && rect() && st.Items(items) && st.Int(index))) return false;
+		if (key.Is("combo") && !style()) return false;
+		if (!st.End()) return false;
+		if (key.Is("combo"))
+			AddCombo(title, x, y, width, height, items, index, dwStyle);
+		else if (key.Is("list"))
+			AddList(title, x, y, width, height, items, index);
+		else
+			AddVirtualList(title, x, y, width, height, items, index);
+	}
+	else if (key.Is("spin")) {
+		int min = 0;
+		int max = 0;
+		int value = 0;
+		if (!(st.Text(title) && rect() && st.Int(min) && st.Int(max) && st.Int(value) && style() && st.End())) return false;
+		AddSpin(title, x, y, width, height, min, max, value, dwStyle);
+	}
+	else if (key.Is("group")) {
+		if (!(st.Text(text) && rect() && st.End())) return false;
+		AddGroup(text, x, y, width, height);
+	}
+	else if (key.Is("text")) {
+		// Text with an optional title
+		if (!st.Text(text)) return false;
+		if (!st.IsNumber()) {
+			title = text;
+			if (!st.Text(text)) return false;
 		}
-		else {
-			// filename only - add full path - (bin\data or executable directory)
-			std::string path = GetExePath();
-			// First try the bin\data folder
-			inipath = path;
-			inipath += "\\data\\";
-			// Does the folder exist ?
-			if (_access(inipath.c_str(), 0) != -1) {
-				// Openframeworks application
-				inipath += filename;
-			} else {
-				// Executable folder
-				inipath = path;
-				inipath += "\\";
-				inipath += filename;
+		if (!(rect() && style() && st.End())) return false;
+		if (title.empty())
+			AddText(text, x, y, width, height, dwStyle);
+		else
+			AddText(title, text, x, y, width, height, dwStyle);
+	}
+	else if (key.Is("hyperlink")) {
+		if (!(st.Text(title) && st.Text(text) && rect() && style() && st.End())) return false;
+		AddHyperlink(title, text, x, y, width, height, dwStyle);
+	}
+	else {
+		return st.Error("unknown statement \"" + key.String() + "\"");
+	}
+
+	// Section for the initialization file
+	if (!section.empty()) {
+		for (size_t i = first; i < controls.size(); i++)
+			controls[i].Section = section;
+	}
+	return true;
+}
+
+// Style number or style names joined by "|"
+bool ofxWinDialog::DescriptionStyle(DescStatement &st, DWORD &dwStyle)
+{
+	static const struct {
+		const char* name;
+		DWORD style;
+	} styles[] = {
+		{ "WS_BORDER", WS_BORDER },
+		{ "WS_DLGFRAME", WS_DLGFRAME },
+		{ "BS_DEFPUSHBUTTON", BS_DEFPUSHBUTTON },
+		{ "BS_RIGHTBUTTON", BS_RIGHTBUTTON },
+		{ "BS_LEFTTEXT", BS_LEFTTEXT },
+		{ "BS_LEFT", BS_LEFT },
+		{ "BS_RIGHT", BS_RIGHT },
+		{ "BS_CENTER", BS_CENTER },
+		{ "BS_TOP", BS_TOP },
+		{ "BS_BOTTOM", BS_BOTTOM },
+		{ "SS_LEFT", SS_LEFT },
+		{ "SS_CENTER", SS_CENTER },
+		{ "SS_RIGHT", SS_RIGHT },
+		{ "SS_SUNKEN", SS_SUNKEN },
+		{ "ES_LEFT", ES_LEFT },
+		{ "ES_CENTER", ES_CENTER },
+		{ "ES_RIGHT", ES_RIGHT },
+		{ "ES_NUMBER", ES_NUMBER },
+		{ "ES_PASSWORD", ES_PASSWORD },
+		{ "CBS_DROPDOWN", CBS_DROPDOWN },
+		{ "CBS_DROPDOWNLIST", CBS_DROPDOWNLIST },
+		{ "UDS_ALIGNLEFT", UDS_ALIGNLEFT },
+		{ "UDS_ALIGNRIGHT", UDS_ALIGNRIGHT }
+	};
+
+	const DescToken* token = nullptr;
+	if (!st.Token(token))
+		return false;
+	if (token->kind == DescToken::Number) {
+		dwStyle = (DWORD)(long long)token->value;
+		return true;
+	}
+
+	dwStyle = 0;
+	std::string names = token->String();
+	size_t pos = 0;
+	while (pos <= names.size()) {
+		size_t bar = names.find('|', pos);
+		if (bar == std::string::npos)
+			bar = names.size();
+		std::string name = names.substr(pos, bar - pos);
+		bool bFound = false;
+		for (size_t i = 0; i < sizeof(styles) / sizeof(styles[0]); i++) {
+			if (name == styles[i].name) {
+				dwStyle |= styles[i].style;
+				bFound = true;
+				break;
 			}
 		}
+		if (!bFound)
+			return st.Error("unknown style \"" + name + "\"");
+		pos = bar + 1;
 	}
+	return true;
+}
 
-    // Check that the file exists in case an extension was added
-    if (_access(inipath.c_str(), 0) == -1) {
-        printf("ofxWinDialog::Load\nInitialization file \"%s\" not found.", inipath.c_str());
-        return false;
-    }
+//
+// Hot reload (WatchIni, WatchDialog)
+//
+// A background thread waits for change notification of the folders
+// of the watched files, or polls if a folder cannot be watched. A file
+// is read when its write time and size have not changed again for the
+// debounce interval (FileWatch). The thread reads only the changed file
+// and finds the differences from the values last read (IniValues,
+// DiffStatements). The differences are queued and the dialog window is
+// sent WM_DIALOG_RELOAD so that they are applied by the UI thread with
+// the Set functions. Changes while the dialog is closed are applied by
+// the next Open.
+//
 
-	// Set newcontrols first if Load is before Open
-    // hwnd and ID are not yet set
-	newcontrols = controls;
+// Watch an initialization file
+void ofxWinDialog::WatchIni(std::string filename, std::string section)
+{
+	WatchFile(GetFilePath(filename, ".ini"), section, false);
+}
 
-    // Load control values
-    // Only those saved in the ini file are changed
-    for (size_t i=0; i<controls.size(); i++) {
-        if (controls[i].Type    != "Static"
-            && controls[i].Type != "Group"
-            && controls[i].Type != "Button"
-            && controls[i].Type != "OK"
-            && controls[i].Type != "CANCEL") {
-
-            // Use the section name argument if specified
-            // Use the control section name if assigned by SetSection
-            // Default section name is the control type
-            ControlSection = controls[i].Type;
-            if (!section.empty()) 
-                ControlSection = section;
-            else if (!controls[i].Section.empty()) 
-                ControlSection = controls[i].Section;
-
-            if (controls[i].Type == "Combo" || controls[i].Type == "List") {
-                if (GetPrivateProfileStringA((LPCSTR)ControlSection.c_str(), (LPCSTR)controls[i].Title.c_str(), NULL, (LPSTR)tmp, MAX_PATH, (LPCSTR)inipath.c_str()) > 0) {
-                    if (tmp[0]) controls[i].Index = atoi(tmp);
-                }
-            }
-            else if (controls[i].Type == "Edit") {
-                if (GetPrivateProfileStringA((LPCSTR)ControlSection.c_str(), (LPCSTR)controls[i].Title.c_str(), NULL, (LPSTR)tmp, MAX_PATH, (LPCSTR)inipath.c_str())> 0) {
-                    if (tmp[0]) controls[i].Text = tmp;
-                }
-            }
-			else if (controls[i].Type == "Spin") {
-				if (GetPrivateProfileStringA((LPCSTR)ControlSection.c_str(), (LPCSTR)controls[i].Title.c_str(), NULL, (LPSTR)tmp, MAX_PATH, (LPCSTR)inipath.c_str()) > 0) {
-					if (tmp[0]) controls[i].Val = atoi(tmp);
-				}
-			}
-            else if (controls[i].Type == "Slider") {
-                if (GetPrivateProfileStringA((LPCSTR)ControlSection.c_str(), (LPCSTR)controls[i].Title.c_str(), NULL, (LPSTR)tmp, MAX_PATH, (LPCSTR)inipath.c_str()) > 0) {
-                    if (tmp[0]) controls[i].SliderVal = (float)atof(tmp);
-                }
-            }
-            else if (controls[i].Type == "Checkbox") {
-                if (GetPrivateProfileStringA((LPCSTR)ControlSection.c_str(), (LPCSTR)controls[i].Title.c_str(), NULL, (LPSTR)tmp, MAX_PATH, (LPCSTR)inipath.c_str()) > 0) {
-                    if (tmp[0]) controls[i].Val = atoi(tmp);
-                }
-            }
-            else if (controls[i].Type == "Radio") {
-                if (GetPrivateProfileStringA((LPCSTR)ControlSection.c_str(), (LPCSTR)controls[i].Title.c_str(), NULL, (LPSTR)tmp, MAX_PATH, (LPCSTR)inipath.c_str()) > 0) {
-                    if (tmp[0]) controls[i].Val = atoi(tmp);
-                }
-            }
-        }
-    }
+// Watch a dialog description file
+void ofxWinDialog::WatchDialog(std::string filename)
+{
+	WatchFile(GetFilePath(filename, ""), "", true);
+}
 
-    // Refresh the dialog with the new controls
-    Refresh();
+// Stop watching all files
+void ofxWinDialog::StopWatch()
+{
+	EndWatchThread();
+	g_WatchFiles.clear();
+	g_Watch.Clear();
+	std::lock_guard<std::mutex> lock(g_ReloadMutex);
+	g_Reloads.clear();
+}
 
-    return true;
+// Time without further change before a file is read
+void ofxWinDialog::SetWatchDebounce(int msec)
+{
+	EndWatchThread();
+	g_Watch.SetDebounce(msec > 0 ? (uint64_t)msec : 0);
+	StartWatchThread();
+}
+
+// Full path of a file in bin\data or the executable folder
+// The extension is added if the file name has none.
+// If the file name is empty, the executable path is used.
+std::string ofxWinDialog::GetFilePath(std::string filename, std::string extension)
+{
+	if (filename.empty()) {
+		std::string exepath = GetExePath(true);
+		return exepath.substr(0, exepath.rfind(".")) + extension;
+	}
+	size_t dot = filename.rfind('.');
+	if (!extension.empty() && (dot == std::string::npos || filename.find_first_of("/\\", dot) != std::string::npos))
+		filename += extension;
+	// Full path
+	if (filename.find('/') != std::string::npos || filename.find('\\') != std::string::npos)
+		return filename;
+	std::string path = GetExePath();
+	if (_access((path + "\\data\\").c_str(), 0) != -1)
+		return path + "\\data\\" + filename;
+	return path + "\\" + filename;
+}
+
+// Write time and size of a file for change detection
+static bool FileStamp(const std::string &path, uint64_t &stamp)
+{
+	WIN32_FILE_ATTRIBUTE_DATA data{};
+	if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data))
+		return false;
+	uint64_t time = ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+	uint64_t size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+	stamp = time ^ (size * 0x9E3779B97F4A7C15ULL);
+	if (stamp == 0) stamp = 1; // Zero is a missing file
+	return true;
+}
+
+// Read a whole file to a string
+static bool ReadTextFile(const std::string &path, std::string &text)
+{
+	std::ifstream file(path.c_str(), std::ios::binary);
+	if (!file)
+		return false;
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	text = buffer.str();
+	return true;
+}
+
+// Description arguments that are control values and can
+// be changed with a Set function (see ParseDialog)
+static bool IsValueArgument(const DescRecord &r, size_t arg)
+{
+	const std::string &k = r.keyword;
+	if (k == "checkbox" || k == "radio")
+		return arg == 6;
+	if (k == "slider" || k == "spin")
+		return arg == 7;
+	if (k == "edit")
+		return arg == 5;
+	// Text with a title
+	if (k == "text")
+		return arg == 1 && r.kinds.size() > 1 && r.kinds[1] != DescToken::Number;
+	// Items and index
+	if (k == "combo" || k == "list" || k == "virtuallist")
+		return arg == 5 || arg == ListPosition(r, DescToken::ListEnd) + 1;
+	return false;
+}
+
+// Add a file to watch and read its current values
+void ofxWinDialog::WatchFile(std::string path, std::string section, bool bDialog)
+{
+	// Files are changed while the thread is stopped
+	EndWatchThread();
+
+	uint64_t stamp = 0;
+	FileStamp(path, stamp);
+	size_t index = g_Watch.Add(path, stamp);
+	if (index >= g_WatchFiles.size()) {
+		g_WatchFiles.resize(index + 1);
+		g_WatchFiles[index].path = path;
+	}
+	watchfile &file = g_WatchFiles[index];
+	file.section = section;
+	file.bDialog = bDialog;
+	ReadWatchFile(file, nullptr);
 
+	StartWatchThread();
 }
 
-// Load initialization file to a string
-std::string ofxWinDialog::LoadFile(std::string filename)
+void ofxWinDialog::StartWatchThread()
 {
-	char tmp[MAX_PATH]{};
-	std::string inipath = "";
+	if (g_WatchFiles.empty() || g_WatchThread.joinable())
+		return;
+	g_hWatchStop = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (g_hWatchStop)
+		g_WatchThread = std::thread(&ofxWinDialog::WatchThread, this);
+}
 
-	// If no filename, create ini file from exe path
-	if (filename.empty()) {
-		inipath = GetExePath(true);
-		// Strip ".exe" and replace with ".ini"
-		inipath = inipath.substr(0, inipath.rfind(".")) + ".ini";
+void ofxWinDialog::EndWatchThread()
+{
+	if (g_WatchThread.joinable()) {
+		SetEvent(g_hWatchStop);
+		g_WatchThread.join();
 	}
-	else {
-		// Check for full path
-		if (filename.find('/') != std::string::npos || filename.find('\\') != std::string::npos) {
-			inipath = filename;
+	if (g_hWatchStop) {
+		CloseHandle(g_hWatchStop);
+		g_hWatchStop = NULL;
+	}
+}
+
+// Watch thread
+void ofxWinDialog::WatchThread()
+{
+	// Change notification for the folder of each file
+	// Folders that cannot be watched are polled
+	std::vector<HANDLE> handles;
+	handles.push_back(g_hWatchStop);
+	std::vector<std::string> folders;
+	bool bPoll = false;
+	for (size_t i = 0; i < g_WatchFiles.size(); i++) {
+		std::string folder = g_WatchFiles[i].path;
+		size_t pos = folder.find_last_of("/\\");
+		folder = (pos == std::string::npos) ? "." : folder.substr(0, pos);
+		if (std::find(folders.begin(), folders.end(), folder) != folders.end())
+			continue;
+		folders.push_back(folder);
+		HANDLE hChange = INVALID_HANDLE_VALUE;
+		if (handles.size() < MAXIMUM_WAIT_OBJECTS) {
+			hChange = FindFirstChangeNotificationA(folder.c_str(), FALSE,
+				FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_FILE_NAME);
 		}
-		else {
-			// filename only - add full path - (bin\data or executable directory)
-			std::string path = GetExePath();
-			// First try the bin\data folder
-			inipath = path;
-			inipath += "\\data\\";
-			// Does the folder exist ?
-			if (_access(inipath.c_str(), 0) != -1) {
-				// Openframeworks application
-				inipath += filename;
-			} else {
-				// Executable folder
-				inipath = path;
-				inipath += "\\";
-				inipath += filename;
+		if (hChange == INVALID_HANDLE_VALUE)
+			bPoll = true;
+		else
+			handles.push_back(hChange);
+	}
+
+	std::vector<size_t> changed;
+	for (;;) {
+		// Wait for a change, the end of the debounce interval or the next poll
+		DWORD timeout = INFINITE;
+		if (g_Watch.IsPending())
+			timeout = 50;
+		else if (bPoll)
+			timeout = 500;
+		DWORD result = WaitForMultipleObjects((DWORD)handles.size(), handles.data(), FALSE, timeout);
+		if (result == WAIT_OBJECT_0 || result == WAIT_FAILED)
+			break;
+		if (result > WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + (DWORD)handles.size())
+			FindNextChangeNotification(handles[result - WAIT_OBJECT_0]);
+
+		if (g_Watch.Poll(GetTickCount64(), FileStamp, changed) == 0)
+			continue;
+
+		// Read the changed files and queue the differences
+		bool bQueued = false;
+		for (size_t k = 0; k < changed.size(); k++) {
+			reload changes;
+			if (ReadWatchFile(g_WatchFiles[changed[k]], &changes)) {
+				std::lock_guard<std::mutex> lock(g_ReloadMutex);
+				g_Reloads.push_back(std::move(changes));
+				bQueued = true;
 			}
 		}
+		HWND hwnd = g_hwndWatch;
+		if (bQueued && hwnd)
+			PostMessage(hwnd, WM_DIALOG_RELOAD, 0, 0L);
 	}
 
-	// Check that the file exists in case an extension was added
-	if (_access(inipath.c_str(), 0) == -1) {
-		printf("ofxWinDialog::LoadFile - file \"%s\" not found.", inipath.c_str());
-		return "";
-	}
+	for (size_t i = 1; i < handles.size(); i++)
+		FindCloseChangeNotification(handles[i]);
+}
 
-	// Open the file for reading
-	std::ifstream file(inipath.c_str());
-	if (!file) {
-		printf("ofxWinDialog::LoadFile - Error opening file\n");
-		return "";
+// Read a watched file and find the differences from the values last read
+// Returns true if there are differences
+bool ofxWinDialog::ReadWatchFile(watchfile &file, reload* changes)
+{
+	std::string text;
+	if (!ReadTextFile(file.path, text))
+		return false;
+
+	if (file.bDialog) {
+		// A description with an error is ignored until it is saved again
+		std::vector<DescRecord> statements;
+		if (!ReadStatements(text, statements))
+			return false;
+		bool bChanged = false;
+		if (changes) {
+			std::vector<size_t> changed;
+			changes->bStructure = !DiffStatements(file.statements, statements, IsValueArgument, changed);
+			for (size_t k = 0; k < changed.size(); k++)
+				changes->statements.push_back(statements[changed[k]]);
+			bChanged = changes->bStructure || !changed.empty();
+		}
+		file.statements.swap(statements);
+		if (!bChanged)
+			return false;
 	}
+	else {
+		IniValues values;
+		values.Parse(text);
+		bool bChanged = false;
+		if (changes)
+			bChanged = file.values.Diff(values, changes->values) > 0;
+		file.values = std::move(values);
+		if (!bChanged)
+			return false;
+	}
+	changes->path = file.path;
+	changes->section = file.section;
+	changes->bDialog = file.bDialog;
+	return true;
+}
 
-	// stringstream buffer
-	std::stringstream buffer;
+// Apply the differences read by the watch thread
+void ofxWinDialog::ApplyReloads()
+{
+	std::vector<reload> reloads;
+	{
+		std::lock_guard<std::mutex> lock(g_ReloadMutex);
+		reloads.swap(g_Reloads);
+	}
+	for (size_t i = 0; i < reloads.size(); i++) {
+		int changes = 0;
+		if (reloads[i].bDialog && reloads[i].bStructure) {
+			changes = -1;
+		}
+		else if (reloads[i].bDialog) {
+			for (size_t k = 0; k < reloads[i].statements.size(); k++)
+				ApplyStatement(reloads[i].statements[k], changes);
+		}
+		else {
+			for (size_t k = 0; k < reloads[i].values.size(); k++)
+				ApplyIniValue(reloads[i].values[k], reloads[i].section, changes);
+		}
+		DialogFunction("WM_RELOAD", reloads[i].path, changes);
+	}
+}
 
-	// Read the entire file into the stringstream
-	buffer << file.rdbuf();
+// Apply an initialization file value to the controls as for Load
+void ofxWinDialog::ApplyIniValue(const IniValues::value &v, const std::string &section, int &changes)
+{
+	std::string key = IniValues::Key(v.section, v.key);
+	for (size_t i = 0; i < controls.size(); i++) {
+		// Section argument, control section or control type
+		std::string ControlSection = controls[i].Type;
+		if (!section.empty())
+			ControlSection = section;
+		else if (!controls[i].Section.empty())
+			ControlSection = controls[i].Section;
+		if (IniValues::Key(ControlSection, controls[i].Title) != key || v.value.empty())
+			continue;
+
+		const std::string &title = controls[i].Title;
+		if (controls[i].Type == "Combo" || controls[i].Type == "List") {
+			int index = atoi(v.value.c_str());
+			if (index == controls[i].Index)
+				continue;
+			if (controls[i].Type == "Combo")
+				SetComboItem(title, index);
+			else
+				SetListItem(title, index);
+		}
+		else if (controls[i].Type == "Edit") {
+			if (v.value == controls[i].Text)
+				continue;
+			SetEdit(title, v.value);
+		}
+		else if (controls[i].Type == "Slider") {
+			// Saved with two decimal places
+			float value = (float)atof(v.value.c_str());
+			float diff = value - controls[i].SliderVal;
+			if (diff > -0.005f && diff < 0.005f)
+				continue;
+			SetSlider(title, value);
+		}
+		else if (controls[i].Type == "Spin" || controls[i].Type == "Checkbox" || controls[i].Type == "Radio") {
+			int value = atoi(v.value.c_str());
+			if (value == controls[i].Val)
+				continue;
+			if (controls[i].Type == "Spin")
+				SetSpin(title, value);
+			else if (controls[i].Type == "Checkbox")
+				SetCheckBox(title, value);
+			else
+				SetRadioButton(title, value);
+		}
+		else {
+			continue;
+		}
+		changes++;
+	}
+}
 
-	// Return the contents as a string
-	return buffer.str();
+// Apply the values of a changed description statement
+void ofxWinDialog::ApplyStatement(const DescRecord &r, int &changes)
+{
+	const std::vector<std::string> &a = r.args;
+	const std::string &k = r.keyword;
+	auto number = [&a](size_t arg) {
+		double v = 0.0;
+		if (arg < a.size())
+			DescriptionParser::ToNumber(a[arg].data(), a[arg].size(), v);
+		return v;
+	};
+	if (a.empty())
+		return;
 
+	if (k == "checkbox")
+		SetCheckBox(a[0], (int)number(6));
+	else if (k == "radio")
+		SetRadioButton(a[0], (int)number(6));
+	else if (k == "slider")
+		SetSlider(a[0], (float)number(7));
+	else if (k == "spin")
+		SetSpin(a[0], (int)number(7));
+	else if (k == "edit" && a.size() > 5)
+		SetEdit(a[0], a[5]);
+	else if (k == "text" && a.size() > 1)
+		SetText(a[0], a[1]);
+	else if (k == "combo" || k == "list" || k == "virtuallist") {
+		size_t first = ListPosition(r, DescToken::ListBegin);
+		size_t last = ListPosition(r, DescToken::ListEnd);
+		if (first >= last || last >= a.size())
+			return;
+		std::vector<std::string> items(a.begin() + first + 1, a.begin() + last);
+		int index = (int)number(last + 1);
+		if (k == "combo")
+			SetCombo(a[0], items, index);
+		else
+			SetList(a[0], items, index);
+	}
+	else
+		return;
+	changes++;
 }
 
 // Set dialog window icon
@@ -1716,16 +4499,46 @@ void ofxWinDialog::SetPosition(int x, int y, int width, int height)
 // Dialog position and size must have been set by SetPosition
 HWND ofxWinDialog::Open(std::string title)
 {
+	// Dialog thread (UseThread)
+	// Show a kept dialog with the thread or start a new one
+	if (bUseThread) {
+		HWND hwnd = NULL;
+		if (CallDialogThread([&] { hwnd = Open(title); }))
+			return hwnd;
+		if (g_DialogThreadId.load() != GetCurrentThreadId())
+			return OpenThread(title);
+	}
+
+	TraceScope span(g_TraceLog, "Open", "dialog", title.c_str());
 	// Safety
 	if (dialogWidth == 0 || dialogHeight == 0)
 		return NULL;
 
+	auto start = std::chrono::steady_clock::now();
+
+	// Changes to watched files while the dialog was closed
+	ApplyReloads();
+
+	// Kept dialog (KeepAlive) - show the hidden window again
+	if (g_Core.IsKeepAlive() && m_hDialog && IsWindow(m_hDialog)) {
+		HWND hwnd = ShowDialog(title);
+		g_OpenTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		return hwnd;
+	}
+
 	// Register the dialog window if not already
 	if (!bRegistered) {
 		if (!RegisterDialog())
 			return NULL;
 	}
 
+	// Dialog size for the DPI of the parent window or the system
+	// The size is corrected after creation if the dialog is on
+	// a monitor with a different DPI
+	g_Dpi.Set(m_hwnd ? (int)GetDpiForWindow(m_hwnd) : (int)GetDpiForSystem());
+	int width = g_Dpi.Scale(dialogWidth);
+	int height = g_Dpi.Scale(dialogHeight);
+
 	// Dialog position
 	int xpos = dialogX;
 	int ypos = dialogY;
@@ -1733,8 +4546,8 @@ HWND ofxWinDialog::Open(std::string title)
 	//  o If x and y are both negative, centre on the desktop
 	//  o If x and y are both positive, that position is used
 	if (dialogX < 0 && dialogY < 0) {
-		xpos = (GetSystemMetrics(SM_CXSCREEN) - dialogWidth) / 2;
-		ypos = (GetSystemMetrics(SM_CYSCREEN) - dialogHeight) / 2;
+		xpos = (GetSystemMetrics(SM_CXSCREEN) - width) / 2;
+		ypos = (GetSystemMetrics(SM_CYSCREEN) - height) / 2;
 	}
 
 	// Relative to parent window
@@ -1749,16 +4562,16 @@ HWND ofxWinDialog::Open(std::string title)
 		//	o If x and y are both zero, centre on the host window
 		if (dialogX == 0 && dialogY == 0) {
 			// Centre on the host window
-			xpos = rect.left + rwidth / 2 - dialogWidth / 2;
-			ypos = rect.top + rheight / 2 - dialogHeight / 2;
+			xpos = rect.left + rwidth / 2 - width / 2;
+			ypos = rect.top + rheight / 2 - height / 2;
 		}
 		//  o if y is zero, offset from the centre by the x amount
 		else if (dialogY == 0 && dialogX != CW_USEDEFAULT) {
 			//  o if y is zero, offset from the left by the x amount
 			//    and position at the top of the window or offset
 			//    from the centre if the dialog height is greater
-			if(dialogHeight > rheight)
-				ypos = rect.top + rheight / 2 - dialogHeight / 2;
+			if(height > rheight)
+				ypos = rect.top + rheight / 2 - height / 2;
 			else
 				ypos = rect.top;
 			if (ypos < 0) ypos = 0;
@@ -1766,8 +4579,8 @@ HWND ofxWinDialog::Open(std::string title)
 			RECT workArea{};
 			SystemParametersInfo(SPI_GETWORKAREA, 0, &workArea, 0);
 			int wheight = workArea.bottom - workArea.top;
-			if ((ypos + dialogHeight) > wheight)
-				ypos = wheight - dialogHeight;
+			if ((ypos + height) > wheight)
+				ypos = wheight - height;
 
 			xpos = rect.left + dialogX;
 			if (xpos < 0) xpos = 0;
@@ -1790,11 +4603,16 @@ HWND ofxWinDialog::Open(std::string title)
 	DWORD dwStyle = WS_CAPTION | WS_OVERLAPPED | WS_SYSMENU;
 	if (bResizable)
 		dwStyle |= WS_THICKFRAME;
+	// Double buffered - child windows are not painted over
+	if (bDoubleBuffer)
+		dwStyle |= WS_CLIPCHILDREN;
 
+	// A dialog with its own thread has no owner so that
+	// it is not held up by the thread of the ofApp window
 	HWND hwnd = CreateWindow(m_ClassName, titlechars,
         dwStyle,
-        xpos, ypos, dialogWidth, dialogHeight,
-        m_hwnd,      // Parent window
+        xpos, ypos, width, height,
+        bUseThread ? NULL : m_hwnd, // Parent window
         NULL,        // No menu
         m_hInstance, // Parent instance
         NULL);
@@ -1806,6 +4624,14 @@ HWND ofxWinDialog::Open(std::string title)
         return 0;
     }
 
+	// DPI of the monitor showing the dialog
+	int dpi = (int)GetDpiForWindow(hwnd);
+	if (dpi > 0 && dpi != g_Dpi.Get()) {
+		g_Dpi.Set(dpi);
+		SetWindowPos(hwnd, NULL, 0, 0, g_Dpi.Scale(dialogWidth), g_Dpi.Scale(dialogHeight),
+			SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE);
+	}
+
 	// Set transparency
 	if (bTransparent) {
 		//
@@ -1818,509 +4644,1471 @@ HWND ofxWinDialog::Open(std::string title)
 		// Make pixels transparent
 		SetLayeredWindowAttributes(hwnd, Hex2Rgb(TransparentColor), 0, LWA_COLORKEY);
 
-		// This creates a window with a thick blue border
-		DWORD policy = DWMNCRP_DISABLED;
-		DwmSetWindowAttribute(hwnd, DWMWA_NCRENDERING_POLICY, &policy, sizeof(policy));
+		// This creates a window with a thick blue border
+		DWORD policy = DWMNCRP_DISABLED;
+		DwmSetWindowAttribute(hwnd, DWMWA_NCRENDERING_POLICY, &policy, sizeof(policy));
+
+	}
+
+     // Store the instance pointer in the window's user data
+    SetWindowLongPtr(hwnd, GWLP_USERDATA, (LONG_PTR)this);
+
+    // Key messages for the dialog window (GetKeyMsgProc)
+    g_Hooks.Add((uintptr_t)hwnd, this);
+
+    // Class window handle
+    m_hDialog = hwnd;
+    // Window for changes to watched files
+    g_hwndWatch = hwnd;
+    // Window and thread for queued Set functions (QueueSet, UseThread)
+    g_hwndThread = hwnd;
+    g_WindowThreadId = GetCurrentThreadId();
+    // OSC messages received before the window was created (StartOsc)
+    if (!g_OscIn.Empty())
+        PostMessage(hwnd, WM_DIALOG_OSC, 0, 0);
+    // Shared parameters changed while the dialog was closed (BindParameter)
+    if (!g_ParamQueue.Empty())
+        PostMessage(hwnd, WM_DIALOG_PARAMS, 0, 0);
+
+    // Dialog window icon if specified
+    if (m_hIcon) {
+        SendMessage(hwnd, WM_SETICON, ICON_BIG, (LPARAM)m_hIcon);
+        SendMessage(hwnd, WM_SETICON, ICON_SMALL, (LPARAM)m_hIcon);
+    }
+
+    // Clear all window handles for repeat open of the same dialog
+    for (size_t i=0; i<controls.size(); i++) {
+        controls[i].hwndControl = NULL;
+        controls[i].hwndSliderVal = NULL;
+    }
+    // No changes to apply to the new windows
+    g_Core.Open();
+
+    // Control positions and sizes for the dialog DPI
+    g_Core.ScaleControls(g_Dpi, false);
+
+    //
+    // Draw all controls
+    //
+    // Controls on pages that are not shown are created by ShowPage
+    // when the page is first shown (AddPage)
+    ClosePage();
+    g_Pages.Reset();
+    if (!g_Pages.Empty())
+        g_Pages.Show(g_Pages.GetCurrent());
+    g_NextID = 1000; // Start control ID
+    g_hwndTemplate = NULL;
+    // Control positions from the layout for the client area
+    FlushLayout();
+    if (!g_Layout.Empty()) {
+        RECT client{};
+        GetClientRect(hwnd, &client);
+        g_Layout.Invalidate();
+        ArrangeLayout(client.right - client.left, client.bottom - client.top);
+    }
+    // All controls from one dialog template (UseTemplate)
+    // Double buffered dialogs paint their own background
+    if (bUseTemplate && !bDoubleBuffer)
+        g_hwndTemplate = CreateFromTemplate(hwnd);
+    if (!g_hwndTemplate)
+        g_Core.CreateWindows();
+
+	    
+    // Disable Visual Styles if flag is set
+    // DisableTheme(std::string type, std::string title)
+    for (size_t i=0; i<controls.size(); i++) {
+        if (!controls[i].VisualStyle) {
+            SetWindowTheme(controls[i].hwndControl, L"", L"");
+        }
+    }
+
+	// Hover rectangles for owner draw buttons
+	UpdateHoverIndex();
+    
+
+    //
+    // Save all controls
+    //
+
+    // Original controls for reset
+    if (newcontrols.empty()) {
+        newcontrols = controls;
+    }
+    else {
+        // Update window handles for a new dialog
+        for (size_t i=0; i<controls.size(); i++) {
+            // Control handles
+            newcontrols[i].hwndControl = controls[i].hwndControl;
+            // Control ID
+            newcontrols[i].ID = controls[i].ID;
+            // Slider value text display
+            newcontrols[i].hwndSliderVal = controls[i].hwndSliderVal;
+        }
+    }
+
+    // Old controls for restore (Cancel)
+    oldcontrols = controls;
+
+    // Custom dialog font
+    if (!fontname.empty() && fontheight > 0) {
+
+		 //
+		 // Font height is in points
+		 // Converted to logical units for the dialog DPI (DialogFont)
+		 // https://learn.microsoft.com/en-us/windows/win32/api/wingdi/ns-wingdi-logfonta
+		 //
+         HFONT hFont = DialogFont();
+
+		 // Save the font handle to retrieve with GetFont
+		 g_hFont = hFont;
+
+         // Set the font for the dialog and all controls
+         // Template controls are created with the template font
+         SendMessage(hwnd, WM_SETFONT, (WPARAM)hFont, (LPARAM)MAKELONG(TRUE, 0));
+         for (size_t i=0; i<controls.size() && !g_hwndTemplate; i++) {
+             SendMessage(controls[i].hwndControl, WM_SETFONT, (WPARAM)hFont, (LPARAM)MAKELONG(TRUE, 0));
+             if (controls[i].hwndSliderVal)
+                 SendMessage(controls[i].hwndSliderVal, WM_SETFONT, (WPARAM)hFont, (LPARAM)MAKELONG(TRUE, 0));
+         }
+    }
+
+	// Back buffer is allocated for the new window at the first paint
+	if (bDoubleBuffer) {
+		ReleaseBackBuffer();
+	}
+
+	// Open minimized or hidden if the option is set
+	if(bMinimize)
+		ShowWindow(hwnd, SW_MINIMIZE);
+	else if (bHide)
+		ShowWindow(hwnd, SW_HIDE);
+	else
+		ShowWindow(hwnd, SW_SHOWNORMAL);
+
+    UpdateWindow(hwnd);
+
+	SetFocus(hwnd);
+
+	g_OpenTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    return hwnd;
+
+}
+
+//
+// Keep-alive dialog (KeepAlive)
+//
+// Close hides the dialog window and Open shows it again.
+// Set functions record the controls they change. While the
+// dialog is hidden, the control windows are not updated and
+// Open refreshes only the controls that were changed. The old
+// controls for Restore are updated in the same way unless the
+// user, Reset or Restore has changed the controls.
+//
+
+// Keep the dialog window when it is closed
+void ofxWinDialog::KeepAlive(bool bKeep)
+{
+	bool bHidden = g_Core.IsHidden();
+	g_Core.KeepAlive(bKeep);
+	// Destroy a hidden window
+	if (!bKeep && bHidden && m_hDialog && IsWindow(m_hDialog))
+		SendMessage(m_hDialog, WM_CLOSE, 0, 0);
+}
+
+// Time taken by the last Open (msec)
+double ofxWinDialog::GetOpenTime()
+{
+	return g_OpenTime;
+}
+
+//
+// Dialog thread (UseThread)
+//
+// QueueSet queues the Set functions of other threads in the same way
+// for a dialog run by the ofApp thread. The queue has no locks. Each
+// batch is applied at the next message of the window thread, with
+// only the last value set for each control and one redraw.
+//
+// Open starts a thread that creates the dialog window and runs a
+// message loop until the window is destroyed. A Set function called
+// by another thread queues a command and posts WM_DIALOG_COMMAND to
+// the window for the first command of a batch. The dialog thread then
+// applies all the commands queued with the same Set functions, so
+// ofApp never waits for the dialog. Functions that return a value or
+// change more than one value are sent to the window with
+// WM_DIALOG_CALL and wait for the dialog thread. Control events are
+// queued by the dialog thread and passed to ofApp by PollEvents.
+//
+
+// Run the dialog on a thread of its own
+void ofxWinDialog::UseThread(bool bThread)
+{
+	bUseThread = bThread;
+}
+
+// Queue Set functions called by other threads
+void ofxWinDialog::QueueSet(bool bQueue)
+{
+	bQueueSet = bQueue;
+}
+
+// Pass the control events queued by the dialog thread to ofApp
+int ofxWinDialog::PollEvents()
+{
+	// Shared parameters changed by other threads while the
+	// dialog is closed, if this is the thread that owns it
+	if (GetCurrentThreadId() == ParamThread())
+		ApplyParams();
+	std::vector<DialogEvent> events;
+	g_Events.Drain(events);
+	for (size_t k = 0; k < events.size(); k++)
+		AppCallback(events[k].title, events[k].text, events[k].value);
+	return (int)events.size();
+}
+
+// Called by a thread other than the dialog thread while it runs
+// or, for QueueSet, the thread of the dialog window while it is open
+bool ofxWinDialog::OtherThread()
+{
+	DWORD id = g_DialogThreadId.load();
+	if (id == 0 && bQueueSet)
+		id = g_WindowThreadId.load();
+	return id != 0 && id != GetCurrentThreadId();
+}
+
+// Run a function on the dialog thread and wait for it
+// Returns false if there is no dialog window or the caller is the
+// dialog thread, and the caller then runs the function itself.
+bool ofxWinDialog::CallDialogThread(const std::function<void()> &fn)
+{
+	if (!bUseThread || !OtherThread())
+		return false;
+	HWND hwnd = g_hwndThread.load();
+	if (!hwnd)
+		return false;
+	return SendMessage(hwnd, WM_DIALOG_CALL, 0, (LPARAM)&fn) != 0;
+}
+
+// Queue a Set function called by another thread
+// Returns false if the caller is to apply it
+bool ofxWinDialog::QueueCommand(int op, const std::string &title, const std::string &text, int value, float fvalue)
+{
+	if (!OtherThread())
+		return false;
+	// Counted so that the thread does not end while the command
+	// is queued (EndCommands)
+	g_Queuing++;
+	if (!OtherThread()) {
+		g_Queuing--;
+		return false;
+	}
+	EventTrace::event e;
+	e.op = op;
+	e.title = title;
+	e.text = text;
+	e.value = value;
+	e.fvalue = fvalue;
+	// Wake the dialog thread for the first command of a batch
+	// Commands queued before the window is created are applied
+	// when it has been created
+	if (g_Commands.Push(std::move(e))) {
+		HWND hwnd = g_hwndThread.load();
+		if (hwnd)
+			PostMessage(hwnd, WM_DIALOG_COMMAND, 0, 0);
+	}
+	g_Queuing--;
+	return true;
+}
+
+// Apply the queued Set functions (dialog thread)
+void ofxWinDialog::ApplyCommands()
+{
+	if (g_Commands.Drain(g_CommandBatch) == 0)
+		return;
+
+	// Only the last value set for a control is applied
+	g_Collapse.Apply(g_CommandBatch, [](const EventTrace::event &e) {
+		std::string key(1, (char)e.op);
+		return key + e.title;
+	});
+
+	// The dialog is drawn once for the batch
+	// WM_SETREDRAW would show a hidden window (KeepAlive)
+	bool bRedraw = g_CommandBatch.size() > 1 && m_hDialog && IsWindowVisible(m_hDialog);
+	if (bRedraw)
+		SendMessage(m_hDialog, WM_SETREDRAW, FALSE, 0L);
+	for (size_t k = 0; k < g_CommandBatch.size(); k++)
+		ReplayEvent(g_CommandBatch[k]);
+	if (bRedraw) {
+		SendMessage(m_hDialog, WM_SETREDRAW, TRUE, 0L);
+		RedrawWindow(m_hDialog, NULL, NULL, RDW_ERASE | RDW_INVALIDATE | RDW_ALLCHILDREN);
+	}
+}
+
+// Stop queuing Set functions for a thread that is ending
+// and apply the commands already queued
+void ofxWinDialog::EndCommands(std::atomic<DWORD> &thread)
+{
+	thread = 0;
+	// Set functions queuing a command
+	while (g_Queuing.load() > 0)
+		std::this_thread::yield();
+	ApplyCommands();
+}
+
+// Start the dialog thread and wait for the dialog window
+HWND ofxWinDialog::OpenThread(std::string title)
+{
+	// Thread of a dialog window that has been destroyed
+	EndDialogThread();
+	HANDLE hOpened = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (!hOpened)
+		return NULL;
+	g_hwndThread = NULL;
+	g_DialogThread = std::thread(&ofxWinDialog::DialogThread, this, title, hOpened);
+	WaitForSingleObject(hOpened, INFINITE);
+	CloseHandle(hOpened);
+	return g_hwndThread.load();
+}
+
+void ofxWinDialog::EndDialogThread()
+{
+	if (!g_DialogThread.joinable())
+		return;
+	// Destroy the window on the dialog thread so that WM_DESTROY
+	// ends the commands and the message loop. WM_CLOSE only hides
+	// a kept dialog (KeepAlive).
+	HWND hwnd = g_hwndThread.load();
+	if (hwnd && IsWindow(hwnd)) {
+		std::function<void()> fn = [hwnd] { DestroyWindow(hwnd); };
+		SendMessage(hwnd, WM_DIALOG_CALL, 0, (LPARAM)&fn);
+	}
+	// The window was not created or the loop has not started
+	DWORD id = g_DialogThreadId.load();
+	if (id)
+		PostThreadMessage(id, WM_QUIT, 0, 0);
+	g_DialogThread.join();
+}
+
+// Dialog thread
+void ofxWinDialog::DialogThread(std::string title, HANDLE hOpened)
+{
+	DWORD id = GetCurrentThreadId();
+	g_DialogThreadId = id;
 
+	// Message hook of this thread for the tab key
+	if (g_Hooks.Acquire(id)) {
+		HHOOK hHook = SetWindowsHookEx(WH_GETMESSAGE, GetKeyMsgProc, NULL, id);
+		g_Hooks.SetHook(id, (uintptr_t)hHook);
 	}
 
-     // Store the instance pointer in the window's user data
-    SetWindowLongPtr(hwnd, GWLP_USERDATA, (LONG_PTR)this);
+	HWND hwnd = Open(title);
+	g_hwndThread = hwnd;
+	SetEvent(hOpened);
+
+	if (hwnd) {
+		// Commands queued before the window was created
+		ApplyCommands();
+		// Until the window is destroyed (WM_DESTROY)
+		MSG msg{};
+		while (GetMessage(&msg, NULL, 0, 0) > 0) {
+			TranslateMessage(&msg);
+			DispatchMessage(&msg);
+		}
+	}
+	g_hwndThread = NULL;
 
-    // Save static window handle for GetMsgProc
-    hwndDialog = hwnd;
+	// Later Set functions are applied by the caller
+	EndCommands(g_DialogThreadId);
 
-    // Class window handle
-    m_hDialog = hwnd;
+	uintptr_t hHook = 0;
+	if (g_Hooks.Release(id, hHook) && hHook)
+		UnhookWindowsHookEx((HHOOK)hHook);
+}
 
-    // Dialog window icon if specified
-    if (m_hIcon) {
-        SendMessage(hwnd, WM_SETICON, ICON_BIG, (LPARAM)m_hIcon);
-        SendMessage(hwnd, WM_SETICON, ICON_SMALL, (LPARAM)m_hIcon);
-    }
+// Show a hidden dialog
+HWND ofxWinDialog::ShowDialog(std::string title)
+{
+	HWND hwnd = m_hDialog;
+	SetWindowTextA(hwnd, title.c_str());
 
-    // Clear all window handles for repeat open of the same dialog
-    for (size_t i=0; i<controls.size(); i++) {
-        controls[i].hwndControl = NULL;
-    }
+	// Controls changed by Set functions since the last Open
+	// and the old controls for restore (Cancel)
+	g_Core.Show(oldcontrols);
 
-    //
-    // Draw all controls
-    //
+	if (bMinimize)
+		ShowWindow(hwnd, SW_MINIMIZE);
+	else if (bHide)
+		ShowWindow(hwnd, SW_HIDE);
+	else
+		ShowWindow(hwnd, SW_SHOWNORMAL);
+	UpdateWindow(hwnd);
+	SetFocus(hwnd);
+
+	return hwnd;
+}
+
+// Hide the dialog instead of destroying it
+void ofxWinDialog::HideDialog()
+{
+	ShowWindow(m_hDialog, SW_HIDE);
+	g_Core.Hide();
+	DialogFunction("WM_CLOSE", "", PtrToUint(m_hDialog));
+}
+
+//
+// Create the window of a control
+// ID is incremented for each control window created
+//
+void ofxWinDialog::CreateControl(size_t i, HWND hwnd, uint64_t &ID)
+{
     HWND hwndc = NULL;
-    uint64_t ID = 1000; // Start control ID
-    for (size_t i=0; i<controls.size(); i++) {
 
-        //
-        // Checkbox
-        //
-        if (controls[i].Type == "Checkbox") {
-            // Text in the checkbox is independent of the title
-            // If the text string is empty, the title is used.
-            std::string str = controls[i].Text.c_str();
-            if (str.empty()) str = controls[i].Title;
-            // Style can be BS_RIGHTBUTTON - default is a button to the left of the text
-            DWORD dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD | BS_CHECKBOX | BS_AUTOCHECKBOX;
-            if (controls[i].Style > 0)
-                dwStyle |= controls[i].Style;
-            else
-                dwStyle |= BS_LEFT;;
-            hwndc = CreateWindowExA(0, "BUTTON", str.c_str(), dwStyle,
-                controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
-                hwnd,        // Parent window
-                (HMENU)ID,   // Control ID
-                m_hInstance, // Parent instance handle
-                NULL);
-
-            if (hwndc) {
-                // Initial checkbox state
-                SendMessage(hwndc, BM_SETCHECK, controls[i].Val, 0);
-                controls[i].hwndControl = hwndc;
-                controls[i].ID = ID;
-                ID++;
-            }
+    //
+    // Checkbox
+    //
+    if (controls[i].Type == "Checkbox") {
+        // Text in the checkbox is independent of the title
+        // If the text string is empty, the title is used.
+        std::string str = controls[i].Text.c_str();
+        if (str.empty()) str = controls[i].Title;
+        // Style can be BS_RIGHTBUTTON - default is a button to the left of the text
+        DWORD dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD | BS_CHECKBOX | BS_AUTOCHECKBOX;
+        if (controls[i].Style > 0)
+            dwStyle |= controls[i].Style;
+        else
+            dwStyle |= BS_LEFT;;
+        hwndc = CreateWindowExA(0, "BUTTON", str.c_str(), dwStyle,
+            controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
+            hwnd,        // Parent window
+            (HMENU)ID,   // Control ID
+            m_hInstance, // Parent instance handle
+            NULL);
+
+        if (hwndc) {
+            // Initial checkbox state
+            SendMessage(hwndc, BM_SETCHECK, controls[i].Val, 0);
+            controls[i].hwndControl = hwndc;
+            controls[i].ID = ID;
+            ID++;
         }
+    }
 
-        //
-        // Radio button
-        //
-        // The first radio button in the group has the WS_GROUP style
-        // to define the beginning of a radio button group. 
-        // A new group is started by AddRadioGroup.
-        //
-        if (controls[i].Type == "Radio") {
-            // Text in the radio button is independent of the title
-            // If the text string is empty, the title is used.
-            std::string str = controls[i].Text.c_str();
-            if (str.empty()) str = controls[i].Title;
-            DWORD dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON;
-            // The first radio button in the group has WS_GROUP style
-            if (controls[i].First == 1)
-                dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON | WS_GROUP;
-            // Style can also be BS_RIGHTBUTTON - default is a button to the left of the text
-            if (controls[i].Style > 0)
-                dwStyle |= controls[i].Style;
-            else
-                dwStyle |= BS_LEFT;
-
-            hwndc = CreateWindowExA(0, "BUTTON", str.c_str(), dwStyle,
-                controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
-                hwnd, (HMENU)ID, m_hInstance, NULL);
-
-            if (hwndc) {
-                // Initial state
-                SendMessage(hwndc, BM_SETCHECK, controls[i].Val, 0);
-                controls[i].hwndControl = hwndc;
-                controls[i].ID = ID;
-                ID++;
-            }
+    //
+    // Radio button
+    //
+    // The first radio button in the group has the WS_GROUP style
+    // to define the beginning of a radio button group. 
+    // A new group is started by AddRadioGroup.
+    //
+    if (controls[i].Type == "Radio") {
+        // Text in the radio button is independent of the title
+        // If the text string is empty, the title is used.
+        std::string str = controls[i].Text.c_str();
+        if (str.empty()) str = controls[i].Title;
+        DWORD dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON;
+        // The first radio button in the group has WS_GROUP style
+        if (controls[i].First == 1)
+            dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON | WS_GROUP;
+        // Style can also be BS_RIGHTBUTTON - default is a button to the left of the text
+        if (controls[i].Style > 0)
+            dwStyle |= controls[i].Style;
+        else
+            dwStyle |= BS_LEFT;
+
+        hwndc = CreateWindowExA(0, "BUTTON", str.c_str(), dwStyle,
+            controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
+            hwnd, (HMENU)ID, m_hInstance, NULL);
+
+        if (hwndc) {
+            // Initial state
+            SendMessage(hwndc, BM_SETCHECK, controls[i].Val, 0);
+            controls[i].hwndControl = hwndc;
+            controls[i].ID = ID;
+            ID++;
         }
+    }
 
-        //
-        // Slider
-        //
-        if (controls[i].Type == "Slider") {
-            DWORD dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD | TBS_HORZ;
-            if (controls[i].Tick > 0.0f)
-                dwStyle |= TBS_AUTOTICKS;
-            else
-                dwStyle |= TBS_NOTICKS;
-
-            hwndc = CreateWindowExA(0, TRACKBAR_CLASSA, controls[i].Title.c_str(),
-                dwStyle,
-                controls[i].X, controls[i].Y,
-                controls[i].Width, controls[i].Height,
-                hwnd, (HMENU)ID, m_hInstance, NULL);
-
-            if (hwndc) {
-                controls[i].hwndControl = hwndc;
-                controls[i].ID = ID;
-                ID++;
-
-                // Set slider range and initial position
-                if ((controls[i].Max-controls[i].Min) > 1000.0) {
-					SendMessage(hwndc, TBM_SETRANGE, TRUE, MAKELONG((int)(controls[i].Min), (int)(controls[i].Max)));
-                    SendMessage(hwndc, TBM_SETPOS, TRUE, (int)(controls[i].SliderVal));
-                }
-                else {
-                    SendMessage(hwndc, TBM_SETRANGE, TRUE, MAKELONG((int)(controls[i].Min*100.0f), (int)(controls[i].Max*100.0f)));
-                    SendMessage(hwndc, TBM_SETPOS, TRUE, (int)(controls[i].SliderVal*100.0f));
-			    }
-				float pagesize = (controls[i].Max - controls[i].Min)/20.0f; // 5% range
-				SendMessage(hwndc, TBM_SETPAGESIZE, 0, (int)(pagesize*100.0f));
-
-                // Set tick interval
-                if (controls[i].Tick > 0.0f) {
-                    if ((controls[i].Max - controls[i].Min) > 1000.0)
-                        SendMessage(hwndc, TBM_SETTICFREQ, (int)(controls[i].Tick), 0);
-                    else
-                        SendMessage(hwndc, TBM_SETTICFREQ, (int)(controls[i].Tick*100.0f), 0);
-                }
+    //
+    // Slider
+    //
+    if (controls[i].Type == "Slider") {
+        DWORD dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD | TBS_HORZ;
+        if (controls[i].Tick > 0.0f)
+            dwStyle |= TBS_AUTOTICKS;
+        else
+            dwStyle |= TBS_NOTICKS;
+
+        hwndc = CreateWindowExA(0, TRACKBAR_CLASSA, controls[i].Title.c_str(),
+            dwStyle,
+            controls[i].X, controls[i].Y,
+            controls[i].Width, controls[i].Height,
+            hwnd, (HMENU)ID, m_hInstance, NULL);
+
+        if (hwndc) {
+            controls[i].hwndControl = hwndc;
+            controls[i].ID = ID;
+            ID++;
+
+            // Set slider range and initial position
+            SendMessage(hwndc, TBM_SETRANGE, TRUE, MAKELONG(
+                SliderScale::ToPosition(controls[i].Min, controls[i].Min, controls[i].Max),
+                SliderScale::ToPosition(controls[i].Max, controls[i].Min, controls[i].Max)));
+            SendMessage(hwndc, TBM_SETPOS, TRUE, SliderScale::ToPosition(controls[i].SliderVal, controls[i].Min, controls[i].Max));
+            SendMessage(hwndc, TBM_SETPAGESIZE, 0, SliderScale::PageSize(controls[i].Min, controls[i].Max)); // 5% range
+
+            // Set tick interval
+            if (controls[i].Tick > 0.0f) {
+                if ((controls[i].Max - controls[i].Min) > 1000.0)
+                    SendMessage(hwndc, TBM_SETTICFREQ, (int)(controls[i].Tick), 0);
+                else
+                    SendMessage(hwndc, TBM_SETTICFREQ, (int)(controls[i].Tick*100.0f), 0);
+            }
 
-                // Slider value text display
-                // Index is a flag to show value text to the right
-                if (controls[i].Index > 0) {
-                    // Create a static text control to display the value of the slider
-                    HWND hwndval = CreateWindowExA(
-                        0, "STATIC", "0", WS_VISIBLE | WS_CHILD | SS_RIGHT, // right aligned
-                        controls[i].X + controls[i].Width, controls[i].Y,
-                        40, controls[i].Height, hwnd, NULL, m_hInstance, NULL);
-                    if (hwndval) {
-                        // Initial slider value text
-                        char tmp[8]{};
-                        if (controls[i].Max >= 100.0f)
-                            sprintf_s(tmp, 8, "%.0f", controls[i].SliderVal);
-                        else if (controls[i].Max >= 10.0f)
-                            sprintf_s(tmp, 8, "%.1f", controls[i].SliderVal);
-                        else
-                            sprintf_s(tmp, 8, "%.2f", controls[i].SliderVal);
-
-                        SetWindowTextA(hwndval, (LPCSTR)tmp);
-                        // hwndSliderVal is only set if Index > 0
-                        controls[i].hwndSliderVal = hwndval;
-                    }
+            // Slider value text display
+            // Index is a flag to show value text to the right
+            if (controls[i].Index > 0) {
+                // Create a static text control to display the value of the slider
+                HWND hwndval = CreateWindowExA(
+                    0, "STATIC", "0", WS_VISIBLE | WS_CHILD | SS_RIGHT, // right aligned
+                    controls[i].X + controls[i].Width, controls[i].Y,
+                    g_Dpi.Scale(40), controls[i].Height, hwnd, NULL, m_hInstance, NULL);
+                if (hwndval) {
+                    // hwndSliderVal is only set if Index > 0
+                    controls[i].hwndSliderVal = hwndval;
+                    // Initial slider value text
+                    g_Core.SliderText(i);
                 }
             }
         }
+    }
 
-        //
-        // Edit control
-        //
-        if (controls[i].Type == "Edit") {
-            // Text alignment can be ES_LEFT, ES_RIGHT or ES_CENTER. Default is ES_LEFT.
-            // Outline can be WS_BORDER, WS_DLGFRAME
-            DWORD dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD | ES_AUTOHSCROLL | controls[i].Style;
-            hwndc = CreateWindowExA(WS_EX_CLIENTEDGE, "EDIT", controls[i].Text.c_str(),
-                dwStyle,
-                controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
-                hwnd, (HMENU)ID, m_hInstance, NULL);
-
-            if (hwndc) {
-                controls[i].hwndControl = hwndc;
-                controls[i].ID = ID;
-                ID++;
-            }
+    //
+    // Edit control
+    //
+    if (controls[i].Type == "Edit") {
+        // Text alignment can be ES_LEFT, ES_RIGHT or ES_CENTER. Default is ES_LEFT.
+        // Outline can be WS_BORDER, WS_DLGFRAME
+        DWORD dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD | ES_AUTOHSCROLL | controls[i].Style;
+        hwndc = CreateWindowExA(WS_EX_CLIENTEDGE, "EDIT", controls[i].Text.c_str(),
+            dwStyle,
+            controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
+            hwnd, (HMENU)ID, m_hInstance, NULL);
+
+        if (hwndc) {
+            controls[i].hwndControl = hwndc;
+            controls[i].ID = ID;
+            ID++;
         }
+    }
 
 
-		//
-		// Spin control
-		//
-		// A spin control increments or decrements a value in
-		// a buddy text window and immediately returns it to ofApp.
-		if (controls[i].Type == "Spin") {
-
-			// Create the static text buddy window
-			// Text alignment can be SS_LEFT (default), SS_RIGHT or SS_CENTER.
-			// Outline can be WS_BORDER, SS_SUNKEN
-			DWORD dwStyle = 0;
-			// Remove the spin control alignment styles
+	//
+	// Spin control
+	//
+	// A spin control increments or decrements a value in
+	// a buddy text window and immediately returns it to ofApp.
+	if (controls[i].Type == "Spin") {
+
+		// Create the static text buddy window
+		// Text alignment can be SS_LEFT (default), SS_RIGHT or SS_CENTER.
+		// Outline can be WS_BORDER, SS_SUNKEN
+		DWORD dwStyle = 0;
+		// Remove the spin control alignment styles
+		if (controls[i].Style > 0) {
+			dwStyle = controls[i].Style;
+			dwStyle &= ~UDS_ALIGNLEFT;
+			dwStyle &= ~UDS_ALIGNRIGHT;
+			// Add the basic styles
+			dwStyle |= (WS_CHILD | WS_VISIBLE | WS_CHILD);
+		} else {
+			dwStyle = WS_CHILD | WS_VISIBLE | WS_CHILD;
+		}
+
+		// Create the static text buddy control
+		hwndc = CreateWindowExA(0, "STATIC", "0",
+			dwStyle,
+			controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
+			hwnd, (HMENU)ID, m_hInstance, NULL);
+
+		if (hwndc) {
+
+			// Create the spin control (UPDOWN_CLASS)
+			// Style can include UDS_ALIGNLEFT or UDS_ALIGNRIGHT (default)
 			if (controls[i].Style > 0) {
 				dwStyle = controls[i].Style;
-				dwStyle &= ~UDS_ALIGNLEFT;
-				dwStyle &= ~UDS_ALIGNRIGHT;
-				// Add the basic styles
-				dwStyle |= (WS_CHILD | WS_VISIBLE | WS_CHILD);
+				// Remove UDS_WRAP in case SS_CENTER has been specified
+				// for the static text (the values are the same).
+				dwStyle &= ~UDS_WRAP;
+				// Isolate the UDS style
+				if ((dwStyle & UDS_ALIGNLEFT) == UDS_ALIGNLEFT) {
+					dwStyle |= UDS_ALIGNLEFT;
+				} else {
+					dwStyle |= UDS_ALIGNRIGHT;
+				}
+				dwStyle |= (WS_CHILD | WS_VISIBLE | UDS_SETBUDDYINT | UDS_AUTOBUDDY);
 			} else {
-				dwStyle = WS_CHILD | WS_VISIBLE | WS_CHILD;
+				dwStyle = WS_CHILD | WS_VISIBLE | UDS_SETBUDDYINT | UDS_AUTOBUDDY | UDS_ALIGNRIGHT;
 			}
 
-			// Create the static text buddy control
-			hwndc = CreateWindowExA(0, "STATIC", "0",
-				dwStyle,
-				controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
+			// Position left or right depending on the style
+			// X position is connected to the buddy window
+			// and depends on UDS_ALIGNLEFT or UDS_ALIGNLEFT
+			hwndc = CreateWindowExA(0, UPDOWN_CLASSA, controls[i].Title.c_str(), dwStyle,
+				// Set to zero to automatically size to fit the buddy window.
+				// Position and size is determined by UDS_ALIGNLEFT or UDS_ALIGNRIGHT.
+				0, 0, 0, 0,
 				hwnd, (HMENU)ID, m_hInstance, NULL);
 
 			if (hwndc) {
+				// Set the range for the up-down control - min, max (integer)
+				// The LOWORD of lParam is a short that specifies the maximum position
+				// and the HIWORD is a short that specifies the minimum position.
+				// MAKELPARAM(low, high)
+				SendMessageA(hwndc, (UINT)UDM_SETRANGE, 0, MAKELPARAM(controls[i].Max, controls[i].Min));
+				// Set a starting value
+				SendMessageA(hwndc, (UINT)UDM_SETPOS, 0, (LPARAM)controls[i].Val);
+				// The control hahdle
+				controls[i].hwndControl = hwndc;
+				controls[i].ID = ID;
+				ID++;
+			}
+		}
+	}
 
-				// Create the spin control (UPDOWN_CLASS)
-				// Style can include UDS_ALIGNLEFT or UDS_ALIGNRIGHT (default)
-				if (controls[i].Style > 0) {
-					dwStyle = controls[i].Style;
-					// Remove UDS_WRAP in case SS_CENTER has been specified
-					// for the static text (the values are the same).
-					dwStyle &= ~UDS_WRAP;
-					// Isolate the UDS style
-					if ((dwStyle & UDS_ALIGNLEFT) == UDS_ALIGNLEFT) {
-						dwStyle |= UDS_ALIGNLEFT;
-					} else {
-						dwStyle |= UDS_ALIGNRIGHT;
-					}
-					dwStyle |= (WS_CHILD | WS_VISIBLE | UDS_SETBUDDYINT | UDS_AUTOBUDDY);
-				} else {
-					dwStyle = WS_CHILD | WS_VISIBLE | UDS_SETBUDDYINT | UDS_AUTOBUDDY | UDS_ALIGNRIGHT;
-				}
 
-				// Position left or right depending on the style
-				// X position is connected to the buddy window
-				// and depends on UDS_ALIGNLEFT or UDS_ALIGNLEFT
-				hwndc = CreateWindowExA(0, UPDOWN_CLASSA, controls[i].Title.c_str(), dwStyle,
-					// Set to zero to automatically size to fit the buddy window.
-					// Position and size is determined by UDS_ALIGNLEFT or UDS_ALIGNRIGHT.
-					0, 0, 0, 0,
-					hwnd, (HMENU)ID, m_hInstance, NULL);
-
-				if (hwndc) {
-					// Set the range for the up-down control - min, max (integer)
-					// The LOWORD of lParam is a short that specifies the maximum position
-					// and the HIWORD is a short that specifies the minimum position.
-					// MAKELPARAM(low, high)
-					SendMessageA(hwndc, (UINT)UDM_SETRANGE, 0, MAKELPARAM(controls[i].Max, controls[i].Min));
-					// Set a starting value
-					SendMessageA(hwndc, (UINT)UDM_SETPOS, 0, (LPARAM)controls[i].Val);
-					// The control hahdle
-					controls[i].hwndControl = hwndc;
-					controls[i].ID = ID;
-					ID++;
-				}
+    //
+    // Combo box list selection control
+    //
+    if (controls[i].Type == "Combo") {
+
+		// DEBUG
+		// MessageBoxA(NULL, "Combo box", "", 0);
+
+		// Style CBS_DROPDOWN allows user entry
+		// Default is CBS_DROPDOWNLIST which prevents user entry
+		DWORD dwStyle = WS_TABSTOP | CBS_HASSTRINGS | WS_CHILD | WS_OVERLAPPED | WS_VISIBLE;
+		if (controls[i].Style > 0)
+			dwStyle |= controls[i].Style;
+		else
+			dwStyle |= CBS_DROPDOWNLIST;
+        hwndc = CreateWindowExA(WS_EX_CLIENTEDGE, "COMBOBOX", controls[i].Title.c_str(),
+            dwStyle, controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
+            hwnd, (HMENU)ID, m_hInstance, NULL);
+
+        if (hwndc) {
+            // Add combo box items
+			// Item strings are converted to wide chars for unicode and multi-byte
+			if (!controls[i].Items.empty() && controls[i].Items.size() > 0)
+				InsertItems(hwndc, true, controls[i].Items);
+
+            // Display an initial item in the selection field
+            SendMessage(hwndc, CB_SETCURSEL, (WPARAM)controls[i].Index, (LPARAM)0);
+
+            // Select all text in the edit field
+			if((dwStyle & CBS_DROPDOWN) == CBS_DROPDOWN)
+				SendMessage(hwndc, CB_SETEDITSEL, 0, MAKELONG(0, -1));
+
+            controls[i].hwndControl = hwndc;
+            controls[i].ID = ID;
+
+            ID++;
+        }
+    }
+			
+	//
+	// List box control
+	//
+	if (controls[i].Type == "List") {
+		
+		DWORD dwStyle = WS_TABSTOP | WS_HSCROLL | WS_VSCROLL | LBS_NOINTEGRALHEIGHT | LBS_NOTIFY | WS_CHILD | WS_OVERLAPPED | WS_VISIBLE;
+		// Virtual list - no item data and owner draw rows
+		if (controls[i].Store >= 0)
+			dwStyle |= LBS_NODATA | LBS_OWNERDRAWFIXED;
+
+		hwndc = CreateWindowExA(WS_EX_CLIENTEDGE, "LISTBOX", controls[i].Title.c_str(),
+			dwStyle,
+			controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
+			hwnd, (HMENU)ID, m_hInstance, NULL);
+
+		if (hwndc) {
+			// Virtual list - item count only
+			// Rows are drawn from the item store
+			if (controls[i].Store >= 0) {
+				SendMessage(hwndc, LB_SETCOUNT, (WPARAM)g_Stores[controls[i].Store].Size(), 0L);
 			}
+			// Add list box items
+			// The index of each item is set as item data
+			// Retrieve the index with LB_GETITEMDATA
+			// A filtered list is filled by ApplyListFilter
+			else if (!controls[i].Items.empty() && controls[i].Items.size() > 0 && !IsListFiltered(controls[i])) {
+				InsertItems(hwndc, false, controls[i].Items);
+			}
+
+			// Highlight the current selection (controls[i].Index when added)
+			SendMessage(hwndc, LB_SETCURSEL, (WPARAM)controls[i].Index, (LPARAM)0);
+
+			controls[i].hwndControl = hwndc;
+			controls[i].ID = ID;
+			ID++;
+
+			// Show the items that match the list filter
+			if (IsListFiltered(controls[i]))
+				ApplyListFilter(controls[i]);
 		}
+	}
+
+    //
+    // Push button
+    //
+    if (controls[i].Type == "Button") {
+        
+        // Text in the button is independent of the title
+        // If the text string is empty, the title is used.
+        std::string str = controls[i].Text.c_str();
+        if (str.empty()) str = controls[i].Title;
+
+        DWORD dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD;
+        // The button control style can be specified as default
+        // BS_DEFPUSHBUTTON (1) default style is BS_PUSHBUTTON (0)
+        // For example the OK button is usually the default.
+        if (controls[i].Style > 0)
+            dwStyle |= controls[i].Style;
+
+        hwndc = CreateWindowExA(0, "BUTTON", str.c_str(),
+            dwStyle,
+            controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
+            hwnd, (HMENU)ID, m_hInstance, NULL);
+        if (hwndc) {
+            controls[i].hwndControl = hwndc;
+            controls[i].ID = ID;
+            ID++;
+        }
+    }
+
+    //
+    // Group box
+    //
+    if (controls[i].Type == "Group") {
+        // Double buffered - group frames are drawn
+        // in the back buffer and the window is hidden
+        DWORD dwStyle = WS_CHILD | BS_GROUPBOX;
+        if (!bDoubleBuffer)
+            dwStyle |= WS_VISIBLE;
+        hwndc = CreateWindowExA(0, "BUTTON", controls[i].Text.c_str(),
+            dwStyle,
+            controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
+            hwnd, (HMENU)ID, m_hInstance, NULL);
+        if (hwndc) {
+            controls[i].hwndControl = hwndc;
+            controls[i].ID = ID;
+            ID++;
+        }
+    }
 
+    //
+    // Static text
+    //
+    if (controls[i].Type == "Static") {
+
+        // Default style is left aligned (SS_LEFT)
+        // Additional styles can be specified
+        //	SS_CENTER - centered
+        //	SS_RIGHT  - right aligned
+        //	WS_BORDER - outlined
+        //	SS_SUNKEN - sunken edge
+        DWORD dwStyle = WS_VISIBLE | WS_CHILD;
+        if (controls[i].Style > 0)
+            dwStyle |= controls[i].Style;
+        else
+            dwStyle |= SS_LEFT;
+
+        hwndc = CreateWindowExA(0, "STATIC", controls[i].Text.c_str(),
+            dwStyle,
+            controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
+            hwnd, (HMENU)ID, m_hInstance, NULL);
+
+        if (hwndc) {
+            controls[i].hwndControl = hwndc;
+            controls[i].ID = ID;
+            ID++;
+        }
+    }
+}
 
-        //
-        // Combo box list selection control
-        //
-        if (controls[i].Type == "Combo") {
+//
+// Dialog template (UseTemplate)
+//
+// The controls shown at Open are compiled to an in-memory dialog
+// template and all control windows are created by one call to
+// CreateDialogIndirectParam as a child dialog that fills the client
+// area. The template is compiled again only if the values used to
+// build it have changed. Template positions are in dialog units,
+// so the exact pixel positions are set after creation with one
+// DeferWindowPos batch. Control messages of the child dialog
+// are forwarded to the dialog window (TemplateDialogProc).
+//
 
-			// DEBUG
-			// MessageBoxA(NULL, "Combo box", "", 0);
+// Hash of the values used to compile the template
+uint64_t ofxWinDialog::GetTemplateKey(int width, int height)
+{
+	TemplateKey key;
+	key.Add((uint64_t)width);
+	key.Add((uint64_t)height);
+	key.Add(fontname);
+	key.Add((uint64_t)fontheight);
+	key.Add((uint64_t)fontweight);
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (!g_Pages.IsShown(controls[i].Page))
+			continue;
+		key.Add((uint64_t)i);
+		key.Add(controls[i].Type);
+		key.Add(controls[i].Title);
+		key.Add(controls[i].Text);
+		key.Add((uint64_t)controls[i].Style);
+		key.Add((uint64_t)controls[i].X);
+		key.Add((uint64_t)controls[i].Y);
+		key.Add((uint64_t)controls[i].Width);
+		key.Add((uint64_t)controls[i].Height);
+		key.Add((uint64_t)controls[i].First);
+		key.Add((uint64_t)(controls[i].Store >= 0));
+		key.Add((uint64_t)(controls[i].Tick > 0.0f));
+		if (controls[i].Type == "Slider")
+			key.Add((uint64_t)(controls[i].Index > 0));
+	}
+	return key.Get();
+}
 
-			// Style CBS_DROPDOWN allows user entry
-			// Default is CBS_DROPDOWNLIST which prevents user entry
+// Compile the controls shown at Open to a dialog template
+// Styles and text are the same as for CreateControl
+void ofxWinDialog::CompileTemplate(int width, int height)
+{
+	// Dialog base units for pixel to dialog unit conversion
+	// Approximate for a custom font. The exact pixel
+	// positions are set after creation.
+	LONG units = GetDialogBaseUnits();
+	int bx = LOWORD(units);
+	int by = HIWORD(units);
+	auto dx = [bx](int pixels) { return DialogTemplate::PixelsToDialogUnits(pixels, bx, 4); };
+	auto dy = [by](int pixels) { return DialogTemplate::PixelsToDialogUnits(pixels, by, 8); };
+
+	// Child dialog without WS_VISIBLE
+	// It is shown when the controls are in position
+	int pointsize = (!fontname.empty() && fontheight > 0) ? (int)fontheight : 0;
+	// Titles are ANSI text as for CreateWindowExA
+	g_Template.SetConverter(AnsiToUtf16);
+	g_Template.Begin(WS_CHILD | DS_CONTROL, WS_EX_CONTROLPARENT,
+		0, 0, dx(width), dy(height), "", pointsize, (int)fontweight, fontname);
+	g_TemplateItems.clear();
+
+	uint32_t ID = 1000; // As Open
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (!g_Pages.IsShown(controls[i].Page))
+			continue;
+
+		const ctl &c = controls[i];
+		int x = dx(c.X);
+		int y = dy(c.Y);
+		int cx = dx(c.Width);
+		int cy = dy(c.Height);
+		templateitem item;
+		item.control = i;
+
+		// Button text is independent of the title
+		// If the text string is empty, the title is used.
+		std::string str = c.Text;
+		if (str.empty()) str = c.Title;
+
+		if (c.Type == "Checkbox") {
+			DWORD dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD | BS_CHECKBOX | BS_AUTOCHECKBOX;
+			dwStyle |= (c.Style > 0) ? c.Style : BS_LEFT;
+			g_Template.AddItem(dwStyle, 0, x, y, cx, cy, ID, DialogTemplate::Button, str);
+		}
+		else if (c.Type == "Radio") {
+			DWORD dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD | BS_AUTORADIOBUTTON;
+			if (c.First == 1)
+				dwStyle |= WS_GROUP;
+			dwStyle |= (c.Style > 0) ? c.Style : BS_LEFT;
+			g_Template.AddItem(dwStyle, 0, x, y, cx, cy, ID, DialogTemplate::Button, str);
+		}
+		else if (c.Type == "Slider") {
+			DWORD dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD | TBS_HORZ;
+			dwStyle |= (c.Tick > 0.0f) ? TBS_AUTOTICKS : TBS_NOTICKS;
+			g_Template.AddItem(dwStyle, 0, x, y, cx, cy, ID, TRACKBAR_CLASSA, c.Title);
+			// Slider value text to the right
+			if (c.Index > 0) {
+				g_TemplateItems.push_back(item);
+				item.part = 1;
+				g_Template.AddItem(WS_VISIBLE | WS_CHILD | SS_RIGHT, 0,
+					dx(c.X + c.Width), y, dx(g_Dpi.Scale(40)), cy, 0, DialogTemplate::Static, "0");
+			}
+		}
+		else if (c.Type == "Edit") {
+			DWORD dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD | ES_AUTOHSCROLL | c.Style;
+			g_Template.AddItem(dwStyle, WS_EX_CLIENTEDGE, x, y, cx, cy, ID, DialogTemplate::Edit, c.Text);
+		}
+		else if (c.Type == "Spin") {
+			// Static text buddy without the spin control alignment styles
+			DWORD dwStyle = WS_CHILD | WS_VISIBLE;
+			if (c.Style > 0)
+				dwStyle |= (c.Style & ~(UDS_ALIGNLEFT | UDS_ALIGNRIGHT));
+			g_Template.AddItem(dwStyle, 0, x, y, cx, cy, ID, DialogTemplate::Static, "0");
+			g_TemplateItems.push_back(item);
+			// Spin control sized to fit the buddy window
+			dwStyle = WS_CHILD | WS_VISIBLE | UDS_SETBUDDYINT | UDS_AUTOBUDDY;
+			if (c.Style > 0 && (c.Style & UDS_ALIGNLEFT) == UDS_ALIGNLEFT)
+				dwStyle |= (c.Style & ~UDS_WRAP) | UDS_ALIGNLEFT;
+			else if (c.Style > 0)
+				dwStyle |= (c.Style & ~UDS_WRAP) | UDS_ALIGNRIGHT;
+			else
+				dwStyle |= UDS_ALIGNRIGHT;
+			item.part = 1;
+			g_Template.AddItem(dwStyle, 0, 0, 0, 0, 0, ID, UPDOWN_CLASSA, c.Title);
+		}
+		else if (c.Type == "Combo") {
 			DWORD dwStyle = WS_TABSTOP | CBS_HASSTRINGS | WS_CHILD | WS_OVERLAPPED | WS_VISIBLE;
-			if (controls[i].Style > 0)
-				dwStyle |= controls[i].Style;
+			dwStyle |= (c.Style > 0) ? c.Style : CBS_DROPDOWNLIST;
+			g_Template.AddItem(dwStyle, WS_EX_CLIENTEDGE, x, y, cx, cy, ID, DialogTemplate::ComboBox, c.Title);
+		}
+		else if (c.Type == "List") {
+			DWORD dwStyle = WS_TABSTOP | WS_HSCROLL | WS_VSCROLL | LBS_NOINTEGRALHEIGHT | LBS_NOTIFY | WS_CHILD | WS_OVERLAPPED | WS_VISIBLE;
+			if (c.Store >= 0)
+				dwStyle |= LBS_NODATA | LBS_OWNERDRAWFIXED;
+			g_Template.AddItem(dwStyle, WS_EX_CLIENTEDGE, x, y, cx, cy, ID, DialogTemplate::ListBox, c.Title);
+		}
+		else if (c.Type == "Button") {
+			DWORD dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD;
+			if (c.Style > 0)
+				dwStyle |= c.Style;
+			g_Template.AddItem(dwStyle, 0, x, y, cx, cy, ID, DialogTemplate::Button, str);
+		}
+		else if (c.Type == "Group") {
+			g_Template.AddItem(WS_CHILD | WS_VISIBLE | BS_GROUPBOX, 0, x, y, cx, cy, ID, DialogTemplate::Button, c.Text);
+		}
+		else if (c.Type == "Static") {
+			DWORD dwStyle = WS_VISIBLE | WS_CHILD;
+			dwStyle |= (c.Style > 0) ? c.Style : SS_LEFT;
+			g_Template.AddItem(dwStyle, 0, x, y, cx, cy, ID, DialogTemplate::Static, c.Text);
+		}
+		else {
+			continue;
+		}
+		g_TemplateItems.push_back(item);
+		ID++;
+	}
+}
+
+// Create the control windows from the dialog template
+// Returns the child dialog or NULL if it could not be created
+HWND ofxWinDialog::CreateFromTemplate(HWND hwnd)
+{
+	RECT rect{};
+	GetClientRect(hwnd, &rect);
+	int width = rect.right - rect.left;
+	int height = rect.bottom - rect.top;
+
+	// Compile the template if the controls have changed
+	uint64_t key = GetTemplateKey(width, height);
+	if (g_Template.Empty() || key != g_TemplateKey) {
+		CompileTemplate(width, height);
+		g_TemplateKey = key;
+	}
+	if (g_TemplateItems.empty())
+		return NULL;
+
+	HWND hwndt = CreateDialogIndirectParamW(m_hInstance,
+		(LPCDLGTEMPLATEW)g_Template.Data().data(), hwnd,
+		TemplateDialogProc, (LPARAM)this);
+	if (!hwndt)
+		return NULL;
+	SetWindowPos(hwndt, NULL, 0, 0, width, height, SWP_NOZORDER | SWP_NOACTIVATE);
+	// Controls are scaled with the dialog window (SetDialogDpi)
+	SetDialogDpiChangeBehavior(hwndt, DDC_DISABLE_ALL, DDC_DISABLE_ALL);
+
+	// Control windows are created in template order
+	HDWP hdwp = BeginDeferWindowPos((int)g_TemplateItems.size());
+	HWND hwndc = GetWindow(hwndt, GW_CHILD);
+	for (size_t k = 0; k < g_TemplateItems.size() && hwndc; k++) {
+		size_t i = g_TemplateItems[k].control;
+		ctl &c = controls[i];
+		int x = c.X;
+		int y = c.Y;
+		int cx = c.Width;
+		int cy = c.Height;
+		if (g_TemplateItems[k].part == 0) {
+			// Main control window, or the spin control buddy
+			c.ID = (uint64_t)GetDlgCtrlID(hwndc);
+			c.hwndControl = hwndc;
+			c.hwndSliderVal = NULL;
+		}
+		else if (c.Type == "Slider") {
+			c.hwndSliderVal = hwndc;
+			x = c.X + c.Width;
+			cx = g_Dpi.Scale(40);
+		}
+		else {
+			// Spin control - positioned by its buddy
+			c.hwndControl = hwndc;
+			hwndc = GetWindow(hwndc, GW_HWNDNEXT);
+			continue;
+		}
+		if (hdwp)
+			hdwp = DeferWindowPos(hdwp, hwndc, NULL, x, y, cx, cy, SWP_NOZORDER | SWP_NOACTIVATE);
+		hwndc = GetWindow(hwndc, GW_HWNDNEXT);
+	}
+	if (hdwp)
+		EndDeferWindowPos(hdwp);
+
+	// Control values after the last window of each control
+	for (size_t k = 0; k < g_TemplateItems.size(); k++) {
+		size_t i = g_TemplateItems[k].control;
+		if (k + 1 < g_TemplateItems.size() && g_TemplateItems[k + 1].control == i)
+			continue;
+		InitTemplateControl(i);
+		g_NextID = (std::max)(g_NextID, (uint64_t)controls[i].ID + 1);
+	}
+
+	ShowWindow(hwndt, SW_SHOWNA);
+	return hwndt;
+}
+
+// Values of a control created from the dialog template
+// As for CreateControl
+void ofxWinDialog::InitTemplateControl(size_t i)
+{
+	HWND hwndc = controls[i].hwndControl;
+	if (!hwndc)
+		return;
+
+	if (controls[i].Type == "Checkbox" || controls[i].Type == "Radio") {
+		SendMessage(hwndc, BM_SETCHECK, controls[i].Val, 0);
+	}
+
+	if (controls[i].Type == "Slider") {
+		SendMessage(hwndc, TBM_SETRANGE, TRUE, MAKELONG(
+			SliderScale::ToPosition(controls[i].Min, controls[i].Min, controls[i].Max),
+			SliderScale::ToPosition(controls[i].Max, controls[i].Min, controls[i].Max)));
+		SendMessage(hwndc, TBM_SETPOS, TRUE, SliderScale::ToPosition(controls[i].SliderVal, controls[i].Min, controls[i].Max));
+		SendMessage(hwndc, TBM_SETPAGESIZE, 0, SliderScale::PageSize(controls[i].Min, controls[i].Max)); // 5% range
+		if (controls[i].Tick > 0.0f) {
+			if ((controls[i].Max - controls[i].Min) > 1000.0)
+				SendMessage(hwndc, TBM_SETTICFREQ, (int)(controls[i].Tick), 0);
 			else
-				dwStyle |= CBS_DROPDOWNLIST;
-            hwndc = CreateWindowExA(WS_EX_CLIENTEDGE, "COMBOBOX", controls[i].Title.c_str(),
-                dwStyle, controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
-                hwnd, (HMENU)ID, m_hInstance, NULL);
-
-            if (hwndc) {
-                // Add combo box items
-				if (!controls[i].Items.empty() && controls[i].Items.size() > 0) {
-                    for (size_t j = 0; j<controls[i].Items.size(); j++) {
-                        // Item string is wide chars for unicode and multi-byte
-                        wchar_t itemstr[MAX_PATH]{};
-                        mbstowcs_s(NULL, itemstr, controls[i].Items[j].c_str(), MAX_PATH);
-                        SendMessageW(hwndc, (UINT)CB_ADDSTRING, (WPARAM)0, (LPARAM)itemstr);
-                    }
-                }
+				SendMessage(hwndc, TBM_SETTICFREQ, (int)(controls[i].Tick*100.0f), 0);
+		}
+		g_Core.SliderText(i);
+	}
 
-                // Display an initial item in the selection field
-                SendMessage(hwndc, CB_SETCURSEL, (WPARAM)controls[i].Index, (LPARAM)0);
+	if (controls[i].Type == "Spin") {
+		// Align with the buddy window at its final position
+		HWND hwndBuddy = GetWindow(hwndc, GW_HWNDPREV);
+		if (hwndBuddy)
+			SendMessage(hwndc, UDM_SETBUDDY, (WPARAM)hwndBuddy, 0L);
+		SendMessageA(hwndc, (UINT)UDM_SETRANGE, 0, MAKELPARAM(controls[i].Max, controls[i].Min));
+		SendMessageA(hwndc, (UINT)UDM_SETPOS, 0, (LPARAM)controls[i].Val);
+	}
 
-                // Select all text in the edit field
-				if((dwStyle & CBS_DROPDOWN) == CBS_DROPDOWN)
-					SendMessage(hwndc, CB_SETEDITSEL, 0, MAKELONG(0, -1));
+	if (controls[i].Type == "Combo") {
+		if (!controls[i].Items.empty())
+			InsertItems(hwndc, true, controls[i].Items);
+		SendMessage(hwndc, CB_SETCURSEL, (WPARAM)controls[i].Index, (LPARAM)0);
+		if ((GetWindowLong(hwndc, GWL_STYLE) & CBS_DROPDOWN) == CBS_DROPDOWN)
+			SendMessage(hwndc, CB_SETEDITSEL, 0, MAKELONG(0, -1));
+	}
 
-                controls[i].hwndControl = hwndc;
-                controls[i].ID = ID;
+	if (controls[i].Type == "List") {
+		if (controls[i].Store >= 0)
+			SendMessage(hwndc, LB_SETCOUNT, (WPARAM)g_Stores[controls[i].Store].Size(), 0L);
+		else if (!controls[i].Items.empty() && !IsListFiltered(controls[i]))
+			InsertItems(hwndc, false, controls[i].Items);
+		SendMessage(hwndc, LB_SETCURSEL, (WPARAM)controls[i].Index, (LPARAM)0);
+		if (IsListFiltered(controls[i]))
+			ApplyListFilter(controls[i]);
+	}
+}
 
-                ID++;
-            }
-        }
-				
-		//
-		// List box control
-		//
-		if (controls[i].Type == "List") {
-			
-			hwndc = CreateWindowExA(WS_EX_CLIENTEDGE, "LISTBOX", controls[i].Title.c_str(),
-				WS_TABSTOP | WS_HSCROLL | WS_VSCROLL | LBS_NOINTEGRALHEIGHT | LBS_NOTIFY | WS_CHILD | WS_OVERLAPPED | WS_VISIBLE,
-				controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
-				hwnd, (HMENU)ID, m_hInstance, NULL);
+// Parent window of the controls
+HWND ofxWinDialog::GetControlParent()
+{
+	return g_hwndTemplate ? g_hwndTemplate : m_hDialog;
+}
 
-			if (hwndc) {
-				// Add list box items
-				if (!controls[i].Items.empty() && controls[i].Items.size() > 0) {
-					for (size_t j = 0; j < controls[i].Items.size(); j++) {
-						// Item string is wide chars for unicode and multi-byte
-						wchar_t itemstr[MAX_PATH] {};
-						mbstowcs_s(NULL, itemstr, controls[i].Items[j].c_str(), MAX_PATH);
-						int pos = (int)SendMessageW(hwndc, (UINT)LB_ADDSTRING, (WPARAM)0, (LPARAM)itemstr);
-						// Set the index associated with the item
-						SendMessage(hwndc, LB_SETITEMDATA, pos, (LPARAM)j);
-						// Retrieve the index with LB_GETITEMDATA
-					}
-				}
+//
+// Pages
+//
+// Controls on pages are described by Add functions as usual.
+// Open creates only the windows of controls on the current page
+// and controls not on a page. ShowPage creates the windows of a
+// page the first time it is shown and hides the previous page.
+// If a page cache size is set, windows of the pages shown least
+// recently are destroyed after their values have been saved.
+//
+void ofxWinDialog::AddPage(std::string name)
+{
+	ClosePage();
+	g_AddPage = g_Pages.Add(name);
+	g_PageFirst = controls.size();
+}
 
-				// Highlight the current selection (controls[i].Index when added)
-				SendMessage(hwndc, LB_SETCURSEL, (WPARAM)controls[i].Index, (LPARAM)0);
+void ofxWinDialog::EndPage()
+{
+	ClosePage();
+}
 
-				controls[i].hwndControl = hwndc;
-				controls[i].ID = ID;
-				ID++;
-			}
+// Show a page
+void ofxWinDialog::ShowPage(std::string name)
+{
+	ClosePage();
+	int page = g_Pages.Find(name);
+	if (page < 0)
+		return;
+
+	// The page is shown when the dialog is opened
+	if (!m_hDialog || !IsWindow(m_hDialog)) {
+		g_Pages.SetCurrent(page);
+		return;
+	}
+	if (page == g_Pages.GetCurrent() && g_Pages.IsCreated(page))
+		return;
+
+	PageSet::change change = g_Pages.Show(page);
+
+	SendMessage(m_hDialog, WM_SETREDRAW, FALSE, 0L);
+	if (change.hide >= 0) {
+		for (int c : g_Pages.GetControls(change.hide))
+			ShowControl((size_t)c, false);
+	}
+	for (size_t p = 0; p < change.destroy.size(); p++) {
+		for (int c : g_Pages.GetControls(change.destroy[p]))
+			DestroyControl((size_t)c);
+	}
+	for (int c : g_Pages.GetControls(page)) {
+		if (change.bCreate) {
+			CreateControl((size_t)c, GetControlParent(), g_NextID);
+			InitControl((size_t)c);
+			SyncControlHandles((size_t)c);
+		}
+		else {
+			ShowControl((size_t)c, true);
 		}
+	}
+	UpdateHoverIndex();
+	SendMessage(m_hDialog, WM_SETREDRAW, TRUE, 0L);
+
+	// Group frames of the new page are drawn in the back buffer
+	if (bDoubleBuffer && g_hdcBack)
+		g_Dirty.Add(0, 0, g_BackSize.GetBufferWidth(), g_BackSize.GetBufferHeight());
+	RedrawWindow(m_hDialog, NULL, NULL, RDW_ERASE | RDW_INVALIDATE | RDW_ALLCHILDREN);
+}
+
+// Name of the current page
+std::string ofxWinDialog::GetPage()
+{
+	return g_Pages.GetName(g_Pages.GetCurrent());
+}
+
+// Maximum number of pages with control windows
+void ofxWinDialog::SetPageCache(int maxpages)
+{
+	g_Pages.SetMaxCreated(maxpages);
+}
+
+// Assign the controls added since AddPage to the page
+void ofxWinDialog::ClosePage()
+{
+	if (g_AddPage < 0)
+		return;
+	for (size_t i = g_PageFirst; i < controls.size(); i++) {
+		controls[i].Page = g_AddPage;
+		g_Pages.AddControl(g_AddPage, (int)i);
+	}
+	g_AddPage = -1;
+}
+
+// Theme and font for a control created after Open
+void ofxWinDialog::InitControl(size_t i)
+{
+	if (!controls[i].hwndControl)
+		return;
+	if (!controls[i].VisualStyle)
+		SetWindowTheme(controls[i].hwndControl, L"", L"");
+	if (g_hFont && !fontname.empty() && fontheight > 0) {
+		SendMessage(controls[i].hwndControl, WM_SETFONT, (WPARAM)g_hFont, (LPARAM)MAKELONG(TRUE, 0));
+		if (controls[i].hwndSliderVal)
+			SendMessage(controls[i].hwndSliderVal, WM_SETFONT, (WPARAM)g_hFont, (LPARAM)MAKELONG(TRUE, 0));
+	}
+}
+
+// Show or hide the windows of a control
+void ofxWinDialog::ShowControl(size_t i, bool bShow)
+{
+	int cmd = bShow ? SW_SHOW : SW_HIDE;
+	// Double buffered group frames are drawn and the window is not shown
+	if (controls[i].hwndControl && !(bDoubleBuffer && controls[i].Type == "Group"))
+		ShowWindow(controls[i].hwndControl, cmd);
+	if (controls[i].hwndSliderVal)
+		ShowWindow(controls[i].hwndSliderVal, cmd);
+	// Spin control static text buddy
+	if (controls[i].Type == "Spin" && controls[i].hwndControl) {
+		HWND hwndBuddy = (HWND)SendMessage(controls[i].hwndControl, UDM_GETBUDDY, 0, 0L);
+		if (hwndBuddy)
+			ShowWindow(hwndBuddy, cmd);
+	}
+}
+
+// Save the value of a control and destroy its windows
+void ofxWinDialog::DestroyControl(size_t i)
+{
+	HWND hwndc = controls[i].hwndControl;
+	if (!hwndc)
+		return;
+
+	// Values that are not updated by control messages
+	if (controls[i].Type == "Edit") {
+		int len = GetWindowTextLengthA(hwndc);
+		std::string text(len + 1, '\0');
+		GetWindowTextA(hwndc, &text[0], len + 1);
+		text.resize(len);
+		controls[i].Text = text;
+	}
+	if (controls[i].Type == "Spin") {
+		controls[i].Val = (int)SendMessage(hwndc, UDM_GETPOS, 0, 0L);
+		HWND hwndBuddy = (HWND)SendMessage(hwndc, UDM_GETBUDDY, 0, 0L);
+		if (hwndBuddy)
+			DestroyWindow(hwndBuddy);
+	}
+
+	if (controls[i].hwndSliderVal)
+		DestroyWindow(controls[i].hwndSliderVal);
+	DestroyWindow(hwndc);
+	controls[i].hwndControl = NULL;
+	controls[i].hwndSliderVal = NULL;
+	SyncControlHandles(i);
+}
+
+// Window handles of the reset and restore controls
+void ofxWinDialog::SyncControlHandles(size_t i)
+{
+	if (i < newcontrols.size()) {
+		newcontrols[i].hwndControl = controls[i].hwndControl;
+		newcontrols[i].ID = controls[i].ID;
+		newcontrols[i].hwndSliderVal = controls[i].hwndSliderVal;
+	}
+	if (i < oldcontrols.size()) {
+		oldcontrols[i].hwndControl = controls[i].hwndControl;
+		oldcontrols[i].ID = controls[i].ID;
+		oldcontrols[i].hwndSliderVal = controls[i].hwndSliderVal;
+	}
+}
+
+//
+// Automatic layout
+//
+// Controls added while a layout box is open are items of the box
+// with their width and height as the minimum size (LayoutTree).
+// The layout is arranged for the client area by Open and on WM_SIZE.
+// Only the controls with a new rectangle are moved, and all of their
+// windows are moved by one DeferWindowPos batch. Control positions
+// are updated so that windows created later by ShowPage or the
+// dialog template are at the layout position.
+//
+void ofxWinDialog::LayoutRow(int spacing)
+{
+	LayoutBox(LayoutTree::Row, spacing, 1);
+}
+
+void ofxWinDialog::LayoutColumn(int spacing)
+{
+	LayoutBox(LayoutTree::Column, spacing, 1);
+}
 
-        //
-        // Push button
-        //
-        if (controls[i].Type == "Button") {
-            
-            // Text in the button is independent of the title
-            // If the text string is empty, the title is used.
-            std::string str = controls[i].Text.c_str();
-            if (str.empty()) str = controls[i].Title;
-
-            DWORD dwStyle = WS_TABSTOP | WS_VISIBLE | WS_CHILD;
-            // The button control style can be specified as default
-            // BS_DEFPUSHBUTTON (1) default style is BS_PUSHBUTTON (0)
-            // For example the OK button is usually the default.
-            if (controls[i].Style > 0)
-                dwStyle |= controls[i].Style;
-
-            hwndc = CreateWindowExA(0, "BUTTON", str.c_str(),
-                dwStyle,
-                controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
-                hwnd, (HMENU)ID, m_hInstance, NULL);
-            if (hwndc) {
-                controls[i].hwndControl = hwndc;
-                controls[i].ID = ID;
-                ID++;
-            }
-        }
+// Grid with a number of columns
+// Controls fill the cells left to right and top to bottom
+void ofxWinDialog::LayoutGrid(int columns, int spacing)
+{
+	LayoutBox(LayoutTree::Grid, spacing, columns);
+}
 
-        //
-        // Group box
-        //
-        if (controls[i].Type == "Group") {
-            hwndc = CreateWindowExA(0, "BUTTON", controls[i].Text.c_str(),
-                WS_VISIBLE | WS_CHILD | BS_GROUPBOX,
-                controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
-                hwnd, (HMENU)ID, m_hInstance, NULL);
-            if (hwndc) {
-                controls[i].hwndControl = hwndc;
-                controls[i].ID = ID;
-                ID++;
-            }
-        }
+// Label and control
+void ofxWinDialog::LayoutPair(int spacing)
+{
+	LayoutBox(LayoutTree::Pair, spacing, 1);
+}
 
-        //
-        // Static text
-        //
-        if (controls[i].Type == "Static") {
-
-            // Default style is left aligned (SS_LEFT)
-            // Additional styles can be specified
-            //	SS_CENTER - centered
-            //	SS_RIGHT  - right aligned
-            //	WS_BORDER - outlined
-            //	SS_SUNKEN - sunken edge
-            DWORD dwStyle = WS_VISIBLE | WS_CHILD;
-            if (controls[i].Style > 0)
-                dwStyle |= controls[i].Style;
-            else
-                dwStyle |= SS_LEFT;
-
-            hwndc = CreateWindowExA(0, "STATIC", controls[i].Text.c_str(),
-                dwStyle,
-                controls[i].X, controls[i].Y, controls[i].Width, controls[i].Height,
-                hwnd, (HMENU)ID, m_hInstance, NULL);
-
-            if (hwndc) {
-                controls[i].hwndControl = hwndc;
-                controls[i].ID = ID;
-                ID++;
-            }
-        }
-    } // end all controls
+// End the current layout box
+void ofxWinDialog::LayoutEnd()
+{
+	FlushLayout();
+	if (g_LayoutDepth == 0)
+		return;
+	g_LayoutBox = g_Layout.GetParent(g_LayoutBox);
+	g_LayoutDepth--;
+}
 
-	    
-    // Disable Visual Styles if flag is set
-    // DisableTheme(std::string type, std::string title)
-    for (size_t i=0; i<controls.size(); i++) {
-        if (!controls[i].VisualStyle) {
-            SetWindowTheme(controls[i].hwndControl, L"", L"");
-        }
-    }
-    
+// Stretch factors of the control or box added last
+void ofxWinDialog::LayoutStretch(float horizontal, float vertical)
+{
+	FlushLayout();
+	int node = g_Layout.GetLastChild(g_LayoutBox);
+	if (node >= 0)
+		g_Layout.SetStretch(node, horizontal, vertical);
+}
 
-    //
-    // Save all controls
-    //
+// Space between the layout and the dialog edges
+void ofxWinDialog::LayoutMargin(int margin)
+{
+	g_Layout.SetMargin(margin);
+}
 
-    // Original controls for reset
-    if (newcontrols.empty()) {
-        newcontrols = controls;
-    }
-    else {
-        // Update window handles for a new dialog
-        for (size_t i=0; i<controls.size(); i++) {
-            // Control handles
-            newcontrols[i].hwndControl = controls[i].hwndControl;
-            // Control ID
-            newcontrols[i].ID = controls[i].ID;
-            // Slider value text display
-            newcontrols[i].hwndSliderVal = controls[i].hwndSliderVal;
-        }
-    }
+// Time taken by the last layout (msec)
+double ofxWinDialog::GetLayoutTime()
+{
+	return g_LayoutTime;
+}
 
-    // Old controls for restore (Cancel)
-    oldcontrols = controls;
+// Start a layout box in the current box
+void ofxWinDialog::LayoutBox(int kind, int spacing, int columns)
+{
+	FlushLayout();
+	int box = g_Layout.AddBox(g_LayoutBox, kind, spacing, columns);
+	if (box < 0)
+		return;
+	g_LayoutBox = box;
+	g_LayoutDepth++;
+}
 
-    // Custom dialog font
-    if (!fontname.empty() && fontheight > 0) {
+// Add the controls added since the last layout call to the current box
+void ofxWinDialog::FlushLayout()
+{
+	if (g_LayoutDepth > 0)
+		g_Core.AddToLayout(g_Layout, g_LayoutBox, g_LayoutFirst);
+	g_LayoutFirst = controls.size();
+}
 
-         LOGFONTA logFont{};
-         logFont.lfWeight = fontweight;
-		 logFont.lfHeight = fontheight;
-         logFont.lfCharSet = ANSI_CHARSET;
-         logFont.lfQuality = DEFAULT_QUALITY;
-         strcpy_s(logFont.lfFaceName, 32, fontname.c_str());
+// Arrange the layout for the client area
+// Returns true if controls have moved
+bool ofxWinDialog::ArrangeLayout(int width, int height)
+{
+	if (g_Layout.Empty())
+		return false;
+	auto start = std::chrono::steady_clock::now();
 
-		 //
-		 // Font height is in dialog units
-		 // Convert from dialog units to logical units and adjust for screen dpi.
-		 // https://learn.microsoft.com/en-us/windows/win32/api/wingdi/ns-wingdi-logfonta
-		 //
-		 //
-		 // Get the screen DPI
-		 HDC hdc = GetDC(NULL);
-		 int dpi = GetDeviceCaps(hdc, LOGPIXELSY);
-		 ReleaseDC(NULL, hdc);
+	// The layout is at 96 DPI and scaled for the dialog DPI
+	bool bMoved = g_Core.Arrange(g_Layout, g_Dpi, width, height, g_Placed);
+
+	g_LayoutTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return bMoved;
+}
 
-		 // Calculate the logical font height based on
-		 // the screen dpi and number of dialog points per inch (72)
-		 // A negative value ensures that the font scaling is
-		 // dynamic and adjusts for the DPI.
-		 logFont.lfHeight = -MulDiv(fontheight, dpi, 72);
+//
+// DPI scaling
+//
+// Positions and sizes given by the Add functions are at 96 DPI and are
+// kept as the design values of each control. X, Y, Width and Height
+// are scaled from them for the dialog DPI at Open and on WM_DPICHANGED,
+// so moving between monitors does not add rounding errors. Only the
+// controls with a new position or size are moved.
+//
 
-         // Create the font
-         HFONT hFont = CreateFontIndirectA(&logFont);
+// DPI of the dialog
+int ofxWinDialog::GetDpi()
+{
+	return g_Dpi.Get();
+}
 
-		 // Save the font handle to retrieve with GetFont
-		 g_hFont = hFont;
+// Scale factor of the dialog (1.0 = 100%)
+double ofxWinDialog::GetScale()
+{
+	return g_Dpi.GetScale();
+}
 
-         // Set the font for the dialog and all controls
-         SendMessage(hwnd, WM_SETFONT, (WPARAM)hFont, (LPARAM)MAKELONG(TRUE, 0));
-         for (size_t i=0; i<controls.size(); i++) {
-             SendMessage(controls[i].hwndControl, WM_SETFONT, (WPARAM)hFont, (LPARAM)MAKELONG(TRUE, 0));
-             if (controls[i].hwndSliderVal)
-                 SendMessage(controls[i].hwndSliderVal, WM_SETFONT, (WPARAM)hFont, (LPARAM)MAKELONG(TRUE, 0));
-         }
-    }
+// Scale the dialog for a new DPI (WM_DPICHANGED)
+void ofxWinDialog::SetDialogDpi(int dpi)
+{
+	if (dpi <= 0 || dpi == g_Dpi.Get() || !m_hDialog)
+		return;
+	g_Dpi.Set(dpi);
+
+	SendMessage(m_hDialog, WM_SETREDRAW, FALSE, 0L);
+	g_Core.ScaleControls(g_Dpi, true);
+	// The layout is arranged again for the new window size
+	g_Layout.Invalidate();
+
+	// Font for the DPI from the GDI object cache
+	if (!fontname.empty() && fontheight > 0) {
+		g_hFont = DialogFont();
+		SendMessage(m_hDialog, WM_SETFONT, (WPARAM)g_hFont, (LPARAM)MAKELONG(TRUE, 0));
+		for (size_t i = 0; i < controls.size(); i++) {
+			if (controls[i].hwndControl)
+				SendMessage(controls[i].hwndControl, WM_SETFONT, (WPARAM)g_hFont, (LPARAM)MAKELONG(TRUE, 0));
+			if (controls[i].hwndSliderVal)
+				SendMessage(controls[i].hwndSliderVal, WM_SETFONT, (WPARAM)g_hFont, (LPARAM)MAKELONG(TRUE, 0));
+		}
+	}
+	UpdateHoverIndex();
+	SendMessage(m_hDialog, WM_SETREDRAW, TRUE, 0L);
 
-	// Open minimized or hidden if the option is set
-	if(bMinimize)
-		ShowWindow(hwnd, SW_MINIMIZE);
-	else if (bHide)
-		ShowWindow(hwnd, SW_HIDE);
-	else
-		ShowWindow(hwnd, SW_SHOWNORMAL);
+	if (bDoubleBuffer && g_hdcBack)
+		g_Dirty.Add(0, 0, g_BackSize.GetBufferWidth(), g_BackSize.GetBufferHeight());
+	RedrawWindow(m_hDialog, NULL, NULL, RDW_ERASE | RDW_INVALIDATE | RDW_ALLCHILDREN);
+}
 
-    UpdateWindow(hwnd);
+// Move the windows of controls to their position and size
+// All windows are moved by one DeferWindowPos batch
+void ofxWinDialog::MoveControlWindows(const std::vector<size_t> &moved)
+{
+	if (moved.empty())
+		return;
 
-	SetFocus(hwnd);
+	// Spin control buddy windows and slider value text are moved
+	// with the control so allow two windows for each control
+	HDWP hdwp = BeginDeferWindowPos((int)moved.size() * 2);
+	for (size_t k = 0; k < moved.size() && hdwp; k++) {
+		const ctl &c = controls[moved[k]];
+		// Controls without windows are created at the new position
+		if (!c.hwndControl)
+			continue;
+		HWND hwndc = c.hwndControl;
+		if (c.Type == "Spin") {
+			// The spin control is aligned to its buddy window
+			hwndc = (HWND)SendMessage(c.hwndControl, UDM_GETBUDDY, 0, 0L);
+			if (!hwndc)
+				continue;
+		}
+		hdwp = DeferWindowPos(hdwp, hwndc, NULL, c.X, c.Y, c.Width, c.Height, SWP_NOZORDER | SWP_NOACTIVATE);
+		if (hdwp && c.hwndSliderVal)
+			hdwp = DeferWindowPos(hdwp, c.hwndSliderVal, NULL, c.X + c.Width, c.Y, g_Dpi.Scale(40), c.Height, SWP_NOZORDER | SWP_NOACTIVATE);
+	}
+	if (hdwp)
+		EndDeferWindowPos(hdwp);
+
+	// Align spin controls to the new buddy position
+	for (size_t k = 0; k < moved.size(); k++) {
+		const ctl &c = controls[moved[k]];
+		if (c.Type == "Spin" && c.hwndControl) {
+			HWND hwndBuddy = (HWND)SendMessage(c.hwndControl, UDM_GETBUDDY, 0, 0L);
+			if (hwndBuddy)
+				SendMessage(c.hwndControl, UDM_SETBUDDY, (WPARAM)hwndBuddy, 0L);
+		}
+	}
 
-    return hwnd;
+	// Hover rectangles of owner draw buttons
+	if (m_hDialog)
+		UpdateHoverIndex();
+}
 
+// Dialog font for the dialog DPI
+// The GDI object cache keeps one font for each DPI
+HFONT ofxWinDialog::DialogFont()
+{
+	return (HFONT)g_Gdi.Font(fontname, DpiScale::FontHeight((int)fontheight, g_Dpi.Get()), (int)fontweight);
 }
 
 // Close the dialog window
 void ofxWinDialog::Close()
 {
+    TraceScope span(g_TraceLog, "Close", "dialog");
     if (m_hDialog && IsWindow(m_hDialog)) {
         // Bring the app window to the top
 		if (m_hwnd && IsWindow(m_hwnd)) {
@@ -2339,8 +6127,39 @@ void ofxWinDialog::AppDialogFunction(void(ofApp::* function)(std::string title,
 // Pass back the dialog item title and state to ofApp
 void ofxWinDialog::DialogFunction(std::string title, std::string text, int value)
 {
-    if(pApp && pAppDialogFunction)
+    if (bRecording)
+        RecordEvent(EventTrace::Event, title, text, value);
+    // Shared parameters bound to the control (BindParameter)
+    if (bParams)
+        PublishParameters(title);
+    // Slider and checkbox changes to the control surface (StartOsc)
+    if (bOscSend && !bOscApplying)
+        SendOsc(title);
+    // Queued by the dialog thread for PollEvents (UseThread)
+    if (bUseThread && g_DialogThreadId.load() == GetCurrentThreadId()) {
+        DialogEvent e;
+        e.title = title;
+        e.text = text;
+        e.value = value;
+        g_Events.Push(std::move(e));
+        return;
+    }
+    AppCallback(title, text, value);
+}
+
+// Call the ofApp callback function
+void ofxWinDialog::AppCallback(const std::string &title, const std::string &text, int value)
+{
+    if (pApp && pAppDialogFunction) {
+        TraceScope span(g_TraceLog, "Callback", "app", title.c_str());
+        #ifdef statsWinDialog
+        auto start = std::chrono::steady_clock::now();
+        (pApp->*pAppDialogFunction)(title, text, value);
+        g_CallbackStats.Record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        #else
         (pApp->*pAppDialogFunction)(title, text, value);
+        #endif
+    }
 }
 
 // ---------------------------------------------
@@ -2470,19 +6289,170 @@ LRESULT CALLBACK MainWndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 
     // Pass messages on to the class message handling function
     if (pDlg)
-		return pDlg->WindowProc(hwnd, uMsg, wParam, lParam);
+		return pDlg->TimedWindowProc(hwnd, uMsg, wParam, lParam);
 
     // Default message handling
     return DefWindowProc(hwnd, uMsg, wParam, lParam);
 }
 
+#ifdef statsWinDialog
+// Control ID of a control message or 0
+static UINT MessageControl(UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	switch (msg) {
+		case WM_COMMAND:
+			// Not menus or accelerators
+			return lParam ? (UINT)LOWORD(wParam) : 0;
+		case WM_DRAWITEM:
+		case WM_MEASUREITEM:
+			return (UINT)wParam;
+		case WM_NOTIFY:
+			return lParam ? (UINT)((LPNMHDR)lParam)->idFrom : 0;
+		case WM_HSCROLL:
+		case WM_VSCROLL:
+		case WM_CTLCOLORSTATIC:
+		case WM_CTLCOLORBTN:
+		case WM_CTLCOLOREDIT:
+		case WM_CTLCOLORLISTBOX:
+			return lParam ? (UINT)GetDlgCtrlID((HWND)lParam) : 0;
+	}
+	return 0;
+}
+
+// Statistics in microseconds from a histogram in nanoseconds
+static void HistogramStats(const LatencyHistogram &h, ofxWinDialog::latencystats &stats)
+{
+	stats.count = h.Count();
+	stats.mean = h.Mean() / 1000.0;
+	stats.p50 = (double)h.Percentile(50.0) / 1000.0;
+	stats.p90 = (double)h.Percentile(90.0) / 1000.0;
+	stats.p99 = (double)h.Percentile(99.0) / 1000.0;
+	stats.max = (double)h.Max() / 1000.0;
+}
+#endif
+
+//
+// Time WindowProc for each message and control (statsWinDialog)
+//
+LRESULT ofxWinDialog::TimedWindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	#ifdef statsWinDialog
+	auto start = std::chrono::steady_clock::now();
+	LRESULT lr = WindowProc(hwnd, msg, wParam, lParam);
+	uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	g_MessageStats.Record(msg, ns);
+	UINT id = MessageControl(msg, wParam, lParam);
+	if (id > 0)
+		g_ControlStats.Record(id, ns);
+	return lr;
+	#else
+	return WindowProc(hwnd, msg, wParam, lParam);
+	#endif
+}
+
+// Statistics of a message
+bool ofxWinDialog::GetMessageStats(UINT msg, latencystats &stats)
+{
+	stats = latencystats();
+	#ifdef statsWinDialog
+	const LatencyHistogram* h = g_MessageStats.Find(msg);
+	if (!h)
+		return false;
+	HistogramStats(*h, stats);
+	return true;
+	#else
+	(void)msg;
+	return false;
+	#endif
+}
+
+// Messages with times recorded
+std::vector<UINT> ofxWinDialog::GetStatsMessages()
+{
+	std::vector<UINT> messages;
+	#ifdef statsWinDialog
+	std::vector<uint32_t> keys;
+	g_MessageStats.Keys(keys);
+	std::sort(keys.begin(), keys.end());
+	for (size_t i = 0; i < keys.size(); i++)
+		messages.push_back((UINT)keys[i]);
+	#endif
+	return messages;
+}
+
+// Statistics of the messages for the controls with a title
+bool ofxWinDialog::GetControlStats(std::string title, latencystats &stats)
+{
+	stats = latencystats();
+	#ifdef statsWinDialog
+	LatencyHistogram all;
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Title == title && controls[i].ID > 0) {
+			const LatencyHistogram* h = g_ControlStats.Find((uint32_t)controls[i].ID);
+			if (h)
+				all.Merge(*h);
+		}
+	}
+	if (all.Count() == 0)
+		return false;
+	HistogramStats(all, stats);
+	return true;
+	#else
+	(void)title;
+	return false;
+	#endif
+}
+
+// Statistics of the ofApp callback function
+bool ofxWinDialog::GetCallbackStats(latencystats &stats)
+{
+	stats = latencystats();
+	#ifdef statsWinDialog
+	if (g_CallbackStats.Count() == 0)
+		return false;
+	HistogramStats(g_CallbackStats, stats);
+	return true;
+	#else
+	return false;
+	#endif
+}
+
+// Time added to each message by the timing (usec)
+// Measured once with the same clock and histogram update
+double ofxWinDialog::GetStatsOverhead()
+{
+	#ifdef statsWinDialog
+	if (g_StatsOverhead < 0.0) {
+		const int count = 10000;
+		LatencyHistogram h;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < count; i++) {
+			auto t = std::chrono::steady_clock::now();
+			h.Record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t).count());
+		}
+		g_StatsOverhead = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / count;
+	}
+	return g_StatsOverhead;
+	#else
+	return 0.0;
+	#endif
+}
+
+void ofxWinDialog::ResetStats()
+{
+	#ifdef statsWinDialog
+	g_MessageStats.Reset();
+	g_ControlStats.Reset();
+	g_CallbackStats.Reset();
+	#endif
+}
+
 //
 // Class window message handling procedure for multiple dialogs
 //
 LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
     LPDRAWITEMSTRUCT lpdis ={};
-    HCURSOR cursorHand = NULL;
 
     switch (msg) {
 
@@ -2497,11 +6467,67 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 			break;
 
 		case WM_SIZE:
+			// Template child dialog fills the client area (UseTemplate)
+			if (g_hwndTemplate && wParam != SIZE_MINIMIZED)
+				MoveWindow(g_hwndTemplate, 0, 0, LOWORD(lParam), HIWORD(lParam), FALSE);
+			// Automatic layout (LayoutRow, LayoutColumn, LayoutGrid, LayoutPair)
+			if (wParam != SIZE_MINIMIZED)
+				ArrangeLayout(LOWORD(lParam), HIWORD(lParam));
+			if (bDoubleBuffer) {
+				// Retain the buffer while minimized
+				if (wParam == SIZE_MINIMIZED)
+					return 0;
+				// Resize the back buffer and repaint
+				// only the area exposed by the new size
+				int oldwidth = g_BackSize.GetWidth();
+				int oldheight = g_BackSize.GetHeight();
+				int width = LOWORD(lParam);
+				int height = HIWORD(lParam);
+				if (g_hdcBack && g_BackSize.Resize(width, height)) {
+					HDC hdc = GetDC(hwnd);
+					AllocateBackBuffer(hdc, width, height);
+					ReleaseDC(hwnd, hdc);
+				}
+				else {
+					// Right and bottom strips
+					if (width > oldwidth)
+						g_Dirty.Add(oldwidth, 0, width, height);
+					if (height > oldheight)
+						g_Dirty.Add(0, oldheight, width, height);
+				}
+				// Group frames moved by the layout are drawn again
+				if (!g_Placed.empty())
+					g_Dirty.Add(0, 0, width, height);
+				// Group frames are drawn at a fixed position and do not
+				// need repaint, but the window area is invalidated
+				// without erase so that the buffer is copied.
+				InvalidateRect(hwnd, NULL, FALSE);
+				return 0;
+			}
 			// Invalidate the whole window on resize
 			// to prevent repeat draw of border
 			InvalidateRect(hwnd, NULL, TRUE);
 			return 0;
 
+		// Monitor DPI or display scale changed
+		// Controls are scaled and the window is moved
+		// to the suggested position and size
+		case WM_DPICHANGED:
+		{
+			SetDialogDpi(HIWORD(wParam));
+			RECT* prc = (RECT*)lParam;
+			SetWindowPos(hwnd, NULL, prc->left, prc->top,
+				prc->right - prc->left, prc->bottom - prc->top,
+				SWP_NOZORDER | SWP_NOACTIVATE);
+			return 0;
+		}
+
+		case WM_ERASEBKGND:
+			// The back buffer paints the background
+			if (bDoubleBuffer)
+				return 1;
+			break;
+
 		case WM_PAINT:
 		{
 			PAINTSTRUCT ps;
@@ -2509,6 +6535,23 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 			RECT rect;
 			GetClientRect(hwnd, &rect);
 
+			// Double buffered (DoubleBuffer)
+			// Render dirty areas of the back buffer and copy
+			// only the area to be painted to the window
+			if (bDoubleBuffer) {
+				if (!g_hdcBack)
+					AllocateBackBuffer(hdc, rect.right - rect.left, rect.bottom - rect.top);
+				RenderBackBuffer();
+				if (g_hdcBack) {
+					BitBlt(hdc, ps.rcPaint.left, ps.rcPaint.top,
+						ps.rcPaint.right - ps.rcPaint.left,
+						ps.rcPaint.bottom - ps.rcPaint.top,
+						g_hdcBack, ps.rcPaint.left, ps.rcPaint.top, SRCCOPY);
+				}
+				EndPaint(hwnd, &ps);
+				return 0;
+			}
+
 			// Set the Group box caption colour here
 			// because it is not static text
 			for (size_t i = 0; i < controls.size(); i++) {
@@ -2536,36 +6579,25 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 						COLORREF col = Hex2Rgb(controls[i].Index);
 						SetTextColor(hdc, col);
 
-						// Set the text background colour to
-						// a background pixel inside the rectangle
-						int x = rect.left   + 4;
-						int y = rect.bottom - 4;
-						col = GetPixel(hdc, x, y);
-						SetBkColor(hdc, col);
+						// Set the text background colour
+						// to the dialog background colour
+						SetBkColor(hdc, g_BackColor);
 
 						// Grey border slightly darker than normal for better visibility
 						// Other border colours
 						// COLOR_INACTIVECAPTION	: 191, 205, 219
 						// COLOR_ACTIVEBORDER		: 180, 180, 180
 						// CTLCOLOR_MSGBOX			: 200, 200, 200
-						HBRUSH hBrush = CreateSolidBrush(GetSysColor(CTLCOLOR_MSGBOX));
+						HBRUSH hBrush = (HBRUSH)g_Gdi.Brush(GetSysColor(CTLCOLOR_MSGBOX));
 						
 						// Move the top of the rect down to center the top border with the caption
 						rect.top += 10;
 						FrameRect(hdc, &rect, hBrush);
-						DeleteObject(hBrush);
 
 						// Text color for the caption
 						col = Hex2Rgb(controls[i].Index);
 						SetTextColor(hdc, col);
 
-						// Set the text background colour to
-						// the pixel in centre of the rectangle
-						x = (rect.right - rect.left) / 2;
-						y = (rect.bottom - rect.top) / 2;
-						col = GetPixel(hdc, x, y);
-						SetBkColor(hdc, col);
-
 						// Draw the caption text
 						rect.top -= 10;
 						DrawTextA(hdc, controls[i].Title.c_str(), -1, &rect, DT_SINGLELINE | DT_LEFT | DT_TOP);
@@ -2609,6 +6641,47 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 		}
 		break;
 
+		// Changes to watched files (WatchIni, WatchDialog)
+		case WM_DIALOG_RELOAD:
+			ApplyReloads();
+			return 0;
+
+		// Set functions queued by other threads (UseThread)
+		case WM_DIALOG_COMMAND:
+			ApplyCommands();
+			return 0;
+
+		// Messages received by the OSC thread (StartOsc)
+		case WM_DIALOG_OSC:
+			ApplyOsc();
+			return 0;
+
+		// Shared parameters changed by other threads (BindParameter)
+		case WM_DIALOG_PARAMS:
+			ApplyParams();
+			return 0;
+
+		// Rate limited OSC messages (StartOsc) and replay (Replay)
+		case WM_TIMER:
+			if (wParam == IDT_DIALOG_OSC) {
+				FlushOsc();
+				return 0;
+			}
+			if (wParam == IDT_DIALOG_REPLAY) {
+				ReplayDue();
+				return 0;
+			}
+			break;
+
+		// Function sent by another thread (CallDialogThread)
+		case WM_DIALOG_CALL:
+			(*reinterpret_cast<const std::function<void()>*>(lParam))();
+			return 1;
+
+		// Template child dialog background (UseTemplate)
+		case WM_CTLCOLORDLG:
+			return (LRESULT)g_hBrush;
+
         case WM_DRAWITEM:
 
             lpdis = (LPDRAWITEMSTRUCT)lParam;
@@ -2631,10 +6704,31 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 					SetTextColor(lpdis->hDC, RGB(6, 69, 173));
 					DrawTextA(lpdis->hDC, controls[i].Title.c_str(), -1, &lpdis->rcItem, DT_CENTER);
 					// Set a hand cursor
-					cursorHand = LoadCursor(NULL, IDC_HAND);
-					SetClassLongPtr(controls[i].hwndControl, GCLP_HCURSOR, (LONG_PTR)cursorHand);
+					HCURSOR cursorHand = (HCURSOR)g_Gdi.Cursor((uint32_t)(ULONG_PTR)IDC_HAND);
+					if ((HCURSOR)GetClassLongPtr(controls[i].hwndControl, GCLP_HCURSOR) != cursorHand)
+						SetClassLongPtr(controls[i].hwndControl, GCLP_HCURSOR, (LONG_PTR)cursorHand);
 				} // endif hyperlink
 
+				// Virtual list row
+				else if (controls[i].Type == "List"
+					&& controls[i].Store >= 0
+					&& LOWORD(wParam) == controls[i].ID) {
+					HDC hdc = lpdis->hDC;
+					size_t len = 0;
+					// Item shown in the row if the list is filtered
+					int item = ListItemFromRow(controls[i], (int)lpdis->itemID);
+					const char* text = g_Stores[controls[i].Store].Get((size_t)item, &len);
+					bool bSelected = (lpdis->itemState & ODS_SELECTED) != 0;
+					FillRect(hdc, &lpdis->rcItem, GetSysColorBrush(bSelected ? COLOR_HIGHLIGHT : COLOR_WINDOW));
+					SetBkMode(hdc, TRANSPARENT);
+					SetTextColor(hdc, GetSysColor(bSelected ? COLOR_HIGHLIGHTTEXT : COLOR_WINDOWTEXT));
+					RECT rect = lpdis->rcItem;
+					rect.left += 2;
+					DrawTextA(hdc, text, (int)len, &rect, DT_SINGLELINE | DT_VCENTER | DT_NOPREFIX);
+					if (lpdis->itemState & ODS_FOCUS)
+						DrawFocusRect(hdc, &lpdis->rcItem);
+				}
+
 				// Owner draw button
 				else if (controls[i].Type == "Button"
 					&& controls[i].Index != 1 // not a hyperlink
@@ -2643,12 +6737,23 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 					HDC hdc = lpdis->hDC;
 					RECT rect = lpdis->rcItem; // Button bounding box
 
+					// Double buffered (DoubleBuffer)
+					// Draw to the item buffer and copy to the button when complete
+					HFONT hOldItemFont = nullptr;
+					if (bDoubleBuffer) {
+						HDC hdcItem = GetItemBuffer(lpdis->hDC, rect.right, rect.bottom);
+						if (hdcItem) {
+							hdc = hdcItem;
+							// Use the button font
+							hOldItemFont = (HFONT)SelectObject(hdc, GetCurrentObject(lpdis->hDC, OBJ_FONT));
+						}
+					}
+
 					// Backgound colour is control.Val (default 0)
 					if (controls[i].Val > 0) {
-						HBRUSH hBrush = CreateSolidBrush(Hex2Rgb(controls[i].Val));
+						HBRUSH hBrush = (HBRUSH)g_Gdi.Brush(Hex2Rgb(controls[i].Val));
 						SetBkMode(hdc, TRANSPARENT);
 						FillRect(hdc, &rect, hBrush);
-						DeleteObject(hBrush);
 					}
 					else {
 						// Picture button
@@ -2658,11 +6763,40 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 							SetBkMode(hdc, TRANSPARENT);
 							FillRect(hdc, &rect, (HBRUSH)GetStockObject(WHITE_BRUSH));
 							// Draw the image
-							HDC hdcMem = CreateCompatibleDC(hdc);
 							HBITMAP hBitmap = (HBITMAP)controls[i].hwndType;
-							HBITMAP hOldBitmap = (HBITMAP)SelectObject(hdcMem, hBitmap);
-							BITMAP bitmap;
-							GetObject(hBitmap, sizeof(bitmap), &bitmap);
+							HDC hdcMem = NULL;
+							HBITMAP hOldBitmap = nullptr;
+							int srcx = 0;
+							int srcy = 0;
+							int srcwidth = 0;
+							int srcheight = 0;
+							// Streaming picture button - draw the front buffer
+							// and hold the lock until the draw is complete
+							std::shared_ptr<buttonstream> stream = FindButtonStream(controls[i].Title);
+							std::unique_lock<std::mutex> drawlock;
+							if (stream) {
+								drawlock = std::unique_lock<std::mutex>(stream->drawmutex);
+								if (stream->hBitmap[stream->front])
+									hBitmap = stream->hBitmap[stream->front];
+							}
+							else if (controls[i].Atlas >= 0) {
+								// Atlas picture button - the atlas page bitmap
+								// is already selected into the page memory DC
+								atlasimage &image = g_AtlasImages[controls[i].Atlas];
+								hdcMem = g_AtlasPages[image.page].hdcMem;
+								srcx = image.rect.x;
+								srcy = image.rect.y;
+								srcwidth = image.rect.width;
+								srcheight = image.rect.height;
+							}
+							if (!hdcMem) {
+								hdcMem = CreateCompatibleDC(hdc);
+								hOldBitmap = (HBITMAP)SelectObject(hdcMem, hBitmap);
+								BITMAP bitmap;
+								GetObject(hBitmap, sizeof(bitmap), &bitmap);
+								srcwidth = bitmap.bmWidth;
+								srcheight = bitmap.bmHeight;
+							}
 							// Draw the bitmap to fit the button
 							SetStretchBltMode(hdc, COLORONCOLOR); // Fastest method
 							StretchBlt(
@@ -2671,14 +6805,16 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 								(rect.right - rect.left), // Destination width
 								(rect.bottom - rect.top), // Destination height
 								hdcMem, // Source DC (bitmap)
-								0, 0, // Source position
-								bitmap.bmWidth, // Source width
-								bitmap.bmHeight, // Source height
+								srcx, srcy, // Source position
+								srcwidth, // Source width
+								srcheight, // Source height
 								SRCCOPY // Copy operation
 							);
 							// Cleanup
-							SelectObject(hdcMem, hOldBitmap);
-							DeleteDC(hdcMem);
+							if (hOldBitmap) {
+								SelectObject(hdcMem, hOldBitmap);
+								DeleteDC(hdcMem);
+							}
 							// Do not delete the bitmap
 							// Keep for repeated button press
 						}
@@ -2698,9 +6834,7 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 							}
 						}
 						// Blue border when pressed
-						HBRUSH hBrush = CreateSolidBrush(RGB(0, 120, 215));
-						FrameRect(hdc, &rect, hBrush);
-						DeleteObject(hBrush);
+						FrameRect(hdc, &rect, (HBRUSH)g_Gdi.Brush(RGB(0, 120, 215)));
 					} // endif pressed
 					else {
 						// Button not pressed
@@ -2713,10 +6847,12 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 								SetTextColor(hdc, RGB(0, 0, 0));
 							}
 						}
+						// Blue border when the mouse is over the button
 						// Grey border when not pressed
-						HBRUSH hBrush = CreateSolidBrush(RGB(169, 169, 169));
-						FrameRect(hdc, &rect, hBrush);
-						DeleteObject(hBrush);
+						if (g_Hover.GetHover() == (int)i)
+							FrameRect(hdc, &rect, (HBRUSH)g_Gdi.Brush(RGB(0, 100, 215)));
+						else
+							FrameRect(hdc, &rect, (HBRUSH)g_Gdi.Brush(RGB(169, 169, 169)));
 					} // endif not pressed
 					if (!controls[i].Text.empty()) {
 						// controls[i].Min contains optional style
@@ -2732,52 +6868,40 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 							dwStyle |= DT_VCENTER; // Default centre
 						DrawTextA(hdc, controls[i].Text.c_str(), -1, &lpdis->rcItem, dwStyle);
 					}
+
+					// Copy the item buffer to the button
+					if (hdc != lpdis->hDC) {
+						BitBlt(lpdis->hDC, rect.left, rect.top,
+							rect.right - rect.left, rect.bottom - rect.top,
+							hdc, rect.left, rect.top, SRCCOPY);
+						if (hOldItemFont)
+							SelectObject(hdc, hOldItemFont);
+					}
 				} // endif button
             }
             break;
         
 		case WM_SETCURSOR:
-			for (size_t i = 0; i < controls.size(); i++) {
-				if (controls[i].Type == "Button"
-					&& controls[i].Index != 1 // not a hyperlink
-					&& (controls[i].hwndType || controls[i].Val > 1) ) { // Owner draw button
-
-					// Cursor position
-					POINT pt{};
-					GetCursorPos(&pt);
-
-					// If the mouse is over the button, set a hand cursor
-					if (!bOver && WindowFromPoint(pt) == controls[i].hwndControl) {
-						// Blue border when mouse is over the button
-						HBRUSH hBrush = CreateSolidBrush(RGB(0, 100, 215));
-						RECT rect;
-						GetClientRect(controls[i].hwndControl, &rect);
-						HDC hdc = GetDC(controls[i].hwndControl);
-						FrameRect(hdc, &rect, hBrush);
-						DeleteObject(hBrush);
-						DeleteObject(hdc);
-						// Set a flag to restore to grey when not over the button
-						bOver = true;
-						return TRUE;
-					}
-					else {
-						// If not over the button, restore the border colour
-						if (!bOver) {
-							HDC hdc = GetDC(controls[i].hwndControl);
-							// Current border colour
-							COLORREF bc = GetPixel(hdc, 0, 0);
-							// If border colour has been changed to blue,
-							// restore to grey when not pressed (as in WM_DRAWITEM)
-							if (bc == RGB(0, 100, 215)) {
-								HBRUSH hBrush = CreateSolidBrush(RGB(169, 169, 169));
-								RECT rect{};
-								GetClientRect(controls[i].hwndControl, &rect);
-								FrameRect(hdc, &rect, hBrush);
-								DeleteObject(hBrush);
-							}
-							DeleteObject(hdc);
-						}
-						bOver = false;
+			// Sent for every mouse move over the dialog and its controls.
+			// Hit test the owner draw buttons and redraw only
+			// the buttons that change hover state.
+			if (LOWORD(lParam) == HTCLIENT) {
+				DWORD pos = GetMessagePos();
+				POINT pt = { GET_X_LPARAM(pos), GET_Y_LPARAM(pos) };
+				ScreenToClient(hwnd, &pt);
+				int left = -1;
+				int entered = -1;
+				if (g_Hover.Move(pt.x, pt.y, left, entered)) {
+					if (left >= 0)
+						InvalidateRect(controls[left].hwndControl, NULL, FALSE);
+					if (entered >= 0) {
+						// Button subclass receives WM_MOUSELEAVE (ButtonHoverProc)
+						TRACKMOUSEEVENT tme{};
+						tme.cbSize = sizeof(tme);
+						tme.dwFlags = TME_LEAVE;
+						tme.hwndTrack = controls[entered].hwndControl;
+						TrackMouseEvent(&tme);
+						InvalidateRect(controls[entered].hwndControl, NULL, FALSE);
 					}
 				}
 			}
@@ -2793,16 +6917,10 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 								switch (((LPNMHDR)lParam)->code) {
 									case UDN_DELTAPOS:
 										LPNMUPDOWN lpnmud = (LPNMUPDOWN)lParam;
-										int num = lpnmud->iDelta + lpnmud->iPos;
-										if(num < (int)controls[i].Min)
-											num = (int)controls[i].Min;
-										if (num > (int)controls[i].Max)
-											num = (int)controls[i].Max;
-										controls[i].Val = num;
-										// Update the spin control position
-										SendMessage(controls[i].hwndControl, UDM_SETPOS, 0, (LPARAM)num);
+										// New value within the range and the spin control position
+										int num = g_Core.SpinEvent(i, lpnmud->iPos, lpnmud->iDelta);
 										// Inform ofApp
-										DialogFunction(controls[i].Title, "", controls[i].Val);
+										DialogFunction(controls[i].Title, "", num);
 								}
 							}
 						}
@@ -2835,6 +6953,47 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
                      }
                  }
 
+                 // Filter as you type (SetListFilterEdit)
+                 if (HIWORD(wParam) == EN_CHANGE) {
+                     for (size_t i = 0; i < controls.size(); i++) {
+                         if (controls[i].Type != "List" || controls[i].Search < 0)
+                             continue;
+                         itemsearch &search = g_Search[controls[i].Search];
+                         if (search.edit.empty())
+                             continue;
+                         for (size_t j = 0; j < controls.size(); j++) {
+                             if (controls[j].Type == "Edit" && controls[j].Title == search.edit
+                                 && LOWORD(wParam) == controls[j].ID) {
+                                 char tmp[256]{};
+                                 GetWindowTextA(controls[j].hwndControl, tmp, sizeof(tmp));
+                                 controls[j].Text = tmp;
+                                 search.filter = tmp;
+                                 ApplyListFilter(controls[i]);
+                             }
+                         }
+                     }
+                 }
+
+                 // Edit text changed by the user (KeepAlive)
+                 if (HIWORD(wParam) == EN_CHANGE) {
+                     for (size_t i = 0; i < controls.size(); i++) {
+                         if (controls[i].Type == "Edit" && LOWORD(wParam) == controls[i].ID)
+                             g_Core.UserChanged();
+                     }
+                 }
+
+                 // Edit controls bound to shared parameters (BindParameter)
+                 if (HIWORD(wParam) == EN_CHANGE && bParams) {
+                     for (size_t i = 0; i < controls.size(); i++) {
+                         if (controls[i].Type == "Edit" && LOWORD(wParam) == controls[i].ID) {
+                             char tmp[256]{};
+                             GetWindowTextA(controls[i].hwndControl, tmp, sizeof(tmp));
+                             controls[i].Text = tmp;
+                             PublishParameters(controls[i].Title);
+                         }
+                     }
+                 }
+
                  // Combo box
                  if (HIWORD(wParam) == CBN_SELCHANGE) {
                      // Check all combo and list controls
@@ -2845,20 +7004,36 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 								 // Allow for error if the user edits the list item
 								 int index = (int)SendMessage(controls[i].hwndControl, (UINT)CB_GETCURSEL, (WPARAM)0, (LPARAM)0);
 								 if (index != CB_ERR) {
-									 // Inform ofApp if no error
-									 DialogFunction(controls[i].Title, controls[i].Items[index], index);
-									 // Reset the control index
-									 controls[i].Index = index;
+									 // Inform ofApp if no error and reset the control index
+									 g_Core.ComboEvent(i, index, [this](const std::string &title, const std::string &text, int value) {
+										 DialogFunction(title, text, value);
+									 });
 								 }
 							 }
                          }
 
-						 if (controls[i].Type == "List") {
+						 if (controls[i].Type == "List" && controls[i].Store >= 0) {
+							 // Virtual list - text from the item store
+							 if (LOWORD(wParam) == controls[i].ID) {
+								 int index = (int)SendMessage(controls[i].hwndControl, (UINT)LB_GETCURSEL, (WPARAM)0, (LPARAM)0);
+								 if (index != LB_ERR) {
+									 index = ListItemFromRow(controls[i], index);
+									 controls[i].Index = index;
+									 g_Core.UserChanged(); // KeepAlive
+									 DialogFunction(controls[i].Title, GetListText(controls[i], index), index);
+								 }
+							 }
+						 }
+						 else if (controls[i].Type == "List") {
 							 int index = (int)SendMessage(controls[i].hwndControl, (UINT)LB_GETCURSEL, (WPARAM)0, (LPARAM)0);
 							 if (index != LB_ERR) {
 								 char tmp[256] {};
 								 SendMessageA(controls[i].hwndControl, LB_GETTEXT, index, (LPARAM)tmp);
+								 // Item shown in the row if the list is filtered
+								 index = ListItemFromRow(controls[i], index);
 								 controls[i].Items[index] = tmp;
+								 if (index != controls[i].Index)
+									 g_Core.UserChanged(); // KeepAlive
 								 DialogFunction(controls[i].Title, tmp, index);
 							 }
 							 controls[i].Index = index;
@@ -2879,11 +7054,8 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
                          if (controls[i].Type == "Checkbox") {
                              if (LOWORD(wParam) == controls[i].ID) { // ID of the checkbox selected
                                  // Test if the checkbox is checked or unchecked
-                                 if (SendMessage((HWND)lParam, BM_GETCHECK, 0, 0) == BST_CHECKED)
-                                     controls[i].Val = 1;
-                                 else
-                                     controls[i].Val = 0;
-                                 DialogFunction(controls[i].Title, "", controls[i].Val);
+                                 bool bChecked = SendMessage((HWND)lParam, BM_GETCHECK, 0, 0) == BST_CHECKED;
+                                 DialogFunction(controls[i].Title, "", g_Core.CheckEvent(i, bChecked));
                              }
                          } // End Checkbox
 
@@ -2895,32 +7067,20 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
                              for (int j=0; j<=nRadioGroup; j++) {
                                  // Group numbering starts at 0
                                  if (j == controls[i].RadioGroup) {
-                                     int selectedGroup   = -1;
                                      int selectedControl = -1;
                                      // ID of the radio button selected
                                      if (LOWORD(wParam) == controls[i].ID) {
-                                         selectedGroup = j;
                                          if (SendMessage((HWND)lParam, BM_GETCHECK, 0, 0) == BST_CHECKED) {
                                              selectedControl = (int)i;
                                          }
                                      }
                                      if (selectedControl >= 0) {
-                                         // Look though all the radio buttons and set the selected one
+                                         // Set the selected radio button
                                          // Others in the same group are set to zero
-                                         for (size_t k=0; k<controls.size(); k++) {
-                                             if (controls[k].Type == "Radio") {
-                                                 if (selectedGroup == controls[k].RadioGroup) {
-                                                     if (selectedControl == (int)k) {
-                                                         controls[k].Val = 1;
-                                                     }
-                                                     else {
-                                                         controls[k].Val = 0;
-                                                     }
-                                                     // Inform ofApp
-                                                     DialogFunction(controls[k].Title, "", controls[k].Val);
-                                                 }
-                                             }
-                                         }
+                                         // Inform ofApp for each button of the group
+                                         g_Core.RadioEvent((size_t)selectedControl, [this](const std::string &title, const std::string &text, int value) {
+                                             DialogFunction(title, text, value);
+                                         });
                                      } // endif selectedControl >= 0
                                  } // endif if j == controls[i].Group
                              } // end loop though each radio button group
@@ -2950,69 +7110,17 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
                     if (controls[i].Type == "Slider") {
                         if ((HWND)lParam == controls[i].hwndControl) {
 
-							// Set a flag to prevent SetSilder from updating
-							// the position while it is currently being moved
-							bDrag = false;
-							if (LOWORD(wParam) == SB_THUMBTRACK)
-								bDrag = true;
-
                             // Current position of the slider
                             int pos = (int)SendMessage(controls[i].hwndControl, TBM_GETPOS, 0, 0);
 
-                            // Check for direction keys, left/right, up/down
-                            // Default trackbar style is Down=Right and Up=Left (CommCtrl.h)
-							float range = (controls[i].Max - controls[i].Min);
-                            if (wParam == SB_LINELEFT) { // Left key
-                                // Moves left one unit
-                                // Move 100 units for trackbars with range > 1000, 
-                                if (range > 1000.0) {
-                                    pos = pos - (int)(range/100.0);
-                                    SendMessage(controls[i].hwndControl, TBM_SETPOS, TRUE, pos);
-                                }
-                                else if(range >= 100.0) {
-                                    SendMessage(controls[i].hwndControl, TBM_SETPOS, TRUE, pos-100);
-                                }
-                                else {
-                                    SendMessage(controls[i].hwndControl, TBM_SETPOS, TRUE, pos);
-                                }
-                            }
-                            else if(wParam == SB_LINERIGHT) { // Right key
-                                if (range > 1000.0) {
-                                    pos = pos + (int)(range/100.0);
-                                    SendMessage(controls[i].hwndControl, TBM_SETPOS, TRUE, pos);
-                                }
-                                else if (range >= 100.0) {
-                                    SendMessage(controls[i].hwndControl, TBM_SETPOS, TRUE, pos+100);
-                                }
-                                else {
-                                    SendMessage(controls[i].hwndControl, TBM_SETPOS, TRUE, pos);
-                                }
-                            }
-
-                            if (range > 1000.0)
-                                controls[i].SliderVal = (float)pos;
-                            else
-                                controls[i].SliderVal = (float)pos/100.0f;
-
-                            // Slider value text display
-                            if (controls[i].hwndSliderVal) {
-                                char tmp[8]{};
-                                if (controls[i].Max >= 100.0f)
-                                    sprintf_s(tmp, 8, "%.0f", controls[i].SliderVal);
-                                else if (controls[i].Max >= 10.0f)
-                                    sprintf_s(tmp, 8, "%.1f", controls[i].SliderVal);
-                                else
-                                    sprintf_s(tmp, 8, "%.2f", controls[i].SliderVal);
-                                SetWindowTextA(controls[i].hwndSliderVal, (LPCSTR)tmp);
-                            }
-
-                            // If not one-click mode Inform ofApp of the slider position change
-							if(controls[i].Val == 0) {
-                                DialogFunction(controls[i].Title, "", (int)(controls[i].SliderVal*100.0f));
-                            }
-                            else if (wParam == SB_ENDSCROLL) { // Mouse release or key up
-                                DialogFunction(controls[i].Title, "", (int)(controls[i].SliderVal*100.0f));
-                            }
+                            // Direction keys, slider value and value text.
+                            // SetSlider does not update the position while
+                            // the slider is being dragged (SB_THUMBTRACK).
+                            // If not one-click mode Inform ofApp of the slider
+                            // position change, otherwise at mouse release or key up
+                            int value = 0;
+                            if (g_Core.SliderEvent(i, LOWORD(wParam), pos, value))
+                                DialogFunction(controls[i].Title, "", value);
                         }
                     }
                 }
@@ -3020,10 +7128,28 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
             break;
 
         case WM_CLOSE:
+			// Kept dialog - hide instead of destroy (KeepAlive)
+			if (g_Core.IsKeepAlive()) {
+				HideDialog();
+				return 0;
+			}
+			// fall through
         case WM_DESTROY:
+			g_Core.Close();
 			DialogFunction("WM_DESTROY", "", PtrToUint(m_hDialog));
+			g_Hooks.Remove((uintptr_t)hwnd);
             DestroyWindow(hwnd);
             m_hDialog = nullptr;
+            g_hwndTemplate = NULL;
+            g_hwndWatch = NULL;
+            g_hwndThread = NULL;
+            bOscTimer = false; // Destroyed with the window
+            bReplayTimer = false;
+            // Later Set functions are applied by the caller (QueueSet)
+            EndCommands(g_WindowThreadId);
+            // End the message loop of the dialog thread (UseThread)
+            if (g_DialogThreadId.load() == GetCurrentThreadId())
+                PostQuitMessage(0);
             break;
     }
 
@@ -3034,21 +7160,63 @@ LRESULT ofxWinDialog::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 
 
 //
-// To enable the tab key - IsDialogMessage must be called
+// Owner draw button subclass
+// WM_MOUSELEAVE is requested by TrackMouseEvent in WM_SETCURSOR
+// when the mouse enters the button
+//
+static LRESULT CALLBACK ButtonHoverProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam, UINT_PTR uIdSubclass, DWORD_PTR dwRefData)
+{
+	if (uMsg == WM_MOUSELEAVE) {
+		ofxWinDialog* pDlg = reinterpret_cast<ofxWinDialog*>(dwRefData);
+		if (pDlg) pDlg->HoverLeave((int)uIdSubclass);
+	}
+	else if (uMsg == WM_NCDESTROY) {
+		RemoveWindowSubclass(hwnd, ButtonHoverProc, uIdSubclass);
+	}
+	return DefSubclassProc(hwnd, uMsg, wParam, lParam);
+}
+
+//
+// Child dialog created from the dialog template (UseTemplate)
+// Control messages are forwarded to the dialog window
+//
+static INT_PTR CALLBACK TemplateDialogProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
+{
+	switch (uMsg) {
+		case WM_INITDIALOG:
+			return FALSE; // Focus is set by Open
+
+		case WM_CTLCOLORDLG:
+		case WM_CTLCOLORSTATIC:
+		case WM_CTLCOLORBTN:
+			// The brush is returned directly
+			return (INT_PTR)SendMessage(GetParent(hwnd), uMsg, wParam, lParam);
+
+		case WM_COMMAND:
+		case WM_NOTIFY:
+		case WM_HSCROLL:
+		case WM_DRAWITEM:
+			SetWindowLongPtr(hwnd, DWLP_MSGRESULT, SendMessage(GetParent(hwnd), uMsg, wParam, lParam));
+			return TRUE;
+	}
+	return FALSE;
+}
+
 //
-// This only works correctly when one dialog is open at a time
-// which is typically the case.
+// To enable the tab key - IsDialogMessage must be called
 //
-// The tab key is disabled if a second dialog is opened due to
-// conflict with static variables. It is restored if the dialog
-// is closed and opened again.
+// A key message is passed to the dialog containing the window
+// it is for, so that the tab key works with several dialogs open.
+// Key messages for other windows are not passed to a dialog.
 //
 LRESULT CALLBACK GetKeyMsgProc(int nCode, WPARAM wParam, LPARAM lParam)
 {
     LPMSG lpMsg = (LPMSG)lParam;
     if (nCode >= 0 && PM_REMOVE == wParam) {
-        if ((lpMsg->message >= WM_KEYFIRST && lpMsg->message <= WM_KEYLAST)) {
-            ofxWinDialog* pDlg = reinterpret_cast<ofxWinDialog*>(GetWindowLongPtr(hwndDialog, GWLP_USERDATA));
+        if ((lpMsg->message >= WM_KEYFIRST && lpMsg->message <= WM_KEYLAST) && lpMsg->hwnd) {
+            // The dialog window is the top level window of the control
+            HWND hwndRoot = GetAncestor(lpMsg->hwnd, GA_ROOT);
+            ofxWinDialog* pDlg = g_Hooks.Find((uintptr_t)hwndRoot);
             if (pDlg && pDlg->m_hDialog) {
 
                 // Pass key up and down on to ofApp
@@ -3070,7 +7238,7 @@ LRESULT CALLBACK GetKeyMsgProc(int nCode, WPARAM wParam, LPARAM lParam)
             }
         }
     }
-    return CallNextHookEx(hMsgHook, nCode, wParam, lParam);
+    return CallNextHookEx((HHOOK)g_Hooks.GetHook(GetCurrentThreadId()), nCode, wParam, lParam);
 }
 
 // There is no more ...
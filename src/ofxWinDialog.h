@@ -6,6 +6,13 @@
 #include <windows.h>
 #include <string>
 #include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <io.h>
 
 // For file read to a string
@@ -22,6 +29,29 @@
 #pragma comment(lib, "UxTheme.lib")
 #pragma comment(lib, "dwmapi.lib")
 
+#include "ofxWinDialogPixels.h" // Picture button pixel copy
+#include "ofxWinDialogAtlas.h" // Picture button atlas packing
+#include "ofxWinDialogCache.h" // Brush, pen, font and cursor cache
+#include "ofxWinDialogHover.h" // Owner draw button hover state
+#include "ofxWinDialogPaint.h" // Double buffered paint
+#include "ofxWinDialogItems.h" // Virtual list item storage and item batches
+#include "ofxWinDialogSearch.h" // Combo and list item search
+#include "ofxWinDialogPages.h" // Pages of controls created on first show
+#include "ofxWinDialogTemplate.h" // In-memory dialog template
+#include "ofxWinDialogDescription.h" // Dialog description parser
+#include "ofxWinDialogWatch.h" // Hot reload of watched files
+#include "ofxWinDialogLayout.h" // Automatic layout of controls
+#include "ofxWinDialogDpi.h" // Per-monitor DPI scaling
+#include "ofxWinDialogCore.h" // Control values, lookup and initialization files
+#include "ofxWinDialogBench.h" // Benchmark timing and baseline comparison
+#include "ofxWinDialogStats.h" // Message latency histograms
+#include "ofxWinDialogRecord.h" // Event recording and replay
+#include "ofxWinDialogTrace.h" // Trace export for timeline profilers
+#include "ofxWinDialogHooks.h" // Key message routing for several dialogs
+#include "ofxWinDialogThread.h" // Queues for the dialog thread
+#include "ofxWinDialogParams.h" // Parameters shared between dialogs
+#include "ofxWinDialogOsc.h" // OSC messages for a control surface
+
 // Manifest for Version 6 common controls
 // Runtime dependency for "DisableTheme"
 #ifdef _MSC_VER
@@ -94,19 +124,67 @@ public:
 class ofApp; // Forward declaration
 #endif
 
+//
+// Enable this define to time message handling and the ofApp
+// callback function (GetMessageStats, GetControlStats etc.)
+// Without it nothing is timed and the functions return false.
+//
+// #define statsWinDialog
 
 #define MAX_LOADSTRING 100
 
+//
+// Windows backend for the GDI object cache (ofxWinDialogCache.h)
+//
+struct WinGdiBackend {
+
+	typedef HANDLE Handle;
+
+	Handle Create(const GdiKey &key) {
+		switch (key.type) {
+			case GdiBrush:
+				return (Handle)CreateSolidBrush((COLORREF)key.color);
+			case GdiPen:
+				return (Handle)CreatePen(key.style, key.size, (COLORREF)key.color);
+			case GdiFont: {
+				LOGFONTA logFont{};
+				logFont.lfWeight = key.style;
+				logFont.lfHeight = key.size;
+				logFont.lfCharSet = ANSI_CHARSET;
+				logFont.lfQuality = DEFAULT_QUALITY;
+				strncpy_s(logFont.lfFaceName, LF_FACESIZE, key.name.c_str(), _TRUNCATE);
+				return (Handle)CreateFontIndirectA(&logFont);
+			}
+			case GdiCursor:
+				return (Handle)LoadCursor(NULL, MAKEINTRESOURCE(key.color));
+		}
+		return nullptr;
+	}
+
+	void Destroy(const GdiKey &key, Handle handle) {
+		// System cursors are shared and not destroyed
+		if (key.type != GdiCursor)
+			DeleteObject((HGDIOBJ)handle);
+	}
+
+};
+
 class ofxWinDialog {
 
 public:
 
     // Class message handling procedure to allow multiple dialogs
     LRESULT WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
+    // WindowProc with timing for message statistics (statsWinDialog)
+    LRESULT TimedWindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
     
     // Class dialog window handle
     HWND m_hDialog = nullptr;
 
+	// The mouse has left an owner draw button
+	// Called by the button subclass procedure
+	void HoverLeave(int index);
+
 	// Constructor
 	// Optional class name for multiple dialogs and background colour in hex
 	ofxWinDialog(ofApp* app, HINSTANCE hInstance, HWND hWnd, std::string className="", int background=0);
@@ -186,6 +264,18 @@ public:
 	// Button picture from bitmap
 	void ButtonPicture(HBITMAP hBitmap);
 
+	// Picture button atlas
+	// Pack picture button images into shared atlas pages instead
+	// of a bitmap for each button. Reduces GDI objects and draw setup
+	// for dialogs with many small picture buttons.
+	// size - atlas page width and height (default 1024)
+	// Images larger than the page size use their own bitmap.
+	// Call before ButtonPicture.
+	void ButtonAtlas(bool bAtlas, int size = 1024);
+
+	// Atlas pages, images and average page occupancy (0-1)
+	void GetButtonAtlasStats(int &pages, int &images, double &occupancy);
+
     //
     // Slider
     //
@@ -227,6 +317,44 @@ public:
 	// List box
 	void AddList(std::string title, int x, int y, int width, int height, std::vector<std::string> items, int index);
 
+	// Virtual list box for large numbers of items
+	// Items are held once by ofxWinDialog in contiguous storage
+	// and only the visible rows are drawn.
+	// GetListItem, SetList and SetListItem can be used as for a list box.
+	void AddVirtualList(std::string title, int x, int y, int width, int height, std::vector<std::string> items, int index);
+	// Append an item to a virtual list (constant time)
+	void AppendListItem(std::string title, std::string text);
+	// Replace the text of a virtual list item (constant time)
+	void ReplaceListItem(std::string title, int item, std::string text);
+	// Get the number of list items
+	int GetListCount(std::string title);
+
+	// Bulk item loading for large combo and list boxes
+	// Items are in one UTF-8 buffer with "count"+1 offsets.
+	// Item i is data[offsets[i]] to data[offsets[i+1]].
+	// Storage is reserved, the batch is converted in one pass
+	// and the items are inserted with redraw suspended.
+	// Only these functions take UTF-8. Other item text is
+	// in the ANSI code page as for the rest of the dialog.
+	// The items of a virtual list are drawn as ANSI text.
+	void LoadCombo(std::string title, const char* data, const size_t* offsets, size_t count, int index);
+	void LoadList(std::string title, const char* data, const size_t* offsets, size_t count, int index);
+	// Time taken by the last LoadCombo or LoadList (msec)
+	double GetLoadTime();
+
+	// Item search
+	// Find an item by text, ignoring case. Returns the item index or -1.
+	// A search index is created on first use and updated as items change.
+	int FindComboItem(std::string title, std::string text);
+	int FindListItem(std::string title, std::string text);
+	// Show only the list items that start with the text
+	// or contain the text. An empty text shows all items.
+	// Item indexes are not changed by the filter.
+	void SetListFilter(std::string title, std::string text, bool bContains = false);
+	// Filter as you type
+	// Filter a list with the text of an edit control as it is typed
+	void SetListFilterEdit(std::string title, std::string edit, bool bContains = false);
+
 	// Spin control
 	// Style can be UDS_ALIGNLEFT or UDS_ALIGNRIGHT (default)
 	void AddSpin(std::string title, int x, int y, int width, int height,
@@ -256,6 +384,46 @@ public:
 	//   Default is left aligned (SS_LEFT)
 	void AddText(std::string title, std::string text, int x, int y, int width, int height, DWORD dwStyle = 0);
 
+	//
+	// Pages
+	//
+	// Controls added after AddPage are on that page until the next
+	// AddPage or EndPage. Only the controls of the current page are
+	// shown and their windows are created when the page is first shown.
+	// Get and Set functions use the stored values of controls on pages
+	// that have not been created. Controls not on a page are always shown.
+	void AddPage(std::string name);
+	void EndPage();
+	// Show a page and hide the current page
+	void ShowPage(std::string name);
+	// Name of the current page
+	std::string GetPage();
+	// Maximum number of pages with control windows (0 = all, default)
+	// Windows of the pages shown least recently are destroyed
+	void SetPageCache(int maxpages);
+
+	// Automatic layout
+	// Controls added between LayoutRow, LayoutColumn, LayoutGrid or
+	// LayoutPair and LayoutEnd are positioned by the layout and their
+	// x and y are not used. Width and height are the minimum size.
+	// Boxes can be nested. A pair is a label and a control, and the
+	// labels of pairs in a column are aligned. Controls added outside
+	// a layout box keep their own position.
+	// The layout is arranged when the dialog is opened and again
+	// when a resizeable dialog changes size.
+	void LayoutRow(int spacing = 4);
+	void LayoutColumn(int spacing = 4);
+	void LayoutGrid(int columns, int spacing = 4);
+	void LayoutPair(int spacing = 4);
+	void LayoutEnd();
+	// Stretch factors of the control or box added last
+	// Extra space is shared by the factors of the controls in a box
+	void LayoutStretch(float horizontal, float vertical = 0.0f);
+	// Space between the layout and the dialog edges (default 10)
+	void LayoutMargin(int margin);
+	// Time taken by the last layout (msec)
+	double GetLayoutTime();
+
 	// Static text color
 	// Set before AddText
 	void TextColor(int hexcode);
@@ -321,6 +489,29 @@ public:
 	void SetButtonPicture(std::string title, std::string path);
 	void SetButtonPicture(std::string title, unsigned char* imageData, int width, int height, int nchannels, bool bInvert, bool bSwapRG);
 
+	//
+	// Streaming picture button
+	//
+	// A persistent, double-buffered image surface for a picture button
+	// that is updated repeatedly, for example with video frames.
+	// Frames are copied in place and only the button is redrawn.
+	// The button must have been created as a picture button (ButtonPicture).
+	// UpdateButtonStream can be called from a worker thread.
+	// Call ButtonStream and CloseButtonStream from the dialog thread.
+	bool ButtonStream(std::string title, int width, int height);
+	bool UpdateButtonStream(std::string title, unsigned char* imageData, int width, int height, int nchannels, bool bInvert, bool bSwapRG);
+	void CloseButtonStream(std::string title);
+
+	// Streaming statistics
+	struct streamstats {
+		uint64_t frames = 0; // Frames copied
+		uint64_t allocations = 0; // Surface allocations
+		double lastms = 0.0; // Last frame copy time (msec)
+		double avgms = 0.0; // Average frame copy time (msec)
+		double maxms = 0.0; // Maximum frame copy time (msec)
+	};
+	bool GetButtonStreamStats(std::string title, streamstats &stats);
+
 	// Enable/Disable a control
 	// (Except Hyperlink, Static and Group)
 	void EnableControl(std::string title, bool bEnabled);
@@ -349,6 +540,37 @@ public:
 	// Load file to a string
 	std::string LoadFile(std::string filename = "");
 
+	// Dialog description
+	// Controls are described by one statement on each line with the
+	// arguments of the Add function, for example :
+	//    slider "Red" 30 50 200 30 0 255 128
+	//    combo "Mode" 30 90 200 100 ["One" "Two" "Three"] 0 CBS_DROPDOWN
+	// See ParseDialog in ofxWinDialog.cpp for all statements.
+	// Controls are added as by the Add functions. Statements before
+	// an error are applied. Returns false for an error (GetParseError).
+	bool LoadDialog(std::string filename);
+	bool ParseDialog(const std::string &description);
+	// Error message of the last LoadDialog or ParseDialog
+	std::string GetParseError();
+	// Time taken by the last LoadDialog or ParseDialog (msec)
+	double GetParseTime();
+
+	// Hot reload
+	// Watch an initialization file (Save/Load) or a dialog description
+	// file (LoadDialog) for changes made by another program. Files are
+	// checked by a background thread and read when they have not changed
+	// again for the debounce interval. Only the values that differ are
+	// applied with the Set functions. ofApp is informed by "WM_RELOAD"
+	// with the file path and the number of controls changed, or -1 if
+	// a description has changed more than control values and must be
+	// loaded again. Files are found as for Load and LoadDialog.
+	void WatchIni(std::string filename = "", std::string section = "");
+	void WatchDialog(std::string filename);
+	// Stop watching all files
+	void StopWatch();
+	// Time without further change before a file is read (msec, default 200)
+	void SetWatchDebounce(int msec);
+
     // Set icon for the dialog window
     void SetIcon(HICON hIcon);
 
@@ -358,7 +580,7 @@ public:
     // Set a custom font
     // https://learn.microsoft.com/en-us/windows/win32/api/wingdi/ns-wingdi-logfonta
     // name    - e.g. "Tahoma", "Ms Shell Dlg" etc.
-    // height  - height in dialog units
+    // height  - height in points, scaled for the dialog DPI
     // weight  - FW_NORMAL, FW_BOLD etc. (default FW_NORMAL)
 	void SetFont(std::string name, LONG height, LONG weight = FW_NORMAL);
 
@@ -368,6 +590,92 @@ public:
 	// Return the logical font handle after window creation
 	HFONT GetFont();
 
+	// Brushes, pens, fonts and cursors created
+	// and re-used by the drawing object cache
+	void GetGdiCacheStats(uint64_t &created, uint64_t &reused);
+
+	// DPI scaling
+	// Dialog and control positions and sizes are given at 96 DPI (100%)
+	// and are scaled for the DPI of the monitor showing the dialog. The
+	// dialog is scaled again when it is moved to a monitor with a
+	// different DPI or the display scale is changed.
+	// DPI of the dialog (96 before Open)
+	int GetDpi();
+	// Scale factor of the dialog (1.0 = 100%)
+	double GetScale();
+
+	// Benchmark
+	// Time the dialog hot paths with the controls of the dialog :
+	// lookup by title, slider set, GetControls, Save and Load, Refresh,
+	// combo and list population, bulk loading of 10k, 100k and 1M
+	// list items and picture button pixel copy.
+	// Window scenarios are timed if the dialog is open. GetControls
+	// calls the ofApp callback function for every control.
+	//   jsonfile  - results as JSON (ofxWinDialogBench.h)
+	//   baseline  - JSON results of an earlier version to compare with
+	//   runs      - timed runs of each scenario
+	//   tolerance - slower fraction allowed (0.1 = 10%)
+	// Returns false if a scenario is slower than the baseline.
+	bool Benchmark(std::string jsonfile = "", std::string baseline = "", int runs = 20, double tolerance = 0.1);
+
+	// Event recording and replay
+	// Control events passed to the ofApp callback function and Set
+	// functions called by ofApp are recorded with the time from the
+	// start of recording (ofxWinDialogRecord.h)
+	void StartRecording();
+	// Stop recording and write the events to a trace file
+	// The default file is the executable name with ".trace"
+	bool StopRecording(std::string filename = "");
+	bool IsRecording();
+	// Replay a trace file in the order recorded
+	//   speed - 1.0 recorded speed, 2.0 twice as fast, 0 as fast as possible
+	// Set functions are called again. A control event sets the control
+	// and calls the ofApp callback function as if made by the user.
+	// At a recorded speed the events are applied by a timer of the open
+	// dialog as they become due and Replay returns at once. Otherwise
+	// all events are applied before Replay returns.
+	// Returns the number of events to replay, -1 if the file is not read.
+	int Replay(std::string filename = "", double speed = 1.0);
+	// Time taken by the last Replay to complete (msec)
+	double GetReplayTime();
+
+	// Trace export
+	// Spans of Open, Close, Refresh, Load, Save, image decode and the
+	// ofApp callback function are buffered for each thread and written
+	// to a Chrome trace file by a background thread (ofxWinDialogTrace.h).
+	// Open the file with chrome://tracing or https://ui.perfetto.dev
+	//   filename - the default is the executable name with ".json"
+	//   capacity - spans buffered for each thread, set by the first StartTrace
+	bool StartTrace(std::string filename = "", size_t capacity = 4096);
+	// Stop the trace and complete the file
+	void StopTrace();
+	bool IsTracing();
+	// Spans dropped because a buffer was full
+	uint64_t GetTraceDropped();
+
+	// Message statistics
+	// Times of WindowProc for each message, of the messages for each
+	// control and of the ofApp callback function, in microseconds.
+	// Times include messages sent while a message is handled.
+	// Requires the "statsWinDialog" define, otherwise returns false.
+	struct latencystats {
+		uint64_t count = 0;
+		double mean = 0.0;
+		double p50 = 0.0;
+		double p90 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+	};
+	bool GetMessageStats(UINT msg, latencystats &stats);
+	// Messages with times recorded
+	std::vector<UINT> GetStatsMessages();
+	// WM_COMMAND, WM_NOTIFY, WM_HSCROLL, WM_DRAWITEM etc. for a control
+	bool GetControlStats(std::string title, latencystats &stats);
+	bool GetCallbackStats(latencystats &stats);
+	// Time added to each message by the timing (usec)
+	double GetStatsOverhead();
+	void ResetStats();
+
 	// Dialog background colour
 	void BackGroundColor(int hexcode);
 	void BackGroundColor(int red, int grn, int blu);
@@ -385,6 +693,18 @@ public:
 	// Hide on open
 	void Hide();
 
+	// Double buffered painting to prevent flicker on resize
+	// Background, group frames and owner draw buttons are drawn
+	// to off-screen buffers and copied to the window when complete.
+	// Set before Open.
+	void DoubleBuffer();
+
+	// Create all controls with one in-memory dialog template
+	// The controls are compiled to a dialog template that is
+	// re-used by Open until the controls are changed.
+	// Not used with DoubleBuffer. Set before Open.
+	void UseTemplate(bool bTemplate = true);
+
     // Set dialog position and size
     //  o If x and y are both positive, that position is used
     //  o If x and y are both zero, centre on the host window
@@ -401,6 +721,78 @@ public:
     // Close dialog window and retain controls
     void Close();
 
+	// Keep the dialog window when it is closed
+	// Close hides the window and Open shows it again without
+	// creating the controls. Set functions while the dialog is
+	// hidden are applied when it is shown again. The app is
+	// informed of close by "WM_CLOSE" instead of "WM_DESTROY".
+	// KeepAlive(false) destroys a hidden dialog window.
+	void KeepAlive(bool bKeep = true);
+
+	// Time taken by the last Open (msec)
+	double GetOpenTime();
+
+	// Dialog thread
+	// Run the dialog window and its messages on a thread of their own
+	// so that the dialog responds while ofApp is busy in update or draw.
+	// Set before Open. Open starts the thread and returns when the
+	// window has been created. The thread ends when the window is
+	// destroyed. The dialog window has no owner window in this mode.
+	// Set functions called by ofApp are queued and applied by the
+	// dialog thread in batches. Get functions, SetCombo, SetList,
+	// GetControls, Reset, Restore, Refresh, Save and Load wait for the
+	// dialog thread. Other functions are called before Open.
+	void UseThread(bool bThread = true);
+	// Call the ofApp callback function with the control events queued
+	// by the dialog thread. Call from ofApp update. Also applies shared
+	// parameters changed by other threads while the dialog is closed.
+	// Returns the number of events.
+	int PollEvents();
+
+	// Thread-safe Set functions
+	// SetCheckBox, SetRadioButton, SetSlider, SetEdit, SetText,
+	// SetComboItem, SetListItem and SetSpin called by a thread other
+	// than the thread of the dialog window are queued and applied by
+	// the window thread at its next message. Only the last value set
+	// for each control is applied and the dialog is drawn once for each
+	// batch. Always on for UseThread. Other functions are not changed.
+	// Set before Open.
+	void QueueSet(bool bQueue = true);
+
+	// Shared parameters
+	// Bind a control to an entry of the process-wide parameter store
+	// (ParamStore::Global in ofxWinDialogParams.h) so that controls of
+	// the same parameter in several dialogs have the same value. The
+	// key is the control title if empty. A new entry has the value of
+	// the control, otherwise the control is set to the entry value.
+	// A change by the user is passed to all other bound controls, and a
+	// change to the store by ofApp or another thread is passed to all.
+	// A change by another thread is applied by the thread of the dialog
+	// window or, while the dialog is closed, by the thread that created
+	// the dialog at the next Open or PollEvents. Set functions change
+	// only their control. Bind after the control has been added and
+	// before Open. QueueSet is set by the first binding.
+	bool BindParameter(std::string title, std::string key = "");
+	void UnbindParameter(std::string title);
+
+	// OSC control surface
+	// Each control is addressed by its title as "/title", or as
+	// "/prefix/title" for several dialogs, with spaces as '_'
+	// (ofxWinDialogOsc.h). Messages received by a background thread set
+	// the control and call the ofApp callback function as if changed by
+	// the user. A message to a button presses it. Messages received
+	// together are applied with one redraw and only the last value for
+	// each control. Slider and checkbox changes are sent to the host,
+	// at most once for each interval for each control. The last value
+	// is always sent. A received value is not sent back.
+	//   port     - UDP port to receive, 0 to send only
+	//   host     - IP address to send to, empty to receive only
+	//   sendport - UDP port of the host
+	//   interval - minimum time between messages for a control (msec)
+	//   prefix   - first part of the address of each control
+	bool StartOsc(int port, std::string host = "", int sendport = 0, int interval = 20, std::string prefix = "");
+	void StopOsc();
+
     // Disable Visual Style themes for dialog controls
     // if using common controls version 6.0.0.0
     // All controls if hwndControl is not specified
@@ -428,33 +820,17 @@ public:
     //
     // Control variables
     //
-    struct ctl {
-
-        std::string Type="";  // Control type
-        std::string Title=""; // Control title
-        std::string Section=""; // Control section for initialization file
-
-        // Control size
-        int X = 0;
-        int Y = 0;
-        int Width = 0;
-        int Height = 0;
-
-        std::string Text="";  // Edit control text
-        std::vector<std::string> Items; // Combo list items
-        int Index = 0; // Combo list index
-
-        // Slider
-        float Min = 0; // Range min
-        float Max = 0; // Range max
-        float SliderVal = 0; // Slider value
-        float Tick = 0; // Tick interval
+    // Control values (DialogControl in ofxWinDialogCore.h) and windows
+    struct ctl : public DialogControl {
 
         // Buttons
-        int Val = 0; // Value
-        int RadioGroup = 0; // Radio button group
         bool First = false; // First in group flag (see AddRadioGroup)
 
+        int Atlas = -1; // Picture button atlas image (ButtonAtlas)
+        int Store = -1; // Virtual list item store (AddVirtualList)
+        int Search = -1; // Item search index (FindComboItem, FindListItem, SetListFilter)
+        int Page = -1; // Page of the control (AddPage)
+
         uint64_t ID = 0LL; // Control ID
         DWORD Style = 0; // Static text and button style
         bool VisualStyle = true; // Enable or disable Visual Styles for a control
@@ -485,10 +861,51 @@ public:
     HWND hwndOKButton = NULL;  // OK Button
     HWND hwndCancelButton = NULL;  // Cancel Button
 	HBRUSH g_hBrush = NULL; // Dialog background brush
+	COLORREF g_BackColor = 0; // Dialog background colour
 		
 	COLORREF g_TextColor = RGB(0, 0, 0); // Static text colour
 	COLORREF g_ButtonColor = RGB(0, 0, 0); // Button background (default COLOR_BTNFACE);
 	HBITMAP g_hBitmap = nullptr; // Bitmap handle for owner draw button
+	std::vector<HBITMAP> g_Bitmaps; // Bitmaps created by ofxWinDialog
+
+	// Streaming picture button surface
+	struct buttonstream {
+		HBITMAP hBitmap[2]{}; // Double buffered DIB sections
+		unsigned char* bits[2]{}; // DIB pixels
+		int width = 0;
+		int height = 0;
+		int pitch = 0; // DIB row pitch
+		int front = 0; // Buffer to draw
+		HWND hwndControl = NULL; // Button to invalidate
+		std::mutex drawmutex; // Front buffer swap and draw
+		std::mutex writemutex; // Back buffer write
+		streamstats stats;
+		bool bClosed = false; // Set by CloseButtonStream with both locks held
+	};
+	// A writer holds a reference so that the stream is not
+	// destroyed by CloseButtonStream while it waits for the lock
+	std::map<std::string, std::shared_ptr<buttonstream>> g_Streams;
+	std::mutex g_StreamMutex; // Map insert, find and erase
+	std::shared_ptr<buttonstream> FindButtonStream(const std::string &title);
+
+	// Picture button atlas
+	struct atlaspage {
+		HBITMAP hBitmap = nullptr; // Page DIB section
+		unsigned char* bits = nullptr; // DIB pixels
+		int pitch = 0; // DIB row pitch
+		HDC hdcMem = NULL; // Memory DC with the page selected
+		HBITMAP hOldBitmap = nullptr;
+		AtlasPacker packer;
+	};
+	struct atlasimage {
+		int page = -1; // -1 if free
+		AtlasRect rect;
+	};
+	std::vector<atlaspage> g_AtlasPages;
+	std::vector<atlasimage> g_AtlasImages;
+	bool bAtlas = false; // Atlas mode (ButtonAtlas)
+	int g_AtlasSize = 1024; // Atlas page size
+	int g_AtlasImage = -1; // Atlas image for AddButton and SetButton
 
 	// Dialog position and size
     int dialogX = 0;
@@ -507,15 +924,267 @@ public:
 	// Hide on open
 	bool bHide = false;
 
+	// Double buffered painting
+	bool bDoubleBuffer = false;
+	HDC g_hdcBack = NULL; // Back buffer for background and group frames
+	HBITMAP g_hbmBack = nullptr;
+	HBITMAP g_hbmBackOld = nullptr;
+	BackBufferSize g_BackSize;
+	DirtyRegion g_Dirty; // Back buffer areas to render
+	HDC g_hdcItem = NULL; // Owner draw button buffer
+	HBITMAP g_hbmItem = nullptr;
+	HBITMAP g_hbmItemOld = nullptr;
+	BackBufferSize g_ItemSize;
+	void AllocateBackBuffer(HDC hdc, int width, int height);
+	void ReleaseBackBuffer();
+	void RenderBackBuffer();
+	HDC GetItemBuffer(HDC hdc, int width, int height);
+
     // Variables for optional font
     std::string fontname;
 	LONG fontheight = 0;
     LONG fontweight = FW_NORMAL;
 	HFONT g_hFont = NULL;
 
-	// TODO
-	// Windows scale factor
-	// double g_Scale = 1.0; // default 100%
+	// Drawing objects created once and released in the destructor
+	GdiCache<WinGdiBackend> g_Gdi;
+
+	// Virtual list item storage
+	std::vector<ItemStore> g_Stores;
+	std::string GetListText(const ctl &control, int item);
+
+	// Bulk item loading
+	double g_LoadTime = 0.0;
+	void InsertItems(HWND hwndList, bool bCombo, const char* data, const size_t* offsets, size_t count, const uint32_t* itemdata = nullptr, bool bUtf8 = false);
+	void InsertItems(HWND hwndList, bool bCombo, const std::vector<std::string> &items, const uint32_t* itemdata = nullptr);
+
+	// Item search
+	struct itemsearch {
+		ItemIndex index;
+		bool bFiltered = false;
+		std::string filter; // Filter text
+		bool bContains = false; // Items containing the filter text
+		std::string edit; // Edit control for filter as you type
+		std::vector<uint32_t> rows; // Items shown when filtered
+	};
+	std::vector<itemsearch> g_Search;
+	ItemIndex &GetSearchIndex(ctl &control, bool bNgrams = false);
+	void UpdateSearch(ctl &control);
+	void ApplyListFilter(ctl &control);
+	bool IsListFiltered(const ctl &control);
+	int ListItemFromRow(const ctl &control, int row);
+	int ListRowFromItem(const ctl &control, int item);
+
+	// Owner draw button hover state
+	HoverTracker g_Hover;
+	void UpdateHoverIndex();
+
+	// Control windows
+	uint64_t g_NextID = 1000; // Next control ID
+	void CreateControl(size_t i, HWND hwnd, uint64_t &ID);
+	void InitControl(size_t i);
+	void ShowControl(size_t i, bool bShow);
+	void DestroyControl(size_t i);
+	void SyncControlHandles(size_t i);
+
+	// Keep-alive dialog (KeepAlive)
+	// Changes made while the dialog is hidden are kept by the core
+	enum {
+		ChangedValue = DialogControl::ChangedValue,
+		ChangedWindow = DialogControl::ChangedWindow,
+		ChangedItems = DialogControl::ChangedItems
+	};
+	double g_OpenTime = 0.0;
+	HWND ShowDialog(std::string title);
+	void HideDialog();
+
+	// Dialog description
+	std::string g_ParseError;
+	double g_ParseTime = 0.0;
+	bool DescriptionStatement(DescStatement &st, std::string &section);
+	bool DescriptionStyle(DescStatement &st, DWORD &dwStyle);
+
+	// Hot reload (WatchIni, WatchDialog)
+	struct watchfile {
+		std::string path;
+		std::string section; // Initialization file section if specified
+		bool bDialog = false; // Dialog description
+		IniValues values; // Values last read
+		std::vector<DescRecord> statements; // Statements last read
+	};
+	struct reload {
+		std::string path;
+		std::string section;
+		bool bDialog = false;
+		bool bStructure = false; // Description changed more than values
+		std::vector<IniValues::value> values; // Changed initialization values
+		std::vector<DescRecord> statements; // Changed statements
+	};
+	std::vector<watchfile> g_WatchFiles; // Used by the watch thread while it runs
+	FileWatch g_Watch;
+	std::thread g_WatchThread;
+	HANDLE g_hWatchStop = NULL;
+	std::atomic<HWND> g_hwndWatch{ NULL }; // Dialog window for reload messages
+	std::mutex g_ReloadMutex;
+	std::vector<reload> g_Reloads; // Changes read by the watch thread
+	void WatchFile(std::string path, std::string section, bool bDialog);
+	void StartWatchThread();
+	void EndWatchThread();
+	void WatchThread();
+	bool ReadWatchFile(watchfile &file, reload* changes);
+	void ApplyReloads();
+	void ApplyIniValue(const IniValues::value &v, const std::string &section, int &changes);
+	void ApplyStatement(const DescRecord &r, int &changes);
+	std::string GetFilePath(std::string filename, std::string extension);
+
+	// Pages
+	PageSet g_Pages;
+	int g_AddPage = -1; // Page for controls being added
+	size_t g_PageFirst = 0; // First control of the page
+	void ClosePage();
+
+	// Automatic layout
+	LayoutTree g_Layout;
+	int g_LayoutBox = 0; // Box for controls being added
+	int g_LayoutDepth = 0; // Boxes not ended
+	size_t g_LayoutFirst = 0; // First control not in the layout
+	std::vector<LayoutTree::placed> g_Placed; // Controls moved by the last layout
+	double g_LayoutTime = 0.0;
+	void LayoutBox(int kind, int spacing, int columns);
+	void FlushLayout();
+	bool ArrangeLayout(int width, int height);
+
+	// Dialog template (UseTemplate)
+	struct templateitem {
+		size_t control = 0;
+		int part = 0; // Second window of a slider or spin control
+	};
+	bool bUseTemplate = false;
+	DialogTemplate g_Template;
+	uint64_t g_TemplateKey = 0; // Values used to compile the template
+	std::vector<templateitem> g_TemplateItems;
+	HWND g_hwndTemplate = NULL; // Child dialog with the control windows
+	uint64_t GetTemplateKey(int width, int height);
+	void CompileTemplate(int width, int height);
+	HWND CreateFromTemplate(HWND hwnd);
+	void InitTemplateControl(size_t i);
+	HWND GetControlParent();
+
+	// DPI scaling
+	DpiScale g_Dpi;
+	void SetDialogDpi(int dpi);
+	void MoveControlWindows(const std::vector<size_t> &moved);
+	HFONT DialogFont();
+
+	// Event recording (StartRecording, Replay)
+	EventTrace g_Trace;
+	bool bRecording = false;
+	std::chrono::steady_clock::time_point g_RecordStart;
+	double g_ReplayTime = 0.0;
+	EventTrace g_ReplayTrace; // Events of the replay
+	size_t g_ReplayNext = 0; // Next event to replay
+	uint64_t g_ReplayDue = 0; // Time of the last event applied from the start (usec)
+	double g_ReplaySpeed = 0.0;
+	std::chrono::steady_clock::time_point g_ReplayStart;
+	bool bReplayTimer = false;
+	void RecordEvent(int op, const std::string &title, const std::string &text, int value, float fvalue = 0.0f);
+	void ReplayEvent(const EventTrace::event &e);
+	void ReplayDue();
+
+	// Thread of the key message hook (GetKeyMsgProc)
+	DWORD m_HookThread = 0;
+
+	// Dialog thread (UseThread)
+	bool bUseThread = false;
+	bool bQueueSet = false; // Set functions of other threads are queued (QueueSet)
+	std::thread g_DialogThread;
+	std::atomic<DWORD> g_DialogThreadId{ 0 }; // While the thread runs
+	std::atomic<DWORD> g_WindowThreadId{ 0 }; // Thread of the dialog window while open
+	std::atomic<HWND> g_hwndThread{ NULL }; // Dialog window for queued commands
+	std::atomic<int> g_Queuing{ 0 }; // Set functions queuing a command
+	CommandQueue<EventTrace::event> g_Commands; // Set functions called by other threads
+	std::vector<EventTrace::event> g_CommandBatch;
+	CommandCollapse g_Collapse;
+	BatchQueue<DialogEvent> g_Events; // Control events for PollEvents
+	HWND OpenThread(std::string title);
+	void EndDialogThread();
+	void DialogThread(std::string title, HANDLE hOpened);
+	bool OtherThread();
+	bool CallDialogThread(const std::function<void()> &fn);
+	bool QueueCommand(int op, const std::string &title, const std::string &text, int value, float fvalue = 0.0f);
+	void ApplyCommands();
+	void EndCommands(std::atomic<DWORD> &thread);
+	void AppCallback(const std::string &title, const std::string &text, int value);
+
+	// Trace export (StartTrace)
+	TraceLog g_TraceLog;
+	std::thread g_TraceThread;
+	std::atomic<bool> bTraceRun{ false };
+	std::ofstream g_TraceFile;
+	bool bTraceFirst = true;
+	void TraceThread();
+	void FlushTrace();
+
+	// Message statistics (statsWinDialog)
+	#ifdef statsWinDialog
+	LatencyTable g_MessageStats; // By message
+	LatencyTable g_ControlStats; // By control ID
+	LatencyHistogram g_CallbackStats;
+	double g_StatsOverhead = -1.0; // Measured on first use
+	#endif
+
+	// Control lookup, values, events, keep-alive changes and layout
+	// (DialogCore in ofxWinDialogCore.h). The Win32 backend, defined in
+	// ofxWinDialog.cpp, changes the control windows for the core.
+	struct winbackend;
+	std::unique_ptr<winbackend> g_Backend;
+	DialogCore<ctl> g_Core{ controls };
+
+	// Shared parameters (BindParameter)
+	struct parambinding {
+		std::string title;
+		std::string type;
+		int param = -1; // Store entry, -1 if unbound
+		int binding = -1; // Store binding
+	};
+	std::vector<parambinding> g_ParamBindings; // By binding tag
+	std::mutex g_ParamMutex; // Bindings
+	std::atomic<bool> bParams{ false }; // A control has been bound
+	int g_ParamSubscriber = -1;
+	CommandQueue<ParamStore::change> g_ParamQueue; // Changes made by other threads
+	std::vector<ParamStore::change> g_ParamBatch;
+	CommandCollapse g_ParamCollapse;
+	DWORD ParamThread();
+	double ControlNumber(const ctl &control);
+	void PublishParameters(const std::string &title);
+	void ApplyParameter(const parambinding &b, double number, const std::string &text);
+	void ParamsChanged(const std::vector<ParamStore::change> &changes);
+	void ApplyParams();
+
+	// OSC bridge (StartOsc)
+	// Winsock socket and send address, defined in ofxWinDialog.cpp
+	// so that users of the addon do not need the Winsock headers
+	struct oscsocket;
+	std::unique_ptr<oscsocket> g_Osc;
+	bool bOscSend = false;
+	bool bOscApplying = false; // Received values are not sent back
+	bool bOscTimer = false;
+	std::string g_OscPrefix;
+	std::thread g_OscThread;
+	CommandQueue<OscMessage> g_OscIn; // Received by the OSC thread
+	std::vector<OscMessage> g_OscBatch;
+	CommandCollapse g_OscCollapse;
+	std::unordered_map<std::string, std::string> g_OscTitles; // Control titles by address
+	size_t g_OscControls = 0; // Controls when the titles were found
+	OscRateLimit g_OscLimit;
+	std::vector<OscMessage> g_OscDue;
+	std::vector<uint8_t> g_OscPacket;
+	void OscThread(oscsocket* osc);
+	void ApplyOsc();
+	void ApplyOscMessage(const OscMessage &msg);
+	void SendOsc(const std::string &title);
+	void FlushOsc();
+	void SendOscMessage(const OscMessage &msg);
 
 	// Register dialog window
 	bool RegisterDialog();
@@ -523,8 +1192,22 @@ public:
 
 	// Create button bitmap from image path
 	HBITMAP CreateButtonBitmap(std::string path);
+	// Decode an image file
+	unsigned char* LoadImagePixels(const std::string &path, int &width, int &height, int &nchannels);
 	// Create button bitmap from pixel buffer
 	HBITMAP CreateButtonBitmap(unsigned char* pixels, int width, int height, int nchannels, bool bInvert, bool bSwapRG);
+	// Create an empty top-down 24 bit DIB section
+	HBITMAP CreateDibSection(int width, int height, unsigned char** bits);
+	// Release a bitmap created by ofxWinDialog if no longer used
+	void ReleaseButtonBitmap(HBITMAP hBitmap);
+	// Copy an image into an atlas page
+	int AtlasInsert(unsigned char* imageData, int width, int height, int nchannels, bool bInvert, bool bSwapRG);
+	// Release an atlas image if no longer used
+	void AtlasRelease(int index);
+	// Replace the atlas image of a picture button
+	void SetAtlasPicture(int index, unsigned char* imageData, int width, int height, int nchannels, bool bInvert, bool bSwapRG);
+	// Allocate streaming button surfaces
+	bool AllocateButtonStream(buttonstream &stream, int width, int height);
 
 	// Get executable or dll path
 	std::string GetExePath(bool bFull = false);
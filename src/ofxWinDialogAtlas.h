@@ -0,0 +1,183 @@
+//
+// ofxWinDialogAtlas.h
+//
+// Rectangle packing for picture button image atlases.
+// Tested by tests/ofxWinDialogAtlasTest.cpp.
+//
+// Shelf packing :
+//   The atlas is divided into horizontal shelves. Each shelf keeps
+//   a list of free spans. A rectangle is placed in the shelf with
+//   the least wasted height that has a wide enough free span, or a
+//   new shelf is opened below the last one. Removed rectangles are
+//   returned to their shelf and merged with neighbouring free spans.
+//   Empty shelves at the bottom of the atlas are reclaimed.
+//
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+struct AtlasRect {
+	int x = 0;
+	int y = 0;
+	int width = 0;
+	int height = 0;
+};
+
+class AtlasPacker {
+
+public:
+
+	AtlasPacker(int width = 0, int height = 0) {
+		Reset(width, height);
+	}
+
+	// Clear all rectangles
+	void Reset(int width, int height) {
+		m_Width = width;
+		m_Height = height;
+		m_Used = 0;
+		m_Area = 0;
+		m_Shelves.clear();
+	}
+
+	// Find space for a rectangle
+	// Returns false if the atlas is full
+	bool Insert(int width, int height, AtlasRect &rect) {
+
+		if (width <= 0 || height <= 0 || width > m_Width || height > m_Height)
+			return false;
+
+		// Best existing shelf - least wasted height
+		size_t bestspan = 0;
+		int best = FindShelf(width, height, true, bestspan);
+
+		// Open a new shelf below the last one
+		if (best < 0) {
+			int top = m_Shelves.empty() ? 0 : m_Shelves.back().y + m_Shelves.back().height;
+			if (top + height <= m_Height) {
+				shelf s;
+				s.y = top;
+				s.height = height;
+				s.free.push_back({ 0, m_Width });
+				m_Shelves.push_back(s);
+				best = (int)m_Shelves.size() - 1;
+				bestspan = 0;
+			}
+		}
+
+		// No room for a new shelf - allow any taller shelf
+		if (best < 0)
+			best = FindShelf(width, height, false, bestspan);
+		if (best < 0)
+			return false;
+
+		// Take the space from the left of the free span
+		shelf &s = m_Shelves[best];
+		span &f = s.free[bestspan];
+		rect.x = f.x;
+		rect.y = s.y;
+		rect.width = width;
+		rect.height = height;
+		f.x += width;
+		f.width -= width;
+		if (f.width == 0)
+			s.free.erase(s.free.begin() + bestspan);
+		s.count++;
+
+		m_Used++;
+		m_Area += (long long)width * height;
+		return true;
+	}
+
+	// Return the space of a rectangle found by Insert
+	void Remove(const AtlasRect &rect) {
+
+		for (size_t i = 0; i < m_Shelves.size(); i++) {
+			shelf &s = m_Shelves[i];
+			if (s.y != rect.y)
+				continue;
+
+			// Insert the span in x order and merge with neighbours
+			size_t j = 0;
+			while (j < s.free.size() && s.free[j].x < rect.x) j++;
+			s.free.insert(s.free.begin() + j, { rect.x, rect.width });
+			if (j + 1 < s.free.size() && s.free[j].x + s.free[j].width == s.free[j + 1].x) {
+				s.free[j].width += s.free[j + 1].width;
+				s.free.erase(s.free.begin() + j + 1);
+			}
+			if (j > 0 && s.free[j - 1].x + s.free[j - 1].width == s.free[j].x) {
+				s.free[j - 1].width += s.free[j].width;
+				s.free.erase(s.free.begin() + j);
+			}
+			s.count--;
+
+			// Reclaim empty shelves at the bottom
+			while (!m_Shelves.empty() && m_Shelves.back().count == 0)
+				m_Shelves.pop_back();
+
+			m_Used--;
+			m_Area -= (long long)rect.width * rect.height;
+			return;
+		}
+	}
+
+	// Number of rectangles in the atlas
+	int GetCount() const { return m_Used; }
+
+	// Fraction of the atlas area occupied by rectangles
+	double GetOccupancy() const {
+		if (m_Width <= 0 || m_Height <= 0) return 0.0;
+		return (double)m_Area / ((double)m_Width * (double)m_Height);
+	}
+
+	int GetWidth() const { return m_Width; }
+	int GetHeight() const { return m_Height; }
+
+private:
+
+	// Shelf with the least wasted height and a wide enough free span
+	// bStrict - avoid placing small images in much taller shelves
+	int FindShelf(int width, int height, bool bStrict, size_t &spanindex) const {
+		int best = -1;
+		int bestwaste = m_Height + 1;
+		for (size_t i = 0; i < m_Shelves.size(); i++) {
+			const shelf &s = m_Shelves[i];
+			if (s.height < height)
+				continue;
+			int waste = s.height - height;
+			if (bStrict && waste > height && waste > 8)
+				continue;
+			if (waste >= bestwaste)
+				continue;
+			for (size_t j = 0; j < s.free.size(); j++) {
+				if (s.free[j].width >= width) {
+					best = (int)i;
+					spanindex = j;
+					bestwaste = waste;
+					break;
+				}
+			}
+		}
+		return best;
+	}
+
+	struct span {
+		int x;
+		int width;
+	};
+
+	struct shelf {
+		int y = 0;
+		int height = 0;
+		int count = 0; // Rectangles in the shelf
+		std::vector<span> free; // Free spans in x order
+	};
+
+	int m_Width = 0;
+	int m_Height = 0;
+	int m_Used = 0;
+	long long m_Area = 0;
+	std::vector<shelf> m_Shelves;
+
+};
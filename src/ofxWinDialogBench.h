@@ -0,0 +1,223 @@
+//
+// ofxWinDialogBench.h
+//
+// Timing of repeated scenarios with results as JSON and
+// comparison with the results of an earlier version.
+// Tested by tests/ofxWinDialogBenchTest.cpp.
+//
+// BenchResults
+//   Run times a scenario a number of times after one untimed run.
+//   Times are in milliseconds for one run. The median is used for
+//   comparison because a few runs may be slowed by other processes.
+//   "ops" is the number of operations in one run (controls searched,
+//   keys saved etc.) so that the time for each operation is known.
+//
+//   The JSON text is one object with an array of results :
+//     { "results" : [ { "name" : "lookup", "runs" : 20, "ops" : 500,
+//       "min" : 0.01, "median" : 0.012, "p95" : 0.02, "mean" : 0.013 }, ... ] }
+//   ParseJson reads this format only.
+//
+#pragma once
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstddef>
+
+class BenchResults {
+
+public:
+
+	struct result {
+		std::string name;
+		size_t runs = 0;
+		size_t ops = 0; // Operations in one run
+		double min = 0.0; // Milliseconds for one run
+		double median = 0.0;
+		double p95 = 0.0;
+		double mean = 0.0;
+	};
+
+	struct comparison {
+		std::string name;
+		double baseline = 0.0; // Median of the baseline
+		double median = 0.0;
+		double change = 0.0; // 0.1 = 10% slower
+	};
+
+	// Time "runs" calls of fn() after one untimed call
+	template <typename Fn>
+	const result &Run(const std::string &name, int runs, size_t ops, Fn fn) {
+		if (runs < 1) runs = 1;
+		fn();
+		std::vector<double> times;
+		times.reserve((size_t)runs);
+		for (int i = 0; i < runs; i++) {
+			auto start = std::chrono::steady_clock::now();
+			fn();
+			times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+		return Add(name, ops, times);
+	}
+
+	// Add a result from run times
+	const result &Add(const std::string &name, size_t ops, std::vector<double> times) {
+		result r;
+		r.name = name;
+		r.ops = ops;
+		r.runs = times.size();
+		if (!times.empty()) {
+			std::sort(times.begin(), times.end());
+			double sum = 0.0;
+			for (size_t i = 0; i < times.size(); i++)
+				sum += times[i];
+			size_t n = times.size();
+			r.min = times[0];
+			r.median = (n % 2) ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) / 2.0;
+			r.p95 = times[(std::min)(n - 1, (n * 95 + 99) / 100 - 1)];
+			r.mean = sum / (double)n;
+		}
+		m_Results.push_back(r);
+		return m_Results.back();
+	}
+
+	// Result of a scenario or nullptr
+	const result* Find(const std::string &name) const {
+		for (size_t i = 0; i < m_Results.size(); i++) {
+			if (m_Results[i].name == name)
+				return &m_Results[i];
+		}
+		return nullptr;
+	}
+
+	const std::vector<result> &GetResults() const { return m_Results; }
+	size_t Size() const { return m_Results.size(); }
+	void Clear() { m_Results.clear(); }
+
+	std::string ToJson() const {
+		std::string json = "{\n  \"results\" : [\n";
+		char tmp[256]{};
+		for (size_t i = 0; i < m_Results.size(); i++) {
+			const result &r = m_Results[i];
+			json += "    { \"name\" : \"";
+			json += Escape(r.name);
+			snprintf(tmp, sizeof(tmp),
+				"\", \"runs\" : %zu, \"ops\" : %zu, \"min\" : %.6f, \"median\" : %.6f, \"p95\" : %.6f, \"mean\" : %.6f }",
+				r.runs, r.ops, r.min, r.median, r.p95, r.mean);
+			json += tmp;
+			json += (i + 1 < m_Results.size()) ? ",\n" : "\n";
+		}
+		json += "  ]\n}\n";
+		return json;
+	}
+
+	// Read results written by ToJson
+	// Returns false if no result is found
+	bool ParseJson(const std::string &json) {
+		m_Results.clear();
+		size_t pos = json.find('[');
+		while (pos != std::string::npos) {
+			size_t open = json.find('{', pos);
+			if (open == std::string::npos)
+				break;
+			size_t close = json.find('}', open);
+			if (close == std::string::npos)
+				break;
+			std::string object = json.substr(open, close - open);
+			result r;
+			if (ReadString(object, "name", r.name)) {
+				r.runs = (size_t)ReadNumber(object, "runs");
+				r.ops = (size_t)ReadNumber(object, "ops");
+				r.min = ReadNumber(object, "min");
+				r.median = ReadNumber(object, "median");
+				r.p95 = ReadNumber(object, "p95");
+				r.mean = ReadNumber(object, "mean");
+				m_Results.push_back(r);
+			}
+			pos = close + 1;
+		}
+		return !m_Results.empty();
+	}
+
+	//
+	// Compare with the results of a baseline
+	//   tolerance - slower fraction allowed (0.1 = 10%)
+	//   changes   - every scenario found in both results
+	// Returns the number of scenarios slower than the tolerance.
+	// Scenarios of less than a microsecond are not compared.
+	//
+	size_t Compare(const BenchResults &baseline, double tolerance, std::vector<comparison> &changes) const {
+		changes.clear();
+		size_t slower = 0;
+		for (size_t i = 0; i < m_Results.size(); i++) {
+			const result* b = baseline.Find(m_Results[i].name);
+			if (!b)
+				continue;
+			comparison c;
+			c.name = m_Results[i].name;
+			c.baseline = b->median;
+			c.median = m_Results[i].median;
+			if (b->median > 0.001) {
+				c.change = (c.median - c.baseline) / c.baseline;
+				if (c.change > tolerance)
+					slower++;
+			}
+			changes.push_back(c);
+		}
+		return slower;
+	}
+
+private:
+
+	static std::string Escape(const std::string &text) {
+		std::string s;
+		for (size_t i = 0; i < text.size(); i++) {
+			if (text[i] == '"' || text[i] == '\\')
+				s += '\\';
+			if ((unsigned char)text[i] >= 0x20)
+				s += text[i];
+		}
+		return s;
+	}
+
+	// Position after "key" :
+	static size_t Value(const std::string &object, const char* key) {
+		std::string name = std::string("\"") + key + "\"";
+		size_t pos = object.find(name);
+		if (pos == std::string::npos)
+			return std::string::npos;
+		pos = object.find(':', pos + name.size());
+		if (pos == std::string::npos)
+			return std::string::npos;
+		pos++;
+		while (pos < object.size() && (object[pos] == ' ' || object[pos] == '\t'))
+			pos++;
+		return pos;
+	}
+
+	static bool ReadString(const std::string &object, const char* key, std::string &text) {
+		size_t pos = Value(object, key);
+		if (pos == std::string::npos || pos >= object.size() || object[pos] != '"')
+			return false;
+		text.clear();
+		for (pos++; pos < object.size() && object[pos] != '"'; pos++) {
+			if (object[pos] == '\\' && pos + 1 < object.size())
+				pos++;
+			text += object[pos];
+		}
+		return true;
+	}
+
+	static double ReadNumber(const std::string &object, const char* key) {
+		size_t pos = Value(object, key);
+		if (pos == std::string::npos)
+			return 0.0;
+		return atof(object.c_str() + pos);
+	}
+
+	std::vector<result> m_Results;
+
+};
@@ -0,0 +1,131 @@
+//
+// ofxWinDialogCache.h
+//
+// Cache of drawing objects (brushes, pens, fonts, cursors)
+// used by owner draw and paint messages.
+//
+// Objects are created once on first use, keyed by type, colour
+// and style, and released together when the cache is cleared
+// or destroyed. Objects are created and released by a backend
+// class, a fake one in tests/ofxWinDialogCacheTest.cpp :
+//
+//   struct Backend {
+//       typedef <handle type> Handle;
+//       Handle Create(const GdiKey &key);
+//       void Destroy(const GdiKey &key, Handle handle);
+//   };
+//
+// The Windows backend is "WinGdiBackend" in ofxWinDialog.h.
+//
+#pragma once
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <cstdint>
+
+// Object types
+enum GdiType {
+	GdiBrush  = 1, // Solid brush - color
+	GdiPen    = 2, // Pen - style, size (width), color
+	GdiFont   = 3, // Font - name, size (height), style (weight)
+	GdiCursor = 4  // System cursor - color is the resource ID
+};
+
+// Cache key
+struct GdiKey {
+	int type = 0;
+	uint32_t color = 0;
+	int style = 0;
+	int size = 0;
+	std::string name;
+	bool operator<(const GdiKey &k) const {
+		return std::tie(type, color, style, size, name)
+			< std::tie(k.type, k.color, k.style, k.size, k.name);
+	}
+};
+
+template <typename Backend>
+class GdiCache {
+
+public:
+
+	typedef typename Backend::Handle Handle;
+
+	GdiCache() {}
+	~GdiCache() { Clear(); }
+
+	// Objects are owned by the cache
+	GdiCache(const GdiCache &) = delete;
+	GdiCache &operator=(const GdiCache &) = delete;
+
+	// Find or create an object
+	Handle Get(const GdiKey &key) {
+		auto it = m_Objects.find(key);
+		if (it != m_Objects.end()) {
+			m_Reused++;
+			return it->second;
+		}
+		Handle handle = m_Backend.Create(key);
+		if (handle) {
+			m_Objects[key] = handle;
+			m_Created++;
+		}
+		return handle;
+	}
+
+	Handle Brush(uint32_t color) {
+		GdiKey key;
+		key.type = GdiBrush;
+		key.color = color;
+		return Get(key);
+	}
+
+	Handle Pen(int style, int width, uint32_t color) {
+		GdiKey key;
+		key.type = GdiPen;
+		key.style = style;
+		key.size = width;
+		key.color = color;
+		return Get(key);
+	}
+
+	Handle Font(std::string name, int height, int weight) {
+		GdiKey key;
+		key.type = GdiFont;
+		key.name = name;
+		key.size = height;
+		key.style = weight;
+		return Get(key);
+	}
+
+	Handle Cursor(uint32_t id) {
+		GdiKey key;
+		key.type = GdiCursor;
+		key.color = id;
+		return Get(key);
+	}
+
+	// Release all objects
+	void Clear() {
+		for (auto &obj : m_Objects)
+			m_Backend.Destroy(obj.first, obj.second);
+		m_Objects.clear();
+	}
+
+	// Objects created and requests satisfied from the cache
+	uint64_t GetCreated() const { return m_Created; }
+	uint64_t GetReused() const { return m_Reused; }
+	// Objects currently held
+	size_t GetCount() const { return m_Objects.size(); }
+
+	Backend &GetBackend() { return m_Backend; }
+
+private:
+
+	std::map<GdiKey, Handle> m_Objects;
+	Backend m_Backend;
+	uint64_t m_Created = 0;
+	uint64_t m_Reused = 0;
+
+};
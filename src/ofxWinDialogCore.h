@@ -0,0 +1,933 @@
+//
+// ofxWinDialogCore.h
+//
+// Control model of the dialog without windows. ofxWinDialog keeps its
+// controls in a DialogCore and changes the control windows through a
+// ControlBackend. ofxWinDialog.cpp has the Win32 backend, which sends
+// window messages, and ofxWinDialogHeadless.h has a backend that
+// records them, so that the same code is tested and timed on any
+// platform (tests/ofxWinDialogCoreTest.cpp).
+//
+// SliderScale
+//   Trackbar positions are integers. A slider with a range greater
+//   than 1000 uses the value as the position, otherwise the value
+//   times 100 so that two decimal places are kept. Positions are
+//   truncated. The value text has no decimal places for a maximum of
+//   100 or more, one for 10 or more, otherwise two.
+//
+// IniValue
+//   The text of a control value in an initialization file, as written
+//   by Save and read by Load. Static, group and push buttons have no
+//   value. Combo and list boxes save the item index, edit controls the
+//   text, sliders the value with two decimal places and other controls
+//   the integer value.
+//
+// ControlIndex
+//   Controls by type and title. Controls with the same type and title
+//   are chained in the order they were added, so that a Set function
+//   finds every matching control without a search of all controls.
+//
+// DialogControl
+//   The values of a control. ofxWinDialog::ctl adds the window handles.
+//
+// ControlBackend
+//   The changes to control windows for the control values, the values
+//   read back from the windows and the initialization file values.
+//   Controls are identified by their index.
+//
+// DialogCore
+//   Control lookup, Set and Get functions, Refresh, GetControls, Save
+//   and Load, control events (slider, spin, checkbox and combo box),
+//   replay of recorded events, the keep-alive changes (KeepAlive) and
+//   control positions from the layout and DPI. The controls are held
+//   by the owner of the core and can be replaced (Reset, Restore).
+//
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+
+#include "ofxWinDialogLayout.h"
+#include "ofxWinDialogDpi.h"
+#include "ofxWinDialogRecord.h"
+
+class SliderScale {
+
+public:
+
+	// Positions are the value
+	static bool IsWide(float min, float max) {
+		return (max - min) > 1000.0f;
+	}
+
+	// Trackbar position of a value
+	static int ToPosition(float value, float min, float max) {
+		return IsWide(min, max) ? (int)value : (int)(value * 100.0f);
+	}
+
+	// Value of a trackbar position
+	static float FromPosition(int pos, float min, float max) {
+		return IsWide(min, max) ? (float)pos : (float)pos / 100.0f;
+	}
+
+	// Position for a page up or down (5% of the range)
+	static int PageSize(float min, float max) {
+		return (int)((max - min) / 20.0f * 100.0f);
+	}
+
+	// Value text with decimal places for the maximum
+	// Returns the number of characters
+	static int Format(float value, float max, char* text, size_t size) {
+		const char* format = "%.2f";
+		if (max >= 100.0f)
+			format = "%.0f";
+		else if (max >= 10.0f)
+			format = "%.1f";
+		int len = snprintf(text, size, format, value);
+		if (len < 0) {
+			if (size > 0) text[0] = 0;
+			return 0;
+		}
+		return (size_t)len < size ? len : (int)size - 1;
+	}
+
+};
+
+class IniValue {
+
+public:
+
+	// Controls with a value that is saved
+	static bool IsSaved(const std::string &type) {
+		return type != "Static" && type != "Group" && type != "Button"
+			&& type != "OK" && type != "CANCEL";
+	}
+
+	// Text of the value of a control
+	static std::string Write(const std::string &type, int val, int index, float slider, const std::string &text) {
+		char tmp[64]{};
+		if (type == "Combo" || type == "List")
+			snprintf(tmp, sizeof(tmp), "%d", index);
+		else if (type == "Edit")
+			return text;
+		else if (type == "Slider")
+			snprintf(tmp, sizeof(tmp), "%.2f", slider);
+		else
+			snprintf(tmp, sizeof(tmp), "%d", val);
+		return tmp;
+	}
+
+	// Set the value of a control from the text
+	// Returns false if the text is empty or the type has no value,
+	// and the value is not changed.
+	static bool Read(const std::string &type, const std::string &value, int &val, int &index, float &slider, std::string &text) {
+		if (value.empty())
+			return false;
+		if (type == "Combo" || type == "List")
+			index = atoi(value.c_str());
+		else if (type == "Edit")
+			text = value;
+		else if (type == "Slider")
+			slider = (float)atof(value.c_str());
+		else if (type == "Spin" || type == "Checkbox" || type == "Radio")
+			val = atoi(value.c_str());
+		else
+			return false;
+		return true;
+	}
+
+};
+
+class ControlIndex {
+
+public:
+
+	static constexpr size_t npos = SIZE_MAX;
+
+	// Add the next control
+	void Add(const std::string &type, const std::string &title) {
+		size_t id = m_Next.size();
+		m_Next.push_back(npos);
+		auto it = m_Chains.find(Key(type, title));
+		if (it == m_Chains.end()) {
+			m_Chains.emplace(Key(type, title), chain{ id, id });
+			return;
+		}
+		m_Next[it->second.last] = id;
+		it->second.last = id;
+	}
+
+	// First control with the type and title or npos
+	size_t Find(const std::string &type, const std::string &title) const {
+		auto it = m_Chains.find(Key(type, title));
+		return it == m_Chains.end() ? npos : it->second.first;
+	}
+
+	// Last control with the type and title or npos
+	size_t FindLast(const std::string &type, const std::string &title) const {
+		auto it = m_Chains.find(Key(type, title));
+		return it == m_Chains.end() ? npos : it->second.last;
+	}
+
+	// Next control with the same type and title or npos
+	size_t Next(size_t id) const {
+		return id < m_Next.size() ? m_Next[id] : npos;
+	}
+
+	void Clear() {
+		m_Next.clear();
+		m_Chains.clear();
+	}
+
+	// Number of controls indexed
+	size_t Size() const { return m_Next.size(); }
+
+private:
+
+	static std::string Key(const std::string &type, const std::string &title) {
+		std::string key;
+		key.reserve(type.size() + title.size() + 1);
+		key += type;
+		key += '\n';
+		key += title;
+		return key;
+	}
+
+	struct chain {
+		size_t first;
+		size_t last;
+	};
+
+	std::vector<size_t> m_Next;
+	std::unordered_map<std::string, chain> m_Chains;
+
+};
+
+struct DialogControl {
+
+	// Changes made while a kept dialog is hidden (Changed)
+	enum { ChangedValue = 1, ChangedWindow = 2, ChangedItems = 4 };
+
+	std::string Type = "";  // Control type
+	std::string Title = ""; // Control title
+	std::string Section = ""; // Control section for initialization file
+
+	// Control size
+	int X = 0;
+	int Y = 0;
+	int Width = 0;
+	int Height = 0;
+
+	std::string Text = "";  // Edit control text
+	std::vector<std::string> Items; // Combo list items
+	int Index = 0; // Combo list index
+
+	// Slider
+	float Min = 0; // Range min
+	float Max = 0; // Range max
+	float SliderVal = 0; // Slider value
+	float Tick = 0; // Tick interval
+
+	// Buttons
+	int Val = 0; // Value
+	int RadioGroup = 0; // Radio button group
+
+	int Layout = -1; // Layout item (LayoutRow, LayoutColumn, LayoutGrid, LayoutPair)
+
+	// Position and size at 96 DPI (GetDpi)
+	// X, Y, Width and Height are scaled for the dialog DPI
+	int DesignX = 0;
+	int DesignY = 0;
+	int DesignWidth = 0;
+	int DesignHeight = 0;
+	int Dpi = 0; // DPI of X, Y, Width and Height, 0 if not yet scaled, -1 to scale again
+	int Changed = 0; // Changed by Set functions since Open (KeepAlive)
+
+};
+
+class ControlBackend {
+
+public:
+
+	virtual ~ControlBackend() {}
+
+	// Control windows
+	virtual void Create(size_t i) = 0; // Windows of a control (Open)
+	virtual bool HasWindow(size_t i) = 0;
+	virtual void SetCheck(size_t i, bool bChecked) = 0; // BM_SETCHECK
+	virtual void SetPosition(size_t i, int pos) = 0; // TBM_SETPOS
+	virtual void SetValueText(size_t i, const char* text) = 0; // Slider value text
+	virtual void SetText(size_t i, const std::string &text) = 0; // WM_SETTEXT
+	virtual void SetSpin(size_t i, int value) = 0; // UDM_SETPOS
+	// Current item of a combo or list box (CB_SETCURSEL, LB_SETCURSEL)
+	// bRefresh - as Refresh, the item text is replaced by the control
+	// text if there is one. Returns false if the item is not shown.
+	virtual bool SetSelection(size_t i, int item, bool bRefresh) = 0;
+	// Items of a combo or list box replaced while a kept dialog was hidden
+	virtual void SetItems(size_t i) = 0;
+	// Controls with a new position or size
+	virtual void Move(const std::vector<size_t> &moved) = 0;
+
+	// Values read from the control windows
+	// Text of an edit control, false if there is no window
+	virtual bool GetText(size_t i, std::string &text) = 0;
+	// Spin control position, false if not read (dialog closed)
+	virtual bool GetSpin(size_t i, int &value) = 0;
+	// Items of a list kept by the backend (virtual list), -1 if none
+	virtual int GetItemCount(size_t i) = 0;
+	virtual std::string GetItemText(size_t i, int item) = 0;
+
+	// Initialization file
+	// ReadValue returns false if the key is not found or is empty
+	virtual bool ReadValue(const std::string &file, const std::string &section,
+		const std::string &key, std::string &value) = 0;
+	virtual void WriteValue(const std::string &file, const std::string &section,
+		const std::string &key, const std::string &value) = 0;
+
+};
+
+template <typename Control = DialogControl>
+class DialogCore {
+
+public:
+
+	// Trackbar notification codes (SB_LINELEFT etc.)
+	enum { LineLeft = 0, LineRight = 1, ThumbTrack = 5, EndScroll = 8 };
+
+	explicit DialogCore(std::vector<Control> &controls) : m_Controls(controls) {}
+	DialogCore(const DialogCore &) = delete;
+	DialogCore &operator=(const DialogCore &) = delete;
+
+	// The backend must remain valid while it is used
+	void SetBackend(ControlBackend* backend) { m_Backend = backend; }
+	ControlBackend* GetBackend() const { return m_Backend; }
+
+	// Add a control
+	Control &Add(const std::string &type, const std::string &title) {
+		Control c;
+		c.Type = type;
+		c.Title = title;
+		m_Controls.push_back(c);
+		return m_Controls.back();
+	}
+
+	//
+	// Lookup
+	//
+
+	// First control with a type and title
+	// Controls added since the last search are indexed first.
+	// Returns an index past the end of controls if not found.
+	size_t Find(const std::string &type, const std::string &title) {
+		Update();
+		return m_Index.Find(type, title);
+	}
+
+	// Next control with the same type and title
+	size_t Next(size_t i) const { return m_Index.Next(i); }
+
+	// Last control with a type and title
+	size_t FindLast(const std::string &type, const std::string &title) {
+		Update();
+		return m_Index.FindLast(type, title);
+	}
+
+	// Index the controls again after they have been replaced
+	void Reindex() { m_Index.Clear(); }
+
+	//
+	// Set functions
+	// The control values are changed and the windows updated
+	//
+
+	void SetCheckBox(const std::string &title, int value) { SetButton("Checkbox", title, value); }
+
+	// The application must set all buttons in the group
+	void SetRadioButton(const std::string &title, int value) { SetButton("Radio", title, value); }
+
+	// The first slider with the title
+	// Not changed while the slider is dragged by the user
+	void SetSlider(const std::string &title, float value) {
+		size_t i = Find("Slider", title);
+		if (i >= m_Controls.size() || m_bDrag)
+			return;
+		m_Controls[i].SliderVal = value;
+		if (Defer(i, DialogControl::ChangedWindow))
+			return;
+		m_Backend->SetPosition(i, SliderScale::ToPosition(value, m_Controls[i].Min, m_Controls[i].Max));
+		SliderText(i);
+	}
+
+	void SetEdit(const std::string &title, const std::string &text) { SetText("Edit", title, text); }
+
+	// Static text
+	void SetText(const std::string &title, const std::string &text) { SetText("Static", title, text); }
+
+	// The index is kept for a later SetCombo if not in the list
+	void SetComboItem(const std::string &title, int item) {
+		for (size_t i = Find("Combo", title); i < m_Controls.size(); i = Next(i)) {
+			m_Controls[i].Index = item;
+			if (Defer(i, DialogControl::ChangedWindow))
+				continue;
+			if (item < (int)m_Controls[i].Items.size())
+				m_Backend->SetSelection(i, item, false);
+		}
+	}
+
+	// The item is made current only if it is shown
+	void SetListItem(const std::string &title, int item) {
+		for (size_t i = Find("List", title); i < m_Controls.size(); i = Next(i)) {
+			// Selected by Open
+			if (Defer(i, DialogControl::ChangedWindow)) {
+				m_Controls[i].Index = item;
+				continue;
+			}
+			if (m_Backend->SetSelection(i, item, false))
+				m_Controls[i].Index = item;
+		}
+	}
+
+	void SetSpin(const std::string &title, int value) {
+		for (size_t i = Find("Spin", title); i < m_Controls.size(); i = Next(i)) {
+			m_Controls[i].Val = value;
+			if (Defer(i, DialogControl::ChangedWindow))
+				continue;
+			m_Backend->SetSpin(i, value);
+		}
+	}
+
+	// Slider value text
+	void SliderText(size_t i) {
+		char tmp[16]{};
+		SliderScale::Format(m_Controls[i].SliderVal, m_Controls[i].Max, tmp, sizeof(tmp));
+		m_Backend->SetValueText(i, tmp);
+	}
+
+	//
+	// Get functions
+	// The value of the last control with the title, 0 if not found
+	//
+
+	int GetCheckBox(const std::string &title) { return GetValue("Checkbox", title); }
+	int GetRadioButton(const std::string &title) { return GetValue("Radio", title); }
+	int GetSpin(const std::string &title) { return GetValue("Spin", title); }
+
+	float GetSlider(const std::string &title) {
+		size_t i = FindLast("Slider", title);
+		return i < m_Controls.size() ? m_Controls[i].SliderVal : 0.0f;
+	}
+
+	// Text of the window if there is one
+	std::string GetEdit(const std::string &title) {
+		std::string str;
+		for (size_t i = Find("Edit", title); i < m_Controls.size(); i = Next(i)) {
+			std::string text;
+			if (m_Backend->GetText(i, text))
+				m_Controls[i].Text = text;
+			str = m_Controls[i].Text;
+		}
+		return str;
+	}
+
+	int GetComboItem(const std::string &title) { return GetIndex("Combo", title); }
+	int GetListItem(const std::string &title) { return GetIndex("List", title); }
+
+	//
+	// All controls
+	//
+
+	// Update the windows of all controls with their values
+	void Refresh() {
+		for (size_t i = 0; i < m_Controls.size(); i++)
+			RefreshControl(i);
+	}
+
+	// Update the windows of a control with its values
+	void RefreshControl(size_t i) {
+		Control &c = m_Controls[i];
+		// Items reset while a kept dialog was hidden (KeepAlive)
+		if (c.Changed & DialogControl::ChangedItems) {
+			c.Changed &= ~DialogControl::ChangedItems;
+			m_Backend->SetItems(i);
+		}
+		if (c.Type == "Checkbox" || c.Type == "Radio") {
+			m_Backend->SetCheck(i, c.Val == 1);
+		}
+		else if (c.Type == "Slider") {
+			m_Backend->SetPosition(i, SliderScale::ToPosition(c.SliderVal, c.Min, c.Max));
+			SliderText(i);
+		}
+		else if (c.Type == "Combo" || c.Type == "List") {
+			m_Backend->SetSelection(i, c.Index, true);
+		}
+		else if (c.Type == "Edit") {
+			m_Backend->SetText(i, c.Text);
+		}
+		else if (c.Type == "Spin") {
+			m_Backend->SetSpin(i, c.Val);
+		}
+		// Static text set while a kept dialog was hidden (KeepAlive)
+		else if (c.Type == "Static" && (c.Changed & DialogControl::ChangedWindow)) {
+			m_Backend->SetText(i, c.Text);
+		}
+	}
+
+	// Pass the value of every control with a value to
+	// fn(title, text, value) as the ofApp callback function
+	template <typename Callback>
+	void GetControls(Callback fn) {
+		for (size_t i = 0; i < m_Controls.size(); i++) {
+			Control &c = m_Controls[i];
+			if (!IniValue::IsSaved(c.Type))
+				continue;
+			if (c.Type == "Combo" || c.Type == "List") {
+				// Items kept by the backend or the control
+				int count = m_Backend->GetItemCount(i);
+				if (count > 0)
+					fn(c.Title, m_Backend->GetItemText(i, c.Index), c.Index);
+				else if (count < 0 && c.Index >= 0 && c.Index < (int)c.Items.size())
+					fn(c.Title, c.Items[c.Index], c.Index);
+			}
+			else if (c.Type == "Slider") {
+				fn(c.Title, std::string(), (int)(c.SliderVal * 100.0f));
+			}
+			else if (c.Type == "Edit") {
+				std::string text;
+				if (m_Backend->GetText(i, text))
+					c.Text = text;
+				fn(c.Title, c.Text, 1);
+			}
+			else if (c.Type == "Spin") {
+				if (m_Backend->GetSpin(i, c.Val))
+					fn(c.Title, std::string(), c.Val);
+			}
+			else {
+				fn(c.Title, std::string(), c.Val);
+			}
+		}
+	}
+
+	// Write the values of all controls to an initialization file
+	// The section is the control section (SetSection) or the type
+	void Save(const std::string &file) {
+		for (size_t i = 0; i < m_Controls.size(); i++) {
+			const Control &c = m_Controls[i];
+			if (!IniValue::IsSaved(c.Type))
+				continue;
+			m_Backend->WriteValue(file, c.Section.empty() ? c.Type : c.Section, c.Title,
+				IniValue::Write(c.Type, c.Val, c.Index, c.SliderVal, c.Text));
+		}
+	}
+
+	// Read control values from an initialization file and Refresh
+	// Only the values in the file are changed. The section is that
+	// of each control (SetSection or the type) unless specified.
+	// Returns the number of controls changed.
+	size_t Load(const std::string &file, const std::string &section = "") {
+		size_t changed = 0;
+		std::string value;
+		for (size_t i = 0; i < m_Controls.size(); i++) {
+			Control &c = m_Controls[i];
+			if (!IniValue::IsSaved(c.Type))
+				continue;
+			const std::string &name = !section.empty() ? section : (c.Section.empty() ? c.Type : c.Section);
+			if (!m_Backend->ReadValue(file, name, c.Title, value))
+				continue;
+			if (IniValue::Read(c.Type, value, c.Val, c.Index, c.SliderVal, c.Text))
+				changed++;
+		}
+		Refresh();
+		return changed;
+	}
+
+	//
+	// Control events
+	// The control values are changed as by the user. Each returns
+	// true with the arguments for the ofApp callback function if it
+	// is to be informed.
+	//
+
+	// Slider moved (WM_HSCROLL)
+	//   code - trackbar notification code
+	//   pos  - trackbar position
+	bool SliderEvent(size_t i, int code, int pos, int &value) {
+		Control &c = m_Controls[i];
+		m_bUserChanged = true;
+		// SetSlider does not move the thumb while it is dragged
+		m_bDrag = code == ThumbTrack;
+
+		// Direction keys, left/right, up/down
+		// Default trackbar style is Down=Right and Up=Left (CommCtrl.h)
+		float range = c.Max - c.Min;
+		if (code == LineLeft) {
+			// Move 100 units for trackbars with range > 1000
+			if (range > 1000.0) {
+				pos = pos - (int)(range / 100.0);
+				m_Backend->SetPosition(i, pos);
+			}
+			else if (range >= 100.0) {
+				m_Backend->SetPosition(i, pos - 100);
+			}
+			else {
+				m_Backend->SetPosition(i, pos);
+			}
+		}
+		else if (code == LineRight) {
+			if (range > 1000.0) {
+				pos = pos + (int)(range / 100.0);
+				m_Backend->SetPosition(i, pos);
+			}
+			else if (range >= 100.0) {
+				m_Backend->SetPosition(i, pos + 100);
+			}
+			else {
+				m_Backend->SetPosition(i, pos);
+			}
+		}
+		c.SliderVal = SliderScale::FromPosition(pos, c.Min, c.Max);
+		SliderText(i);
+
+		// Every change, or only at the end in one-click mode (Val)
+		value = (int)(c.SliderVal * 100.0f);
+		return c.Val == 0 || code == EndScroll;
+	}
+
+	// Spin arrow pressed (UDN_DELTAPOS)
+	// Returns the new value within the range
+	int SpinEvent(size_t i, int pos, int delta) {
+		Control &c = m_Controls[i];
+		int num = pos + delta;
+		if (num < (int)c.Min)
+			num = (int)c.Min;
+		if (num > (int)c.Max)
+			num = (int)c.Max;
+		c.Val = num;
+		m_bUserChanged = true;
+		m_Backend->SetSpin(i, num);
+		return num;
+	}
+
+	// Checkbox clicked (BN_CLICKED)
+	int CheckEvent(size_t i, bool bChecked) {
+		m_Controls[i].Val = bChecked ? 1 : 0;
+		m_bUserChanged = true;
+		return m_Controls[i].Val;
+	}
+
+	// Radio button checked (BN_CLICKED)
+	// The other buttons of the group are cleared and
+	// each button of the group is passed to fn(title, text, value)
+	template <typename Callback>
+	void RadioEvent(size_t i, Callback fn) {
+		m_bUserChanged = true;
+		int group = m_Controls[i].RadioGroup;
+		for (size_t k = 0; k < m_Controls.size(); k++) {
+			if (m_Controls[k].Type != "Radio" || m_Controls[k].RadioGroup != group)
+				continue;
+			m_Controls[k].Val = k == i ? 1 : 0;
+			fn(m_Controls[k].Title, std::string(), m_Controls[k].Val);
+		}
+	}
+
+	// Combo box item selected (CBN_SELCHANGE)
+	// The item is passed to fn(title, text, value) before the
+	// index is changed. Returns false for an index not in the list.
+	template <typename Callback>
+	bool ComboEvent(size_t i, int index, Callback fn) {
+		Control &c = m_Controls[i];
+		if (index < 0 || index >= (int)c.Items.size())
+			return false;
+		m_bUserChanged = true;
+		fn(c.Title, c.Items[index], index);
+		m_Controls[i].Index = index;
+		return true;
+	}
+
+	// The slider thumb is being dragged by the user
+	bool IsDragging() const { return m_bDrag; }
+
+	//
+	// Replay of recorded events (ofxWinDialogRecord.h)
+	//
+
+	// Apply one recorded event
+	// Set functions are called again. A control event sets the control
+	// as the user did and is passed to fn(title, text, value). Events
+	// without a control (WM_KEYDOWN etc.) are only passed to fn.
+	template <typename Callback>
+	void Apply(const EventTrace::event &e, Callback fn) {
+		switch (e.op) {
+			case EventTrace::SetCheckBox:    SetCheckBox(e.title, e.value); return;
+			case EventTrace::SetRadioButton: SetRadioButton(e.title, e.value); return;
+			case EventTrace::SetSlider:      SetSlider(e.title, e.fvalue); return;
+			case EventTrace::SetEdit:        SetEdit(e.title, e.text); return;
+			case EventTrace::SetText:        SetText(e.title, e.text); return;
+			case EventTrace::SetComboItem:   SetComboItem(e.title, e.value); return;
+			case EventTrace::SetListItem:    SetListItem(e.title, e.value); return;
+			case EventTrace::SetSpin:        SetSpin(e.title, e.value); return;
+		}
+		for (size_t i = 0; i < m_Controls.size(); i++) {
+			if (m_Controls[i].Title != e.title)
+				continue;
+			const std::string &type = m_Controls[i].Type;
+			if (type == "Checkbox")
+				SetCheckBox(e.title, e.value);
+			else if (type == "Radio")
+				SetRadioButton(e.title, e.value);
+			else if (type == "Slider")
+				SetSlider(e.title, (float)e.value / 100.0f); // As sent by SliderEvent
+			else if (type == "Spin")
+				SetSpin(e.title, e.value);
+			else if (type == "Combo")
+				SetComboItem(e.title, e.value);
+			else if (type == "List")
+				SetListItem(e.title, e.value);
+			else if (type == "Edit")
+				SetEdit(e.title, e.text);
+			else
+				continue;
+			break;
+		}
+		fn(e.title, e.text, e.value);
+	}
+
+	// Apply all the events of a trace in the order recorded
+	// The recorded times are not waited for, so that the result
+	// is the same for every replay. Returns the number of events.
+	template <typename Callback>
+	size_t Replay(const EventTrace &trace, Callback fn) {
+		for (size_t k = 0; k < trace.Size(); k++)
+			Apply(trace.GetEvents()[k], fn);
+		return trace.Size();
+	}
+
+	//
+	// Keep-alive dialog (KeepAlive)
+	// Set functions record the controls they change. While the dialog
+	// is hidden the windows are not updated and Show refreshes only the
+	// controls that were changed.
+	//
+
+	void KeepAlive(bool bKeep) {
+		m_bKeepAlive = bKeep;
+		m_bHidden = false;
+	}
+	bool IsKeepAlive() const { return m_bKeepAlive; }
+
+	// New control windows - no changes to apply
+	void Open() {
+		for (size_t i = 0; i < m_Controls.size(); i++)
+			m_Controls[i].Changed = 0;
+		m_Changed.clear();
+		m_bUserChanged = false;
+		m_bHidden = false;
+	}
+
+	// Create the windows of all controls
+	void CreateWindows() {
+		for (size_t i = 0; i < m_Controls.size(); i++)
+			m_Backend->Create(i);
+	}
+
+	// The kept dialog window is hidden
+	void Hide() { m_bHidden = true; }
+	bool IsHidden() const { return m_bHidden; }
+
+	// The dialog window is destroyed
+	void Close() { m_bHidden = false; }
+
+	// The kept dialog window is shown again
+	// Controls changed while it was hidden are refreshed. The old
+	// controls for restore (Cancel) are updated in the same way unless
+	// the user, Reset or Restore has changed the controls.
+	void Show(std::vector<Control> &oldcontrols) {
+		for (size_t k = 0; k < m_Changed.size(); k++) {
+			size_t i = m_Changed[k];
+			if (i >= m_Controls.size())
+				continue;
+			if (m_Controls[i].Changed & (DialogControl::ChangedWindow | DialogControl::ChangedItems))
+				RefreshControl(i);
+			m_Controls[i].Changed = 0;
+			if (!m_bUserChanged && i < oldcontrols.size())
+				oldcontrols[i] = m_Controls[i];
+		}
+		m_Changed.clear();
+		if (m_bUserChanged)
+			oldcontrols = m_Controls;
+		m_bUserChanged = false;
+		m_bHidden = false;
+	}
+
+	// Record a control changed by a Set function
+	// Returns true if the window update is deferred
+	// because the kept dialog is hidden
+	bool Defer(size_t i, int change) {
+		if (!m_bKeepAlive)
+			return false;
+		Control &c = m_Controls[i];
+		if (c.Changed == 0)
+			m_Changed.push_back(i);
+		c.Changed |= DialogControl::ChangedValue;
+		if (!m_bHidden || !m_Backend->HasWindow(i))
+			return false;
+		c.Changed |= change;
+		return true;
+	}
+
+	// Controls changed by the user, Reset or Restore
+	void UserChanged() { m_bUserChanged = true; }
+
+	// Controls changed by Set functions since Open
+	const std::vector<size_t> &GetChanged() const { return m_Changed; }
+
+	//
+	// Position and size
+	// Positions and sizes given by the Add functions are at 96 DPI and
+	// are kept as the design values of each control. X, Y, Width and
+	// Height are scaled from them for the dialog DPI.
+	//
+
+	// Position and size of a control for the DPI
+	// Returns true if the position or size has changed
+	bool ScaleControl(size_t i, const DpiScale &dpi) {
+		Control &c = m_Controls[i];
+		if (c.Dpi == 0) {
+			// Values of the Add function
+			c.DesignX = c.X;
+			c.DesignY = c.Y;
+			c.DesignWidth = c.Width;
+			c.DesignHeight = c.Height;
+		}
+		else if (c.Dpi == dpi.Get()) {
+			return false;
+		}
+		c.Dpi = dpi.Get();
+		int x = 0;
+		int y = 0;
+		int width = 0;
+		int height = 0;
+		dpi.ScaleRect(c.DesignX, c.DesignY, c.DesignWidth, c.DesignHeight, x, y, width, height);
+		if (x == c.X && y == c.Y && width == c.Width && height == c.Height)
+			return false;
+		c.X = x;
+		c.Y = y;
+		c.Width = width;
+		c.Height = height;
+		return true;
+	}
+
+	// Scale all controls for the DPI
+	// bMove - move the control windows
+	void ScaleControls(const DpiScale &dpi, bool bMove) {
+		std::vector<size_t> moved;
+		for (size_t i = 0; i < m_Controls.size(); i++) {
+			if (ScaleControl(i, dpi))
+				moved.push_back(i);
+		}
+		if (bMove && !moved.empty())
+			m_Backend->Move(moved);
+	}
+
+	// Add the controls from "first" to a box of the layout
+	void AddToLayout(LayoutTree &layout, int box, size_t first) {
+		for (size_t i = first; i < m_Controls.size(); i++) {
+			Control &c = m_Controls[i];
+			// Minimum size at 96 DPI
+			bool bScaled = c.Dpi != 0;
+			int width = bScaled ? c.DesignWidth : c.Width;
+			int height = bScaled ? c.DesignHeight : c.Height;
+			// Slider value text to the right
+			if (c.Type == "Slider" && c.Index > 0)
+				width += 40;
+			c.Layout = layout.AddItem(box, (int)i, width, height);
+		}
+	}
+
+	// Arrange the layout for a client area and move the controls
+	// The layout is at 96 DPI and scaled for the dialog DPI.
+	// Returns true if controls have moved.
+	bool Arrange(LayoutTree &layout, const DpiScale &dpi, int width, int height,
+		std::vector<LayoutTree::placed> &placed) {
+		if (layout.Empty())
+			return false;
+		layout.Arrange(0, 0, dpi.Unscale(width), dpi.Unscale(height), placed);
+		std::vector<size_t> moved;
+		for (size_t k = 0; k < placed.size(); k++) {
+			size_t i = (size_t)placed[k].id;
+			if (i >= m_Controls.size())
+				continue;
+			const LayoutTree::rect &r = placed[k].r;
+			Control &c = m_Controls[i];
+			c.DesignX = r.x;
+			c.DesignY = r.y;
+			c.DesignWidth = r.width;
+			c.DesignHeight = r.height;
+			if (c.Type == "Slider" && c.Index > 0)
+				c.DesignWidth = (std::max)(r.width - 40, 0);
+			c.Dpi = -1; // Scale again
+			if (ScaleControl(i, dpi))
+				moved.push_back(i);
+		}
+		if (!moved.empty())
+			m_Backend->Move(moved);
+		return !moved.empty();
+	}
+
+	std::vector<Control> &Controls() { return m_Controls; }
+	size_t Size() const { return m_Controls.size(); }
+
+private:
+
+	// Index the controls added since the last search
+	void Update() {
+		// Controls replaced by Reset or Restore
+		if (m_Index.Size() > m_Controls.size())
+			m_Index.Clear();
+		for (size_t i = m_Index.Size(); i < m_Controls.size(); i++)
+			m_Index.Add(m_Controls[i].Type, m_Controls[i].Title);
+	}
+
+	void SetButton(const char* type, const std::string &title, int value) {
+		for (size_t i = Find(type, title); i < m_Controls.size(); i = Next(i)) {
+			m_Controls[i].Val = value;
+			if (Defer(i, DialogControl::ChangedWindow))
+				continue;
+			m_Backend->SetCheck(i, value == 1);
+		}
+	}
+
+	void SetText(const char* type, const std::string &title, const std::string &text) {
+		for (size_t i = Find(type, title); i < m_Controls.size(); i = Next(i)) {
+			m_Controls[i].Text = text;
+			if (Defer(i, DialogControl::ChangedWindow))
+				continue;
+			m_Backend->SetText(i, text);
+		}
+	}
+
+	int GetValue(const char* type, const std::string &title) {
+		size_t i = FindLast(type, title);
+		return i < m_Controls.size() ? m_Controls[i].Val : 0;
+	}
+
+	int GetIndex(const char* type, const std::string &title) {
+		size_t i = FindLast(type, title);
+		return i < m_Controls.size() ? m_Controls[i].Index : 0;
+	}
+
+	std::vector<Control> &m_Controls;
+	ControlBackend* m_Backend = nullptr;
+	ControlIndex m_Index;
+	bool m_bDrag = false; // Slider thumb dragged
+	bool m_bKeepAlive = false;
+	bool m_bHidden = false; // Kept dialog hidden
+	bool m_bUserChanged = false; // Changed by the user, Reset or Restore
+	std::vector<size_t> m_Changed; // Controls changed by Set functions
+
+};
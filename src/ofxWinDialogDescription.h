@@ -0,0 +1,373 @@
+//
+// ofxWinDialogDescription.h
+//
+// Parser for dialog description text.
+// Tested by tests/ofxWinDialogDescriptionTest.cpp.
+//
+// Description format
+//   One statement on each line. A statement is a keyword followed by
+//   arguments separated by spaces, tabs or commas. "//" starts a comment
+//   to the end of the line.
+//     word    - keyword, name or style without spaces (SS_CENTER|WS_BORDER)
+//     number  - integer or decimal, hex with 0x or # (#FF8000)
+//     "text"  - quoted text, "" for a quote character
+//     [ ... ] - list of items which can continue over several lines
+//
+// DescriptionParser
+//   One pass over the text without copying. Tokens point into the text
+//   and numbers are converted as they are read. The tokens of each
+//   statement are passed to a callback and the token array is re-used
+//   for the next statement. Text is copied only when the callback
+//   reads it as a string.
+//
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+struct DescToken {
+	enum { Word, Number, Text, ListBegin, ListEnd };
+	int kind = Word;
+	const char* text = nullptr; // Into the description, not terminated
+	size_t size = 0;
+	double value = 0.0; // Number
+	bool bEscaped = false; // Text with "" for a quote
+
+	bool Is(const char* word) const {
+		return kind == Word && strlen(word) == size && memcmp(text, word, size) == 0;
+	}
+
+	// Word, number or text as a string
+	std::string String() const {
+		if (!bEscaped)
+			return std::string(text, size);
+		std::string s;
+		s.reserve(size);
+		for (size_t i = 0; i < size; i++) {
+			s += text[i];
+			if (text[i] == '"')
+				i++; // Skip the second quote
+		}
+		return s;
+	}
+};
+
+//
+// Arguments of one statement
+// Read in order after the keyword. Each read returns false with an
+// error message if the next argument is missing or of the wrong kind.
+//
+class DescStatement {
+
+public:
+
+	DescStatement(const std::vector<DescToken> &tokens, int line)
+		: m_Tokens(tokens), m_Line(line) {}
+
+	const DescToken &Keyword() const { return m_Tokens[0]; }
+	int GetLine() const { return m_Line; }
+
+	// More arguments to read
+	bool More() const { return m_Pos < m_Tokens.size(); }
+
+	// Next argument is a number
+	bool IsNumber() const { return More() && m_Tokens[m_Pos].kind == DescToken::Number; }
+
+	// Next argument is a list
+	bool IsList() const { return More() && m_Tokens[m_Pos].kind == DescToken::ListBegin; }
+
+	// Text or word
+	bool Text(std::string &text) {
+		if (!More() || m_Tokens[m_Pos].kind == DescToken::ListBegin || m_Tokens[m_Pos].kind == DescToken::ListEnd)
+			return Error("text expected");
+		text = m_Tokens[m_Pos++].String();
+		return true;
+	}
+
+	bool Number(double &value) {
+		if (!IsNumber())
+			return Error("number expected");
+		value = m_Tokens[m_Pos++].value;
+		return true;
+	}
+
+	bool Int(int &value) {
+		double v = 0.0;
+		if (!Number(v))
+			return false;
+		value = (int)(long long)v;
+		return true;
+	}
+
+	bool Float(float &value) {
+		double v = 0.0;
+		if (!Number(v))
+			return false;
+		value = (float)v;
+		return true;
+	}
+
+	// Next argument as a token (number or word for a style)
+	bool Token(const DescToken* &token) {
+		if (!More() || m_Tokens[m_Pos].kind == DescToken::ListBegin || m_Tokens[m_Pos].kind == DescToken::ListEnd)
+			return Error("argument expected");
+		token = &m_Tokens[m_Pos++];
+		return true;
+	}
+
+	// List of items
+	bool Items(std::vector<std::string> &items) {
+		if (!IsList())
+			return Error("item list expected");
+		m_Pos++;
+		size_t first = m_Pos;
+		while (m_Pos < m_Tokens.size() && m_Tokens[m_Pos].kind != DescToken::ListEnd)
+			m_Pos++;
+		items.clear();
+		items.reserve(m_Pos - first);
+		for (size_t i = first; i < m_Pos; i++)
+			items.push_back(m_Tokens[i].String());
+		m_Pos++; // ListEnd
+		return true;
+	}
+
+	// All arguments read
+	bool End() {
+		if (More())
+			return Error("too many arguments");
+		return true;
+	}
+
+	bool Error(const std::string &error) {
+		if (m_Error.empty())
+			m_Error = error;
+		return false;
+	}
+
+	const std::string &GetError() const { return m_Error; }
+
+private:
+
+	const std::vector<DescToken> &m_Tokens;
+	int m_Line = 0;
+	size_t m_Pos = 1; // After the keyword
+	std::string m_Error;
+
+};
+
+class DescriptionParser {
+
+public:
+
+	// Parse a description
+	// fn(DescStatement &) is called for each statement and
+	// returns false with DescStatement::Error to stop.
+	// Returns false with GetError() for an error.
+	template <typename Callback>
+	bool Parse(const char* data, size_t size, Callback fn) {
+		m_Error.clear();
+		m_ErrorLine = 0;
+		m_Statements = 0;
+		m_Tokens.clear();
+
+		const char* p = data;
+		const char* end = data + size;
+		int line = 1;
+		int start = 1; // Line of the statement
+		bool bList = false;
+
+		while (p < end) {
+			char c = *p;
+			if (c == '\n') {
+				line++;
+				p++;
+				// A list continues the statement on the next line
+				if (bList)
+					continue;
+				if (!Statement(fn, start))
+					return false;
+				start = line;
+				continue;
+			}
+			if (c == ' ' || c == '\t' || c == '\r' || c == ',') {
+				p++;
+				continue;
+			}
+			// Comment to the end of the line
+			if (c == '/' && p + 1 < end && p[1] == '/') {
+				while (p < end && *p != '\n')
+					p++;
+				continue;
+			}
+			if (m_Tokens.empty())
+				start = line;
+
+			DescToken t;
+			if (c == '"') {
+				// Quoted text, "" for a quote
+				t.kind = DescToken::Text;
+				t.text = ++p;
+				for (;;) {
+					if (p >= end || *p == '\n')
+						return Fail(line, "text without a closing quote");
+					if (*p == '"') {
+						if (p + 1 < end && p[1] == '"') {
+							t.bEscaped = true;
+							p += 2;
+							continue;
+						}
+						break;
+					}
+					p++;
+				}
+				t.size = (size_t)(p - t.text);
+				p++; // Closing quote
+			}
+			else if (c == '[') {
+				if (bList)
+					return Fail(line, "list within a list");
+				if (m_Tokens.empty())
+					return Fail(line, "keyword expected");
+				bList = true;
+				t.kind = DescToken::ListBegin;
+				t.text = p++;
+				t.size = 1;
+			}
+			else if (c == ']') {
+				if (!bList)
+					return Fail(line, "end of list without a list");
+				bList = false;
+				t.kind = DescToken::ListEnd;
+				t.text = p++;
+				t.size = 1;
+			}
+			else {
+				// Word or number
+				t.text = p;
+				while (p < end && !IsDelimiter(*p) && !(*p == '/' && p + 1 < end && p[1] == '/'))
+					p++;
+				t.size = (size_t)(p - t.text);
+				if (ToNumber(t.text, t.size, t.value))
+					t.kind = DescToken::Number;
+				else
+					t.kind = DescToken::Word;
+			}
+			if (m_Tokens.empty() && t.kind != DescToken::Word)
+				return Fail(line, "keyword expected");
+			m_Tokens.push_back(t);
+		}
+		if (bList)
+			return Fail(start, "list without an end");
+		return Statement(fn, start);
+	}
+
+	template <typename Callback>
+	bool Parse(const std::string &text, Callback fn) {
+		return Parse(text.data(), text.size(), fn);
+	}
+
+	// Error message and line of the last Parse
+	const std::string &GetError() const { return m_Error; }
+	int GetErrorLine() const { return m_ErrorLine; }
+
+	// Number of statements of the last Parse
+	size_t GetStatements() const { return m_Statements; }
+
+	// Integer, decimal or hex (0x or #)
+	// The whole token must be a number
+	static bool ToNumber(const char* text, size_t size, double &value) {
+		size_t i = 0;
+		bool bNegative = false;
+		if (i < size && (text[i] == '-' || text[i] == '+')) {
+			bNegative = text[i] == '-';
+			i++;
+		}
+		if (i >= size)
+			return false;
+
+		// Hex
+		bool bHex = false;
+		if (text[i] == '#') {
+			bHex = true;
+			i++;
+		}
+		else if (i + 1 < size && text[i] == '0' && (text[i + 1] == 'x' || text[i + 1] == 'X')) {
+			bHex = true;
+			i += 2;
+		}
+		if (bHex) {
+			if (i >= size || size - i > 16)
+				return false;
+			uint64_t v = 0;
+			for (; i < size; i++) {
+				int d = HexDigit(text[i]);
+				if (d < 0)
+					return false;
+				v = (v << 4) | (uint64_t)d;
+			}
+			value = bNegative ? -(double)v : (double)v;
+			return true;
+		}
+
+		// Decimal
+		double v = 0.0;
+		size_t digits = 0;
+		for (; i < size && text[i] >= '0' && text[i] <= '9'; i++, digits++)
+			v = v * 10.0 + (text[i] - '0');
+		if (i < size && text[i] == '.') {
+			i++;
+			double scale = 0.1;
+			for (; i < size && text[i] >= '0' && text[i] <= '9'; i++, digits++) {
+				v += (text[i] - '0') * scale;
+				scale *= 0.1;
+			}
+		}
+		if (digits == 0 || i != size)
+			return false;
+		value = bNegative ? -v : v;
+		return true;
+	}
+
+private:
+
+	template <typename Callback>
+	bool Statement(Callback &fn, int line) {
+		if (m_Tokens.empty())
+			return true;
+		DescStatement st(m_Tokens, line);
+		bool bOk = fn(st);
+		m_Tokens.clear();
+		if (!bOk)
+			return Fail(line, st.GetError().empty() ? "unknown statement" : st.GetError());
+		m_Statements++;
+		return true;
+	}
+
+	bool Fail(int line, const std::string &error) {
+		m_ErrorLine = line;
+		m_Error = "Line " + std::to_string(line) + " : " + error;
+		m_Tokens.clear();
+		return false;
+	}
+
+	static bool IsDelimiter(char c) {
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ','
+			|| c == '"' || c == '[' || c == ']';
+	}
+
+	static int HexDigit(char c) {
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	std::vector<DescToken> m_Tokens; // Tokens of the current statement
+	std::string m_Error;
+	int m_ErrorLine = 0;
+	size_t m_Statements = 0;
+
+};
@@ -0,0 +1,82 @@
+//
+// ofxWinDialogDpi.h
+//
+// Scaling of control positions and fonts for the monitor DPI.
+// Tested by tests/ofxWinDialogDpiTest.cpp.
+//
+// DpiScale
+//   Positions and sizes are given at 96 DPI (100%) and scaled to the
+//   DPI of the monitor showing the dialog, 120 for 125%, 144 for 150%,
+//   192 for 200% and so on. Values are always scaled from the 96 DPI
+//   value so that moving between monitors does not add rounding errors.
+//   A rectangle is scaled by its edges so that controls which touch at
+//   96 DPI still touch when scaled.
+//
+//   FontHeight is the logical font height for a point size. The font
+//   cache (GdiCache) is keyed by height, so there is one font for each
+//   DPI and a font is created again only for a DPI not seen before.
+//
+#pragma once
+
+#include <cstdint>
+
+class DpiScale {
+
+public:
+
+	// 100% scale
+	static const int Default = 96;
+
+	DpiScale(int dpi = Default) { Set(dpi); }
+
+	void Set(int dpi) { m_Dpi = dpi > 0 ? dpi : Default; }
+	int Get() const { return m_Dpi; }
+
+	// Scale factor (1.0 = 100%)
+	double GetScale() const { return (double)m_Dpi / (double)Default; }
+
+	bool IsDefault() const { return m_Dpi == Default; }
+
+	// 96 DPI value to the DPI
+	int Scale(int value) const { return MulDivRound(value, m_Dpi, Default); }
+
+	// Value at the DPI to 96 DPI
+	int Unscale(int value) const { return MulDivRound(value, Default, m_Dpi); }
+
+	// Rectangle scaled by its edges
+	void ScaleRect(int x, int y, int width, int height,
+		int &sx, int &sy, int &swidth, int &sheight) const
+	{
+		sx = Scale(x);
+		sy = Scale(y);
+		swidth = Scale(x + width) - sx;
+		sheight = Scale(y + height) - sy;
+	}
+
+	// Logical height of a font point size at a DPI
+	// Negative for the character height without internal leading
+	static int FontHeight(int points, int dpi) {
+		return -MulDivRound(points, dpi > 0 ? dpi : Default, 72);
+	}
+
+	// a * b / c rounded to the nearest, halves away from zero
+	static int MulDivRound(int a, int b, int c) {
+		if (c == 0)
+			return 0;
+		int64_t n = (int64_t)a * b;
+		int64_t d = c;
+		if (d < 0) {
+			n = -n;
+			d = -d;
+		}
+		int64_t q = n >= 0 ? (n + d / 2) / d : -((-n + d / 2) / d);
+		if (q > INT32_MAX) return INT32_MAX;
+		if (q < INT32_MIN) return INT32_MIN;
+		return (int)q;
+	}
+
+private:
+
+	int m_Dpi = Default;
+
+};
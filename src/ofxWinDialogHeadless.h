@@ -0,0 +1,135 @@
+//
+// ofxWinDialogHeadless.h
+//
+// Control backend without windows, for tests and benchmarks of the
+// dialog core (DialogCore in ofxWinDialogCore.h) on any platform
+// (tests/ofxWinDialogCoreTest.cpp, tests/ofxWinDialogBenchmark.cpp).
+//
+// RecordingBackend
+//   Records the changes that the dialog core makes to control windows
+//   as the window messages that ofxWinDialog sends for them
+//   (BM_SETCHECK, TBM_SETPOS etc.), so that a test can check what
+//   would have been sent and a benchmark can time the core without a
+//   window system. Windows are created by Create as by Open. List
+//   boxes show all the items of the control. The initialization file
+//   values are kept in memory by file, section and key.
+//
+#pragma once
+
+#include <vector>
+#include <string>
+#include <map>
+#include <cstddef>
+
+#include "ofxWinDialogCore.h"
+
+class RecordingBackend : public ControlBackend {
+
+public:
+
+	struct message {
+		const char* name = ""; // Window message that the dialog sends
+		size_t control = 0;
+		int value = 0;
+		std::string text;
+	};
+
+	explicit RecordingBackend(const std::vector<DialogControl> &controls) : m_Controls(controls) {}
+
+	void Create(size_t i) override {
+		if (m_Windows.size() < m_Controls.size())
+			m_Windows.resize(m_Controls.size(), false);
+		m_Windows[i] = true;
+		m_Created++;
+	}
+	bool HasWindow(size_t i) override { return i < m_Windows.size() && m_Windows[i]; }
+
+	void SetCheck(size_t i, bool bChecked) override { Add("BM_SETCHECK", i, bChecked ? 1 : 0); }
+	void SetPosition(size_t i, int pos) override { Add("TBM_SETPOS", i, pos); }
+	void SetValueText(size_t i, const char* text) override { Add("WM_SETTEXT", i, 1, text); }
+	void SetText(size_t i, const std::string &text) override { Add("WM_SETTEXT", i, 0, text); }
+	void SetSpin(size_t i, int value) override { Add("UDM_SETPOS", i, value); }
+
+	bool SetSelection(size_t i, int item, bool bRefresh) override {
+		const DialogControl &c = m_Controls[i];
+		bool bCombo = c.Type == "Combo";
+		// A list box selects only an item that it shows
+		if (!bCombo && !bRefresh && item >= (int)c.Items.size())
+			return false;
+		Add(bCombo ? "CB_SETCURSEL" : "LB_SETCURSEL", i, item);
+		return true;
+	}
+	void SetItems(size_t i) override { Add("LB_RESETCONTENT", i, (int)m_Controls[i].Items.size()); }
+	void Move(const std::vector<size_t> &moved) override {
+		for (size_t k = 0; k < moved.size(); k++)
+			Add("DeferWindowPos", moved[k], 0);
+	}
+
+	bool GetText(size_t, std::string &) override { return false; }
+	bool GetSpin(size_t, int &) override { return true; }
+	int GetItemCount(size_t) override { return -1; }
+	std::string GetItemText(size_t i, int item) override {
+		const DialogControl &c = m_Controls[i];
+		return item >= 0 && item < (int)c.Items.size() ? c.Items[item] : std::string();
+	}
+
+	bool ReadValue(const std::string &file, const std::string &section,
+		const std::string &key, std::string &value) override {
+		auto it = m_Files.find(file + '\n' + section + '\n' + key);
+		if (it == m_Files.end() || it->second.empty())
+			return false;
+		value = it->second;
+		return true;
+	}
+	void WriteValue(const std::string &file, const std::string &section,
+		const std::string &key, const std::string &value) override {
+		m_Files[file + '\n' + section + '\n' + key] = value;
+	}
+
+	const std::vector<message> &Messages() const { return m_Messages; }
+	size_t Size() const { return m_Messages.size(); }
+	void Clear() { m_Messages.clear(); }
+
+	// Stop recording messages (benchmarks)
+	void Record(bool bRecord) { m_bRecord = bRecord; }
+
+	// Number of messages of a name
+	size_t Count(const char* name) const {
+		size_t n = 0;
+		for (size_t k = 0; k < m_Messages.size(); k++) {
+			if (std::string(m_Messages[k].name) == name)
+				n++;
+		}
+		return n;
+	}
+
+	// Windows created since the last Destroy
+	size_t GetCreated() const { return m_Created; }
+
+	// All windows destroyed (dialog closed)
+	void Destroy() {
+		m_Windows.assign(m_Windows.size(), false);
+		m_Created = 0;
+	}
+
+private:
+
+	void Add(const char* name, size_t i, int value, const std::string &text = "") {
+		if (!m_bRecord)
+			return;
+		message m;
+		m.name = name;
+		m.control = i;
+		m.value = value;
+		m.text = text;
+		m_Messages.push_back(m);
+	}
+
+	const std::vector<DialogControl> &m_Controls;
+	std::vector<bool> m_Windows;
+	size_t m_Created = 0;
+	std::vector<message> m_Messages;
+	std::map<std::string, std::string> m_Files;
+	bool m_bRecord = true;
+
+};
@@ -0,0 +1,126 @@
+//
+// ofxWinDialogHooks.h
+//
+// Routing of keyboard messages to the dialog that has them.
+// Tested by tests/ofxWinDialogHooksTest.cpp.
+//
+// HookRegistry
+//   Dialogs by window, so that a key message is passed to the
+//   dialog that contains the window with the focus rather than to
+//   the dialog opened last. A window is added when a dialog window
+//   is created and removed when it is destroyed. Find is a hash
+//   lookup whatever the number of dialogs.
+//
+//   A message hook is for one thread. Each dialog instance holds a
+//   reference to the hook of the thread that created it. The hook is
+//   installed for the first reference and removed with the last, so
+//   deleting one dialog does not remove the hook used by others.
+//
+//   Windows and hooks are held as integers (HWND and HHOOK on Windows).
+//   All functions can be called from any thread.
+//
+#pragma once
+
+#include <unordered_map>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+template <typename Dialog>
+class HookRegistry {
+
+public:
+
+	// Add a reference to the hook of a thread
+	// Returns true for the first reference. The caller then
+	// installs the hook and sets it with SetHook.
+	bool Acquire(uint64_t thread) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		hook &h = m_Hooks[thread];
+		return ++h.refs == 1;
+	}
+
+	void SetHook(uint64_t thread, uintptr_t handle) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto it = m_Hooks.find(thread);
+		if (it != m_Hooks.end())
+			it->second.handle = handle;
+	}
+
+	// Hook of a thread or 0
+	uintptr_t GetHook(uint64_t thread) const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto it = m_Hooks.find(thread);
+		return it == m_Hooks.end() ? 0 : it->second.handle;
+	}
+
+	// Release a reference to the hook of a thread
+	// Returns true with the hook for the last reference.
+	// The caller then removes the hook.
+	bool Release(uint64_t thread, uintptr_t &handle) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		handle = 0;
+		auto it = m_Hooks.find(thread);
+		if (it == m_Hooks.end())
+			return false;
+		if (--it->second.refs > 0)
+			return false;
+		handle = it->second.handle;
+		m_Hooks.erase(it);
+		return true;
+	}
+
+	// References to the hook of a thread
+	int GetRefs(uint64_t thread) const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto it = m_Hooks.find(thread);
+		return it == m_Hooks.end() ? 0 : it->second.refs;
+	}
+
+	// Add or replace the dialog of a window
+	void Add(uintptr_t window, Dialog* dialog) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Dialogs[window] = dialog;
+	}
+
+	void Remove(uintptr_t window) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Dialogs.erase(window);
+	}
+
+	// Remove all windows of a dialog
+	void RemoveDialog(const Dialog* dialog) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		for (auto it = m_Dialogs.begin(); it != m_Dialogs.end();) {
+			if (it->second == dialog)
+				it = m_Dialogs.erase(it);
+			else
+				++it;
+		}
+	}
+
+	// Dialog of a window or nullptr
+	Dialog* Find(uintptr_t window) const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto it = m_Dialogs.find(window);
+		return it == m_Dialogs.end() ? nullptr : it->second;
+	}
+
+	// Number of dialog windows
+	size_t Size() const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Dialogs.size();
+	}
+
+private:
+
+	struct hook {
+		int refs = 0;
+		uintptr_t handle = 0;
+	};
+
+	mutable std::mutex m_Mutex;
+	std::unordered_map<uintptr_t, Dialog*> m_Dialogs;
+	std::unordered_map<uint64_t, hook> m_Hooks; // By thread
+
+};
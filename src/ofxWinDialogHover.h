@@ -0,0 +1,132 @@
+//
+// ofxWinDialogHover.h
+//
+// Hover state for owner draw buttons.
+// Tested by tests/ofxWinDialogHoverTest.cpp.
+//
+// Control rectangles are held in a uniform grid so that a hit
+// test only checks the rectangles in one cell. The hover state
+// changes only when the mouse enters or leaves a rectangle and
+// each change reports the controls to be redrawn.
+//
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+class HoverTracker {
+
+public:
+
+	HoverTracker(int cellsize = 64) {
+		m_CellSize = cellsize > 0 ? cellsize : 64;
+	}
+
+	// Remove all rectangles and clear the hover state
+	void Clear() {
+		m_Rects.clear();
+		m_Cells.clear();
+		m_Hover = -1;
+	}
+
+	// Add a control rectangle
+	// id is returned by HitTest and state changes
+	void Add(int id, int x, int y, int width, int height) {
+		if (width <= 0 || height <= 0)
+			return;
+		rect r{ id, x, y, width, height };
+		int index = (int)m_Rects.size();
+		m_Rects.push_back(r);
+		int cx0 = Cell(x);
+		int cy0 = Cell(y);
+		int cx1 = Cell(x + width - 1);
+		int cy1 = Cell(y + height - 1);
+		for (int cy = cy0; cy <= cy1; cy++) {
+			for (int cx = cx0; cx <= cx1; cx++) {
+				m_Cells[Key(cx, cy)].push_back(index);
+			}
+		}
+	}
+
+	// Control under the point or -1
+	// The last rectangle added is on top
+	int HitTest(int x, int y) const {
+		auto it = m_Cells.find(Key(Cell(x), Cell(y)));
+		if (it == m_Cells.end())
+			return -1;
+		const std::vector<int> &list = it->second;
+		for (size_t i = list.size(); i-- > 0; ) {
+			const rect &r = m_Rects[list[i]];
+			if (x >= r.x && x < r.x + r.width && y >= r.y && y < r.y + r.height)
+				return r.id;
+		}
+		return -1;
+	}
+
+	// Mouse moved to x, y
+	// Returns true if the hover control changed
+	// left    - control that lost hover or -1
+	// entered - control that gained hover or -1
+	bool Move(int x, int y, int &left, int &entered) {
+		return SetHover(HitTest(x, y), left, entered);
+	}
+
+	// Mouse left a control or the dialog
+	// Ignored if the control is no longer the hover control
+	// Use id -1 for any control
+	bool Leave(int id, int &left) {
+		int entered = -1;
+		if (id >= 0 && id != m_Hover) {
+			left = -1;
+			return false;
+		}
+		return SetHover(-1, left, entered);
+	}
+
+	// Current hover control or -1
+	int GetHover() const { return m_Hover; }
+
+	// Number of hover state changes
+	uint64_t GetChanges() const { return m_Changes; }
+
+private:
+
+	bool SetHover(int id, int &left, int &entered) {
+		left = -1;
+		entered = -1;
+		if (id == m_Hover)
+			return false;
+		left = m_Hover;
+		entered = id;
+		m_Hover = id;
+		m_Changes++;
+		return true;
+	}
+
+	int Cell(int v) const {
+		// Floor division for negative coordinates
+		return v >= 0 ? v / m_CellSize : -((-v + m_CellSize - 1) / m_CellSize);
+	}
+
+	// Unsigned so that negative cells are not shifted
+	static unsigned long long Key(int cx, int cy) {
+		return ((unsigned long long)(unsigned int)cx << 32) | (unsigned int)cy;
+	}
+
+	struct rect {
+		int id;
+		int x;
+		int y;
+		int width;
+		int height;
+	};
+
+	int m_CellSize = 64;
+	int m_Hover = -1;
+	uint64_t m_Changes = 0;
+	std::vector<rect> m_Rects;
+	std::unordered_map<unsigned long long, std::vector<int>> m_Cells;
+
+};
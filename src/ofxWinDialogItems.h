@@ -0,0 +1,303 @@
+//
+// ofxWinDialogItems.h
+//
+// Item storage for virtual list boxes and item batches
+// for combo and list boxes.
+// Tested by tests/ofxWinDialogItemsTest.cpp.
+//
+// ItemStore
+//   All item text is held in one contiguous buffer with an offset
+//   and length for each item. Append is constant time. Replace
+//   overwrites in place if the new text fits, or appends the text
+//   and leaves the old space unused. The buffer is compacted when
+//   the unused space exceeds the used space.
+//
+// ListWindow
+//   Visible rows of a list with fixed item height.
+//
+// Item batches
+//   Items in one contiguous UTF-8 buffer with an offsets array.
+//   Item i is data[offsets[i]] to data[offsets[i+1]], so the offsets
+//   array has count+1 entries. Utf8ToUtf16 converts a whole batch in
+//   one pass to null terminated UTF-16 items for the list controls.
+//
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+class ItemStore {
+
+public:
+
+	// Reserve storage for a number of items and text bytes
+	void Reserve(size_t items, size_t bytes) {
+		m_Offset.reserve(items);
+		m_Length.reserve(items);
+		m_Data.reserve(bytes + items); // Allow for terminating nulls
+	}
+
+	// Add an item and return its index
+	size_t Append(const char* text, size_t len) {
+		m_Offset.push_back(Store(text, len));
+		m_Length.push_back((uint32_t)len);
+		return m_Offset.size() - 1;
+	}
+
+	size_t Append(const std::string &text) {
+		return Append(text.c_str(), text.size());
+	}
+
+	// Replace the text of an item
+	bool Replace(size_t index, const char* text, size_t len) {
+		if (index >= m_Offset.size())
+			return false;
+		if (len <= m_Length[index]) {
+			// Fits in the existing space
+			memcpy(&m_Data[m_Offset[index]], text, len);
+			m_Data[m_Offset[index] + len] = 0;
+			m_Unused += m_Length[index] - len;
+		}
+		else {
+			m_Unused += m_Length[index] + 1;
+			m_Offset[index] = Store(text, len);
+		}
+		m_Length[index] = (uint32_t)len;
+		if (m_Unused > 4096 && m_Unused > m_Data.size() / 2)
+			Compact();
+		return true;
+	}
+
+	bool Replace(size_t index, const std::string &text) {
+		return Replace(index, text.c_str(), text.size());
+	}
+
+	// Null terminated item text
+	const char* Get(size_t index, size_t* len = nullptr) const {
+		if (index >= m_Offset.size()) {
+			if (len) *len = 0;
+			return "";
+		}
+		if (len) *len = m_Length[index];
+		return &m_Data[m_Offset[index]];
+	}
+
+	std::string GetString(size_t index) const {
+		size_t len = 0;
+		const char* text = Get(index, &len);
+		return std::string(text, len);
+	}
+
+	size_t Size() const { return m_Offset.size(); }
+	bool Empty() const { return m_Offset.empty(); }
+
+	// Storage used including unused space
+	size_t GetBytes() const {
+		return m_Data.capacity() + m_Offset.capacity() * sizeof(size_t) + m_Length.capacity() * sizeof(uint32_t);
+	}
+
+	void Clear() {
+		m_Data.clear();
+		m_Offset.clear();
+		m_Length.clear();
+		m_Unused = 0;
+	}
+
+	// Remove unused space
+	void Compact() {
+		std::vector<char> data;
+		data.reserve(m_Data.size() - m_Unused);
+		for (size_t i = 0; i < m_Offset.size(); i++) {
+			size_t offset = data.size();
+			data.insert(data.end(), m_Data.begin() + m_Offset[i], m_Data.begin() + m_Offset[i] + m_Length[i] + 1);
+			m_Offset[i] = offset;
+		}
+		m_Data.swap(data);
+		m_Unused = 0;
+	}
+
+private:
+
+	size_t Store(const char* text, size_t len) {
+		size_t offset = m_Data.size();
+		m_Data.insert(m_Data.end(), text, text + len);
+		m_Data.push_back(0);
+		return offset;
+	}
+
+	std::vector<char> m_Data;
+	std::vector<size_t> m_Offset;
+	std::vector<uint32_t> m_Length;
+	size_t m_Unused = 0;
+
+};
+
+class ListWindow {
+
+public:
+
+	ListWindow(int itemheight = 1, int clientheight = 0) {
+		Set(itemheight, clientheight);
+	}
+
+	void Set(int itemheight, int clientheight) {
+		m_ItemHeight = itemheight > 0 ? itemheight : 1;
+		m_ClientHeight = clientheight > 0 ? clientheight : 0;
+	}
+
+	// Number of rows visible, including a partly visible last row
+	int GetVisibleCount() const {
+		return (m_ClientHeight + m_ItemHeight - 1) / m_ItemHeight;
+	}
+
+	// Number of whole rows visible
+	int GetPageSize() const {
+		int rows = m_ClientHeight / m_ItemHeight;
+		return rows > 0 ? rows : 1;
+	}
+
+	// Whether an item is visible with the top item at "top"
+	bool IsVisible(int index, int top) const {
+		return index >= top && index < top + GetVisibleCount();
+	}
+
+	// Top item to make an item fully visible
+	int ScrollToShow(int index, int top, int count) const {
+		if (index < top)
+			top = index;
+		else if (index >= top + GetPageSize())
+			top = index - GetPageSize() + 1;
+		return ClampTop(top, count);
+	}
+
+	// Limit the top item to the item count
+	int ClampTop(int top, int count) const {
+		int maxtop = count - GetPageSize();
+		if (top > maxtop) top = maxtop;
+		if (top < 0) top = 0;
+		return top;
+	}
+
+	// Item at a vertical client position or -1
+	int ItemFromY(int y, int top, int count) const {
+		if (y < 0) return -1;
+		int index = top + y / m_ItemHeight;
+		return index < count ? index : -1;
+	}
+
+private:
+
+	int m_ItemHeight = 1;
+	int m_ClientHeight = 0;
+
+};
+
+//
+// Build an item batch from a vector of strings
+//
+inline void BuildItemBatch(const std::vector<std::string> &items, std::string &data, std::vector<size_t> &offsets)
+{
+	size_t bytes = 0;
+	for (size_t i = 0; i < items.size(); i++)
+		bytes += items[i].size();
+	data.clear();
+	data.reserve(bytes);
+	offsets.clear();
+	offsets.reserve(items.size() + 1);
+	for (size_t i = 0; i < items.size(); i++) {
+		offsets.push_back(data.size());
+		data += items[i];
+	}
+	offsets.push_back(data.size());
+}
+
+//
+// Check that item batch offsets are in order
+//
+inline bool CheckItemBatch(const char* data, const size_t* offsets, size_t count)
+{
+	if (count == 0)
+		return true;
+	if (!data || !offsets)
+		return false;
+	for (size_t i = 0; i < count; i++) {
+		if (offsets[i + 1] < offsets[i])
+			return false;
+	}
+	return true;
+}
+
+//
+// Convert an item batch from UTF-8 to null terminated UTF-16 items
+//
+//   wide     - all items, each followed by a null
+//   woffsets - start of each item in "wide"
+//
+// Invalid UTF-8 sequences are replaced with U+FFFD.
+// Returns false if the offsets are not valid.
+//
+inline bool Utf8ToUtf16(const char* data, const size_t* offsets, size_t count,
+	std::vector<uint16_t> &wide, std::vector<size_t> &woffsets)
+{
+	wide.clear();
+	woffsets.clear();
+	if (count == 0)
+		return true;
+	if (!CheckItemBatch(data, offsets, count))
+		return false;
+
+	// UTF-16 never needs more units than UTF-8 bytes
+	wide.reserve(offsets[count] - offsets[0] + count);
+	woffsets.reserve(count);
+
+	for (size_t i = 0; i < count; i++) {
+		size_t pos = offsets[i];
+		size_t end = offsets[i + 1];
+		woffsets.push_back(wide.size());
+		while (pos < end) {
+			unsigned char c = (unsigned char)data[pos];
+			uint32_t cp = 0xFFFD;
+			size_t n = 1;
+			if (c < 0x80) {
+				cp = c;
+			}
+			else {
+				int extra = 0;
+				uint32_t min = 0;
+				if ((c & 0xE0) == 0xC0) { cp = c & 0x1F; extra = 1; min = 0x80; }
+				else if ((c & 0xF0) == 0xE0) { cp = c & 0x0F; extra = 2; min = 0x800; }
+				else if ((c & 0xF8) == 0xF0) { cp = c & 0x07; extra = 3; min = 0x10000; }
+				else { extra = -1; }
+				if (extra > 0 && pos + extra < end) {
+					bool bValid = true;
+					for (int k = 1; k <= extra; k++) {
+						unsigned char cc = (unsigned char)data[pos + k];
+						if ((cc & 0xC0) != 0x80) { bValid = false; break; }
+						cp = (cp << 6) | (cc & 0x3F);
+					}
+					if (bValid && cp >= min && cp <= 0x10FFFF && (cp < 0xD800 || cp > 0xDFFF))
+						n = (size_t)extra + 1;
+					else
+						cp = 0xFFFD;
+				}
+				else {
+					cp = 0xFFFD;
+				}
+			}
+			if (cp >= 0x10000) {
+				cp -= 0x10000;
+				wide.push_back((uint16_t)(0xD800 + (cp >> 10)));
+				wide.push_back((uint16_t)(0xDC00 + (cp & 0x3FF)));
+			}
+			else {
+				wide.push_back((uint16_t)cp);
+			}
+			pos += n;
+		}
+		wide.push_back(0);
+	}
+	return true;
+}
@@ -0,0 +1,457 @@
+//
+// ofxWinDialogLayout.h
+//
+// Automatic layout of controls in rows, columns and grids.
+// Tested by tests/ofxWinDialogLayoutTest.cpp.
+//
+// LayoutTree
+//   A tree of boxes with controls as items. Node 0 is the root column
+//   which fills the area given to Arrange less the margin.
+//     Row    - children side by side with spacing between
+//     Column - children one below the other
+//     Grid   - children in cells, left to right and top to bottom
+//     Pair   - a label and a control in a row. The labels of the pairs
+//              in a column have the width of the widest label.
+//   The minimum size of an item is the size given when it is added.
+//   The minimum size of a box is found from its children.
+//
+//   Stretch factors share the space left over after the minimum sizes.
+//   In a row, the width is shared by the horizontal factors and an item
+//   fills the height if it has a vertical factor. A column is the same
+//   with the axes swapped. Grid columns and rows have the largest factor
+//   of their cells. A box without factors of its own uses the largest
+//   factors of its children. Items that do not fill a cell are left
+//   aligned and centered vertically.
+//
+//   Arrange is incremental. Minimum sizes are measured again only for
+//   the boxes above a changed item. A box is arranged again only if its
+//   rectangle has changed or a child's minimum size has changed, so an
+//   unchanged subtree is skipped. Only the items with a new rectangle
+//   are returned, for one batch of window moves.
+//
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class LayoutTree {
+
+public:
+
+	enum { Row, Column, Grid, Pair, Item };
+
+	struct rect {
+		int x = 0;
+		int y = 0;
+		int width = 0;
+		int height = 0;
+		bool operator == (const rect &r) const {
+			return x == r.x && y == r.y && width == r.width && height == r.height;
+		}
+		bool operator != (const rect &r) const { return !(*this == r); }
+	};
+
+	// An item with a new rectangle
+	struct placed {
+		int id = -1;
+		rect r;
+	};
+
+	LayoutTree() { Clear(); }
+
+	// Remove all nodes except the root column
+	void Clear() {
+		m_Nodes.clear();
+		node root;
+		root.kind = Column;
+		m_Nodes.push_back(root);
+		m_Visited = 0;
+	}
+
+	// Add a box to a parent box
+	// Returns the node number of the box
+	int AddBox(int parent, int kind, int spacing = 4, int columns = 1) {
+		if (!IsBox(parent) || kind == Item)
+			return -1;
+		node n;
+		n.kind = kind;
+		n.parent = parent;
+		n.spacing = spacing > 0 ? spacing : 0;
+		n.columns = columns > 0 ? columns : 1;
+		n.sx = n.sy = -1.0f; // From the children
+		return Link(n);
+	}
+
+	// Add an item with a minimum size
+	// id is returned with the rectangle by Arrange
+	int AddItem(int parent, int id, int width, int height) {
+		if (!IsBox(parent))
+			return -1;
+		node n;
+		n.kind = Item;
+		n.parent = parent;
+		n.id = id;
+		n.width = width > 0 ? width : 0;
+		n.height = height > 0 ? height : 0;
+		return Link(n);
+	}
+
+	// Stretch factors of a node
+	// A negative factor for a box uses the factors of its children
+	void SetStretch(int n, float sx, float sy) {
+		if (!IsNode(n))
+			return;
+		if (m_Nodes[n].sx == sx && m_Nodes[n].sy == sy)
+			return;
+		m_Nodes[n].sx = sx;
+		m_Nodes[n].sy = sy;
+		Changed(n);
+	}
+
+	// Minimum size of an item
+	void SetSize(int n, int width, int height) {
+		if (!IsNode(n) || m_Nodes[n].kind != Item)
+			return;
+		if (m_Nodes[n].width == width && m_Nodes[n].height == height)
+			return;
+		m_Nodes[n].width = width > 0 ? width : 0;
+		m_Nodes[n].height = height > 0 ? height : 0;
+		Changed(n);
+	}
+
+	// Space around the root column
+	void SetMargin(int margin) {
+		if (margin < 0) margin = 0;
+		if (margin == m_Margin)
+			return;
+		m_Margin = margin;
+		m_Nodes[0].bArrange = true;
+	}
+
+	// Spacing of the root column
+	void SetSpacing(int spacing) {
+		if (spacing < 0) spacing = 0;
+		if (spacing == m_Nodes[0].spacing)
+			return;
+		m_Nodes[0].spacing = spacing;
+		Changed(0);
+	}
+
+	int GetParent(int n) const { return IsNode(n) ? m_Nodes[n].parent : -1; }
+
+	// Last child of a box or -1
+	int GetLastChild(int n) const {
+		if (!IsBox(n) || m_Nodes[n].children.empty())
+			return -1;
+		return m_Nodes[n].children.back();
+	}
+
+	// Arrange all nodes in an area
+	// Returns the number of items with a new rectangle
+	size_t Arrange(int x, int y, int width, int height, std::vector<placed> &changed) {
+		changed.clear();
+		m_Visited = 0;
+		Measure(0);
+		rect r;
+		r.x = x + m_Margin;
+		r.y = y + m_Margin;
+		r.width = width - m_Margin * 2;
+		r.height = height - m_Margin * 2;
+		if (r.width < 0) r.width = 0;
+		if (r.height < 0) r.height = 0;
+		Place(0, r, changed);
+		return changed.size();
+	}
+
+	// Arrange everything again on the next Arrange
+	void Invalidate() {
+		for (size_t i = 0; i < m_Nodes.size(); i++) {
+			m_Nodes[i].bMeasure = true;
+			m_Nodes[i].bArrange = true;
+			m_Nodes[i].bPlaced = false;
+		}
+	}
+
+	// Minimum size of the whole layout including the margin
+	int GetMinWidth() { Measure(0); return m_Nodes[0].minw + m_Margin * 2; }
+	int GetMinHeight() { Measure(0); return m_Nodes[0].minh + m_Margin * 2; }
+
+	// Nodes arranged by the last Arrange
+	size_t GetVisited() const { return m_Visited; }
+
+	size_t Size() const { return m_Nodes.size(); }
+	// Only the root
+	bool Empty() const { return m_Nodes[0].children.empty(); }
+
+private:
+
+	struct node {
+		int kind = Item;
+		int parent = -1;
+		std::vector<int> children;
+		int id = -1; // Item
+		int spacing = 0;
+		int columns = 1; // Grid
+		int width = 0; // Item minimum size
+		int height = 0;
+		float sx = 0.0f; // Stretch factors
+		float sy = 0.0f;
+
+		// Measured
+		int minw = 0;
+		int minh = 0;
+		float fx = 0.0f; // Factors used by the parent
+		float fy = 0.0f;
+		int label = 0; // Pair label width from the parent column
+		std::vector<int> cols; // Grid column widths and row heights
+		std::vector<int> rows;
+		std::vector<float> colf; // Grid column and row factors
+		std::vector<float> rowf;
+
+		bool bMeasure = true; // Minimum size must be measured
+		bool bArrange = true; // Children must be arranged
+		bool bPlaced = false;
+		rect r; // Last rectangle
+	};
+
+	bool IsNode(int n) const { return n >= 0 && n < (int)m_Nodes.size(); }
+	bool IsBox(int n) const { return IsNode(n) && m_Nodes[n].kind != Item; }
+
+	int Link(const node &n) {
+		int index = (int)m_Nodes.size();
+		m_Nodes.push_back(n);
+		m_Nodes[n.parent].children.push_back(index);
+		Changed(index);
+		return index;
+	}
+
+	// A node and the boxes above it must be measured again
+	void Changed(int n) {
+		for (; n >= 0; n = m_Nodes[n].parent)
+			m_Nodes[n].bMeasure = true;
+	}
+
+	static int Max(int a, int b) { return a > b ? a : b; }
+	static float Max(float a, float b) { return a > b ? a : b; }
+
+	// Width of a child in a column, with the common label width of pairs
+	int PairWidth(const node &c) const {
+		if (c.kind != Pair || c.children.empty())
+			return c.minw;
+		return c.minw - m_Nodes[c.children[0]].minw + Max(c.label, m_Nodes[c.children[0]].minw);
+	}
+
+	void Measure(int n) {
+		node &b = m_Nodes[n];
+		if (!b.bMeasure)
+			return;
+		b.bMeasure = false;
+		b.bArrange = true;
+
+		if (b.kind == Item) {
+			b.minw = b.width;
+			b.minh = b.height;
+			b.fx = b.sx > 0.0f ? b.sx : 0.0f;
+			b.fy = b.sy > 0.0f ? b.sy : 0.0f;
+			return;
+		}
+
+		float fx = 0.0f;
+		float fy = 0.0f;
+		int w = 0;
+		int h = 0;
+		size_t count = b.children.size();
+		for (size_t k = 0; k < count; k++) {
+			Measure(b.children[k]);
+			fx = Max(fx, m_Nodes[b.children[k]].fx);
+			fy = Max(fy, m_Nodes[b.children[k]].fy);
+		}
+		int gaps = count > 1 ? b.spacing * (int)(count - 1) : 0;
+
+		if (b.kind == Row || b.kind == Pair) {
+			for (size_t k = 0; k < count; k++) {
+				const node &c = m_Nodes[b.children[k]];
+				w += c.minw;
+				h = Max(h, c.minh);
+			}
+			w += gaps;
+		}
+		else if (b.kind == Column) {
+			// Common label width of the pairs
+			int label = 0;
+			for (size_t k = 0; k < count; k++) {
+				const node &c = m_Nodes[b.children[k]];
+				if (c.kind == Pair && !c.children.empty())
+					label = Max(label, m_Nodes[c.children[0]].minw);
+			}
+			for (size_t k = 0; k < count; k++) {
+				node &c = m_Nodes[b.children[k]];
+				if (c.kind == Pair && c.label != label) {
+					c.label = label;
+					c.bArrange = true;
+				}
+				w = Max(w, PairWidth(c));
+				h += c.minh;
+			}
+			h += gaps;
+		}
+		else {
+			// Grid
+			size_t ncols = (size_t)b.columns;
+			size_t nrows = (count + ncols - 1) / ncols;
+			b.cols.assign(ncols, 0);
+			b.rows.assign(nrows, 0);
+			b.colf.assign(ncols, 0.0f);
+			b.rowf.assign(nrows, 0.0f);
+			for (size_t k = 0; k < count; k++) {
+				const node &c = m_Nodes[b.children[k]];
+				size_t col = k % ncols;
+				size_t row = k / ncols;
+				b.cols[col] = Max(b.cols[col], c.minw);
+				b.rows[row] = Max(b.rows[row], c.minh);
+				b.colf[col] = Max(b.colf[col], c.fx);
+				b.rowf[row] = Max(b.rowf[row], c.fy);
+			}
+			for (size_t j = 0; j < ncols; j++)
+				w += b.cols[j];
+			for (size_t j = 0; j < nrows; j++)
+				h += b.rows[j];
+			if (ncols > 1) w += b.spacing * (int)(ncols - 1);
+			if (nrows > 1) h += b.spacing * (int)(nrows - 1);
+		}
+		b.minw = w;
+		b.minh = h;
+		b.fx = b.sx >= 0.0f ? b.sx : fx;
+		b.fy = b.sy >= 0.0f ? b.sy : fy;
+	}
+
+	// Share extra space by factors without rounding drift
+	// sizes are the minimum sizes and receive the shares
+	static void Share(std::vector<int> &sizes, const std::vector<float> &factors, int extra) {
+		float total = 0.0f;
+		for (size_t k = 0; k < factors.size(); k++)
+			total += factors[k];
+		if (extra <= 0 || total <= 0.0f)
+			return;
+		float sum = 0.0f;
+		int given = 0;
+		for (size_t k = 0; k < sizes.size(); k++) {
+			sum += factors[k];
+			int upto = (int)((double)extra * sum / total + 0.5);
+			sizes[k] += upto - given;
+			given = upto;
+		}
+	}
+
+	// Rectangle of a child in a cell
+	// Fills an axis with a factor, otherwise left aligned and centered vertically
+	rect Cell(const node &c, int x, int y, int w, int h) const {
+		rect r;
+		r.x = x;
+		r.width = (c.fx > 0.0f || c.minw > w) ? w : c.minw;
+		r.height = (c.fy > 0.0f || c.minh > h) ? h : c.minh;
+		r.y = y + (h - r.height) / 2;
+		return r;
+	}
+
+	void Place(int n, const rect &r, std::vector<placed> &changed) {
+		node &b = m_Nodes[n];
+		if (b.bPlaced && !b.bArrange && b.r == r)
+			return; // Unchanged subtree
+		m_Visited++;
+		bool bMoved = !b.bPlaced || b.r != r;
+		b.r = r;
+		b.bPlaced = true;
+		b.bArrange = false;
+
+		if (b.kind == Item) {
+			if (bMoved) {
+				placed p;
+				p.id = b.id;
+				p.r = r;
+				changed.push_back(p);
+			}
+			return;
+		}
+
+		size_t count = b.children.size();
+		if (count == 0)
+			return;
+		std::vector<int> sizes;
+		std::vector<float> factors;
+		sizes.reserve(count);
+		factors.reserve(count);
+
+		if (b.kind == Row || b.kind == Pair) {
+			int used = b.spacing * (int)(count - 1);
+			for (size_t k = 0; k < count; k++) {
+				const node &c = m_Nodes[b.children[k]];
+				bool bLabel = b.kind == Pair && k == 0;
+				// The label column does not stretch
+				sizes.push_back(bLabel ? Max(b.label, c.minw) : c.minw);
+				factors.push_back(bLabel ? 0.0f : c.fx);
+				used += sizes.back();
+			}
+			Share(sizes, factors, r.width - used);
+			int x = r.x;
+			for (size_t k = 0; k < count; k++) {
+				Place(b.children[k], Cell(m_Nodes[b.children[k]], x, r.y, sizes[k], r.height), changed);
+				x += sizes[k] + b.spacing;
+			}
+		}
+		else if (b.kind == Column) {
+			int used = b.spacing * (int)(count - 1);
+			for (size_t k = 0; k < count; k++) {
+				sizes.push_back(m_Nodes[b.children[k]].minh);
+				factors.push_back(m_Nodes[b.children[k]].fy);
+				used += sizes.back();
+			}
+			Share(sizes, factors, r.height - used);
+			int y = r.y;
+			for (size_t k = 0; k < count; k++) {
+				const node &c = m_Nodes[b.children[k]];
+				rect cr;
+				cr.x = r.x;
+				cr.y = y;
+				// Pairs fill the width so that the labels line up
+				cr.width = PairWidth(c);
+				if (c.fx > 0.0f || c.kind == Pair)
+					cr.width = Max(cr.width, r.width);
+				cr.height = c.fy > 0.0f ? sizes[k] : c.minh;
+				Place(b.children[k], cr, changed);
+				y += sizes[k] + b.spacing;
+			}
+		}
+		else {
+			// Grid
+			std::vector<int> cols(b.cols);
+			std::vector<int> rows(b.rows);
+			int usedw = cols.size() > 1 ? b.spacing * (int)(cols.size() - 1) : 0;
+			int usedh = rows.size() > 1 ? b.spacing * (int)(rows.size() - 1) : 0;
+			for (size_t j = 0; j < cols.size(); j++) usedw += cols[j];
+			for (size_t j = 0; j < rows.size(); j++) usedh += rows[j];
+			Share(cols, b.colf, r.width - usedw);
+			Share(rows, b.rowf, r.height - usedh);
+			size_t ncols = cols.size();
+			int y = r.y;
+			for (size_t row = 0; row < rows.size(); row++) {
+				int x = r.x;
+				for (size_t col = 0; col < ncols; col++) {
+					size_t k = row * ncols + col;
+					if (k >= count)
+						break;
+					const node &c = m_Nodes[b.children[k]];
+					Place(b.children[k], Cell(c, x, y, cols[col], rows[row]), changed);
+					x += cols[col] + b.spacing;
+				}
+				y += rows[row] + b.spacing;
+			}
+		}
+	}
+
+	std::vector<node> m_Nodes;
+	int m_Margin = 0;
+	size_t m_Visited = 0;
+
+};
@@ -0,0 +1,322 @@
+//
+// ofxWinDialogOsc.h
+//
+// Open Sound Control messages for a control surface.
+// Tested by tests/ofxWinDialogOscTest.cpp.
+//
+// OscMessage
+//   An address and arguments of type int32 'i', float32 'f' or
+//   string 's'. Int and Float convert either number argument, so that
+//   a console sending 1.0 to a checkbox or 64 to a slider is accepted.
+//
+// OscPacket
+//   Encode writes a message to a UDP packet. Decode reads a message or
+//   a bundle of messages, including bundles within bundles, and adds
+//   them to a vector in the order of the packet. A packet that is not
+//   valid OSC is ignored. Numbers are big-endian and all parts of a
+//   packet are padded to four bytes.
+//
+// OscAddress
+//   The address of a control is "/" followed by the prefix and the
+//   control title. Spaces are replaced by '_' and the characters that
+//   OSC uses for patterns are removed, so "Line width" is "/Line_width".
+//
+// OscRateLimit
+//   Outgoing values at most once for each interval for each address.
+//   A value offered within the interval replaces the value waiting to
+//   be sent and Due returns it when the interval has passed, so that
+//   the last value of a slider drag is always sent.
+//
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+struct OscMessage {
+
+	struct arg {
+		char type = 'i'; // 'i', 'f' or 's'
+		int32_t i = 0;
+		float f = 0.0f;
+		std::string s;
+	};
+
+	std::string address;
+	std::vector<arg> args;
+
+	void AddInt(int32_t value) {
+		arg a;
+		a.type = 'i';
+		a.i = value;
+		args.push_back(a);
+	}
+
+	void AddFloat(float value) {
+		arg a;
+		a.type = 'f';
+		a.f = value;
+		args.push_back(a);
+	}
+
+	void AddString(const std::string &value) {
+		arg a;
+		a.type = 's';
+		a.s = value;
+		args.push_back(a);
+	}
+
+	// First argument as a number or text
+	int Int(int def = 0) const {
+		if (args.empty())
+			return def;
+		if (args[0].type == 'f')
+			return (int)(args[0].f < 0.0f ? args[0].f - 0.5f : args[0].f + 0.5f);
+		if (args[0].type == 's')
+			return def;
+		return args[0].i;
+	}
+
+	float Float(float def = 0.0f) const {
+		if (args.empty() || args[0].type == 's')
+			return def;
+		return args[0].type == 'f' ? args[0].f : (float)args[0].i;
+	}
+
+	std::string Text() const {
+		if (args.empty())
+			return "";
+		if (args[0].type == 's')
+			return args[0].s;
+		return args[0].type == 'f' ? std::to_string(args[0].f) : std::to_string(args[0].i);
+	}
+};
+
+class OscPacket {
+
+public:
+
+	// Write a message to a packet
+	static void Encode(const OscMessage &msg, std::vector<uint8_t> &packet) {
+		packet.clear();
+		AddString(packet, msg.address);
+		std::string tags = ",";
+		for (size_t k = 0; k < msg.args.size(); k++)
+			tags += msg.args[k].type;
+		AddString(packet, tags);
+		for (size_t k = 0; k < msg.args.size(); k++) {
+			const OscMessage::arg &a = msg.args[k];
+			if (a.type == 'i') {
+				AddInt(packet, (uint32_t)a.i);
+			}
+			else if (a.type == 'f') {
+				uint32_t bits = 0;
+				memcpy(&bits, &a.f, 4);
+				AddInt(packet, bits);
+			}
+			else {
+				AddString(packet, a.s);
+			}
+		}
+	}
+
+	// Read the messages of a packet
+	// Returns the number of messages added
+	static size_t Decode(const uint8_t* data, size_t size, std::vector<OscMessage> &messages) {
+		size_t count = messages.size();
+		if (!DecodePart(data, size, messages, 0))
+			messages.resize(count); // Not valid
+		return messages.size() - count;
+	}
+
+private:
+
+	// Bundles within bundles are read to this depth
+	static const int MaxDepth = 8;
+
+	static bool DecodePart(const uint8_t* data, size_t size, std::vector<OscMessage> &messages, int depth) {
+		if (size < 4 || (size & 3) != 0 || depth > MaxDepth)
+			return false;
+
+		// Bundle - "#bundle", time tag and elements with a size each
+		if (size >= 16 && memcmp(data, "#bundle\0", 8) == 0) {
+			size_t pos = 16;
+			while (pos < size) {
+				uint32_t part = 0;
+				if (!ReadInt(data, size, pos, part) || part > size - pos)
+					return false;
+				if (!DecodePart(data + pos, part, messages, depth + 1))
+					return false;
+				pos += part;
+			}
+			return true;
+		}
+
+		// Message - address, type tags and arguments
+		OscMessage msg;
+		size_t pos = 0;
+		if (!ReadString(data, size, pos, msg.address) || msg.address.empty() || msg.address[0] != '/')
+			return false;
+		std::string tags;
+		if (pos < size) {
+			if (!ReadString(data, size, pos, tags) || tags.empty() || tags[0] != ',')
+				return false;
+		}
+		for (size_t k = 1; k < tags.size(); k++) {
+			OscMessage::arg a;
+			a.type = tags[k];
+			uint32_t bits = 0;
+			switch (tags[k]) {
+				case 'i':
+					if (!ReadInt(data, size, pos, bits))
+						return false;
+					a.i = (int32_t)bits;
+					break;
+				case 'f':
+					if (!ReadInt(data, size, pos, bits))
+						return false;
+					memcpy(&a.f, &bits, 4);
+					break;
+				case 's':
+					if (!ReadString(data, size, pos, a.s))
+						return false;
+					break;
+				case 'T': // True and false have no data
+				case 'F':
+					a.type = 'i';
+					a.i = tags[k] == 'T' ? 1 : 0;
+					break;
+				default:
+					// The size of other types is not known
+					// so the arguments after them are not read
+					k = tags.size();
+					continue;
+			}
+			msg.args.push_back(a);
+		}
+		messages.push_back(msg);
+		return true;
+	}
+
+	static void AddInt(std::vector<uint8_t> &packet, uint32_t value) {
+		packet.push_back((uint8_t)(value >> 24));
+		packet.push_back((uint8_t)(value >> 16));
+		packet.push_back((uint8_t)(value >> 8));
+		packet.push_back((uint8_t)value);
+	}
+
+	// Null terminated and padded to four bytes
+	static void AddString(std::vector<uint8_t> &packet, const std::string &text) {
+		packet.insert(packet.end(), text.begin(), text.end());
+		size_t pad = 4 - (text.size() & 3);
+		packet.insert(packet.end(), pad, 0);
+	}
+
+	static bool ReadInt(const uint8_t* data, size_t size, size_t &pos, uint32_t &value) {
+		if (size - pos < 4)
+			return false;
+		value = ((uint32_t)data[pos] << 24) | ((uint32_t)data[pos + 1] << 16)
+			| ((uint32_t)data[pos + 2] << 8) | (uint32_t)data[pos + 3];
+		pos += 4;
+		return true;
+	}
+
+	static bool ReadString(const uint8_t* data, size_t size, size_t &pos, std::string &text) {
+		const void* end = memchr(data + pos, 0, size - pos);
+		if (!end)
+			return false;
+		size_t len = (size_t)((const uint8_t*)end - (data + pos));
+		text.assign((const char*)data + pos, len);
+		pos += (len + 4) & ~(size_t)3;
+		return pos <= size;
+	}
+
+};
+
+// Address of a control title
+inline std::string OscAddress(const std::string &prefix, const std::string &title) {
+	std::string address = "/";
+	std::string name = prefix.empty() ? title : prefix + "/" + title;
+	for (size_t i = 0; i < name.size(); i++) {
+		char c = name[i];
+		if (c == ' ')
+			address += '_';
+		else if (c == '/' && !address.empty() && address.back() != '/')
+			address += c;
+		else if (c > ' ' && !strchr("#*,/?[]{}", c))
+			address += c;
+	}
+	return address;
+}
+
+class OscRateLimit {
+
+public:
+
+	// Interval in milliseconds
+	void SetInterval(uint64_t interval) { m_Interval = interval; }
+	uint64_t GetInterval() const { return m_Interval; }
+
+	// Returns true if the message can be sent now,
+	// otherwise it is kept until the interval has passed
+	bool Offer(const OscMessage &msg, uint64_t now) {
+		slot &s = m_Slots[msg.address];
+		if (!s.bSent || now - s.last >= m_Interval) {
+			s.bSent = true;
+			s.last = now;
+			if (s.bPending) {
+				s.bPending = false; // Replaced by this message
+				m_Pending--;
+			}
+			return true;
+		}
+		s.msg = msg;
+		if (!s.bPending) {
+			s.bPending = true;
+			m_Pending++;
+		}
+		return false;
+	}
+
+	// Messages kept by Offer whose interval has passed
+	size_t Due(uint64_t now, std::vector<OscMessage> &messages) {
+		messages.clear();
+		if (m_Pending == 0)
+			return 0;
+		for (auto it = m_Slots.begin(); it != m_Slots.end(); ++it) {
+			slot &s = it->second;
+			if (s.bPending && now - s.last >= m_Interval) {
+				s.bPending = false;
+				s.last = now;
+				m_Pending--;
+				messages.push_back(s.msg);
+			}
+		}
+		return messages.size();
+	}
+
+	// Messages waiting to be sent
+	size_t Pending() const { return m_Pending; }
+
+	void Clear() {
+		m_Slots.clear();
+		m_Pending = 0;
+	}
+
+private:
+
+	struct slot {
+		uint64_t last = 0; // Time of the last message sent
+		bool bSent = false;
+		bool bPending = false;
+		OscMessage msg; // Waiting to be sent
+	};
+
+	std::unordered_map<std::string, slot> m_Slots; // By address
+	uint64_t m_Interval = 20;
+	size_t m_Pending = 0;
+
+};
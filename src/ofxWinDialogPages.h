@@ -0,0 +1,165 @@
+//
+// ofxWinDialogPages.h
+//
+// Pages of controls with windows created on first show.
+// Tested by tests/ofxWinDialogPagesTest.cpp.
+//
+// PageSet
+//   Each page has a name and a list of control numbers. One page is
+//   current and only its controls are shown. A page is "created" when
+//   its control windows exist. Show reports whether the new page must
+//   be created and which pages must be destroyed so that no more than
+//   the maximum number of pages remain created. The pages shown least
+//   recently are destroyed first. The current page is never destroyed.
+//   Controls that are not on a page are always shown.
+//
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+class PageSet {
+
+public:
+
+	// Result of showing a page
+	struct change {
+		int hide = -1; // Page to hide or -1
+		bool bCreate = false; // Create the page controls
+		std::vector<int> destroy; // Pages to destroy
+	};
+
+	// Add a page or find an existing page with the name
+	// The first page added is current
+	int Add(const std::string &name) {
+		int page = Find(name);
+		if (page >= 0)
+			return page;
+		page_t p;
+		p.name = name;
+		m_Pages.push_back(p);
+		if (m_Current < 0)
+			m_Current = 0;
+		return (int)m_Pages.size() - 1;
+	}
+
+	int Find(const std::string &name) const {
+		for (size_t i = 0; i < m_Pages.size(); i++) {
+			if (m_Pages[i].name == name)
+				return (int)i;
+		}
+		return -1;
+	}
+
+	void AddControl(int page, int control) {
+		if (IsPage(page))
+			m_Pages[page].controls.push_back(control);
+	}
+
+	const std::vector<int> &GetControls(int page) const {
+		static const std::vector<int> none;
+		return IsPage(page) ? m_Pages[page].controls : none;
+	}
+
+	std::string GetName(int page) const {
+		return IsPage(page) ? m_Pages[page].name : "";
+	}
+
+	// Make a page current
+	// Returns the pages to hide, create and destroy
+	change Show(int page) {
+		change c;
+		if (!IsPage(page))
+			return c;
+		if (page != m_Current && IsPage(m_Current) && m_Pages[m_Current].bCreated)
+			c.hide = m_Current;
+		m_Current = page;
+		page_t &p = m_Pages[page];
+		p.used = ++m_Clock;
+		if (!p.bCreated) {
+			p.bCreated = true;
+			c.bCreate = true;
+			m_Creations++;
+		}
+
+		// Destroy the least recently shown pages
+		if (m_MaxCreated > 0) {
+			for (;;) {
+				int count = 0;
+				int oldest = -1;
+				for (size_t i = 0; i < m_Pages.size(); i++) {
+					if (!m_Pages[i].bCreated)
+						continue;
+					count++;
+					if ((int)i != m_Current && (oldest < 0 || m_Pages[i].used < m_Pages[oldest].used))
+						oldest = (int)i;
+				}
+				if (count <= m_MaxCreated || oldest < 0)
+					break;
+				m_Pages[oldest].bCreated = false;
+				c.destroy.push_back(oldest);
+				m_Evictions++;
+			}
+		}
+		return c;
+	}
+
+	// Current page without creating it
+	// Used before the dialog is open
+	void SetCurrent(int page) {
+		if (IsPage(page))
+			m_Current = page;
+	}
+
+	int GetCurrent() const { return m_Current; }
+
+	// Whether controls on the page are shown
+	// Controls not on a page (-1) are always shown
+	bool IsShown(int page) const {
+		return page < 0 || page == m_Current;
+	}
+
+	bool IsCreated(int page) const {
+		return IsPage(page) && m_Pages[page].bCreated;
+	}
+
+	// All control windows destroyed with the dialog
+	void Reset() {
+		for (size_t i = 0; i < m_Pages.size(); i++)
+			m_Pages[i].bCreated = false;
+	}
+
+	// Maximum number of pages with control windows (0 = all)
+	void SetMaxCreated(int max) { m_MaxCreated = max > 0 ? max : 0; }
+	int GetMaxCreated() const { return m_MaxCreated; }
+
+	size_t Size() const { return m_Pages.size(); }
+	bool Empty() const { return m_Pages.empty(); }
+
+	// Number of times pages were created and destroyed
+	uint64_t GetCreations() const { return m_Creations; }
+	uint64_t GetEvictions() const { return m_Evictions; }
+
+private:
+
+	bool IsPage(int page) const {
+		return page >= 0 && page < (int)m_Pages.size();
+	}
+
+	struct page_t {
+		std::string name;
+		std::vector<int> controls;
+		bool bCreated = false;
+		uint64_t used = 0; // Last shown
+	};
+
+	std::vector<page_t> m_Pages;
+	int m_Current = -1;
+	int m_MaxCreated = 0;
+	uint64_t m_Clock = 0;
+	uint64_t m_Creations = 0;
+	uint64_t m_Evictions = 0;
+
+};
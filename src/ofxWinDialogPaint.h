@@ -0,0 +1,182 @@
+//
+// ofxWinDialogPaint.h
+//
+// Dirty rectangles and back buffer sizing for double-buffered painting.
+// Tested by tests/ofxWinDialogPaintTest.cpp.
+//
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+// Rectangle with exclusive right and bottom (as RECT)
+struct PaintRect {
+	int left = 0;
+	int top = 0;
+	int right = 0;
+	int bottom = 0;
+
+	bool IsEmpty() const { return right <= left || bottom <= top; }
+	long long Area() const { return IsEmpty() ? 0 : (long long)(right - left) * (bottom - top); }
+
+	bool Intersects(const PaintRect &r) const {
+		return left < r.right && r.left < right && top < r.bottom && r.top < bottom;
+	}
+
+	// Overlapping or sharing an edge
+	bool Touches(const PaintRect &r) const {
+		return left <= r.right && r.left <= right && top <= r.bottom && r.top <= bottom;
+	}
+
+	PaintRect Union(const PaintRect &r) const {
+		PaintRect u;
+		u.left   = (std::min)(left, r.left);
+		u.top    = (std::min)(top, r.top);
+		u.right  = (std::max)(right, r.right);
+		u.bottom = (std::max)(bottom, r.bottom);
+		return u;
+	}
+};
+
+//
+// Dirty rectangle accumulator
+//
+// Rectangles that overlap or touch are merged if the merged
+// rectangle does not add more than a quarter to their area.
+// If the number of rectangles exceeds the maximum, all are
+// merged into the bounding rectangle.
+//
+class DirtyRegion {
+
+public:
+
+	DirtyRegion(size_t maxrects = 16) {
+		m_MaxRects = maxrects > 0 ? maxrects : 1;
+	}
+
+	void Add(int left, int top, int right, int bottom) {
+		PaintRect r;
+		r.left = left;
+		r.top = top;
+		r.right = right;
+		r.bottom = bottom;
+		Add(r);
+	}
+
+	void Add(PaintRect r) {
+		if (r.IsEmpty())
+			return;
+
+		// Merge with existing rectangles until no more merges
+		bool bMerged = true;
+		while (bMerged) {
+			bMerged = false;
+			for (size_t i = 0; i < m_Rects.size(); i++) {
+				if (!r.Touches(m_Rects[i]))
+					continue;
+				PaintRect u = r.Union(m_Rects[i]);
+				if (u.Area() * 4 <= (r.Area() + m_Rects[i].Area()) * 5) {
+					r = u;
+					m_Rects.erase(m_Rects.begin() + i);
+					bMerged = true;
+					break;
+				}
+			}
+		}
+		m_Rects.push_back(r);
+
+		// Too many - use the bounding rectangle
+		if (m_Rects.size() > m_MaxRects) {
+			PaintRect b = m_Rects[0];
+			for (size_t i = 1; i < m_Rects.size(); i++)
+				b = b.Union(m_Rects[i]);
+			m_Rects.clear();
+			m_Rects.push_back(b);
+		}
+	}
+
+	// Limit all rectangles to the buffer size
+	void Clip(int width, int height) {
+		for (size_t i = 0; i < m_Rects.size(); ) {
+			PaintRect &r = m_Rects[i];
+			r.left   = (std::max)(r.left, 0);
+			r.top    = (std::max)(r.top, 0);
+			r.right  = (std::min)(r.right, width);
+			r.bottom = (std::min)(r.bottom, height);
+			if (r.IsEmpty())
+				m_Rects.erase(m_Rects.begin() + i);
+			else
+				i++;
+		}
+	}
+
+	void Clear() { m_Rects.clear(); }
+	bool IsEmpty() const { return m_Rects.empty(); }
+	const std::vector<PaintRect> &GetRects() const { return m_Rects; }
+
+private:
+
+	size_t m_MaxRects = 16;
+	std::vector<PaintRect> m_Rects;
+
+};
+
+//
+// Back buffer size
+//
+// The buffer is allocated in steps larger than the window so that
+// it is not re-allocated for every size change while resizing.
+// It is reduced again only if the window becomes much smaller.
+//
+class BackBufferSize {
+
+public:
+
+	BackBufferSize(int step = 128) {
+		m_Step = step > 0 ? step : 128;
+	}
+
+	// Set the window size
+	// Returns true if the buffer must be re-allocated
+	bool Resize(int width, int height) {
+		m_Width = (std::max)(width, 1);
+		m_Height = (std::max)(height, 1);
+		bool bGrow = m_Width > m_CapWidth || m_Height > m_CapHeight;
+		bool bShrink = m_CapWidth > 2 * RoundUp(m_Width) || m_CapHeight > 2 * RoundUp(m_Height);
+		if (bGrow || bShrink) {
+			m_CapWidth = RoundUp(m_Width);
+			m_CapHeight = RoundUp(m_Height);
+			m_Allocations++;
+			return true;
+		}
+		return false;
+	}
+
+	// Force re-allocation on the next Resize
+	void Reset() {
+		m_CapWidth = 0;
+		m_CapHeight = 0;
+	}
+
+	// Window size
+	int GetWidth() const { return m_Width; }
+	int GetHeight() const { return m_Height; }
+	// Allocated buffer size
+	int GetBufferWidth() const { return m_CapWidth; }
+	int GetBufferHeight() const { return m_CapHeight; }
+	// Number of allocations
+	int GetAllocations() const { return m_Allocations; }
+
+private:
+
+	int RoundUp(int v) const { return ((v + m_Step - 1) / m_Step) * m_Step; }
+
+	int m_Step = 128;
+	int m_Width = 0;
+	int m_Height = 0;
+	int m_CapWidth = 0;
+	int m_CapHeight = 0;
+	int m_Allocations = 0;
+
+};
@@ -0,0 +1,451 @@
+//
+// ofxWinDialogParams.h
+//
+// Parameters shared by the controls of several dialogs.
+// Tested by tests/ofxWinDialogParamsTest.cpp.
+//
+// ParamStore
+//   Typed entries by key. An Int entry is rounded to a whole number,
+//   a Float entry is a number and a Text entry is up to MaxText
+//   characters. Global is the store for the process.
+//
+//   Readers do not lock. Find probes a hash table of entry numbers
+//   and GetNumber is one atomic load. GetText copies the text and
+//   copies it again if a writer changed it during the copy (sequence
+//   lock). Writers take a mutex.
+//
+//   A subscriber is a function told of changes to the entries it is
+//   bound to. A binding has a tag that the subscriber uses to find its
+//   control. A change made for a binding (the source) is not passed
+//   back to it, and a value that is not changed is not passed on at all,
+//   so a control set from the store does not set the store again.
+//
+//   Changes are passed on in the order made. Each subscriber is called
+//   once for all the changes of a pass. Changes made by a subscriber
+//   while it is called are passed on by the same thread after it
+//   returns. Changes between BeginBatch and EndBatch are passed on
+//   together by EndBatch.
+//
+#pragma once
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+class ParamStore {
+
+public:
+
+	enum Type { Int, Float, Text };
+
+	static const int MaxParams = 1024;
+	static const size_t MaxText = 255;
+
+	// Change of an entry for a binding
+	struct change {
+		int id = -1; // Entry
+		int tag = 0; // Tag of the binding
+		double number = 0.0;
+		std::string text;
+	};
+	typedef std::function<void(const std::vector<change> &)> Subscriber;
+
+	ParamStore() {
+		for (int i = 0; i < MaxParams; i++)
+			m_Entries[i].store(nullptr);
+		for (int i = 0; i < TableSize; i++)
+			m_Table[i].store(0);
+	}
+
+	~ParamStore() {
+		for (int i = 0; i < MaxParams; i++)
+			delete m_Entries[i].load();
+	}
+
+	ParamStore(const ParamStore &) = delete;
+	ParamStore &operator=(const ParamStore &) = delete;
+
+	// Store for the process
+	static ParamStore &Global() {
+		static ParamStore store;
+		return store;
+	}
+
+	//
+	// Entries
+	//
+
+	// Entry of a key, created with the type and value if new
+	// Returns -1 if the store is full
+	int Add(const std::string &key, Type type, double number = 0.0, const std::string &text = "", bool* bCreated = nullptr) {
+		if (bCreated) *bCreated = false;
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		int id = Find(key);
+		if (id >= 0)
+			return id;
+		int count = m_Count.load(std::memory_order_relaxed);
+		if (count >= MaxParams)
+			return -1;
+		entry* e = new entry;
+		e->key = key;
+		e->type = type;
+		Write(*e, number, text);
+		m_Entries[count].store(e, std::memory_order_release);
+		m_Count.store(count + 1, std::memory_order_release);
+		// Published after the entry so that a reader finds a complete entry
+		size_t slot = Hash(key);
+		while (m_Table[slot].load(std::memory_order_relaxed) != 0)
+			slot = (slot + 1) & (TableSize - 1);
+		m_Table[slot].store(count + 1, std::memory_order_release);
+		if (bCreated) *bCreated = true;
+		return count;
+	}
+
+	// Entry of a key or -1
+	int Find(const std::string &key) const {
+		size_t slot = Hash(key);
+		for (int n = 0; n < TableSize; n++) {
+			int id = m_Table[slot].load(std::memory_order_acquire) - 1;
+			if (id < 0)
+				return -1;
+			const entry* e = m_Entries[id].load(std::memory_order_acquire);
+			if (e && e->key == key)
+				return id;
+			slot = (slot + 1) & (TableSize - 1);
+		}
+		return -1;
+	}
+
+	int Size() const { return m_Count.load(std::memory_order_acquire); }
+
+	std::string GetKey(int id) const {
+		const entry* e = Get(id);
+		return e ? e->key : std::string();
+	}
+
+	Type GetType(int id) const {
+		const entry* e = Get(id);
+		return e ? e->type : Float;
+	}
+
+	double GetNumber(int id) const {
+		const entry* e = Get(id);
+		if (!e)
+			return 0.0;
+		uint64_t bits = e->number.load(std::memory_order_acquire);
+		double number = 0.0;
+		memcpy(&number, &bits, sizeof(number));
+		return number;
+	}
+
+	std::string GetText(int id) const {
+		const entry* e = Get(id);
+		return e ? ReadText(*e) : std::string();
+	}
+
+	// Number of changes to an entry
+	uint32_t GetVersion(int id) const {
+		const entry* e = Get(id);
+		return e ? e->seq.load(std::memory_order_acquire) / 2 : 0;
+	}
+
+	//
+	// Set an entry value
+	// A Text entry has the number as text and a number entry has the
+	// number of the text. Bound subscribers are told of the change
+	// unless it is within a batch.
+	//   source - binding that made the change, not told of it
+	// Returns false if the value is not changed.
+	//
+	bool SetNumber(int id, double number, int source = -1) {
+		entry* e = Get(id);
+		if (!e)
+			return false;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			std::string text;
+			if (e->type == Text) {
+				char tmp[32]{};
+				snprintf(tmp, sizeof(tmp), "%g", number);
+				text = tmp;
+			}
+			if (!Change(*e, number, text))
+				return false;
+			m_Pending.push_back({ id, source });
+		}
+		Deliver();
+		return true;
+	}
+
+	bool SetText(int id, const std::string &text, int source = -1) {
+		entry* e = Get(id);
+		if (!e)
+			return false;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (!Change(*e, atof(text.c_str()), text))
+				return false;
+			m_Pending.push_back({ id, source });
+		}
+		Deliver();
+		return true;
+	}
+
+	//
+	// Subscribers and bindings
+	//
+
+	// Returns the subscriber number
+	int Subscribe(Subscriber fn) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Subscribers.push_back(fn);
+		return (int)m_Subscribers.size() - 1;
+	}
+
+	// Remove a subscriber and its bindings
+	// Waits for a pass by another thread, so that the
+	// subscriber is not called after it has returned.
+	void Unsubscribe(int subscriber) {
+		{
+			std::unique_lock<std::mutex> deliver(m_Deliver, std::defer_lock);
+			if (!Delivering())
+				deliver.lock();
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (subscriber < 0 || subscriber >= (int)m_Subscribers.size())
+				return;
+			m_Subscribers[(size_t)subscriber] = nullptr;
+			for (size_t b = 0; b < m_Bindings.size(); b++) {
+				if (m_Bindings[b].subscriber == subscriber)
+					m_Bindings[b].id = -1;
+			}
+		}
+		// Changes made while waiting
+		Deliver();
+	}
+
+	// Bind a subscriber to an entry
+	// Returns the binding number or -1
+	int Bind(int id, int subscriber, int tag) {
+		entry* e = Get(id);
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!e || subscriber < 0 || subscriber >= (int)m_Subscribers.size())
+			return -1;
+		binding b;
+		b.id = id;
+		b.subscriber = subscriber;
+		b.tag = tag;
+		m_Bindings.push_back(b);
+		int index = (int)m_Bindings.size() - 1;
+		e->bindings.push_back(index);
+		return index;
+	}
+
+	void Unbind(int index) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (index >= 0 && index < (int)m_Bindings.size())
+			m_Bindings[(size_t)index].id = -1;
+	}
+
+	//
+	// Batches
+	// Changes by any thread between BeginBatch and EndBatch are
+	// passed on by EndBatch. Batches can be nested.
+	//
+	void BeginBatch() { m_Batch++; }
+
+	void EndBatch() {
+		if (--m_Batch <= 0) {
+			m_Batch = 0;
+			Deliver();
+		}
+	}
+
+private:
+
+	static const int TableSize = MaxParams * 2;
+	static const size_t TextWords = (MaxText + 1) / 8;
+
+	struct entry {
+		std::string key;
+		Type type = Float;
+		std::atomic<uint32_t> seq{ 0 }; // Odd while written
+		std::atomic<uint64_t> number{ 0 }; // Bits of a double
+		std::atomic<uint32_t> length{ 0 };
+		std::atomic<uint64_t> text[TextWords]{};
+		std::vector<int> bindings; // Writers only
+	};
+
+	struct binding {
+		int id = -1; // Entry, -1 if removed
+		int subscriber = -1;
+		int tag = 0;
+	};
+
+	struct pending {
+		int id;
+		int source;
+	};
+
+	// Copy the text again if a writer changed it during the copy
+	static std::string ReadText(const entry &e) {
+		char text[TextWords * 8]{};
+		size_t length = 0;
+		for (;;) {
+			uint32_t seq = e.seq.load(std::memory_order_acquire);
+			if (seq & 1)
+				continue; // Being written
+			length = e.length.load(std::memory_order_relaxed);
+			if (length > MaxText)
+				length = MaxText;
+			for (size_t w = 0; w < (length + 7) / 8; w++) {
+				uint64_t word = e.text[w].load(std::memory_order_relaxed);
+				memcpy(text + w * 8, &word, 8);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (e.seq.load(std::memory_order_relaxed) == seq)
+				break;
+		}
+		return std::string(text, length);
+	}
+
+	entry* Get(int id) const {
+		if (id < 0 || id >= m_Count.load(std::memory_order_acquire))
+			return nullptr;
+		return m_Entries[id].load(std::memory_order_acquire);
+	}
+
+	static size_t Hash(const std::string &key) {
+		// FNV-1a
+		uint32_t h = 2166136261u;
+		for (size_t i = 0; i < key.size(); i++) {
+			h ^= (uint8_t)key[i];
+			h *= 16777619u;
+		}
+		return (size_t)h & (TableSize - 1);
+	}
+
+	// Write a value if it differs (writers)
+	bool Change(entry &e, double number, const std::string &text) {
+		if (e.type == Int)
+			number = std::floor(number + 0.5);
+		if (e.type == Text) {
+			if (text.substr(0, MaxText) == ReadText(e))
+				return false;
+		}
+		else {
+			uint64_t bits = e.number.load(std::memory_order_relaxed);
+			double old = 0.0;
+			memcpy(&old, &bits, sizeof(old));
+			if (old == number)
+				return false;
+		}
+		Write(e, number, text);
+		return true;
+	}
+
+	static void Write(entry &e, double number, const std::string &text) {
+		if (e.type == Int)
+			number = std::floor(number + 0.5);
+		uint64_t bits = 0;
+		memcpy(&bits, &number, sizeof(bits));
+		size_t length = text.size() < MaxText ? text.size() : MaxText;
+		char tmp[TextWords * 8]{};
+		memcpy(tmp, text.data(), length);
+
+		uint32_t seq = e.seq.load(std::memory_order_relaxed);
+		e.seq.store(seq + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		e.number.store(bits, std::memory_order_relaxed);
+		e.length.store((uint32_t)length, std::memory_order_relaxed);
+		for (size_t w = 0; w < TextWords; w++) {
+			uint64_t word = 0;
+			memcpy(&word, tmp + w * 8, 8);
+			e.text[w].store(word, std::memory_order_relaxed);
+		}
+		e.seq.store(seq + 2, std::memory_order_release);
+	}
+
+	// A pass by this thread is calling subscribers
+	bool Delivering() const {
+		return m_DeliverThread.load() == CurrentThread();
+	}
+
+	// Unique for each thread
+	static uintptr_t CurrentThread() {
+		thread_local char t_Thread = 0;
+		return (uintptr_t)&t_Thread;
+	}
+
+	// Pass pending changes to the subscribers
+	// Only one thread passes changes at a time, so the changes are
+	// passed on in the order made. A thread that finds another passing
+	// changes leaves its changes to it.
+	void Deliver() {
+		if (m_Batch > 0 || Delivering())
+			return;
+		for (;;) {
+			if (!m_Deliver.try_lock())
+				return;
+			m_DeliverThread.store(CurrentThread());
+			std::vector<pending> changes;
+			std::vector<std::vector<change>> calls;
+			std::vector<Subscriber> subscribers;
+			for (;;) {
+				{
+					std::lock_guard<std::mutex> lock(m_Mutex);
+					if (m_Pending.empty())
+						break;
+					changes.swap(m_Pending);
+					m_Pending.clear();
+					subscribers = m_Subscribers;
+					calls.assign(m_Subscribers.size(), std::vector<change>());
+					for (size_t k = 0; k < changes.size(); k++) {
+						entry* e = Get(changes[k].id);
+						change c;
+						c.id = changes[k].id;
+						c.number = GetNumber(c.id);
+						if (e->type == Text)
+							c.text = ReadText(*e);
+						for (int index : e->bindings) {
+							const binding &b = m_Bindings[(size_t)index];
+							if (b.id != c.id || index == changes[k].source)
+								continue;
+							c.tag = b.tag;
+							calls[(size_t)b.subscriber].push_back(c);
+						}
+					}
+				}
+				for (size_t s = 0; s < calls.size(); s++) {
+					if (!calls[s].empty() && subscribers[s])
+						subscribers[s](calls[s]);
+				}
+			}
+			m_DeliverThread.store(0);
+			m_Deliver.unlock();
+			// Changes added while the lock was released
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (m_Pending.empty())
+				return;
+		}
+	}
+
+	std::atomic<entry*> m_Entries[MaxParams];
+	std::atomic<int> m_Table[TableSize]; // Entry + 1, 0 if free
+	std::atomic<int> m_Count{ 0 };
+	std::mutex m_Mutex; // Writers
+	std::mutex m_Deliver; // Pass of changes to subscribers
+	std::atomic<uintptr_t> m_DeliverThread{ 0 };
+	std::atomic<int> m_Batch{ 0 };
+	std::vector<Subscriber> m_Subscribers;
+	std::vector<binding> m_Bindings;
+	std::vector<pending> m_Pending;
+
+};
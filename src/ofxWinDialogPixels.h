@@ -0,0 +1,70 @@
+//
+// ofxWinDialogPixels.h
+//
+// Pixel copy and conversion for picture buttons.
+// Tested by tests/ofxWinDialogPixelsTest.cpp.
+//
+#pragma once
+
+#include <cstring>
+
+//
+// Row pitch of a 24 bit DIB section
+// DIB rows are aligned to 4 bytes
+//
+inline int DibPitch(int width)
+{
+	return ((width * 3) + 3) & ~3;
+}
+
+//
+// Copy an image pixel buffer to a 24 bit DIB buffer
+//
+//   dst       - DIB bits (pitch bytes per row)
+//   pitch     - destination row pitch (see DibPitch)
+//   src       - source pixels (RGB or RGBA, width*nchannels bytes per row)
+//   nchannels - 3 or 4. Alpha is ignored.
+//   bFlip     - copy source rows bottom to top
+//   bSwapRG   - source is already in BGR order, copy unchanged
+//
+// Returns false if the arguments are not valid.
+//
+inline bool CopyPixelsToDib(unsigned char* dst, int pitch,
+	const unsigned char* src, int width, int height,
+	int nchannels, bool bFlip, bool bSwapRG)
+{
+	if (!dst || !src || width <= 0 || height <= 0)
+		return false;
+	if (nchannels < 3 || nchannels > 4 || pitch < width * 3)
+		return false;
+
+	const int srcpitch = width * nchannels;
+	for (int y = 0; y < height; y++) {
+		const unsigned char* s = src + (size_t)(bFlip ? (height - 1 - y) : y) * srcpitch;
+		unsigned char* d = dst + (size_t)y * pitch;
+		if (bSwapRG && nchannels == 3) {
+			// Same layout - copy the whole row
+			memcpy(d, s, (size_t)width * 3);
+		}
+		else if (bSwapRG) {
+			for (int x = 0; x < width; x++) {
+				d[0] = s[0];
+				d[1] = s[1];
+				d[2] = s[2];
+				s += nchannels;
+				d += 3;
+			}
+		}
+		else {
+			// RGB to BGR
+			for (int x = 0; x < width; x++) {
+				d[0] = s[2];
+				d[1] = s[1];
+				d[2] = s[0];
+				s += nchannels;
+				d += 3;
+			}
+		}
+	}
+	return true;
+}
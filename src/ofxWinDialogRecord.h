@@ -0,0 +1,231 @@
+//
+// ofxWinDialogRecord.h
+//
+// Recording of dialog events in a compact binary trace.
+// Tested by tests/ofxWinDialogRecordTest.cpp.
+//
+// EventTrace
+//   Each record is the time from the start of recording, an operation,
+//   a control title, text and a value. An operation is a control event
+//   passed to the ofApp callback or a Set function called by ofApp.
+//
+//   Trace format (little endian)
+//     "WDTR" and a version byte, then for each record :
+//       time    - varint, microseconds after the previous record
+//       op      - byte
+//       title   - varint index into the titles. An index equal to the
+//                 number of titles read so far is a new title and is
+//                 followed by varint length and the characters.
+//       text    - varint length and characters
+//       value   - zigzag varint
+//       fvalue  - 4 byte float for SetSlider only
+//   Titles are written once so that a record for a slider move is
+//   usually 5 or 6 bytes.
+//
+// Events are replayed in the order recorded, so a replay is the same
+// sequence whatever the speed. NextDelay gives the time to wait before
+// each event for replay at the recorded speed.
+//
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+class EventTrace {
+
+public:
+
+	enum {
+		Event, // Control event to the ofApp callback
+		SetCheckBox,
+		SetRadioButton,
+		SetSlider,
+		SetEdit,
+		SetText,
+		SetComboItem,
+		SetListItem,
+		SetSpin,
+		OpCount
+	};
+
+	struct event {
+		uint64_t time = 0; // Microseconds from the start of recording
+		int op = Event;
+		std::string title;
+		std::string text;
+		int value = 0;
+		float fvalue = 0.0f;
+	};
+
+	void Add(uint64_t time, int op, const std::string &title,
+		const std::string &text, int value, float fvalue = 0.0f) {
+		event e;
+		e.time = time;
+		e.op = op;
+		e.title = title;
+		e.text = text;
+		e.value = value;
+		e.fvalue = fvalue;
+		m_Events.push_back(e);
+	}
+
+	const std::vector<event> &GetEvents() const { return m_Events; }
+	size_t Size() const { return m_Events.size(); }
+	void Clear() { m_Events.clear(); }
+
+	// Microseconds to wait before an event for replay at a speed
+	// (2.0 = twice as fast). Zero speed is as fast as possible.
+	uint64_t NextDelay(size_t index, double speed) const {
+		if (index >= m_Events.size() || speed <= 0.0)
+			return 0;
+		uint64_t previous = index > 0 ? m_Events[index - 1].time : 0;
+		uint64_t time = m_Events[index].time;
+		if (time <= previous)
+			return 0;
+		return (uint64_t)((double)(time - previous) / speed);
+	}
+
+	// Binary trace of the events
+	void Write(std::string &bytes) const {
+		bytes.clear();
+		bytes.append(Magic, 4);
+		bytes += (char)Version;
+		std::unordered_map<std::string, uint64_t> titles;
+		uint64_t previous = 0;
+		for (size_t i = 0; i < m_Events.size(); i++) {
+			const event &e = m_Events[i];
+			uint64_t time = e.time >= previous ? e.time : previous;
+			PutVarint(bytes, time - previous);
+			previous = time;
+			bytes += (char)e.op;
+			auto it = titles.find(e.title);
+			if (it != titles.end()) {
+				PutVarint(bytes, it->second);
+			}
+			else {
+				uint64_t index = titles.size();
+				titles.emplace(e.title, index);
+				PutVarint(bytes, index);
+				PutString(bytes, e.title);
+			}
+			PutString(bytes, e.text);
+			PutVarint(bytes, Zigzag(e.value));
+			if (e.op == SetSlider) {
+				uint32_t bits = 0;
+				memcpy(&bits, &e.fvalue, 4);
+				for (int b = 0; b < 4; b++)
+					bytes += (char)((bits >> (b * 8)) & 0xFF);
+			}
+		}
+	}
+
+	// Read a binary trace
+	// Returns false if the data is not a complete trace
+	bool Read(const char* data, size_t size) {
+		m_Events.clear();
+		if (size < 5 || memcmp(data, Magic, 4) != 0 || (uint8_t)data[4] != Version)
+			return false;
+		std::vector<std::string> titles;
+		size_t pos = 5;
+		uint64_t time = 0;
+		while (pos < size) {
+			event e;
+			uint64_t delta = 0, index = 0, value = 0;
+			if (!GetVarint(data, size, pos, delta) || pos >= size)
+				return Fail();
+			time += delta;
+			e.time = time;
+			e.op = (uint8_t)data[pos++];
+			if (e.op >= OpCount)
+				return Fail();
+			if (!GetVarint(data, size, pos, index) || index > titles.size())
+				return Fail();
+			if (index == titles.size()) {
+				std::string title;
+				if (!GetString(data, size, pos, title))
+					return Fail();
+				titles.push_back(title);
+			}
+			e.title = titles[(size_t)index];
+			if (!GetString(data, size, pos, e.text) || !GetVarint(data, size, pos, value))
+				return Fail();
+			e.value = Unzigzag(value);
+			if (e.op == SetSlider) {
+				if (size - pos < 4)
+					return Fail();
+				uint32_t bits = 0;
+				for (int b = 0; b < 4; b++)
+					bits |= (uint32_t)(uint8_t)data[pos + b] << (b * 8);
+				memcpy(&e.fvalue, &bits, 4);
+				pos += 4;
+			}
+			m_Events.push_back(e);
+		}
+		return true;
+	}
+
+	bool Read(const std::string &bytes) {
+		return Read(bytes.data(), bytes.size());
+	}
+
+private:
+
+	static constexpr const char* Magic = "WDTR";
+	static const uint8_t Version = 1;
+
+	bool Fail() {
+		m_Events.clear();
+		return false;
+	}
+
+	// Small negative values in one byte
+	static uint64_t Zigzag(int value) {
+		return (uint64_t)(((uint32_t)value << 1) ^ (value < 0 ? 0xFFFFFFFFu : 0u));
+	}
+
+	static int Unzigzag(uint64_t value) {
+		return (int)(uint32_t)((value >> 1) ^ (0 - (value & 1)));
+	}
+
+	static void PutVarint(std::string &bytes, uint64_t value) {
+		while (value >= 0x80) {
+			bytes += (char)((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+		bytes += (char)value;
+	}
+
+	static bool GetVarint(const char* data, size_t size, size_t &pos, uint64_t &value) {
+		value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			if (pos >= size)
+				return false;
+			uint8_t b = (uint8_t)data[pos++];
+			value |= (uint64_t)(b & 0x7F) << shift;
+			if (!(b & 0x80))
+				return true;
+		}
+		return false;
+	}
+
+	static void PutString(std::string &bytes, const std::string &text) {
+		PutVarint(bytes, text.size());
+		bytes += text;
+	}
+
+	static bool GetString(const char* data, size_t size, size_t &pos, std::string &text) {
+		uint64_t length = 0;
+		if (!GetVarint(data, size, pos, length) || length > size - pos)
+			return false;
+		text.assign(data + pos, (size_t)length);
+		pos += (size_t)length;
+		return true;
+	}
+
+	std::vector<event> m_Events;
+
+};
@@ -0,0 +1,273 @@
+//
+// ofxWinDialogSearch.h
+//
+// Search index for combo and list box items.
+// Tested by tests/ofxWinDialogSearchTest.cpp.
+//
+// ItemIndex
+//   Item keys are held in item order and an array of item numbers
+//   is sorted by key. A prefix or exact search is a binary search
+//   of the sorted array. An optional trigram index gives substring
+//   search by intersecting the item lists of the query trigrams.
+//   Matching ignores ASCII case. Other UTF-8 bytes must match.
+//
+//   Appended and replaced items are kept in a pending list and merged
+//   into the sorted array by the next search, so a batch of changes
+//   costs one pass over the array rather than one for each item.
+//   FindPrefix with a limit returns the first items in key order for
+//   type-ahead, in time that does not depend on the number of matches.
+//
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+class ItemIndex {
+
+public:
+
+	ItemIndex(bool bNgrams = false) {
+		m_bNgrams = bNgrams;
+	}
+
+	// Build the index for "count" items
+	// get(i) returns the text of item i as a std::string
+	template <typename Getter>
+	void Build(size_t count, Getter get) {
+		Clear();
+		m_Keys.reserve(count);
+		m_Sorted.reserve(count);
+		m_Moved.assign(count, 0);
+		for (size_t i = 0; i < count; i++) {
+			m_Keys.push_back(Fold(get(i)));
+			m_Sorted.push_back((uint32_t)i);
+			if (m_bNgrams)
+				AddNgrams((uint32_t)i);
+		}
+		std::stable_sort(m_Sorted.begin(), m_Sorted.end(),
+			[this](uint32_t a, uint32_t b) { return m_Keys[a] < m_Keys[b]; });
+	}
+
+	void Build(const std::vector<std::string> &items) {
+		Build(items.size(), [&items](size_t i) { return items[i]; });
+	}
+
+	// Add an item at the end
+	void Append(const std::string &text) {
+		uint32_t id = (uint32_t)m_Keys.size();
+		m_Keys.push_back(Fold(text));
+		m_Pending.push_back(id);
+		m_Moved.push_back(1);
+		if (m_bNgrams)
+			AddNgrams(id);
+	}
+
+	// Replace the text of an item
+	bool Replace(size_t index, const std::string &text) {
+		if (index >= m_Keys.size())
+			return false;
+		uint32_t id = (uint32_t)index;
+		if (m_bNgrams)
+			RemoveNgrams(id);
+		m_Keys[id] = Fold(text);
+		if (!m_Moved[id]) {
+			m_Moved[id] = 1;
+			m_Pending.push_back(id);
+			m_Removed++;
+		}
+		if (m_bNgrams)
+			AddNgrams(id);
+		return true;
+	}
+
+	void Clear() {
+		m_Keys.clear();
+		m_Sorted.clear();
+		m_Pending.clear();
+		m_Moved.clear();
+		m_Removed = 0;
+		m_Ngrams.clear();
+	}
+
+	// Merge appended and replaced items into the sorted array
+	// Called by the searches, or after a batch of changes
+	void Flush() const {
+		if (m_Pending.empty())
+			return;
+		auto less = [this](uint32_t a, uint32_t b) {
+			return m_Keys[a] < m_Keys[b] || (m_Keys[a] == m_Keys[b] && a < b);
+		};
+		// Replaced items leave their old position
+		if (m_Removed > 0) {
+			m_Sorted.erase(std::remove_if(m_Sorted.begin(), m_Sorted.end(),
+				[this](uint32_t id) { return m_Moved[id] != 0; }), m_Sorted.end());
+		}
+		std::sort(m_Pending.begin(), m_Pending.end(), less);
+		size_t middle = m_Sorted.size();
+		m_Sorted.insert(m_Sorted.end(), m_Pending.begin(), m_Pending.end());
+		std::inplace_merge(m_Sorted.begin(), m_Sorted.begin() + (long)middle, m_Sorted.end(), less);
+		for (uint32_t id : m_Pending)
+			m_Moved[id] = 0;
+		m_Pending.clear();
+		m_Removed = 0;
+	}
+
+	// Lowest item with the text or -1
+	int Find(const std::string &text) const {
+		Flush();
+		std::string key = Fold(text);
+		auto it = std::lower_bound(m_Sorted.begin(), m_Sorted.end(), key,
+			[this](uint32_t a, const std::string &k) { return m_Keys[a] < k; });
+		// Equal keys are in item order
+		if (it != m_Sorted.end() && m_Keys[*it] == key)
+			return (int)*it;
+		return -1;
+	}
+
+	// Items starting with the prefix
+	// Without a limit, all the items in item order (list filter).
+	// With a limit, no more than "limit" items in key order (type-ahead).
+	// Returns the number of items that match, which can be more than
+	// the number returned with a limit.
+	size_t FindPrefix(const std::string &prefix, std::vector<uint32_t> &items, size_t limit = SIZE_MAX) const {
+		items.clear();
+		Flush();
+		std::string key = Fold(prefix);
+		// Matches are one range of the sorted array
+		auto first = std::lower_bound(m_Sorted.begin(), m_Sorted.end(), key,
+			[this](uint32_t a, const std::string &k) { return m_Keys[a] < k; });
+		auto last = std::upper_bound(first, m_Sorted.end(), key,
+			[this](const std::string &k, uint32_t a) { return m_Keys[a].compare(0, k.size(), k) > 0; });
+		size_t count = (size_t)(last - first);
+		if (limit != SIZE_MAX) {
+			items.assign(first, first + (long)(std::min)(count, limit));
+		}
+		else if (count > m_Keys.size() / 16) {
+			// Many matches - mark them and collect in item order
+			std::vector<uint8_t> match(m_Keys.size(), 0);
+			for (auto it = first; it != last; ++it)
+				match[*it] = 1;
+			items.reserve(count);
+			for (size_t i = 0; i < match.size(); i++) {
+				if (match[i])
+					items.push_back((uint32_t)i);
+			}
+		}
+		else {
+			items.assign(first, last);
+			std::sort(items.begin(), items.end());
+		}
+		return count;
+	}
+
+	// Items containing the text, in item order
+	// Uses the trigram index if enabled and the text
+	// has at least three characters, otherwise a scan.
+	size_t FindContains(const std::string &text, std::vector<uint32_t> &items) const {
+		items.clear();
+		std::string key = Fold(text);
+		if (!m_bNgrams || key.size() < 3) {
+			for (size_t i = 0; i < m_Keys.size(); i++) {
+				if (m_Keys[i].find(key) != std::string::npos)
+					items.push_back((uint32_t)i);
+			}
+			return items.size();
+		}
+
+		// Item lists of the query trigrams, shortest first
+		std::vector<const std::vector<uint32_t>*> lists;
+		for (size_t i = 0; i + 3 <= key.size(); i++) {
+			auto it = m_Ngrams.find(Trigram(key, i));
+			if (it == m_Ngrams.end())
+				return 0;
+			lists.push_back(&it->second);
+		}
+		std::sort(lists.begin(), lists.end(),
+			[](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) { return a->size() < b->size(); });
+
+		// Candidates have all trigrams, then check the order
+		for (uint32_t id : *lists[0]) {
+			bool bAll = true;
+			for (size_t j = 1; j < lists.size() && bAll; j++)
+				bAll = std::binary_search(lists[j]->begin(), lists[j]->end(), id);
+			if (bAll && m_Keys[id].find(key) != std::string::npos)
+				items.push_back(id);
+		}
+		return items.size();
+	}
+
+	// Whether one item matches a prefix or contains the text
+	bool Matches(size_t index, const std::string &text, bool bContains) const {
+		if (index >= m_Keys.size())
+			return false;
+		std::string key = Fold(text);
+		if (bContains)
+			return m_Keys[index].find(key) != std::string::npos;
+		return m_Keys[index].compare(0, key.size(), key) == 0;
+	}
+
+	size_t Size() const { return m_Keys.size(); }
+	bool HasNgrams() const { return m_bNgrams; }
+
+	// ASCII lower case
+	static std::string Fold(const std::string &text) {
+		std::string key = text;
+		for (size_t i = 0; i < key.size(); i++) {
+			if (key[i] >= 'A' && key[i] <= 'Z')
+				key[i] = (char)(key[i] - 'A' + 'a');
+		}
+		return key;
+	}
+
+private:
+
+	static uint32_t Trigram(const std::string &key, size_t pos) {
+		return ((uint32_t)(unsigned char)key[pos] << 16)
+			| ((uint32_t)(unsigned char)key[pos + 1] << 8)
+			| (uint32_t)(unsigned char)key[pos + 2];
+	}
+
+	// Each trigram item list is sorted and without duplicates
+	void AddNgrams(uint32_t id) {
+		const std::string &key = m_Keys[id];
+		for (size_t i = 0; i + 3 <= key.size(); i++) {
+			std::vector<uint32_t> &list = m_Ngrams[Trigram(key, i)];
+			if (list.empty() || list.back() < id)
+				list.push_back(id);
+			else {
+				auto it = std::lower_bound(list.begin(), list.end(), id);
+				if (it == list.end() || *it != id)
+					list.insert(it, id);
+			}
+		}
+	}
+
+	void RemoveNgrams(uint32_t id) {
+		const std::string &key = m_Keys[id];
+		for (size_t i = 0; i + 3 <= key.size(); i++) {
+			auto ng = m_Ngrams.find(Trigram(key, i));
+			if (ng == m_Ngrams.end())
+				continue;
+			std::vector<uint32_t> &list = ng->second;
+			auto it = std::lower_bound(list.begin(), list.end(), id);
+			if (it != list.end() && *it == id)
+				list.erase(it);
+			if (list.empty())
+				m_Ngrams.erase(ng);
+		}
+	}
+
+	bool m_bNgrams = false;
+	std::vector<std::string> m_Keys; // Folded item text in item order
+	// Sorted by the searches (Flush)
+	mutable std::vector<uint32_t> m_Sorted; // Items sorted by key
+	mutable std::vector<uint32_t> m_Pending; // Appended or replaced since the last search
+	mutable std::vector<uint8_t> m_Moved; // Item is pending
+	mutable size_t m_Removed = 0; // Pending items replaced
+	std::unordered_map<uint32_t, std::vector<uint32_t>> m_Ngrams; // Items for each trigram
+
+};
@@ -0,0 +1,173 @@
+//
+// ofxWinDialogStats.h
+//
+// Latency histograms for dialog message handling.
+// Tested by tests/ofxWinDialogStatsTest.cpp.
+//
+// LatencyHistogram
+//   Times in nanoseconds are counted in log-linear buckets as for an
+//   HDR histogram. Times less than 8 nsec have a bucket each. Above
+//   that, each power of two is divided into 8 buckets, so a percentile
+//   is within 12.5% of the recorded time. Times above about 18 minutes
+//   are counted in the last bucket. Record is a few shifts and an
+//   increment with no allocation.
+//
+// LatencyTable
+//   Histograms by a key such as a message number or control ID.
+//   A histogram is created on the first time recorded for a key.
+//
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+class LatencyHistogram {
+
+public:
+
+	// Sub-buckets for each power of two
+	static const int SubBits = 3;
+	static const uint64_t SubCount = 1 << SubBits;
+	// Highest power of two counted (2^40 nsec)
+	static const int MaxBits = 40;
+	static const size_t Buckets = (size_t)(SubCount + (MaxBits - SubBits) * SubCount);
+
+	void Record(uint64_t ns) {
+		m_Counts[Bucket(ns)]++;
+		if (m_Count == 0 || ns < m_Min)
+			m_Min = ns;
+		if (ns > m_Max)
+			m_Max = ns;
+		m_Count++;
+		m_Sum += ns;
+	}
+
+	uint64_t Count() const { return m_Count; }
+	uint64_t Min() const { return m_Min; }
+	uint64_t Max() const { return m_Max; }
+	double Mean() const { return m_Count ? (double)m_Sum / (double)m_Count : 0.0; }
+
+	// Time at or below which "percent" of the times are
+	// The highest time of the bucket, but not above the maximum
+	uint64_t Percentile(double percent) const {
+		if (m_Count == 0)
+			return 0;
+		if (percent <= 0.0)
+			return m_Min;
+		uint64_t rank = (uint64_t)((percent / 100.0) * (double)m_Count + 0.5);
+		if (rank < 1) rank = 1;
+		if (rank > m_Count) rank = m_Count;
+		uint64_t seen = 0;
+		for (size_t i = 0; i < Buckets; i++) {
+			seen += m_Counts[i];
+			if (seen >= rank) {
+				uint64_t high = Highest(i);
+				return high < m_Max ? (high > m_Min ? high : m_Min) : m_Max;
+			}
+		}
+		return m_Max;
+	}
+
+	void Merge(const LatencyHistogram &other) {
+		if (other.m_Count == 0)
+			return;
+		for (size_t i = 0; i < Buckets; i++)
+			m_Counts[i] += other.m_Counts[i];
+		if (m_Count == 0 || other.m_Min < m_Min)
+			m_Min = other.m_Min;
+		if (other.m_Max > m_Max)
+			m_Max = other.m_Max;
+		m_Count += other.m_Count;
+		m_Sum += other.m_Sum;
+	}
+
+	void Reset() {
+		for (size_t i = 0; i < Buckets; i++)
+			m_Counts[i] = 0;
+		m_Count = 0;
+		m_Sum = 0;
+		m_Min = 0;
+		m_Max = 0;
+	}
+
+	// Bucket of a time
+	static size_t Bucket(uint64_t ns) {
+		if (ns < SubCount)
+			return (size_t)ns;
+		int bits = HighBit(ns);
+		if (bits >= MaxBits)
+			return Buckets - 1;
+		uint64_t sub = (ns >> (bits - SubBits)) & (SubCount - 1);
+		return (size_t)(SubCount + (uint64_t)(bits - SubBits) * SubCount + sub);
+	}
+
+	// Lowest and highest time of a bucket
+	static uint64_t Lowest(size_t bucket) {
+		if (bucket < SubCount)
+			return bucket;
+		uint64_t bits = (bucket - SubCount) / SubCount + SubBits;
+		uint64_t sub = (bucket - SubCount) % SubCount;
+		return (SubCount + sub) << (bits - SubBits);
+	}
+
+	static uint64_t Highest(size_t bucket) {
+		if (bucket < SubCount)
+			return bucket;
+		if (bucket >= Buckets - 1)
+			return UINT64_MAX;
+		return Lowest(bucket + 1) - 1;
+	}
+
+private:
+
+	// Position of the highest bit set (ns > 0)
+	static int HighBit(uint64_t ns) {
+		int bits = 0;
+		if (ns >> 32) { ns >>= 32; bits += 32; }
+		if (ns >> 16) { ns >>= 16; bits += 16; }
+		if (ns >> 8)  { ns >>= 8;  bits += 8; }
+		if (ns >> 4)  { ns >>= 4;  bits += 4; }
+		if (ns >> 2)  { ns >>= 2;  bits += 2; }
+		if (ns >> 1)  { bits += 1; }
+		return bits;
+	}
+
+	uint32_t m_Counts[Buckets] = {};
+	uint64_t m_Count = 0;
+	uint64_t m_Sum = 0;
+	uint64_t m_Min = 0;
+	uint64_t m_Max = 0;
+
+};
+
+class LatencyTable {
+
+public:
+
+	void Record(uint32_t key, uint64_t ns) {
+		m_Table[key].Record(ns);
+	}
+
+	// Histogram of a key or nullptr
+	const LatencyHistogram* Find(uint32_t key) const {
+		auto it = m_Table.find(key);
+		return it == m_Table.end() ? nullptr : &it->second;
+	}
+
+	// Keys with times recorded
+	void Keys(std::vector<uint32_t> &keys) const {
+		keys.clear();
+		for (auto it = m_Table.begin(); it != m_Table.end(); ++it)
+			keys.push_back(it->first);
+	}
+
+	void Reset() { m_Table.clear(); }
+	size_t Size() const { return m_Table.size(); }
+
+private:
+
+	std::unordered_map<uint32_t, LatencyHistogram> m_Table;
+
+};
@@ -0,0 +1,235 @@
+//
+// ofxWinDialogTemplate.h
+//
+// In-memory extended dialog template (DLGTEMPLATEEX).
+// Tested by tests/ofxWinDialogTemplateTest.cpp.
+//
+// DialogTemplate
+//   Begin writes the dialog header and AddItem appends one control.
+//   Each item is aligned to a DWORD boundary. The control class is
+//   either a predefined class atom or a class name. Strings are
+//   converted to null terminated UTF-16, from UTF-8 unless another
+//   conversion is set with SetConverter (the dialog uses the ANSI
+//   code page as for the windows it creates directly). The item
+//   count in the header is updated as items are added, so the data
+//   can be passed directly to CreateDialogIndirectParam.
+//
+//   Positions and sizes are in dialog units. PixelsToDialogUnits
+//   converts from pixels with the horizontal and vertical dialog
+//   base units of the dialog font.
+//
+// TemplateKey
+//   FNV-1a hash of the values used to build a template so that a
+//   compiled template can be re-used while the controls are unchanged.
+//
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+#include "ofxWinDialogItems.h" // Utf8ToUtf16
+
+class DialogTemplate {
+
+public:
+
+	// Predefined control class atoms
+	enum {
+		Button    = 0x0080,
+		Edit      = 0x0081,
+		Static    = 0x0082,
+		ListBox   = 0x0083,
+		ScrollBar = 0x0084,
+		ComboBox  = 0x0085
+	};
+
+	// DS_SETFONT - the header has font fields
+	static const uint32_t SetFont = 0x40;
+
+	// Conversion of a batch of strings to UTF-16 (see Utf8ToUtf16)
+	typedef bool (*Converter)(const char* data, const size_t* offsets, size_t count,
+		std::vector<uint16_t> &wide, std::vector<size_t> &woffsets);
+
+	// Conversion of the strings added, UTF-8 if not set
+	void SetConverter(Converter convert) {
+		m_Convert = convert ? convert : Utf8ToUtf16;
+	}
+
+	// Start a new template
+	// If a point size is given, the font fields are added and
+	// DS_SETFONT is included in the style.
+	void Begin(uint32_t style, uint32_t exstyle,
+		int x, int y, int cx, int cy, const std::string &title,
+		int pointsize = 0, int weight = 400, const std::string &typeface = "")
+	{
+		m_Data.clear();
+		m_Count = 0;
+		if (pointsize > 0)
+			style |= SetFont;
+		else
+			style &= ~SetFont;
+
+		Word(1);      // dlgVer
+		Word(0xFFFF); // signature
+		Dword(0);     // helpID
+		Dword(exstyle);
+		Dword(style);
+		Word(0);      // cDlgItems - updated by AddItem
+		Short(x);
+		Short(y);
+		Short(cx);
+		Short(cy);
+		Word(0);      // No menu
+		Word(0);      // Default dialog class
+		String(title);
+		if (pointsize > 0) {
+			Word((uint16_t)pointsize);
+			Word((uint16_t)weight);
+			Byte(0);  // italic
+			Byte(1);  // DEFAULT_CHARSET
+			String(typeface);
+		}
+	}
+
+	// Add a control with a predefined class
+	void AddItem(uint32_t style, uint32_t exstyle,
+		int x, int y, int cx, int cy, uint32_t id,
+		uint16_t atom, const std::string &title)
+	{
+		Item(style, exstyle, x, y, cx, cy, id);
+		Word(0xFFFF);
+		Word(atom);
+		End(title);
+	}
+
+	// Add a control with a class name (e.g. "msctls_trackbar32")
+	void AddItem(uint32_t style, uint32_t exstyle,
+		int x, int y, int cx, int cy, uint32_t id,
+		const std::string &classname, const std::string &title)
+	{
+		Item(style, exstyle, x, y, cx, cy, id);
+		String(classname);
+		End(title);
+	}
+
+	const std::vector<uint8_t> &Data() const { return m_Data; }
+	size_t Size() const { return m_Data.size(); }
+	bool Empty() const { return m_Data.empty(); }
+	// Number of items
+	size_t GetCount() const { return m_Count; }
+
+	void Clear() {
+		m_Data.clear();
+		m_Count = 0;
+	}
+
+	// Pixels to dialog units
+	//   horizontal - base is the horizontal base unit, units 4
+	//   vertical   - base is the vertical base unit, units 8
+	static int PixelsToDialogUnits(int pixels, int base, int units) {
+		if (base <= 0)
+			return pixels;
+		long long v = (long long)pixels * units;
+		// Round to nearest, away from zero
+		return (int)(v >= 0 ? (v + base / 2) / base : -((-v + base / 2) / base));
+	}
+
+private:
+
+	// Offset of the item count in the header
+	static const size_t CountOffset = 16;
+
+	void Item(uint32_t style, uint32_t exstyle, int x, int y, int cx, int cy, uint32_t id) {
+		Align();
+		Dword(0);     // helpID
+		Dword(exstyle);
+		Dword(style);
+		Short(x);
+		Short(y);
+		Short(cx);
+		Short(cy);
+		Dword(id);
+	}
+
+	void End(const std::string &title) {
+		String(title);
+		Word(0);      // No creation data
+		m_Count++;
+		m_Data[CountOffset] = (uint8_t)(m_Count & 0xFF);
+		m_Data[CountOffset + 1] = (uint8_t)((m_Count >> 8) & 0xFF);
+	}
+
+	void Align() {
+		while (m_Data.size() % 4)
+			m_Data.push_back(0);
+	}
+
+	void Byte(uint8_t v) {
+		m_Data.push_back(v);
+	}
+
+	void Word(uint16_t v) {
+		m_Data.push_back((uint8_t)(v & 0xFF));
+		m_Data.push_back((uint8_t)(v >> 8));
+	}
+
+	void Short(int v) {
+		if (v > 32767) v = 32767;
+		if (v < -32768) v = -32768;
+		Word((uint16_t)(int16_t)v);
+	}
+
+	void Dword(uint32_t v) {
+		Word((uint16_t)(v & 0xFFFF));
+		Word((uint16_t)(v >> 16));
+	}
+
+	// Null terminated UTF-16
+	void String(const std::string &text) {
+		size_t offsets[2] = { 0, text.size() };
+		m_Wide.clear();
+		m_Convert(text.data(), offsets, 1, m_Wide, m_WideOffsets);
+		if (m_Wide.empty())
+			m_Wide.push_back(0);
+		for (size_t i = 0; i < m_Wide.size(); i++)
+			Word(m_Wide[i]);
+	}
+
+	std::vector<uint8_t> m_Data;
+	size_t m_Count = 0;
+	std::vector<uint16_t> m_Wide;
+	std::vector<size_t> m_WideOffsets;
+	Converter m_Convert = Utf8ToUtf16;
+
+};
+
+class TemplateKey {
+
+public:
+
+	void Reset() { m_Hash = 14695981039346656037ULL; }
+
+	void Add(const void* data, size_t size) {
+		const uint8_t* p = (const uint8_t*)data;
+		for (size_t i = 0; i < size; i++) {
+			m_Hash ^= p[i];
+			m_Hash *= 1099511628211ULL;
+		}
+	}
+
+	void Add(const std::string &text) {
+		Add(text.data(), text.size());
+		Add((uint64_t)text.size());
+	}
+
+	void Add(uint64_t v) { Add(&v, sizeof(v)); }
+
+	uint64_t Get() const { return m_Hash; }
+
+private:
+
+	uint64_t m_Hash = 14695981039346656037ULL;
+
+};
@@ -0,0 +1,192 @@
+//
+// ofxWinDialogThread.h
+//
+// Queues between ofApp and a dialog running on a thread of its own.
+// Tested by tests/ofxWinDialogThreadTest.cpp.
+//
+// BatchQueue
+//   Items passed from one or more threads to a reader that takes
+//   them a batch at a time. Push returns true for the first item of
+//   a batch, so the reader is woken once for each batch rather than
+//   for each item. Drain swaps the items out with the lock held only
+//   for the swap, and the vector passed in is re-used by the queue
+//   so that no memory is allocated once the queue has grown.
+//
+// CommandQueue
+//   Items passed from any number of threads to one reader with no
+//   locks. Push links the item onto the head of a list with compare
+//   and swap. Drain takes the whole list with one exchange and puts
+//   the items in the order pushed. Push returns true for the first
+//   item after a Drain, as for BatchQueue.
+//
+// CommandCollapse
+//   Removes the items of a batch that are followed by an item with the
+//   same key, so that only the last value set for a control is applied.
+//   The order of the items kept is not changed.
+//
+// DialogEvent
+//   A control event queued by the dialog thread for the ofApp
+//   callback function, which is called by the ofApp thread.
+//
+#pragma once
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <unordered_map>
+#include <atomic>
+#include <utility>
+#include <cstddef>
+
+template <typename T>
+class BatchQueue {
+
+public:
+
+	// Returns true if the queue was empty
+	bool Push(const T &item) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Items.push_back(item);
+		return m_Items.size() == 1;
+	}
+
+	bool Push(T &&item) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Items.push_back(std::move(item));
+		return m_Items.size() == 1;
+	}
+
+	// Take all items in the order pushed
+	size_t Drain(std::vector<T> &items) {
+		items.clear();
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Items.swap(items);
+		return items.size();
+	}
+
+	size_t Size() const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Items.size();
+	}
+
+	void Clear() {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Items.clear();
+	}
+
+private:
+
+	mutable std::mutex m_Mutex;
+	std::vector<T> m_Items;
+
+};
+
+template <typename T>
+class CommandQueue {
+
+public:
+
+	CommandQueue() = default;
+	CommandQueue(const CommandQueue &) = delete;
+	CommandQueue &operator=(const CommandQueue &) = delete;
+
+	~CommandQueue() {
+		node* list = m_Head.exchange(nullptr);
+		while (list) {
+			node* next = list->next;
+			delete list;
+			list = next;
+		}
+	}
+
+	// Returns true if the queue was empty
+	bool Push(T &&item) {
+		node* n = new node{ std::move(item), nullptr };
+		node* head = m_Head.load(std::memory_order_relaxed);
+		do {
+			n->next = head;
+		} while (!m_Head.compare_exchange_weak(head, n, std::memory_order_release, std::memory_order_relaxed));
+		return head == nullptr;
+	}
+
+	bool Push(const T &item) {
+		T copy(item);
+		return Push(std::move(copy));
+	}
+
+	// Take all items in the order pushed (one reader)
+	size_t Drain(std::vector<T> &items) {
+		items.clear();
+		node* list = m_Head.exchange(nullptr, std::memory_order_acquire);
+		// The list is newest first
+		size_t count = 0;
+		for (node* n = list; n; n = n->next)
+			count++;
+		items.resize(count);
+		for (size_t i = count; list; ) {
+			node* next = list->next;
+			items[--i] = std::move(list->item);
+			delete list;
+			list = next;
+		}
+		return count;
+	}
+
+	bool Empty() const {
+		return m_Head.load(std::memory_order_acquire) == nullptr;
+	}
+
+private:
+
+	struct node {
+		T item;
+		node* next;
+	};
+
+	std::atomic<node*> m_Head{ nullptr };
+
+};
+
+class CommandCollapse {
+
+public:
+
+	// Keep the last of the items with the same key
+	// Returns the number of items removed
+	template <typename T, typename KeyFn>
+	size_t Apply(std::vector<T> &items, KeyFn key) {
+		if (items.size() < 2)
+			return 0;
+		m_Keys.resize(items.size());
+		m_Last.clear();
+		for (size_t i = 0; i < items.size(); i++) {
+			m_Keys[i] = key(items[i]);
+			m_Last[m_Keys[i]] = i;
+		}
+		if (m_Last.size() == items.size())
+			return 0;
+		size_t kept = 0;
+		for (size_t i = 0; i < items.size(); i++) {
+			if (m_Last[m_Keys[i]] != i)
+				continue;
+			if (kept != i)
+				items[kept] = std::move(items[i]);
+			kept++;
+		}
+		size_t removed = items.size() - kept;
+		items.resize(kept);
+		return removed;
+	}
+
+private:
+
+	std::vector<std::string> m_Keys;
+	std::unordered_map<std::string, size_t> m_Last;
+
+};
+
+struct DialogEvent {
+	std::string title;
+	std::string text;
+	int value = 0;
+};
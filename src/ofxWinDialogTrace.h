@@ -0,0 +1,292 @@
+//
+// ofxWinDialogTrace.h
+//
+// Spans of dialog activity for timeline profilers.
+// Tested by tests/ofxWinDialogTraceTest.cpp.
+//
+// TraceRing
+//   A fixed size ring of spans with one writer and one reader
+//   and no locks. A span is dropped if the ring is full, so the
+//   memory used does not grow if the reader falls behind.
+//
+// TraceLog
+//   One ring for each thread that adds spans, up to MaxThreads.
+//   A thread claims a free ring on its first span. Spans are added
+//   only while the log is enabled, and a disabled log costs one
+//   atomic load for each span. Drain reads all rings for the export.
+//
+// TraceScope
+//   Adds a span from construction to destruction.
+//
+// The export is the Chrome trace event format, a JSON array of
+// complete ("X") events with times in microseconds :
+//   { "name" : "Open", "cat" : "dialog", "ph" : "X", "ts" : 1200,
+//     "dur" : 5300, "pid" : 1, "tid" : 1, "args" : { "detail" : "" } }
+// The file can be opened with chrome://tracing or Perfetto.
+//
+#pragma once
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <cstring>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+
+struct TraceEvent {
+	char name[24] = {};
+	char detail[40] = {}; // Control title etc.
+	const char* category = ""; // Static text
+	uint64_t start = 0; // Microseconds from the start of the log
+	uint64_t duration = 0;
+	uint32_t thread = 0; // Ring number from 1
+
+	void Set(const char* n, const char* d) {
+		Copy(name, sizeof(name), n);
+		Copy(detail, sizeof(detail), d);
+	}
+
+	static void Copy(char* dst, size_t size, const char* src) {
+		size_t i = 0;
+		if (src) {
+			for (; i + 1 < size && src[i]; i++)
+				dst[i] = src[i];
+		}
+		dst[i] = 0;
+	}
+};
+
+class TraceRing {
+
+public:
+
+	// Capacity is rounded up to a power of two
+	void Init(size_t capacity) {
+		size_t size = 2;
+		while (size < capacity)
+			size <<= 1;
+		m_Events.assign(size, TraceEvent());
+		m_Mask = size - 1;
+		m_Head.store(0);
+		m_Tail.store(0);
+	}
+
+	// Writer
+	bool Push(const TraceEvent &e) {
+		size_t head = m_Head.load(std::memory_order_relaxed);
+		size_t tail = m_Tail.load(std::memory_order_acquire);
+		if (head - tail > m_Mask)
+			return false; // Full
+		m_Events[head & m_Mask] = e;
+		m_Head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Reader
+	bool Pop(TraceEvent &e) {
+		size_t tail = m_Tail.load(std::memory_order_relaxed);
+		size_t head = m_Head.load(std::memory_order_acquire);
+		if (tail == head)
+			return false; // Empty
+		e = m_Events[tail & m_Mask];
+		m_Tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	size_t Capacity() const { return m_Events.size(); }
+
+private:
+
+	std::vector<TraceEvent> m_Events;
+	size_t m_Mask = 0;
+	std::atomic<size_t> m_Head{ 0 }; // Next write
+	std::atomic<size_t> m_Tail{ 0 }; // Next read
+
+};
+
+class TraceLog {
+
+public:
+
+	static const size_t MaxThreads = 16;
+
+	TraceLog() {
+		for (size_t i = 0; i < MaxThreads; i++)
+			m_Owners[i].store(0);
+		// Unique for each log, as a log may use the memory of another
+		static std::atomic<uint64_t> logs{ 0 };
+		m_Id = ++logs;
+	}
+
+	// Enable the log
+	// The rings are created by the first Start with "capacity"
+	// spans for each thread and are kept until the log is destroyed,
+	// so that a thread adding a span while the log is stopped or
+	// started again never uses a ring that has been freed.
+	void Start(size_t capacity = 4096) {
+		if (!m_bCreated) {
+			for (size_t i = 0; i < MaxThreads; i++)
+				m_Rings[i].Init(capacity);
+			m_bCreated = true;
+		}
+		m_Epoch.store(Clock(), std::memory_order_relaxed);
+		m_Dropped.store(0);
+		m_bEnabled.store(true, std::memory_order_release);
+	}
+
+	void Stop() { m_bEnabled.store(false, std::memory_order_release); }
+
+	bool IsEnabled() const { return m_bEnabled.load(std::memory_order_acquire); }
+
+	// Microseconds from Start
+	uint64_t Now() const {
+		int64_t us = Clock() - m_Epoch.load(std::memory_order_relaxed);
+		return us > 0 ? (uint64_t)us : 0;
+	}
+
+	// Add a span for the calling thread
+	void Add(const char* name, const char* category, const char* detail, uint64_t start, uint64_t end) {
+		if (!IsEnabled())
+			return;
+		size_t ring = Ring();
+		if (ring >= MaxThreads) {
+			m_Dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		TraceEvent e;
+		e.Set(name, detail);
+		e.category = category ? category : "";
+		e.start = start;
+		e.duration = end > start ? end - start : 0;
+		e.thread = (uint32_t)ring + 1;
+		if (!m_Rings[ring].Push(e))
+			m_Dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Read the spans of all threads (one reader)
+	size_t Drain(std::vector<TraceEvent> &events) {
+		events.clear();
+		if (!m_bCreated)
+			return 0;
+		TraceEvent e;
+		for (size_t i = 0; i < MaxThreads; i++) {
+			if (m_Owners[i].load(std::memory_order_acquire) == 0)
+				continue;
+			while (m_Rings[i].Pop(e))
+				events.push_back(e);
+		}
+		return events.size();
+	}
+
+	// Spans dropped because a ring was full or there
+	// were more than MaxThreads threads
+	uint64_t Dropped() const { return m_Dropped.load(std::memory_order_relaxed); }
+
+	// Chrome trace event for a span
+	// bFirst - no separator before the event
+	static void AppendJson(std::string &json, const TraceEvent &e, bool bFirst, int process = 1) {
+		char tmp[128]{};
+		json += bFirst ? "  " : ",\n  ";
+		json += "{ \"name\" : \"";
+		Escape(json, e.name);
+		json += "\", \"cat\" : \"";
+		Escape(json, e.category);
+		snprintf(tmp, sizeof(tmp), "\", \"ph\" : \"X\", \"ts\" : %llu, \"dur\" : %llu, \"pid\" : %d, \"tid\" : %u",
+			(unsigned long long)e.start, (unsigned long long)e.duration, process, e.thread);
+		json += tmp;
+		if (e.detail[0]) {
+			json += ", \"args\" : { \"detail\" : \"";
+			Escape(json, e.detail);
+			json += "\" }";
+		}
+		json += " }";
+	}
+
+private:
+
+	// Ring of the calling thread, MaxThreads if none is free
+	size_t Ring() {
+		// The last log and ring used by this thread
+		thread_local uint64_t t_Log = 0;
+		thread_local size_t t_Ring = MaxThreads;
+		if (t_Log == m_Id)
+			return t_Ring;
+
+		uint64_t id = (uint64_t)std::hash<std::thread::id>()(std::this_thread::get_id());
+		if (id == 0) id = 1; // Zero is a free ring
+		size_t ring = MaxThreads;
+		for (size_t i = 0; i < MaxThreads && ring == MaxThreads; i++) {
+			uint64_t owner = m_Owners[i].load(std::memory_order_acquire);
+			if (owner == id)
+				ring = i;
+		}
+		for (size_t i = 0; i < MaxThreads && ring == MaxThreads; i++) {
+			uint64_t free = 0;
+			if (m_Owners[i].compare_exchange_strong(free, id, std::memory_order_acq_rel))
+				ring = i;
+		}
+		if (ring < MaxThreads) {
+			t_Log = m_Id;
+			t_Ring = ring;
+		}
+		return ring;
+	}
+
+	static int64_t Clock() {
+		return (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	static void Escape(std::string &json, const char* text) {
+		for (; text && *text; text++) {
+			char c = *text;
+			if (c == '"' || c == '\\')
+				json += '\\';
+			if ((unsigned char)c >= 0x20)
+				json += c;
+		}
+	}
+
+	TraceRing m_Rings[MaxThreads];
+	std::atomic<uint64_t> m_Owners[MaxThreads]; // Thread hash of each ring, 0 if free
+	std::atomic<bool> m_bEnabled{ false };
+	std::atomic<uint64_t> m_Dropped{ 0 };
+	std::atomic<int64_t> m_Epoch{ Clock() }; // Microseconds of the clock at Start
+	uint64_t m_Id = 0;
+	bool m_bCreated = false;
+
+};
+
+// Span from construction to destruction
+class TraceScope {
+
+public:
+
+	TraceScope(TraceLog &log, const char* name, const char* category, const char* detail = "")
+		: m_Log(log), m_Name(name), m_Category(category), m_Detail(detail) {
+		m_bEnabled = m_Log.IsEnabled();
+		if (m_bEnabled)
+			m_Start = m_Log.Now();
+	}
+
+	~TraceScope() {
+		if (m_bEnabled)
+			m_Log.Add(m_Name, m_Category, m_Detail, m_Start, m_Log.Now());
+	}
+
+	TraceScope(const TraceScope &) = delete;
+	TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+
+	TraceLog &m_Log;
+	const char* m_Name;
+	const char* m_Category;
+	const char* m_Detail;
+	uint64_t m_Start = 0;
+	bool m_bEnabled = false; // Enabled at the start of the span
+
+};
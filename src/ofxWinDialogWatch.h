@@ -0,0 +1,357 @@
+//
+// ofxWinDialogWatch.h
+//
+// File change detection and differences for hot reload of
+// initialization and dialog description files.
+// Tested by tests/ofxWinDialogWatchTest.cpp.
+//
+// FileWatch
+//   Files are checked with a stamp (write time and size) supplied by
+//   the caller. A change is reported when the stamp has not changed
+//   again for the debounce interval, so that a file saved in several
+//   writes is read once.
+//
+// IniValues
+//   Values of an initialization file by section and key. Names are
+//   matched ignoring ASCII case as by the Windows profile functions.
+//   Diff finds the values that are new or changed in another file.
+//
+// DescRecord
+//   The keyword and arguments of one dialog description statement.
+//   DiffStatements matches the statements of two descriptions in order
+//   and finds the statements with changed arguments. A change is only
+//   a value change if every changed argument is a value argument.
+//
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "ofxWinDialogDescription.h" // DescriptionParser
+
+class FileWatch {
+
+public:
+
+	FileWatch(uint64_t debounce = 200) {
+		m_Debounce = debounce;
+	}
+
+	// Add a file with its current stamp
+	// Returns the index of the file
+	size_t Add(const std::string &path, uint64_t stamp) {
+		for (size_t i = 0; i < m_Files.size(); i++) {
+			if (m_Files[i].path == path)
+				return i;
+		}
+		file f;
+		f.path = path;
+		f.stamp = stamp;
+		m_Files.push_back(f);
+		return m_Files.size() - 1;
+	}
+
+	void Clear() { m_Files.clear(); }
+
+	// Check the files at time "now" (msec)
+	// stamp(path, uint64_t &stamp) gets the current stamp
+	// of a file and returns false if the file is not found.
+	// Returns the number of files changed.
+	template <typename Stamp>
+	size_t Poll(uint64_t now, Stamp stamp, std::vector<size_t> &changed) {
+		changed.clear();
+		for (size_t i = 0; i < m_Files.size(); i++) {
+			file &f = m_Files[i];
+			uint64_t s = 0;
+			if (!stamp(f.path, s))
+				s = 0;
+			if (s != f.stamp) {
+				// Changed again - restart the interval
+				f.stamp = s;
+				f.changed = now;
+				f.bPending = true;
+			}
+			// A missing file is reported when it is created again
+			if (f.bPending && s != 0 && now - f.changed >= m_Debounce) {
+				f.bPending = false;
+				changed.push_back(i);
+			}
+		}
+		return changed.size();
+	}
+
+	// A change is waiting for the debounce interval
+	bool IsPending() const {
+		for (size_t i = 0; i < m_Files.size(); i++) {
+			if (m_Files[i].bPending)
+				return true;
+		}
+		return false;
+	}
+
+	const std::string &GetPath(size_t index) const { return m_Files[index].path; }
+	size_t Size() const { return m_Files.size(); }
+	void SetDebounce(uint64_t debounce) { m_Debounce = debounce; }
+	uint64_t GetDebounce() const { return m_Debounce; }
+
+private:
+
+	struct file {
+		std::string path;
+		uint64_t stamp = 0;
+		uint64_t changed = 0; // Time of the last stamp change
+		bool bPending = false;
+	};
+
+	std::vector<file> m_Files;
+	uint64_t m_Debounce = 200;
+
+};
+
+class IniValues {
+
+public:
+
+	struct value {
+		std::string section;
+		std::string key;
+		std::string value;
+	};
+
+	// Parse initialization file text
+	// "[section]" lines start a section, "key=value" lines add
+	// a value and lines starting with ";" are comments.
+	void Parse(const char* data, size_t size) {
+		m_Values.clear();
+		m_Index.clear();
+		std::string section;
+		size_t pos = 0;
+		while (pos < size) {
+			size_t end = pos;
+			while (end < size && data[end] != '\n')
+				end++;
+			size_t first = pos;
+			size_t last = end;
+			Trim(data, first, last);
+			pos = end + 1;
+			if (first >= last || data[first] == ';')
+				continue;
+			if (data[first] == '[') {
+				size_t close = first + 1;
+				while (close < last && data[close] != ']')
+					close++;
+				size_t s0 = first + 1;
+				size_t s1 = close;
+				Trim(data, s0, s1);
+				section.assign(data + s0, s1 - s0);
+				continue;
+			}
+			size_t equal = first;
+			while (equal < last && data[equal] != '=')
+				equal++;
+			if (equal == last)
+				continue;
+			size_t k0 = first;
+			size_t k1 = equal;
+			size_t v0 = equal + 1;
+			size_t v1 = last;
+			Trim(data, k0, k1);
+			Trim(data, v0, v1);
+			Set(section, std::string(data + k0, k1 - k0), std::string(data + v0, v1 - v0));
+		}
+	}
+
+	void Parse(const std::string &text) {
+		Parse(text.data(), text.size());
+	}
+
+	// Add or replace a value
+	void Set(const std::string &section, const std::string &key, const std::string &text) {
+		std::string k = Key(section, key);
+		auto it = m_Index.find(k);
+		if (it != m_Index.end()) {
+			m_Values[it->second].value = text;
+			return;
+		}
+		value v;
+		v.section = section;
+		v.key = key;
+		v.value = text;
+		m_Index[k] = m_Values.size();
+		m_Values.push_back(v);
+	}
+
+	bool Get(const std::string &section, const std::string &key, std::string &text) const {
+		auto it = m_Index.find(Key(section, key));
+		if (it == m_Index.end())
+			return false;
+		text = m_Values[it->second].value;
+		return true;
+	}
+
+	// Values that are new or changed in "next", in file order
+	// Values removed from "next" are not changes, as for Load.
+	size_t Diff(const IniValues &next, std::vector<value> &changed) const {
+		changed.clear();
+		for (size_t i = 0; i < next.m_Values.size(); i++) {
+			const value &v = next.m_Values[i];
+			std::string text;
+			if (!Get(v.section, v.key, text) || text != v.value)
+				changed.push_back(v);
+		}
+		return changed.size();
+	}
+
+	const std::vector<value> &GetValues() const { return m_Values; }
+	size_t Size() const { return m_Values.size(); }
+
+	// Section and key for lookup, ignoring ASCII case
+	static std::string Key(const std::string &section, const std::string &key) {
+		std::string k = section;
+		k += '\n';
+		k += key;
+		for (size_t i = 0; i < k.size(); i++) {
+			if (k[i] >= 'A' && k[i] <= 'Z')
+				k[i] = (char)(k[i] - 'A' + 'a');
+		}
+		return k;
+	}
+
+private:
+
+	static void Trim(const char* data, size_t &first, size_t &last) {
+		while (first < last && (data[first] == ' ' || data[first] == '\t' || data[first] == '\r'))
+			first++;
+		while (last > first && (data[last - 1] == ' ' || data[last - 1] == '\t' || data[last - 1] == '\r'))
+			last--;
+	}
+
+	std::vector<value> m_Values;
+	std::unordered_map<std::string, size_t> m_Index;
+
+};
+
+// One dialog description statement
+struct DescRecord {
+	std::string keyword;
+	std::vector<std::string> args; // Argument text, lists as "[" items "]"
+	std::vector<int> kinds; // DescToken kind of each argument
+	int line = 0;
+};
+
+//
+// Read the statements of a dialog description
+// Returns false with the parser error if the text is not valid
+//
+inline bool ReadStatements(const std::string &text, std::vector<DescRecord> &records, std::string* error = nullptr)
+{
+	records.clear();
+	DescriptionParser parser;
+	bool bOk = parser.Parse(text, [&records](DescStatement &st) {
+		DescRecord r;
+		r.keyword = st.Keyword().String();
+		r.line = st.GetLine();
+		const DescToken* token = nullptr;
+		while (st.More()) {
+			if (st.IsList()) {
+				std::vector<std::string> items;
+				st.Items(items);
+				r.args.push_back("[");
+				r.kinds.push_back(DescToken::ListBegin);
+				for (size_t i = 0; i < items.size(); i++) {
+					r.args.push_back(items[i]);
+					r.kinds.push_back(DescToken::Text);
+				}
+				r.args.push_back("]");
+				r.kinds.push_back(DescToken::ListEnd);
+			}
+			else {
+				st.Token(token);
+				r.args.push_back(token->String());
+				r.kinds.push_back(token->kind);
+			}
+		}
+		records.push_back(r);
+		return true;
+	});
+	if (!bOk) {
+		records.clear();
+		if (error) *error = parser.GetError();
+	}
+	return bOk;
+}
+
+// Index of the first argument of a kind or the number of arguments
+inline size_t ListPosition(const DescRecord &r, int kind)
+{
+	for (size_t k = 0; k < r.kinds.size(); k++) {
+		if (r.kinds[k] == kind)
+			return k;
+	}
+	return r.args.size();
+}
+
+//
+// Statements of "next" with changed arguments
+//
+//   isvalue(record, arg) - whether an argument is a control value
+//   changed              - indexes of the changed statements of "next"
+//
+// Returns false if statements were added, removed or moved, or if
+// an argument that is not a value has changed. The description
+// must then be loaded again instead of changing values.
+// A list of items is compared as one argument at its start.
+//
+template <typename IsValue>
+bool DiffStatements(const std::vector<DescRecord> &prev, const std::vector<DescRecord> &next,
+	IsValue isvalue, std::vector<size_t> &changed)
+{
+	changed.clear();
+	if (prev.size() != next.size())
+		return false;
+	for (size_t i = 0; i < next.size(); i++) {
+		const DescRecord &a = prev[i];
+		const DescRecord &b = next[i];
+		if (a.keyword != b.keyword)
+			return false;
+		if (a.args.empty() != b.args.empty() || (!a.args.empty() && a.args[0] != b.args[0]))
+			return false;
+		if (a.args == b.args)
+			continue;
+
+		// List position of each statement
+		size_t ab = ListPosition(a, DescToken::ListBegin);
+		size_t ae = ListPosition(a, DescToken::ListEnd);
+		size_t bb = ListPosition(b, DescToken::ListBegin);
+		size_t be = ListPosition(b, DescToken::ListEnd);
+		if (ab != bb || (ae == a.args.size()) != (be == b.args.size()))
+			return false;
+		// Same number of arguments apart from the items
+		if (a.args.size() - ae != b.args.size() - be)
+			return false;
+
+		for (size_t k = 0; k < b.args.size(); k++) {
+			bool bSame = false;
+			if (k == bb && bb < b.args.size()) {
+				// The whole list
+				bSame = std::equal(a.args.begin() + ab, a.args.begin() + ae + 1,
+					b.args.begin() + bb, b.args.begin() + be + 1);
+				if (!bSame && !isvalue(b, k))
+					return false;
+				k = be;
+				continue;
+			}
+			// Arguments after the list are matched from its end
+			size_t j = (be < b.args.size() && k > be) ? k - be + ae : k;
+			bSame = a.args[j] == b.args[k];
+			if (!bSame && !isvalue(b, k))
+				return false;
+		}
+		changed.push_back(i);
+	}
+	return true;
+}
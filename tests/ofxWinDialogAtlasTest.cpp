@@ -0,0 +1,165 @@
+//
+// Rectangle packing for picture button atlases
+// (ofxWinDialogAtlas.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogAtlas.h"
+
+#include <vector>
+#include <random>
+#include <chrono>
+
+static bool Overlap(const AtlasRect &a, const AtlasRect &b)
+{
+	return a.x < b.x + b.width && b.x < a.x + a.width
+		&& a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+static bool Inside(const AtlasPacker &p, const AtlasRect &r)
+{
+	return r.x >= 0 && r.y >= 0 && r.x + r.width <= p.GetWidth() && r.y + r.height <= p.GetHeight();
+}
+
+TEST(Shelves)
+{
+	AtlasPacker packer(100, 100);
+	AtlasRect a, b, c;
+	CHECK(packer.Insert(40, 20, a) && a.x == 0 && a.y == 0);
+	CHECK(packer.Insert(40, 18, b) && b.x == 40 && b.y == 0); // Same shelf
+	CHECK(packer.Insert(40, 30, c) && c.y == 20); // New shelf
+	CHECK(packer.GetCount() == 3);
+	CHECK(packer.GetOccupancy() == (40.0 * 20 + 40 * 18 + 40 * 30) / 10000.0);
+
+	AtlasRect r;
+	CHECK(!packer.Insert(0, 10, r) && !packer.Insert(101, 10, r) && !packer.Insert(10, 101, r));
+	// Too tall for the space below the shelves
+	CHECK(!packer.Insert(90, 60, r));
+}
+
+TEST(RemoveAndReuse)
+{
+	AtlasPacker packer(90, 30);
+	AtlasRect r[3];
+	for (int i = 0; i < 3; i++)
+		CHECK(packer.Insert(30, 30, r[i]) && r[i].x == 30 * i);
+	AtlasRect full;
+	CHECK(!packer.Insert(30, 30, full));
+
+	// Free spans are merged into one
+	packer.Remove(r[0]);
+	packer.Remove(r[1]);
+	AtlasRect wide;
+	CHECK(packer.Insert(60, 30, wide) && wide.x == 0 && wide.y == 0);
+	CHECK(packer.GetCount() == 2);
+
+	// An empty shelf at the bottom is reclaimed
+	packer.Remove(wide);
+	packer.Remove(r[2]);
+	CHECK(packer.GetCount() == 0 && packer.GetOccupancy() == 0.0);
+	AtlasRect tall;
+	CHECK(packer.Insert(90, 30, tall) && tall.y == 0);
+}
+
+TEST(TallerShelf)
+{
+	AtlasPacker packer(100, 40);
+	AtlasRect a, b, small;
+	CHECK(packer.Insert(50, 40, a));
+	// A small image uses a tall shelf only if there is no room below
+	CHECK(packer.Insert(10, 5, small) && small.y == 0 && small.x == 50);
+	packer.Reset(100, 60);
+	CHECK(packer.Insert(50, 40, a));
+	CHECK(packer.Insert(10, 5, b) && b.y == 40);
+}
+
+TEST(RandomNoOverlap)
+{
+	std::mt19937 rng(12345);
+	std::uniform_int_distribution<int> size(4, 48);
+	AtlasPacker packer(512, 512);
+	std::vector<AtlasRect> placed;
+	bool bValid = true;
+	for (int n = 0; n < 2000; n++) {
+		if (!placed.empty() && rng() % 3 == 0) {
+			size_t k = rng() % placed.size();
+			packer.Remove(placed[k]);
+			placed.erase(placed.begin() + (long)k);
+			continue;
+		}
+		AtlasRect r;
+		if (!packer.Insert(size(rng), size(rng), r))
+			continue;
+		if (!Inside(packer, r))
+			bValid = false;
+		for (size_t k = 0; k < placed.size(); k++) {
+			if (Overlap(r, placed[k]))
+				bValid = false;
+		}
+		placed.push_back(r);
+	}
+	CHECK(bValid);
+	CHECK(packer.GetCount() == (int)placed.size());
+	long long area = 0;
+	for (size_t k = 0; k < placed.size(); k++)
+		area += (long long)placed[k].width * placed[k].height;
+	CHECK(packer.GetOccupancy() == (double)area / (512.0 * 512.0));
+}
+
+// Fill ratio and insert and remove speed for a fixed workload of
+// button images, 24 to 96 pixels with a few common sizes.
+// The fill ratio does not depend on the machine, the times are
+// printed for comparison between builds.
+TEST(PackingBenchmark)
+{
+	const int sizes[] = { 24, 32, 48, 64, 96 };
+	std::mt19937 rng(2027);
+	auto next = [&](int &width, int &height) {
+		width = sizes[rng() % 5];
+		height = rng() % 4 ? width : sizes[rng() % 5];
+	};
+
+	// Fill one page until the first insert fails
+	AtlasPacker packer(1024, 1024);
+	std::vector<AtlasRect> placed;
+	int width = 0, height = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (;;) {
+		next(width, height);
+		AtlasRect r;
+		if (!packer.Insert(width, height, r))
+			break;
+		placed.push_back(r);
+	}
+	double fill = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	double filled = packer.GetOccupancy();
+	size_t images = placed.size();
+	CHECK(filled > 0.7);
+
+	// Replace random images, as when buttons are set again
+	const int churn = 100000;
+	int inserted = 0;
+	start = std::chrono::steady_clock::now();
+	for (int n = 0; n < churn; n++) {
+		size_t k = rng() % placed.size();
+		packer.Remove(placed[k]);
+		next(width, height);
+		AtlasRect r;
+		if (packer.Insert(width, height, r)) {
+			placed[k] = r;
+			inserted++;
+		}
+		else {
+			placed[k] = placed.back();
+			placed.pop_back();
+		}
+	}
+	double replace = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	CHECK(packer.GetCount() == (int)placed.size());
+	CHECK(packer.GetOccupancy() > 0.5);
+
+	printf("  fill %.1f%% with %zu images in %.0f us\n", filled * 100.0, images, fill);
+	printf("  %d replacements (%d inserted) : fill %.1f%%, %.2f M insert and remove/s\n",
+		churn, inserted, packer.GetOccupancy() * 100.0, (double)churn * 2.0 / replace);
+}
+
+TEST_MAIN
@@ -0,0 +1,79 @@
+//
+// Timing of scenarios and comparison with a baseline (ofxWinDialogBench.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogBench.h"
+
+#include <string>
+#include <vector>
+
+TEST(Statistics)
+{
+	BenchResults bench;
+	const BenchResults::result &odd = bench.Add("odd", 10, { 5.0, 1.0, 3.0, 2.0, 4.0 });
+	CHECK(odd.runs == 5 && odd.ops == 10);
+	CHECK(odd.min == 1.0 && odd.median == 3.0 && odd.p95 == 5.0 && odd.mean == 3.0);
+	const BenchResults::result &even = bench.Add("even", 1, { 4.0, 1.0, 3.0, 2.0 });
+	CHECK(even.median == 2.5 && even.p95 == 4.0);
+	std::vector<double> times;
+	for (int i = 20; i >= 1; i--)
+		times.push_back((double)i);
+	// Nearest rank
+	CHECK(bench.Add("twenty", 1, times).p95 == 19.0);
+	CHECK(bench.Add("none", 1, {}).runs == 0);
+	CHECK(bench.Size() == 4 && bench.Find("even")->median == 2.5);
+	CHECK(bench.Find("missing") == nullptr);
+}
+
+TEST(RunCalls)
+{
+	BenchResults bench;
+	int calls = 0;
+	const BenchResults::result &r = bench.Run("count", 5, 1, [&]() { calls++; });
+	// One untimed run first
+	CHECK(calls == 6 && r.runs == 5);
+	calls = 0;
+	CHECK(bench.Run("one", 0, 1, [&]() { calls++; }).runs == 1 && calls == 2);
+}
+
+TEST(JsonRoundTrip)
+{
+	BenchResults bench;
+	bench.Add("lookup", 500, { 0.25, 0.5, 0.75 });
+	bench.Add("save \"ini\"", 20, { 1.5 });
+	std::string json = bench.ToJson();
+	CHECK(json.find("\"save \\\"ini\\\"\"") != std::string::npos);
+
+	BenchResults read;
+	CHECK(read.ParseJson(json) && read.Size() == 2);
+	const BenchResults::result* r = read.Find("lookup");
+	CHECK(r && r->runs == 3 && r->ops == 500 && r->min == 0.25 && r->median == 0.5 && r->p95 == 0.75);
+	r = read.Find("save \"ini\"");
+	CHECK(r && r->mean == 1.5 && r->ops == 20);
+	CHECK(!read.ParseJson("{ \"results\" : [ ] }") && read.Size() == 0);
+	CHECK(!read.ParseJson("not json"));
+}
+
+TEST(Compare)
+{
+	BenchResults baseline;
+	baseline.Add("lookup", 1, { 1.0 });
+	baseline.Add("save", 1, { 2.0 });
+	baseline.Add("tiny", 1, { 0.0005 });
+	BenchResults current;
+	current.Add("lookup", 1, { 1.2 });
+	current.Add("save", 1, { 1.0 });
+	current.Add("tiny", 1, { 0.01 });
+	current.Add("new", 1, { 1.0 });
+	std::vector<BenchResults::comparison> changes;
+	CHECK(current.Compare(baseline, 0.1, changes) == 1);
+	// Scenarios in both results only
+	CHECK(changes.size() == 3);
+	CHECK(changes[0].name == "lookup" && changes[0].change > 0.19 && changes[0].change < 0.21);
+	CHECK(changes[1].change == -0.5);
+	// Less than a microsecond is not compared
+	CHECK(changes[2].change == 0.0);
+	CHECK(current.Compare(baseline, 0.25, changes) == 0);
+}
+
+TEST_MAIN
@@ -0,0 +1,221 @@
+//
+// Benchmark of the dialog hot paths with the recording backend
+// (ofxWinDialogHeadless.h), as ofxWinDialog::Benchmark for a dialog
+// without windows. The results are written as JSON and compared with
+// a baseline (tests/benchmark-baseline.json) :
+//
+//   ofxWinDialogBenchmark [--runs 20] [--controls 500] [--json file]
+//                         [--baseline file] [--tolerance 0.1]
+//
+// Returns 1 if a scenario is slower than the baseline by more than
+// the tolerance (0.1 = 10%) or the baseline is not read.
+//
+#include "ofxWinDialogCore.h"
+#include "ofxWinDialogHeadless.h"
+#include "ofxWinDialogBench.h"
+#include "ofxWinDialogItems.h"
+#include "ofxWinDialogPixels.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Panel of sliders, checkboxes, combo and list boxes, edit and spin
+// controls in a column layout, as the settings dialogs of an ofApp
+static void AddControls(DialogCore<> &core, int count)
+{
+	const std::vector<std::string> items = { "Low", "Medium", "High", "Ultra" };
+	for (int i = 0; i < count; i++) {
+		std::string title = "Control " + std::to_string(i);
+		DialogControl* c = nullptr;
+		switch (i % 6) {
+			case 0:
+			case 1:
+				c = &core.Add("Slider", title);
+				c->Max = i % 12 ? 1.0f : 2000.0f;
+				c->SliderVal = c->Max / 2.0f;
+				c->Index = 1; // Value text
+				break;
+			case 2: c = &core.Add("Checkbox", title); break;
+			case 3:
+				c = &core.Add(i % 12 == 3 ? "Combo" : "List", title);
+				c->Items = items;
+				break;
+			case 4: c = &core.Add("Edit", title); c->Text = "Text"; break;
+			default:
+				c = &core.Add("Spin", title);
+				c->Max = 100.0f;
+				break;
+		}
+		c->Width = 200;
+		c->Height = 20;
+	}
+}
+
+static bool ReadFile(const std::string &path, std::string &text)
+{
+	std::ifstream in(path.c_str(), std::ios::binary);
+	if (!in)
+		return false;
+	std::stringstream buffer;
+	buffer << in.rdbuf();
+	text = buffer.str();
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	int runs = 20;
+	int count = 500;
+	double tolerance = 0.1;
+	std::string jsonfile, baseline;
+	for (int a = 1; a + 1 < argc; a += 2) {
+		if (strcmp(argv[a], "--runs") == 0)
+			runs = atoi(argv[a + 1]);
+		else if (strcmp(argv[a], "--controls") == 0)
+			count = atoi(argv[a + 1]);
+		else if (strcmp(argv[a], "--json") == 0)
+			jsonfile = argv[a + 1];
+		else if (strcmp(argv[a], "--baseline") == 0)
+			baseline = argv[a + 1];
+		else if (strcmp(argv[a], "--tolerance") == 0)
+			tolerance = atof(argv[a + 1]);
+		else {
+			printf("ofxWinDialogBenchmark - unknown option \"%s\"\n", argv[a]);
+			return 1;
+		}
+	}
+	if (count < 6)
+		count = 6;
+
+	std::vector<DialogControl> controls;
+	DialogCore<> core(controls);
+	RecordingBackend rec(controls);
+	core.SetBackend(&rec);
+	AddControls(core, count);
+	core.CreateWindows();
+	// Only the time of the core is measured
+	rec.Record(false);
+
+	BenchResults results;
+	size_t calls = 0;
+	auto callback = [&calls](const std::string &, const std::string &, int) { calls++; };
+
+	// Control lookup by type and title
+	results.Run("lookup", runs, controls.size(), [&]() {
+		for (size_t i = 0; i < controls.size(); i++)
+			core.Find(controls[i].Type, controls[i].Title);
+	});
+
+	// Slider moved by the user (WM_HSCROLL) and the ofApp informed
+	std::vector<size_t> sliders;
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Type == "Slider")
+			sliders.push_back(i);
+	}
+	results.Run("slider", runs, sliders.size(), [&]() {
+		for (size_t k = 0; k < sliders.size(); k++) {
+			const DialogControl &c = controls[sliders[k]];
+			int value = 0;
+			if (core.SliderEvent(sliders[k], DialogCore<>::EndScroll, SliderScale::ToPosition(c.SliderVal, c.Min, c.Max), value))
+				callback(c.Title, "", value);
+		}
+	});
+
+	// Values of all controls to the ofApp callback
+	results.Run("getcontrols", runs, controls.size(), [&]() { core.GetControls(callback); });
+
+	// Save and Load of all values (profile functions of the backend)
+	results.Run("save", runs, controls.size(), [&]() { core.Save("benchmark.ini"); });
+	results.Run("load", runs, controls.size(), [&]() { core.Load("benchmark.ini"); });
+
+	// Control windows from the control values (preset recall)
+	results.Run("refresh", runs, controls.size(), [&]() { core.Refresh(); });
+
+	// Combo and list population with new items
+	std::vector<size_t> lists;
+	for (size_t i = 0; i < controls.size(); i++) {
+		if (controls[i].Type == "Combo" || controls[i].Type == "List")
+			lists.push_back(i);
+	}
+	std::vector<std::string> items(100);
+	for (size_t j = 0; j < items.size(); j++)
+		items[j] = "Item " + std::to_string(j);
+	std::string data;
+	std::vector<size_t> offsets;
+	BuildItemBatch(items, data, offsets);
+	results.Run("items", runs, lists.size() * items.size(), [&]() {
+		for (size_t k = 0; k < lists.size(); k++) {
+			DialogControl &c = controls[lists[k]];
+			c.Items.clear();
+			c.Items.reserve(items.size());
+			for (size_t j = 0; j < items.size(); j++)
+				c.Items.emplace_back(data.data() + offsets[j], offsets[j + 1] - offsets[j]);
+			c.Changed |= DialogControl::ChangedItems;
+			core.RefreshControl(lists[k]);
+		}
+	});
+
+	// Picture button pixels of a 256 x 256 RGBA image in BGR order
+	{
+		const int size = 256;
+		std::vector<unsigned char> image((size_t)size * size * 4, 128);
+		std::vector<unsigned char> dib((size_t)DibPitch(size) * size);
+		results.Run("swizzle", runs, (size_t)size * size, [&image, &dib, size]() {
+			CopyPixelsToDib(dib.data(), DibPitch(size), image.data(), size, size, 4, true, false);
+		});
+	}
+
+	// Layout of all controls for a new window width (WM_SIZE)
+	LayoutTree layout;
+	layout.SetMargin(10);
+	core.AddToLayout(layout, layout.AddBox(0, LayoutTree::Column, 4), 0);
+	// Controls as wide as the window, so that all are moved
+	for (size_t i = 0; i < controls.size(); i++)
+		layout.SetStretch(controls[i].Layout, 1.0f, 0.0f);
+	DpiScale dpi(144);
+	std::vector<LayoutTree::placed> placed;
+	int width = 600;
+	results.Run("resize", runs, controls.size(), [&]() {
+		width = width == 600 ? 800 : 600;
+		core.Arrange(layout, dpi, width, 20000, placed);
+	});
+
+	// Results
+	printf("ofxWinDialogBenchmark - %d controls, %d runs\n", (int)controls.size(), runs);
+	for (size_t i = 0; i < results.Size(); i++) {
+		const BenchResults::result &r = results.GetResults()[i];
+		printf("  %-12s median %9.4f  p95 %9.4f  min %9.4f msec  (%d ops)\n",
+			r.name.c_str(), r.median, r.p95, r.min, (int)r.ops);
+	}
+
+	if (!jsonfile.empty()) {
+		std::string json = results.ToJson();
+		std::ofstream out(jsonfile.c_str(), std::ios::binary | std::ios::trunc);
+		if (!out || !out.write(json.data(), (std::streamsize)json.size()))
+			printf("ofxWinDialogBenchmark - could not write \"%s\"\n", jsonfile.c_str());
+	}
+
+	// Compare with the baseline
+	if (baseline.empty())
+		return 0;
+	std::string text;
+	BenchResults base;
+	if (!ReadFile(baseline, text) || !base.ParseJson(text)) {
+		printf("ofxWinDialogBenchmark - baseline \"%s\" not read\n", baseline.c_str());
+		return 1;
+	}
+	std::vector<BenchResults::comparison> changes;
+	size_t slower = results.Compare(base, tolerance, changes);
+	for (size_t i = 0; i < changes.size(); i++) {
+		printf("  %-12s %+6.1f%%%s\n", changes[i].name.c_str(), changes[i].change * 100.0,
+			changes[i].change > tolerance ? "  SLOWER" : "");
+	}
+	if (slower > 0)
+		printf("ofxWinDialogBenchmark - %d scenarios slower than the baseline\n", (int)slower);
+	return slower == 0 ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+//
+// Cache of drawing objects (ofxWinDialogCache.h)
+// with a fake backend that counts objects
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogCache.h"
+#include "ofxWinDialogDpi.h"
+
+#include <set>
+
+// Handles are numbers. Objects alive are kept so that
+// a release of an object not created is found.
+struct FakeGdi {
+	typedef int Handle;
+	static int created;
+	static int destroyed;
+	static int invalid;
+	static std::set<int> &Alive() {
+		static std::set<int> alive;
+		return alive;
+	}
+	Handle Create(const GdiKey &key) {
+		if (key.type == GdiCursor && key.color == 0)
+			return 0; // No such resource
+		created++;
+		Alive().insert(created);
+		return created;
+	}
+	void Destroy(const GdiKey &, Handle handle) {
+		if (!Alive().erase(handle))
+			invalid++;
+		destroyed++;
+	}
+};
+
+int FakeGdi::created = 0;
+int FakeGdi::destroyed = 0;
+int FakeGdi::invalid = 0;
+
+static void ResetFake()
+{
+	FakeGdi::created = 0;
+	FakeGdi::destroyed = 0;
+	FakeGdi::invalid = 0;
+	FakeGdi::Alive().clear();
+}
+
+TEST(RepeatedLookups)
+{
+	ResetFake();
+	{
+		GdiCache<FakeGdi> cache;
+		int brush = cache.Brush(0xFF0000);
+		int pen = cache.Pen(0, 1, 0x0000FF);
+		int font = cache.Font("Tahoma", -12, 400);
+		int cursor = cache.Cursor(32649); // IDC_HAND
+		// Every paint of every button
+		bool bSame = true;
+		for (int i = 0; i < 1000; i++) {
+			if (cache.Brush(0xFF0000) != brush || cache.Pen(0, 1, 0x0000FF) != pen
+				|| cache.Font("Tahoma", -12, 400) != font || cache.Cursor(32649) != cursor)
+				bSame = false;
+		}
+		CHECK(bSame);
+		CHECK(FakeGdi::created == 4 && cache.GetCreated() == 4);
+		CHECK(cache.GetReused() == 4000 && cache.GetCount() == 4);
+
+		// Each colour, style and size is a different object
+		CHECK(cache.Brush(0x00FF00) != brush);
+		CHECK(cache.Pen(0, 2, 0x0000FF) != pen && cache.Pen(2, 1, 0x0000FF) != pen);
+		CHECK(cache.Font("Tahoma", -12, 700) != font && cache.Font("Arial", -12, 400) != font);
+		CHECK(cache.GetCount() == 9);
+
+		// Not created and not cached
+		CHECK(cache.Cursor(0) == 0 && cache.GetCount() == 9);
+		CHECK(FakeGdi::destroyed == 0);
+	}
+	// Everything released with the cache
+	CHECK(FakeGdi::destroyed == 9 && FakeGdi::Alive().empty() && FakeGdi::invalid == 0);
+}
+
+TEST(DpiChangeCreatesFonts)
+{
+	ResetFake();
+	GdiCache<FakeGdi> cache;
+	int font96 = cache.Font("Segoe UI", DpiScale::FontHeight(9, 96), 400);
+	int font144 = cache.Font("Segoe UI", DpiScale::FontHeight(9, 144), 400);
+	CHECK(font144 != font96 && FakeGdi::created == 2);
+	// Back to a DPI seen before - no new font
+	CHECK(cache.Font("Segoe UI", DpiScale::FontHeight(9, 96), 400) == font96);
+	CHECK(FakeGdi::created == 2 && cache.GetReused() == 1);
+}
+
+TEST(ClearReleases)
+{
+	ResetFake();
+	GdiCache<FakeGdi> cache;
+	cache.Brush(1);
+	cache.Brush(2);
+	cache.Clear();
+	CHECK(FakeGdi::destroyed == 2 && cache.GetCount() == 0);
+	// Created again after a clear, released once
+	cache.Brush(1);
+	CHECK(FakeGdi::created == 3);
+	cache.Clear();
+	cache.Clear();
+	CHECK(FakeGdi::destroyed == 3 && FakeGdi::invalid == 0 && FakeGdi::Alive().empty());
+}
+
+TEST_MAIN
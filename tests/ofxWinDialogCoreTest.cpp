@@ -0,0 +1,528 @@
+//
+// Control model of the dialog (ofxWinDialogCore.h) with the
+// recording backend (ofxWinDialogHeadless.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogCore.h"
+#include "ofxWinDialogHeadless.h"
+
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cstring>
+
+TEST(SliderPositions)
+{
+	// Truncated as ofxWinDialog always has
+	CHECK(SliderScale::ToPosition(0.296f, 0.0f, 1.0f) == 29);
+	CHECK(SliderScale::ToPosition(0.5f, 0.0f, 1.0f) == 50);
+	CHECK(SliderScale::ToPosition(-0.296f, -1.0f, 1.0f) == -29);
+	// Wide range - the position is the value
+	CHECK(SliderScale::IsWide(0.0f, 2000.0f));
+	CHECK(SliderScale::ToPosition(1234.6f, 0.0f, 2000.0f) == 1234);
+	CHECK(SliderScale::FromPosition(1234, 0.0f, 2000.0f) == 1234.0f);
+	CHECK(SliderScale::FromPosition(29, 0.0f, 1.0f) == 0.29f);
+	CHECK(SliderScale::PageSize(0.0f, 1.0f) == 5);
+}
+
+TEST(SliderText)
+{
+	char text[16]{};
+	CHECK(SliderScale::Format(0.5f, 1.0f, text, sizeof(text)) == 4);
+	CHECK(strcmp(text, "0.50") == 0);
+	SliderScale::Format(5.25f, 10.0f, text, sizeof(text));
+	CHECK(strcmp(text, "5.2") == 0 || strcmp(text, "5.3") == 0);
+	SliderScale::Format(128.0f, 255.0f, text, sizeof(text));
+	CHECK(strcmp(text, "128") == 0);
+}
+
+TEST(ControlIndexChains)
+{
+	ControlIndex index;
+	index.Add("Slider", "Red");
+	index.Add("Static", "Red");
+	index.Add("Slider", "Red");
+	index.Add("Slider", "Green");
+	CHECK(index.Size() == 4);
+	CHECK(index.Find("Slider", "Red") == 0);
+	CHECK(index.FindLast("Slider", "Red") == 2);
+	CHECK(index.Next(0) == 2);
+	CHECK(index.Next(2) == ControlIndex::npos);
+	CHECK(index.Find("Static", "Red") == 1);
+	CHECK(index.Find("Slider", "Blue") == ControlIndex::npos);
+	// The separator keeps type and title apart
+	CHECK(index.Find("SliderRed", "") == ControlIndex::npos);
+	index.Clear();
+	CHECK(index.Find("Slider", "Red") == ControlIndex::npos);
+}
+
+TEST(IniValueText)
+{
+	CHECK(!IniValue::IsSaved("Button"));
+	CHECK(!IniValue::IsSaved("Static"));
+	CHECK(IniValue::IsSaved("Slider"));
+	CHECK(IniValue::Write("Slider", 0, 0, 0.5f, "") == "0.50");
+	CHECK(IniValue::Write("Combo", 3, 2, 0.0f, "") == "2");
+	CHECK(IniValue::Write("Edit", 0, 0, 0.0f, "Text") == "Text");
+	CHECK(IniValue::Write("Checkbox", 1, 0, 0.0f, "") == "1");
+	int val = 0, index = 0;
+	float slider = 0.0f;
+	std::string text;
+	CHECK(IniValue::Read("Slider", "0.25", val, index, slider, text) && slider == 0.25f);
+	CHECK(IniValue::Read("List", "4", val, index, slider, text) && index == 4);
+	CHECK(IniValue::Read("Spin", "7", val, index, slider, text) && val == 7);
+	CHECK(!IniValue::Read("Spin", "", val, index, slider, text) && val == 7);
+	CHECK(!IniValue::Read("Group", "1", val, index, slider, text));
+}
+
+// Controls, core and backend as held by ofxWinDialog
+struct Dialog {
+	std::vector<DialogControl> controls;
+	DialogCore<> core{ controls };
+	RecordingBackend rec{ controls };
+
+	Dialog() { core.SetBackend(&rec); }
+
+	void Add() {
+		core.Add("Checkbox", "Show").Val = 0;
+		core.Add("Radio", "Fast").Val = 1;
+		DialogControl &slider = core.Add("Slider", "Red");
+		slider.Max = 1.0f;
+		slider.SliderVal = 0.5f;
+		DialogControl &spin = core.Add("Spin", "Count");
+		spin.Max = 10.0f;
+		spin.Val = 3;
+		core.Add("Edit", "Name").Text = "One";
+		core.Add("Combo", "Mode").Items = { "A", "B", "C" };
+		core.Add("List", "Item").Items = { "X", "Y" };
+		core.Add("Button", "Apply");
+		core.Add("Static", "Label");
+	}
+
+	void SetSection(const std::string &title, const std::string &section) {
+		for (size_t i = 0; i < controls.size(); i++) {
+			if (controls[i].Title == title)
+				controls[i].Section = section;
+		}
+	}
+
+	const RecordingBackend::message &Message(size_t k) const { return rec.Messages()[k]; }
+};
+
+TEST(SetMessages)
+{
+	Dialog dialog;
+	dialog.Add();
+	DialogCore<> &core = dialog.core;
+
+	core.SetSlider("Red", 0.29f);
+	CHECK(dialog.rec.Size() == 2);
+	CHECK(dialog.Message(0).name == std::string("TBM_SETPOS") && dialog.Message(0).value == 29);
+	CHECK(dialog.Message(0).control == 2);
+	CHECK(dialog.Message(1).name == std::string("WM_SETTEXT") && dialog.Message(1).text == "0.29");
+	CHECK(core.GetSlider("Red") == 0.29f);
+
+	dialog.rec.Clear();
+	core.SetCheckBox("Show", 1);
+	core.SetComboItem("Mode", 5); // Index kept, no selection
+	core.SetListItem("Item", 5); // Not in the list
+	core.SetListItem("Item", 1);
+	core.SetCheckBox("Missing", 1);
+	CHECK(dialog.rec.Size() == 2);
+	CHECK(dialog.Message(0).name == std::string("BM_SETCHECK") && dialog.Message(0).value == 1);
+	CHECK(dialog.Message(1).name == std::string("LB_SETCURSEL") && dialog.Message(1).value == 1);
+	CHECK(core.GetComboItem("Mode") == 5);
+	CHECK(core.GetListItem("Item") == 1);
+	CHECK(core.GetCheckBox("Missing") == 0);
+
+	// Every control with the title is set and the last one is read
+	core.Add("Checkbox", "Show");
+	dialog.rec.Clear();
+	core.SetCheckBox("Show", 0);
+	CHECK(dialog.rec.Size() == 2 && dialog.Message(1).control == 9);
+	dialog.controls[9].Val = 1;
+	CHECK(core.GetCheckBox("Show") == 1);
+
+	// Controls replaced (Reset, Restore)
+	dialog.controls.resize(3);
+	core.Reindex();
+	CHECK(core.Find("Spin", "Count") >= dialog.controls.size());
+	CHECK(core.Find("Slider", "Red") == 2);
+}
+
+TEST(RefreshAndGetControls)
+{
+	Dialog dialog;
+	dialog.Add();
+	dialog.controls[4].Text = "";
+	dialog.core.Refresh();
+	// One message for each control with a value and the slider text
+	CHECK(dialog.rec.Size() == 8);
+	CHECK(dialog.rec.Count("CB_SETCURSEL") == 1 && dialog.rec.Count("LB_SETCURSEL") == 1);
+
+	std::vector<std::string> titles;
+	std::vector<int> values;
+	dialog.core.GetControls([&](const std::string &title, const std::string &, int value) {
+		titles.push_back(title);
+		values.push_back(value);
+	});
+	// Not the button or static text
+	CHECK(titles.size() == 7);
+	CHECK(titles[2] == "Red" && values[2] == 50);
+	CHECK(titles[4] == "Name" && values[4] == 1);
+	CHECK(titles[5] == "Mode" && values[5] == 0);
+}
+
+TEST(SaveLoad)
+{
+	Dialog a;
+	a.Add();
+	a.SetSection("Name", "Text");
+	a.core.SetSlider("Red", 0.29f);
+	a.core.SetSpin("Count", 8);
+	a.core.SetEdit("Name", "Two");
+	a.core.SetComboItem("Mode", 2);
+	a.core.Save("test.ini");
+
+	// The text of each value as written by WritePrivateProfileString
+	std::string value;
+	CHECK(a.rec.ReadValue("test.ini", "Slider", "Red", value) && value == "0.29");
+	CHECK(a.rec.ReadValue("test.ini", "Text", "Name", value) && value == "Two");
+	CHECK(a.rec.ReadValue("test.ini", "Combo", "Mode", value) && value == "2");
+	CHECK(a.rec.ReadValue("test.ini", "Spin", "Count", value) && value == "8");
+	CHECK(!a.rec.ReadValue("test.ini", "Button", "Apply", value));
+
+	// Read back through the same backend by a second set of controls
+	std::vector<DialogControl> controls;
+	DialogCore<> core(controls);
+	core.SetBackend(&a.rec);
+	Dialog b;
+	b.Add();
+	controls = b.controls;
+	controls[4].Section = "Text";
+	a.rec.Clear();
+	CHECK(core.Load("test.ini") == 7);
+	CHECK(core.GetSlider("Red") == 0.29f);
+	CHECK(core.GetSpin("Count") == 8);
+	CHECK(core.GetEdit("Name") == "Two");
+	CHECK(core.GetComboItem("Mode") == 2);
+	CHECK(core.GetRadioButton("Fast") == 1);
+	// Refreshed
+	CHECK(a.rec.Size() == 8);
+
+	// Only the values in the file are changed
+	a.rec.WriteValue("preset.ini", "Preset", "Count", "4");
+	a.rec.WriteValue("preset.ini", "Preset", "Red", "1.00");
+	a.rec.WriteValue("preset.ini", "Preset", "Name", "");
+	CHECK(core.Load("preset.ini", "Preset") == 2);
+	CHECK(core.GetSpin("Count") == 4 && core.GetSlider("Red") == 1.0f);
+	CHECK(core.GetEdit("Name") == "Two");
+}
+
+TEST(SliderEvents)
+{
+	Dialog dialog;
+	DialogCore<> &core = dialog.core;
+	DialogControl &slider = core.Add("Slider", "Red");
+	slider.Max = 1.0f;
+	int value = 0;
+
+	// Dragged - SetSlider does not move the thumb
+	CHECK(core.SliderEvent(0, DialogCore<>::ThumbTrack, 40, value) && value == 40);
+	CHECK(core.IsDragging() && dialog.controls[0].SliderVal == 0.4f);
+	dialog.rec.Clear();
+	core.SetSlider("Red", 0.9f);
+	CHECK(dialog.rec.Size() == 0 && core.GetSlider("Red") == 0.4f);
+	CHECK(core.SliderEvent(0, DialogCore<>::EndScroll, 40, value) && !core.IsDragging());
+
+	// One-click mode - only at the end
+	dialog.controls[0].Val = 1;
+	CHECK(!core.SliderEvent(0, DialogCore<>::ThumbTrack, 60, value));
+	CHECK(core.SliderEvent(0, DialogCore<>::EndScroll, 60, value) && value == 60);
+
+	// Keys move 1% of a wide range
+	Dialog wide;
+	DialogControl &w = wide.core.Add("Slider", "Wide");
+	w.Max = 2000.0f;
+	wide.core.SliderEvent(0, DialogCore<>::LineRight, 100, value);
+	CHECK(wide.Message(0).name == std::string("TBM_SETPOS") && wide.Message(0).value == 120);
+	CHECK(wide.controls[0].SliderVal == 120.0f && value == 12000);
+
+	// Ranges of 100 to 1000 move the thumb by 100 positions
+	// but the value is of the position before the key
+	Dialog mid;
+	mid.core.Add("Slider", "Mid").Max = 500.0f;
+	mid.core.SliderEvent(0, DialogCore<>::LineLeft, 1000, value);
+	CHECK(mid.Message(0).value == 900 && mid.controls[0].SliderVal == 10.0f);
+}
+
+TEST(ButtonEvents)
+{
+	Dialog dialog;
+	dialog.Add();
+	DialogCore<> &core = dialog.core;
+
+	// Spin within the range
+	CHECK(core.SpinEvent(3, 9, 5) == 10);
+	CHECK(core.SpinEvent(3, 0, -1) == 0 && dialog.controls[3].Val == 0);
+
+	CHECK(core.CheckEvent(0, true) == 1 && core.GetCheckBox("Show") == 1);
+
+	// Other buttons of the group are cleared
+	core.Add("Radio", "Slow").RadioGroup = 0;
+	core.Add("Radio", "Other").RadioGroup = 1;
+	dialog.controls[10].Val = 1;
+	std::vector<std::string> titles;
+	core.RadioEvent(9, [&](const std::string &title, const std::string &, int) { titles.push_back(title); });
+	CHECK(titles.size() == 2 && titles[1] == "Slow");
+	CHECK(core.GetRadioButton("Fast") == 0 && core.GetRadioButton("Slow") == 1);
+	CHECK(core.GetRadioButton("Other") == 1);
+
+	// The callback has the old index
+	int old = -1;
+	std::string text;
+	CHECK(core.ComboEvent(5, 2, [&](const std::string &, const std::string &item, int) {
+		old = core.GetComboItem("Mode");
+		text = item;
+	}));
+	CHECK(old == 0 && text == "C" && core.GetComboItem("Mode") == 2);
+	CHECK(!core.ComboEvent(5, 3, [](const std::string &, const std::string &, int) {}));
+}
+
+// Events of a trace applied by Replay
+struct Replayed {
+	Dialog dialog;
+	std::vector<std::string> calls;
+	size_t count = 0;
+
+	explicit Replayed(const EventTrace &trace) {
+		dialog.Add();
+		dialog.core.CreateWindows();
+		count = dialog.core.Replay(trace, [this](const std::string &title, const std::string &text, int value) {
+			calls.push_back(title + "," + text + "," + std::to_string(value));
+		});
+	}
+};
+
+// A replay is the same for every run. The recorded times
+// are far apart and are not waited for.
+TEST(ReplayTwice)
+{
+	EventTrace trace;
+	uint64_t t = 0;
+	trace.Add(t += 1000000, EventTrace::SetSlider, "Red", "", 0, 0.25f);
+	trace.Add(t += 1000000, EventTrace::Event, "Red", "", 75);
+	trace.Add(t += 1000000, EventTrace::Event, "Show", "", 1);
+	trace.Add(t += 1000000, EventTrace::SetComboItem, "Mode", "", 2);
+	trace.Add(t += 1000000, EventTrace::Event, "Item", "Y", 1);
+	trace.Add(t += 1000000, EventTrace::SetEdit, "Name", "Two", 0);
+	trace.Add(t += 1000000, EventTrace::Event, "Count", "", 7);
+	trace.Add(t += 1000000, EventTrace::Event, "WM_KEYDOWN", "", 32);
+	trace.Add(t += 1000000, EventTrace::SetSpin, "Missing", "", 4);
+	std::string bytes;
+	trace.Write(bytes);
+	EventTrace read;
+	CHECK(read.Read(bytes));
+
+	auto start = std::chrono::steady_clock::now();
+	Replayed a(trace);
+	Replayed b(read);
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	CHECK(ms < 1000.0);
+
+	CHECK(a.count == 9 && b.count == 9);
+	// Set functions are not passed to the callback
+	CHECK(a.calls.size() == 5 && a.calls == b.calls);
+	CHECK(a.calls[0] == "Red,,75" && a.calls[4] == "WM_KEYDOWN,,32");
+
+	const DialogCore<> &core = a.dialog.core;
+	CHECK(a.dialog.controls[2].SliderVal == 0.75f);
+	CHECK(a.dialog.controls[0].Val == 1 && a.dialog.controls[6].Index == 1);
+	CHECK(a.dialog.controls[5].Index == 2 && a.dialog.controls[4].Text == "Two");
+	CHECK(a.dialog.controls[3].Val == 7 && !core.IsDragging());
+
+	// Same control values and window messages
+	for (size_t i = 0; i < a.dialog.controls.size(); i++) {
+		const DialogControl &x = a.dialog.controls[i];
+		const DialogControl &y = b.dialog.controls[i];
+		CHECK(x.Val == y.Val && x.Index == y.Index && x.SliderVal == y.SliderVal && x.Text == y.Text);
+	}
+	CHECK(a.dialog.rec.Size() == b.dialog.rec.Size() && a.dialog.rec.Size() > 0);
+	for (size_t k = 0; k < a.dialog.rec.Size() && k < b.dialog.rec.Size(); k++) {
+		const RecordingBackend::message &x = a.dialog.Message(k);
+		const RecordingBackend::message &y = b.dialog.Message(k);
+		CHECK(std::string(x.name) == y.name && x.control == y.control && x.value == y.value && x.text == y.text);
+	}
+}
+
+TEST(KeepAlive)
+{
+	Dialog dialog;
+	dialog.Add();
+	DialogCore<> &core = dialog.core;
+	core.KeepAlive(true);
+	core.Open();
+	core.CreateWindows();
+	CHECK(dialog.rec.GetCreated() == dialog.controls.size());
+	std::vector<DialogControl> old = dialog.controls;
+
+	// Shown - the window is updated and the change recorded
+	dialog.rec.Clear();
+	core.SetSpin("Count", 5);
+	CHECK(dialog.rec.Size() == 1 && core.GetChanged().size() == 1);
+
+	// Hidden - the window is updated by Show
+	core.Hide();
+	dialog.rec.Clear();
+	core.SetCheckBox("Show", 1);
+	core.SetText("Label", "Hidden");
+	CHECK(dialog.rec.Size() == 0);
+	CHECK(dialog.controls[0].Changed == (DialogControl::ChangedValue | DialogControl::ChangedWindow));
+	core.Show(old);
+	CHECK(dialog.rec.Size() == 2 && dialog.Message(1).text == "Hidden");
+	CHECK(!core.IsHidden() && core.GetChanged().empty());
+	// Old controls for Cancel have the values set
+	CHECK(old[0].Val == 1 && old[3].Val == 5 && old[8].Text == "Hidden");
+
+	// All old controls are replaced if the user changed a control
+	core.Hide();
+	core.CheckEvent(1, false);
+	core.Show(old);
+	CHECK(old[1].Val == 0);
+
+	// Not kept - always updated
+	core.KeepAlive(false);
+	core.Hide();
+	dialog.rec.Clear();
+	core.SetCheckBox("Show", 0);
+	CHECK(dialog.rec.Size() == 1);
+}
+
+// Open time of a dialog that is destroyed by Close and one that is
+// kept (KeepAlive), with one control set while it was closed. The
+// times are printed for comparison between builds.
+TEST(OpenModes)
+{
+	const int count = 2000;
+	const int runs = 50;
+	Dialog dialog;
+	DialogCore<> &core = dialog.core;
+	for (int i = 0; i < count; i++) {
+		DialogControl &c = core.Add(i % 2 ? "Checkbox" : "Slider", "Control " + std::to_string(i));
+		c.Width = 100;
+		c.Height = 20;
+		c.Max = 1.0f;
+	}
+	DpiScale dpi;
+	std::vector<DialogControl> old;
+	std::vector<double> normal, kept;
+
+	// Every window is created again and refreshed
+	for (int run = 0; run < runs; run++) {
+		core.SetCheckBox("Control 1", run % 2);
+		dialog.rec.Destroy();
+		dialog.rec.Clear();
+		auto start = std::chrono::steady_clock::now();
+		old = dialog.controls;
+		core.Open();
+		core.ScaleControls(dpi, false);
+		core.CreateWindows();
+		core.Refresh();
+		normal.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+	}
+	CHECK(dialog.rec.GetCreated() == (size_t)count);
+	CHECK(dialog.rec.Count("BM_SETCHECK") == (size_t)count / 2);
+
+	// Only the changed control is updated
+	core.KeepAlive(true);
+	core.Open();
+	for (int run = 0; run < runs; run++) {
+		core.Hide();
+		core.SetCheckBox("Control 1", run % 2);
+		dialog.rec.Clear();
+		auto start = std::chrono::steady_clock::now();
+		core.Show(old);
+		kept.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+	}
+	CHECK(dialog.rec.Size() == 1 && dialog.Message(0).control == 1);
+	CHECK(old[1].Val == (runs - 1) % 2);
+
+	std::sort(normal.begin(), normal.end());
+	std::sort(kept.begin(), kept.end());
+	printf("  %d controls : open %.1f us, kept open %.2f us median\n", count, normal[runs / 2], kept[runs / 2]);
+#ifdef NDEBUG
+	CHECK(kept[runs / 2] * 10.0 < normal[runs / 2]);
+#endif
+}
+
+TEST(LayoutAndDpi)
+{
+	Dialog dialog;
+	DialogCore<> &core = dialog.core;
+	for (int i = 0; i < 4; i++) {
+		DialogControl &c = core.Add("Checkbox", "Check " + std::to_string(i));
+		c.Width = 100;
+		c.Height = 20;
+	}
+	DialogControl &slider = core.Add("Slider", "Red");
+	slider.Width = 100;
+	slider.Height = 20;
+	slider.Index = 1; // Value text
+
+	LayoutTree layout;
+	layout.SetMargin(10);
+	int box = layout.AddBox(0, LayoutTree::Column, 4);
+	core.AddToLayout(layout, box, 0);
+	CHECK(dialog.controls[4].Layout >= 0);
+
+	DpiScale dpi(144);
+	core.ScaleControls(dpi, false);
+	CHECK(dialog.controls[1].Width == 150 && dialog.controls[1].DesignWidth == 100);
+	CHECK(dialog.rec.Size() == 0);
+
+	std::vector<LayoutTree::placed> placed;
+	CHECK(core.Arrange(layout, dpi, 600, 300, placed));
+	CHECK(dialog.rec.Count("DeferWindowPos") == 5);
+	CHECK(dialog.controls[1].DesignX == 10 && dialog.controls[1].X == 15);
+	// Slider width without the value text
+	CHECK(dialog.controls[4].DesignWidth == 100);
+	CHECK(dialog.controls[4].Dpi == 144);
+	// Not moved again for the same size
+	dialog.rec.Clear();
+	CHECK(!core.Arrange(layout, dpi, 600, 300, placed) && dialog.rec.Size() == 0);
+}
+
+// Deterministic regression checks of the hot paths : the number of
+// messages for a number of controls does not depend on the machine.
+// The times are printed for comparison between builds.
+TEST(HotPaths)
+{
+	const int count = 1000;
+	Dialog dialog;
+	for (int i = 0; i < count; i++) {
+		DialogControl &c = dialog.core.Add("Slider", "Slider " + std::to_string(i));
+		c.Max = 1.0f;
+		c.SliderVal = 0.5f;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < count; i++)
+		dialog.core.SetSlider("Slider " + std::to_string(i), 0.25f);
+	double set = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	CHECK(dialog.rec.Size() == (size_t)count * 2);
+
+	start = std::chrono::steady_clock::now();
+	dialog.core.Save("hot.ini");
+	double save = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+	dialog.rec.Clear();
+	start = std::chrono::steady_clock::now();
+	CHECK(dialog.core.Load("hot.ini") == (size_t)count);
+	double load = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	CHECK(dialog.rec.Size() == (size_t)count * 2);
+
+	printf("  %d sliders : set %.0f us, save %.0f us, load %.0f us\n", count, set, save, load);
+}
+
+TEST_MAIN
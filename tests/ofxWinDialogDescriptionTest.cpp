@@ -0,0 +1,248 @@
+//
+// Dialog description parser (ofxWinDialogDescription.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogDescription.h"
+
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+
+TEST(Numbers)
+{
+	double v = 0.0;
+	CHECK(DescriptionParser::ToNumber("42", 2, v) && v == 42.0);
+	CHECK(DescriptionParser::ToNumber("-0.5", 4, v) && v == -0.5);
+	CHECK(DescriptionParser::ToNumber("#FF8000", 7, v) && v == (double)0xFF8000);
+	CHECK(DescriptionParser::ToNumber("0x1f", 4, v) && v == 31.0);
+	CHECK(DescriptionParser::ToNumber(".5", 2, v) && v == 0.5);
+	CHECK(!DescriptionParser::ToNumber("-", 1, v));
+	CHECK(!DescriptionParser::ToNumber("12px", 4, v));
+	CHECK(!DescriptionParser::ToNumber("0x", 2, v));
+	CHECK(!DescriptionParser::ToNumber("#12345678901234567", 18, v)); // More than 64 bits
+	CHECK(!DescriptionParser::ToNumber(".", 1, v));
+}
+
+TEST(Statements)
+{
+	const std::string text =
+		"// Settings dialog\r\n"
+		"Slider \"Line width\", 0, 10, 2.5 // width\r\n"
+		"\r\n"
+		"Combo \"Mode\" [ \"One\", Two\r\n"
+		"  \"Say \"\"hi\"\"\" ] 1\r\n"
+		"Static Label SS_CENTER|WS_BORDER";
+	DescriptionParser parser;
+	std::vector<std::string> keywords;
+	std::vector<int> lines;
+	std::string title, word;
+	float min = 0.0f, max = 0.0f, value = 0.0f;
+	std::vector<std::string> items;
+	int index = 0;
+	bool bOk = parser.Parse(text, [&](DescStatement &st) {
+		keywords.push_back(st.Keyword().String());
+		lines.push_back(st.GetLine());
+		if (st.Keyword().Is("Slider"))
+			return st.Text(title) && st.Float(min) && st.Float(max) && st.Float(value) && st.End();
+		if (st.Keyword().Is("Combo"))
+			return st.Text(title) && st.IsList() && st.Items(items) && st.Int(index) && st.End();
+		const DescToken* style = nullptr;
+		return st.Text(title) && st.Token(style) && (word = style->String(), true) && st.End();
+	});
+	CHECK(bOk && parser.GetError().empty());
+	CHECK(parser.GetStatements() == 3);
+	CHECK(keywords.size() == 3 && keywords[0] == "Slider" && keywords[1] == "Combo");
+	// Line of the start of each statement
+	CHECK(lines[0] == 2 && lines[1] == 4 && lines[2] == 6);
+	CHECK(min == 0.0f && max == 10.0f && value == 2.5f);
+	CHECK(items.size() == 3 && items[1] == "Two" && items[2] == "Say \"hi\"");
+	CHECK(index == 1);
+	CHECK(word == "SS_CENTER|WS_BORDER");
+}
+
+static std::string ParseError(const std::string &text)
+{
+	DescriptionParser parser;
+	parser.Parse(text, [](DescStatement &st) {
+		if (st.Keyword().Is("Spin")) {
+			int v = 0;
+			return st.Int(v) && st.End();
+		}
+		return st.Keyword().Is("Known");
+	});
+	return parser.GetError();
+}
+
+TEST(Errors)
+{
+	CHECK(ParseError("Known\nSpin \"text\"") == "Line 2 : number expected");
+	CHECK(ParseError("Spin 1 2") == "Line 1 : too many arguments");
+	CHECK(ParseError("Other") == "Line 1 : unknown statement");
+	CHECK(ParseError("Known \"open") == "Line 1 : text without a closing quote");
+	CHECK(ParseError("Known [ a [ b ] ]") == "Line 1 : list within a list");
+	CHECK(ParseError("Known ]") == "Line 1 : end of list without a list");
+	CHECK(ParseError("\n\nKnown [ a\n b") == "Line 3 : list without an end");
+	CHECK(ParseError("12 Known") == "Line 1 : keyword expected");
+	CHECK(ParseError("[ a ]") == "Line 1 : keyword expected");
+	CHECK(ParseError("Known\n// Comment only\n\nKnown") == "");
+}
+
+// The parser stops at the first statement that fails
+TEST(StopAtFailure)
+{
+	DescriptionParser parser;
+	int calls = 0;
+	CHECK(!parser.Parse(std::string("A\nB\nC"), [&calls](DescStatement &st) {
+		calls++;
+		return !st.Keyword().Is("B") || st.Error("stop here");
+	}));
+	CHECK(calls == 2 && parser.GetErrorLine() == 2);
+	CHECK(parser.GetError() == "Line 2 : stop here");
+}
+
+// Controls read from a description as by ofxWinDialog::LoadDialog
+struct DescControl {
+	std::string type;
+	std::string title;
+	std::string text;
+	std::vector<std::string> items;
+	int x = 0, y = 0, width = 0, height = 0;
+	int index = 0;
+	float min = 0.0f, max = 0.0f, value = 0.0f;
+};
+
+static bool ReadControl(DescStatement &st, std::vector<DescControl> &model)
+{
+	DescControl c;
+	c.type = st.Keyword().String();
+	auto rect = [&]() { return st.Int(c.x) && st.Int(c.y) && st.Int(c.width) && st.Int(c.height); };
+	bool bOk = false;
+	if (st.Keyword().Is("checkbox"))
+		bOk = st.Text(c.title) && st.Text(c.text) && rect() && st.Int(c.index) && st.End();
+	else if (st.Keyword().Is("slider"))
+		bOk = st.Text(c.title) && rect() && st.Float(c.min) && st.Float(c.max) && st.Float(c.value) && st.End();
+	else if (st.Keyword().Is("edit"))
+		bOk = st.Text(c.title) && rect() && st.Text(c.text) && st.End();
+	else if (st.Keyword().Is("combo") || st.Keyword().Is("list"))
+		bOk = st.Text(c.title) && rect() && st.Items(c.items) && st.Int(c.index) && st.End();
+	else
+		return st.Error("unknown statement");
+	if (bOk)
+		model.push_back(c);
+	return bOk;
+}
+
+static const char* g_Description =
+	"// Fuzz seed\n"
+	"checkbox \"Show\", \"Show the grid\", 10, 10, 120, 20, 1\n"
+	"slider \"Red\" 10 40 200 20 0 255 128.5 // colour\n"
+	"edit Name 10 70 200 20 \"Say \"\"hi\"\"\"\n"
+	"combo \"Mode\" 10 100 200 80 [ One, \"Two\"\n"
+	"  Three ] 2\n"
+	"list Files 10 130 200 100 [ a.mov b.mov\n c.mov ] 0x1\n";
+
+// Mutated descriptions either parse to a model with one control for
+// each statement or fail with an error on a line of the text. The text
+// is copied to a buffer of its exact size so that a sanitizer build
+// (OFXWINDIALOG_SANITIZE=address) finds a read past the end.
+TEST(MutationFuzz)
+{
+	const std::string seed = g_Description;
+	const char special[] = "\"[]\n/,# -.x0123456789\r\t";
+	std::mt19937 rng(2037);
+	DescriptionParser parser;
+	std::vector<DescControl> model;
+	int valid = 0, invalid = 0;
+	bool bConsistent = true;
+	for (int n = 0; n < 20000; n++) {
+		std::string text = seed;
+		int mutations = 1 + (int)(rng() % 8);
+		for (int m = 0; m < mutations && !text.empty(); m++) {
+			size_t pos = rng() % text.size();
+			switch (rng() % 5) {
+			case 0: text[pos] = special[rng() % (sizeof(special) - 1)]; break;
+			case 1: text.insert(pos, 1, special[rng() % (sizeof(special) - 1)]); break;
+			case 2: text.erase(pos, 1 + rng() % 8); break;
+			case 3: text[pos] = (char)(rng() % 256); break;
+			default: text.resize(pos); break;
+			}
+		}
+		std::vector<char> buffer(text.begin(), text.end());
+		model.clear();
+		int lines = (int)std::count(text.begin(), text.end(), '\n') + 1;
+		bool bOk = parser.Parse(buffer.data(), buffer.size(),
+			[&model](DescStatement &st) { return ReadControl(st, model); });
+		if (bOk) {
+			valid++;
+			if (!parser.GetError().empty() || model.size() != parser.GetStatements())
+				bConsistent = false;
+			for (size_t i = 0; i < model.size(); i++) {
+				if (model[i].type.empty() || model[i].title.size() > text.size())
+					bConsistent = false;
+			}
+		}
+		else {
+			invalid++;
+			if (parser.GetError().compare(0, 5, "Line ") != 0
+				|| parser.GetErrorLine() < 1 || parser.GetErrorLine() > lines)
+				bConsistent = false;
+		}
+	}
+	CHECK(bConsistent);
+	// Both outcomes are exercised
+	CHECK(valid > 100 && invalid > 100);
+
+	// Random bytes
+	for (int n = 0; n < 2000; n++) {
+		std::vector<char> buffer(rng() % 200);
+		for (size_t k = 0; k < buffer.size(); k++)
+			buffer[k] = special[rng() % (sizeof(special) - 1)];
+		if (!buffer.empty() && rng() % 2)
+			buffer[0] = 'c';
+		model.clear();
+		bool bOk = parser.Parse(buffer.data(), buffer.size(),
+			[&model](DescStatement &st) { return ReadControl(st, model); });
+		if (bOk != parser.GetError().empty())
+			bConsistent = false;
+	}
+	CHECK(bConsistent);
+}
+
+// Parse time for 10k controls. The time is printed for comparison
+// between builds and checked against a generous bound.
+TEST(TenThousandControls)
+{
+	std::string text;
+	const int count = 10000;
+	for (int i = 0; i < count; i++) {
+		int y = 10 + (i % 40) * 25;
+		switch (i % 4) {
+		case 0: text += "slider \"Slider " + std::to_string(i) + "\" 10 " + std::to_string(y) + " 200 20 0 1 0.5\n"; break;
+		case 1: text += "checkbox \"Check " + std::to_string(i) + "\" \"Enable\" 220 " + std::to_string(y) + " 80 20 0\n"; break;
+		case 2: text += "combo \"Combo " + std::to_string(i) + "\" 310 " + std::to_string(y) + " 100 80 [ One Two Three ] 1\n"; break;
+		default: text += "edit \"Edit " + std::to_string(i) + "\" 420 " + std::to_string(y) + " 100 20 \"Text\"\n"; break;
+		}
+	}
+	DescriptionParser parser;
+	std::vector<DescControl> model;
+	model.reserve(count);
+	std::vector<double> times;
+	bool bOk = true;
+	for (int run = 0; run < 5; run++) {
+		model.clear();
+		auto start = std::chrono::steady_clock::now();
+		bOk = parser.Parse(text, [&model](DescStatement &st) { return ReadControl(st, model); }) && bOk;
+		times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+	}
+	std::sort(times.begin(), times.end());
+	CHECK(bOk && model.size() == (size_t)count);
+	CHECK(model[2].items.size() == 3 && model[count - 1].text == "Text");
+	printf("  %d controls (%zu KB) : parse %.2f ms median\n", count, text.size() / 1024, times[2]);
+#ifdef NDEBUG
+	CHECK(times[2] < 50.0);
+#endif
+}
+
+TEST_MAIN
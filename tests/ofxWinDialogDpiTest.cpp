@@ -0,0 +1,76 @@
+//
+// Scaling for the monitor DPI (ofxWinDialogDpi.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogDpi.h"
+
+#include <climits>
+
+TEST(Scale)
+{
+	DpiScale dpi;
+	CHECK(dpi.IsDefault() && dpi.Scale(37) == 37);
+	dpi.Set(0);
+	CHECK(dpi.Get() == DpiScale::Default);
+	dpi.Set(144);
+	CHECK(dpi.GetScale() == 1.5 && !dpi.IsDefault());
+	dpi.Set(120);
+	// Halves away from zero
+	CHECK(dpi.Scale(10) == 13 && dpi.Scale(-10) == -13);
+	CHECK(dpi.Unscale(13) == 10);
+}
+
+// Scaled up and back to the 96 DPI value without rounding errors
+TEST(RoundTrip)
+{
+	const int dpis[] = { 96, 120, 144, 168, 192, 240 };
+	bool bSame = true;
+	for (int d : dpis) {
+		DpiScale dpi(d);
+		for (int v = -1000; v <= 1000; v++) {
+			if (dpi.Unscale(dpi.Scale(v)) != v)
+				bSame = false;
+		}
+	}
+	CHECK(bSame);
+}
+
+// Controls which touch at 96 DPI still touch when scaled
+TEST(RectEdges)
+{
+	DpiScale dpi(120);
+	int x, y, w, h;
+	dpi.ScaleRect(0, 0, 10, 10, x, y, w, h);
+	CHECK(x == 0 && w == 13 && h == 13);
+	dpi.ScaleRect(10, 10, 10, 10, x, y, w, h);
+	CHECK(x == 13 && y == 13 && w == 12 && h == 12);
+	// A row of controls has the scaled width of the whole row
+	int right = 0;
+	for (int i = 0; i < 7; i++) {
+		dpi.ScaleRect(i * 15, 0, 15, 10, x, y, w, h);
+		CHECK(x == right);
+		right = x + w;
+	}
+	CHECK(right == dpi.Scale(7 * 15));
+}
+
+TEST(FontHeight)
+{
+	CHECK(DpiScale::FontHeight(9, 96) == -12);
+	CHECK(DpiScale::FontHeight(9, 120) == -15);
+	CHECK(DpiScale::FontHeight(9, 144) == -18);
+	CHECK(DpiScale::FontHeight(9, 0) == -12);
+}
+
+TEST(MulDivRound)
+{
+	CHECK(DpiScale::MulDivRound(3, 1, 2) == 2);
+	CHECK(DpiScale::MulDivRound(-3, 1, 2) == -2);
+	CHECK(DpiScale::MulDivRound(3, 1, -2) == -2);
+	CHECK(DpiScale::MulDivRound(1, 1, 0) == 0);
+	// Clamped to the int range
+	CHECK(DpiScale::MulDivRound(INT_MAX, 4, 1) == INT_MAX);
+	CHECK(DpiScale::MulDivRound(INT_MIN, 4, 1) == INT_MIN);
+}
+
+TEST_MAIN
@@ -0,0 +1,104 @@
+//
+// Routing of key messages and hook references
+// (ofxWinDialogHooks.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogHooks.h"
+
+#include <thread>
+#include <atomic>
+#include <vector>
+
+struct TestDialog {
+	int id = 0;
+};
+
+TEST(HookReferences)
+{
+	HookRegistry<TestDialog> hooks;
+	uintptr_t handle = 0;
+	CHECK(!hooks.Release(1, handle) && handle == 0); // Never acquired
+
+	CHECK(hooks.Acquire(1)); // First - install
+	hooks.SetHook(1, 0x1234);
+	CHECK(!hooks.Acquire(1));
+	CHECK(!hooks.Acquire(1));
+	CHECK(hooks.Acquire(2)); // Other thread
+	hooks.SetHook(2, 0x5678);
+	CHECK(hooks.GetRefs(1) == 3 && hooks.GetHook(1) == 0x1234);
+
+	CHECK(!hooks.Release(1, handle) && handle == 0);
+	CHECK(!hooks.Release(1, handle) && handle == 0);
+	CHECK(hooks.GetHook(1) == 0x1234);
+	// Last - the handle is returned to be removed
+	CHECK(hooks.Release(1, handle) && handle == 0x1234);
+	CHECK(hooks.GetRefs(1) == 0 && hooks.GetHook(1) == 0);
+	CHECK(!hooks.Release(1, handle) && handle == 0);
+	// The other thread keeps its hook
+	CHECK(hooks.GetHook(2) == 0x5678);
+
+	// A thread acquired again installs a new hook
+	CHECK(hooks.Acquire(1));
+	CHECK(hooks.GetHook(1) == 0);
+}
+
+TEST(Routing)
+{
+	HookRegistry<TestDialog> hooks;
+	TestDialog a, b;
+	a.id = 1;
+	b.id = 2;
+	hooks.Add(100, &a); // Dialog window
+	hooks.Add(101, &a); // Control of the dialog
+	hooks.Add(200, &b);
+	hooks.Add(201, &b);
+	CHECK(hooks.Size() == 4);
+	CHECK(hooks.Find(101) == &a);
+	CHECK(hooks.Find(201) == &b);
+	CHECK(hooks.Find(300) == nullptr);
+
+	// Replaced
+	hooks.Add(201, &a);
+	CHECK(hooks.Find(201) == &a);
+	hooks.Add(201, &b);
+
+	hooks.Remove(101);
+	CHECK(hooks.Find(101) == nullptr && hooks.Find(100) == &a);
+
+	// Only the windows of the dialog are removed
+	hooks.RemoveDialog(&a);
+	CHECK(hooks.Find(100) == nullptr);
+	CHECK(hooks.Find(200) == &b && hooks.Find(201) == &b);
+	CHECK(hooks.Size() == 2);
+	hooks.RemoveDialog(&a);
+	CHECK(hooks.Size() == 2);
+}
+
+TEST(ReferencesFromThreads)
+{
+	HookRegistry<TestDialog> hooks;
+	const int count = 1000;
+	std::atomic<int> installs{ 0 }, removes{ 0 };
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++) {
+		threads.push_back(std::thread([&]() {
+			for (int i = 0; i < count; i++) {
+				if (hooks.Acquire(7)) {
+					installs++;
+					hooks.SetHook(7, 0x77);
+				}
+				uintptr_t handle = 0;
+				if (hooks.Release(7, handle))
+					removes++;
+			}
+		}));
+	}
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+	// Each install is matched by one remove
+	CHECK(installs.load() == removes.load());
+	CHECK(installs.load() > 0);
+	CHECK(hooks.GetRefs(7) == 0);
+}
+
+TEST_MAIN
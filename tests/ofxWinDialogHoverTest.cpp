@@ -0,0 +1,46 @@
+//
+// Hover state for owner draw buttons (ofxWinDialogHover.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogHover.h"
+
+TEST(HitTest)
+{
+	HoverTracker hover(16);
+	hover.Add(1, 10, 10, 40, 20); // Spans several cells
+	hover.Add(2, 30, 15, 10, 10); // On top of 1
+	hover.Add(3, -20, -20, 10, 10); // Negative coordinates
+	hover.Add(4, 0, 0, 0, 10); // Empty - not added
+	CHECK(hover.HitTest(10, 10) == 1);
+	CHECK(hover.HitTest(49, 29) == 1);
+	CHECK(hover.HitTest(50, 29) == -1 && hover.HitTest(49, 30) == -1);
+	CHECK(hover.HitTest(35, 20) == 2);
+	CHECK(hover.HitTest(-15, -15) == 3 && hover.HitTest(-21, -15) == -1);
+	CHECK(hover.HitTest(0, 5) == -1);
+	hover.Clear();
+	CHECK(hover.HitTest(10, 10) == -1);
+}
+
+TEST(Changes)
+{
+	HoverTracker hover;
+	hover.Add(1, 0, 0, 10, 10);
+	hover.Add(2, 20, 0, 10, 10);
+	int left = 0, entered = 0;
+	CHECK(hover.Move(5, 5, left, entered) && left == -1 && entered == 1);
+	// No change within the same control
+	CHECK(!hover.Move(6, 6, left, entered) && left == -1 && entered == -1);
+	CHECK(hover.Move(25, 5, left, entered) && left == 1 && entered == 2);
+	CHECK(hover.Move(15, 5, left, entered) && left == 2 && entered == -1);
+	CHECK(hover.GetChanges() == 3 && hover.GetHover() == -1);
+
+	// Leave of a control that no longer has hover is ignored
+	hover.Move(5, 5, left, entered);
+	CHECK(!hover.Leave(2, left) && left == -1 && hover.GetHover() == 1);
+	CHECK(hover.Leave(1, left) && left == 1 && hover.GetHover() == -1);
+	hover.Move(25, 5, left, entered);
+	CHECK(hover.Leave(-1, left) && left == 2);
+	CHECK(!hover.Leave(-1, left));
+}
+
+TEST_MAIN
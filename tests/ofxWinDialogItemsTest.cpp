@@ -0,0 +1,188 @@
+//
+// Item storage, list rows and item batches (ofxWinDialogItems.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogItems.h"
+
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstring>
+
+TEST(Store)
+{
+	ItemStore store;
+	store.Reserve(4, 64);
+	CHECK(store.Append("One") == 0);
+	CHECK(store.Append(std::string("Two")) == 1);
+	size_t len = 0;
+	CHECK(strcmp(store.Get(0, &len), "One") == 0 && len == 3);
+	CHECK(strcmp(store.Get(5, &len), "") == 0 && len == 0);
+
+	// In place and appended
+	CHECK(store.Replace(0, "1"));
+	CHECK(store.GetString(0) == "1" && strcmp(store.Get(0), "1") == 0);
+	CHECK(store.Replace(1, "Twenty two"));
+	CHECK(store.GetString(1) == "Twenty two" && store.GetString(0) == "1");
+	CHECK(!store.Replace(2, "x"));
+	CHECK(store.Size() == 2 && !store.Empty());
+	store.Clear();
+	CHECK(store.Empty());
+}
+
+TEST(Compact)
+{
+	ItemStore store;
+	for (int i = 0; i < 100; i++)
+		store.Append("Item " + std::to_string(i));
+	// Each replace leaves the old text unused until compacted
+	std::string longer(100, 'x');
+	for (int n = 0; n < 5; n++) {
+		for (int i = 0; i < 100; i++)
+			store.Replace((size_t)i, longer + std::to_string(n * 100 + i));
+	}
+	bool bSame = true;
+	for (int i = 0; i < 100; i++) {
+		if (store.GetString((size_t)i) != longer + std::to_string(400 + i))
+			bSame = false;
+	}
+	CHECK(bSame);
+	store.Compact();
+	CHECK(store.GetString(99) == longer + "499");
+}
+
+TEST(Rows)
+{
+	ListWindow list(16, 100); // 6 whole rows and part of a 7th
+	CHECK(list.GetVisibleCount() == 7 && list.GetPageSize() == 6);
+	CHECK(list.IsVisible(16, 10) && !list.IsVisible(17, 10) && !list.IsVisible(9, 10));
+	CHECK(list.ScrollToShow(20, 10, 100) == 15);
+	CHECK(list.ScrollToShow(5, 10, 100) == 5);
+	CHECK(list.ScrollToShow(12, 10, 100) == 10);
+	CHECK(list.ClampTop(98, 100) == 94 && list.ClampTop(3, 4) == 0);
+	CHECK(list.ItemFromY(40, 10, 100) == 12);
+	CHECK(list.ItemFromY(-1, 10, 100) == -1 && list.ItemFromY(99, 95, 100) == -1);
+	ListWindow empty(0, 0);
+	CHECK(empty.GetPageSize() == 1 && empty.GetVisibleCount() == 0);
+}
+
+TEST(Batches)
+{
+	std::string data;
+	std::vector<size_t> offsets;
+	BuildItemBatch({ "A", "", "BC" }, data, offsets);
+	CHECK(data == "ABC" && offsets.size() == 4);
+	CHECK(offsets[1] == 1 && offsets[2] == 1 && offsets[3] == 3);
+	CHECK(CheckItemBatch(data.data(), offsets.data(), 3));
+	const size_t bad[3] = { 0, 2, 1 };
+	CHECK(!CheckItemBatch(data.data(), bad, 2));
+	CHECK(!CheckItemBatch(nullptr, offsets.data(), 3));
+	CHECK(CheckItemBatch(nullptr, nullptr, 0));
+
+	std::vector<uint16_t> wide;
+	std::vector<size_t> woffsets;
+	CHECK(Utf8ToUtf16(data.data(), offsets.data(), 3, wide, woffsets));
+	CHECK(wide.size() == 6 && woffsets[1] == 2 && woffsets[2] == 3);
+	CHECK(wide[0] == 'A' && wide[1] == 0 && wide[2] == 0 && wide[3] == 'B');
+	CHECK(!Utf8ToUtf16(data.data(), bad, 2, wide, woffsets));
+}
+
+static std::vector<uint16_t> Wide(const std::string &text)
+{
+	size_t offsets[2] = { 0, text.size() };
+	std::vector<uint16_t> wide;
+	std::vector<size_t> woffsets;
+	Utf8ToUtf16(text.data(), offsets, 1, wide, woffsets);
+	wide.pop_back(); // Null
+	return wide;
+}
+
+TEST(Utf8)
+{
+	CHECK(Wide("\xE2\x82\xAC") == std::vector<uint16_t>({ 0x20AC }));
+	CHECK(Wide("\xF0\x9F\x98\x80") == std::vector<uint16_t>({ 0xD83D, 0xDE00 }));
+	// Invalid sequences are replaced with U+FFFD
+	CHECK(Wide("\xC0\xAF") == std::vector<uint16_t>({ 0xFFFD, 0xFFFD })); // Overlong
+	CHECK(Wide("\xED\xA0\x80") == std::vector<uint16_t>({ 0xFFFD, 0xFFFD, 0xFFFD })); // Surrogate
+	CHECK(Wide("\xE2\x82") == std::vector<uint16_t>({ 0xFFFD, 0xFFFD })); // Truncated
+	CHECK(Wide("a\xFFz") == std::vector<uint16_t>({ 'a', 0xFFFD, 'z' }));
+}
+
+// 100k file names as in a media browser : append, replace, scroll
+// through the whole list a page at a time reading the visible rows,
+// and convert all items for the list control. The times are printed
+// for comparison between builds.
+TEST(ItemsBenchmark)
+{
+	const int count = 100000;
+	std::mt19937 rng(2031);
+	std::vector<std::string> names;
+	names.reserve(count);
+	for (int i = 0; i < count; i++)
+		names.push_back("clip_" + std::to_string(rng() % 100000) + "_take" + std::to_string(i) + ".mov");
+
+	auto start = std::chrono::steady_clock::now();
+	ItemStore store;
+	for (int i = 0; i < count; i++)
+		store.Append(names[i]);
+	double append = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	size_t text = 0;
+	for (int i = 0; i < count; i++)
+		text += names[i].size() + 1;
+	// One buffer, not a string for each item
+	CHECK(store.Size() == (size_t)count && store.GetBytes() < text * 2 + (size_t)count * 16);
+
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < count; i++) {
+		size_t k = rng() % count;
+		names[k] = (rng() % 2) ? "renamed_" + std::to_string(i) + ".mov" : "r" + std::to_string(i);
+		store.Replace(k, names[k]);
+	}
+	double replace = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	bool bSame = true;
+	for (int i = 0; i < count; i++) {
+		if (store.GetString(i) != names[i])
+			bSame = false;
+	}
+	CHECK(bSame);
+
+	// Scroll to the end a page at a time, drawing the visible rows
+	ListWindow window(16, 400);
+	size_t drawn = 0, bytes = 0;
+	int top = 0, pages = 0;
+	start = std::chrono::steady_clock::now();
+	for (;;) {
+		for (int row = 0; row < window.GetVisibleCount(); row++) {
+			int item = window.ItemFromY(row * 16, top, count);
+			if (item < 0)
+				break;
+			size_t len = 0;
+			store.Get(item, &len);
+			bytes += len;
+			drawn++;
+		}
+		pages++;
+		int next = window.ClampTop(top + window.GetPageSize(), count);
+		if (next == top)
+			break;
+		top = next;
+	}
+	double scroll = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	CHECK(top == count - window.GetPageSize() && drawn >= (size_t)count && bytes > 0);
+
+	std::string data;
+	std::vector<size_t> offsets;
+	std::vector<uint16_t> wide;
+	std::vector<size_t> woffsets;
+	start = std::chrono::steady_clock::now();
+	BuildItemBatch(names, data, offsets);
+	CHECK(Utf8ToUtf16(data.data(), offsets.data(), names.size(), wide, woffsets));
+	double convert = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	CHECK(woffsets.size() == (size_t)count);
+
+	printf("  %d items : append %.0f us, replace %.0f us, %d pages scrolled %.0f us, convert %.0f us, %zu KB\n",
+		count, append, replace, pages, scroll, convert, store.GetBytes() / 1024);
+}
+
+TEST_MAIN
@@ -0,0 +1,184 @@
+//
+// Automatic layout of controls (ofxWinDialogLayout.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogLayout.h"
+
+#include <vector>
+#include <chrono>
+
+static bool Is(const LayoutTree::placed &p, int id, int x, int y, int width, int height)
+{
+	return p.id == id && p.r.x == x && p.r.y == y && p.r.width == width && p.r.height == height;
+}
+
+TEST(AddChecks)
+{
+	LayoutTree tree;
+	CHECK(tree.Empty() && tree.Size() == 1);
+	int row = tree.AddBox(0, LayoutTree::Row);
+	int item = tree.AddItem(row, 1, 10, 10);
+	CHECK(row == 1 && item == 2 && !tree.Empty());
+	CHECK(tree.GetParent(item) == row && tree.GetLastChild(row) == item);
+	CHECK(tree.AddBox(99, LayoutTree::Row) == -1);
+	CHECK(tree.AddBox(0, LayoutTree::Item) == -1);
+	CHECK(tree.AddItem(item, 2, 10, 10) == -1); // Not a box
+	CHECK(tree.GetLastChild(item) == -1);
+	tree.Clear();
+	CHECK(tree.Empty() && tree.Size() == 1);
+}
+
+TEST(RowStretch)
+{
+	LayoutTree tree;
+	tree.SetMargin(10);
+	int row = tree.AddBox(0, LayoutTree::Row);
+	int a = tree.AddItem(row, 1, 50, 20);
+	int b = tree.AddItem(row, 2, 30, 10);
+	tree.SetStretch(b, 1.0f, 0.0f);
+	CHECK(tree.GetMinWidth() == 104 && tree.GetMinHeight() == 40);
+
+	std::vector<LayoutTree::placed> changed;
+	CHECK(tree.Arrange(0, 0, 200, 100, changed) == 2);
+	CHECK(Is(changed[0], 1, 10, 10, 50, 20));
+	// Fills the width left over, centered vertically
+	CHECK(Is(changed[1], 2, 64, 15, 126, 10));
+
+	// Nothing changed
+	CHECK(tree.Arrange(0, 0, 200, 100, changed) == 0 && tree.GetVisited() == 0);
+
+	tree.SetSize(a, 60, 20);
+	CHECK(tree.Arrange(0, 0, 200, 100, changed) == 2);
+	CHECK(Is(changed[0], 1, 10, 10, 60, 20));
+	CHECK(Is(changed[1], 2, 74, 15, 116, 10));
+	CHECK(tree.GetVisited() == 4);
+}
+
+TEST(PairLabelsLineUp)
+{
+	LayoutTree tree;
+	int p1 = tree.AddBox(0, LayoutTree::Pair);
+	tree.AddItem(p1, 10, 40, 10);
+	int c1 = tree.AddItem(p1, 11, 100, 20);
+	tree.SetStretch(c1, 1.0f, 0.0f);
+	int p2 = tree.AddBox(0, LayoutTree::Pair);
+	tree.AddItem(p2, 20, 70, 10);
+	tree.AddItem(p2, 21, 100, 20);
+
+	std::vector<LayoutTree::placed> changed;
+	CHECK(tree.Arrange(0, 0, 300, 100, changed) == 4);
+	CHECK(Is(changed[0], 10, 0, 5, 40, 10));
+	CHECK(Is(changed[1], 11, 74, 0, 226, 20));
+	CHECK(Is(changed[2], 20, 0, 25, 70, 10));
+	CHECK(Is(changed[3], 21, 74, 20, 100, 20));
+}
+
+TEST(GridCells)
+{
+	LayoutTree tree;
+	int grid = tree.AddBox(0, LayoutTree::Grid, 2, 2);
+	tree.AddItem(grid, 1, 10, 10);
+	tree.AddItem(grid, 2, 20, 5);
+	int c = tree.AddItem(grid, 3, 30, 8);
+	CHECK(tree.GetMinWidth() == 52 && tree.GetMinHeight() == 20);
+
+	// The cell factors stretch its column and row
+	tree.SetStretch(c, 1.0f, 1.0f);
+	std::vector<LayoutTree::placed> changed;
+	CHECK(tree.Arrange(0, 0, 100, 50, changed) == 3);
+	CHECK(Is(changed[0], 1, 0, 0, 10, 10));
+	CHECK(Is(changed[1], 2, 80, 2, 20, 5));
+	CHECK(Is(changed[2], 3, 0, 12, 78, 38));
+}
+
+TEST(ShareWithoutDrift)
+{
+	LayoutTree tree;
+	int row = tree.AddBox(0, LayoutTree::Row, 0);
+	for (int i = 0; i < 3; i++)
+		tree.SetStretch(tree.AddItem(row, i, 0, 10), 1.0f, 0.0f);
+	std::vector<LayoutTree::placed> changed;
+	CHECK(tree.Arrange(0, 0, 10, 10, changed) == 3);
+	CHECK(changed[0].r.width == 3 && changed[1].r.width == 4 && changed[2].r.width == 3);
+	CHECK(changed[2].r.x + changed[2].r.width == 10);
+}
+
+// A change in one row does not arrange the other row again
+TEST(UnchangedSubtreeSkipped)
+{
+	LayoutTree tree;
+	int row1 = tree.AddBox(0, LayoutTree::Row);
+	tree.AddItem(row1, 1, 50, 20);
+	int row2 = tree.AddBox(0, LayoutTree::Row);
+	int b = tree.AddItem(row2, 2, 50, 20);
+
+	std::vector<LayoutTree::placed> changed;
+	CHECK(tree.Arrange(0, 0, 100, 100, changed) == 2);
+	tree.SetSize(b, 60, 20);
+	CHECK(tree.Arrange(0, 0, 100, 100, changed) == 1);
+	CHECK(Is(changed[0], 2, 0, 20, 60, 20));
+	CHECK(tree.GetVisited() == 3);
+
+	// Everything again
+	tree.Invalidate();
+	CHECK(tree.Arrange(0, 0, 100, 100, changed) == 2);
+	CHECK(tree.GetVisited() == 5);
+}
+
+// 5000 controls : 625 rows of four label and control pairs. Times a
+// full arrange, a resize of the dialog and a change to one control,
+// which arranges only the boxes above the control and its row.
+TEST(FiveThousandControls)
+{
+	LayoutTree tree;
+	tree.SetMargin(8);
+	std::vector<int> controls;
+	int id = 0;
+	for (int r = 0; r < 625; r++) {
+		int row = tree.AddBox(0, LayoutTree::Row);
+		for (int p = 0; p < 4; p++) {
+			int pair = tree.AddBox(row, LayoutTree::Pair);
+			tree.AddItem(pair, id++, 40 + (r * 7 + p * 13) % 30, 20);
+			int c = tree.AddItem(pair, id++, 80, 20);
+			tree.SetStretch(c, 1.0f, 0.0f);
+			controls.push_back(c);
+		}
+	}
+	const size_t nodes = tree.Size();
+	std::vector<LayoutTree::placed> changed;
+
+	auto start = std::chrono::steady_clock::now();
+	size_t first = tree.Arrange(0, 0, 1600, 20000, changed);
+	double full = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	CHECK(first == 5000 && tree.GetVisited() == nodes);
+
+	// Wider - every control with a stretch factor moves or grows
+	start = std::chrono::steady_clock::now();
+	size_t resized = tree.Arrange(0, 0, 1800, 20000, changed);
+	double resize = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	CHECK(resized >= 2500);
+
+	// One control higher - the rows from its row to the end move
+	tree.SetSize(controls[2000], 80, 30);
+	start = std::chrono::steady_clock::now();
+	size_t moved = tree.Arrange(0, 0, 1800, 20000, changed);
+	double one = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	CHECK(moved == 125 * 8);
+
+	// One control wider - only its row is arranged
+	tree.SetSize(controls[100], 90, 20);
+	start = std::chrono::steady_clock::now();
+	size_t local = tree.Arrange(0, 0, 1800, 20000, changed);
+	double incremental = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	CHECK(local <= 8 && tree.GetVisited() <= 2 + 4 * 3);
+
+	// Nothing changed
+	start = std::chrono::steady_clock::now();
+	CHECK(tree.Arrange(0, 0, 1800, 20000, changed) == 0 && tree.GetVisited() == 0);
+	double none = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+	printf("  5000 controls : arrange %.0f us, resize %.0f us (%zu moved), one row higher %.0f us (%zu moved), "
+		"one control wider %.0f us (%zu moved), unchanged %.0f us\n", full, resize, resized, one, moved, incremental, local, none);
+}
+
+TEST_MAIN
@@ -0,0 +1,199 @@
+//
+// OSC messages, packets, addresses and the send rate limit
+// (ofxWinDialogOsc.h) with a loopback UDP socket
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogOsc.h"
+
+#include <string>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+TEST(Arguments)
+{
+	OscMessage msg;
+	CHECK(msg.Int(7) == 7 && msg.Float(0.5f) == 0.5f && msg.Text() == "");
+	msg.AddFloat(63.6f);
+	CHECK(msg.Int() == 64 && msg.Float() == 63.6f);
+	OscMessage neg;
+	neg.AddFloat(-1.5f);
+	CHECK(neg.Int() == -2);
+	OscMessage text;
+	text.AddString("on");
+	CHECK(text.Int(3) == 3 && text.Float(1.0f) == 1.0f && text.Text() == "on");
+	OscMessage num;
+	num.AddInt(12);
+	CHECK(num.Float() == 12.0f && num.Text() == "12");
+}
+
+TEST(EncodeDecode)
+{
+	OscMessage msg;
+	msg.address = "/Line_width";
+	msg.AddInt(-3);
+	msg.AddFloat(0.25f);
+	msg.AddString("abcd"); // Padded with a full word
+	std::vector<uint8_t> packet;
+	OscPacket::Encode(msg, packet);
+	CHECK(packet.size() == 12 + 8 + 4 + 4 + 8);
+	CHECK((packet.size() & 3) == 0);
+
+	std::vector<OscMessage> messages;
+	CHECK(OscPacket::Decode(packet.data(), packet.size(), messages) == 1);
+	CHECK(messages[0].address == "/Line_width" && messages[0].args.size() == 3);
+	CHECK(messages[0].args[0].i == -3 && messages[0].args[1].f == 0.25f && messages[0].args[2].s == "abcd");
+
+	// Not valid - the messages already in the vector are kept
+	CHECK(OscPacket::Decode(packet.data(), packet.size() - 4, messages) == 0);
+	CHECK(OscPacket::Decode(packet.data(), 3, messages) == 0);
+	std::vector<uint8_t> noslash(packet);
+	noslash[0] = 'x';
+	CHECK(OscPacket::Decode(noslash.data(), noslash.size(), messages) == 0);
+	CHECK(messages.size() == 1);
+}
+
+// Bundle with a time tag and elements with a size each
+static void AddBundle(std::vector<uint8_t> &bundle, const std::vector<std::vector<uint8_t>> &parts)
+{
+	const char head[16] = { '#', 'b', 'u', 'n', 'd', 'l', 'e', 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+	bundle.assign(head, head + 16);
+	for (size_t k = 0; k < parts.size(); k++) {
+		uint32_t size = (uint32_t)parts[k].size();
+		bundle.push_back((uint8_t)(size >> 24));
+		bundle.push_back((uint8_t)(size >> 16));
+		bundle.push_back((uint8_t)(size >> 8));
+		bundle.push_back((uint8_t)size);
+		bundle.insert(bundle.end(), parts[k].begin(), parts[k].end());
+	}
+}
+
+TEST(Bundles)
+{
+	OscMessage a, b;
+	a.address = "/a";
+	a.AddInt(1);
+	b.address = "/b";
+	b.AddFloat(2.0f);
+	std::vector<uint8_t> pa, pb, inner, outer;
+	OscPacket::Encode(a, pa);
+	OscPacket::Encode(b, pb);
+	AddBundle(inner, { pb });
+	AddBundle(outer, { pa, inner });
+	std::vector<OscMessage> messages;
+	CHECK(OscPacket::Decode(outer.data(), outer.size(), messages) == 2);
+	CHECK(messages[0].address == "/a" && messages[1].address == "/b");
+
+	// An element larger than the bundle
+	outer[19] = 0xff;
+	CHECK(OscPacket::Decode(outer.data(), outer.size(), messages) == 0);
+	CHECK(messages.size() == 2);
+
+	// True and false have no data
+	const uint8_t tf[8] = { '/', 't', 0, 0, ',', 'T', 'F', 0 };
+	CHECK(OscPacket::Decode(tf, sizeof(tf), messages) == 1);
+	CHECK(messages.back().args.size() == 2 && messages.back().Int() == 1 && messages.back().args[1].i == 0);
+}
+
+TEST(Addresses)
+{
+	CHECK(OscAddress("", "Line width") == "/Line_width");
+	CHECK(OscAddress("scene", "Red") == "/scene/Red");
+	CHECK(OscAddress("", "Mode [1]*") == "/Mode_1");
+	CHECK(OscAddress("", "/Path//Name") == "/Path/Name");
+}
+
+TEST(RateLimit)
+{
+	OscRateLimit limit;
+	limit.SetInterval(20);
+	OscMessage msg;
+	msg.address = "/Red";
+	msg.AddFloat(0.1f);
+	CHECK(limit.Offer(msg, 1000)); // First is sent
+	msg.args[0].f = 0.2f;
+	CHECK(!limit.Offer(msg, 1005));
+	msg.args[0].f = 0.3f;
+	CHECK(!limit.Offer(msg, 1010));
+	CHECK(limit.Pending() == 1);
+	std::vector<OscMessage> due;
+	CHECK(limit.Due(1015, due) == 0);
+	// The last value is sent when the interval has passed
+	CHECK(limit.Due(1020, due) == 1 && due[0].Float() == 0.3f);
+	CHECK(limit.Pending() == 0);
+	// A message sent now replaces the one waiting
+	CHECK(!limit.Offer(msg, 1030));
+	CHECK(limit.Offer(msg, 1045) && limit.Pending() == 0);
+	// Other addresses are not limited
+	OscMessage other;
+	other.address = "/Green";
+	CHECK(limit.Offer(other, 1046));
+}
+
+#ifndef _WIN32
+
+// Packets from a local sender are received as sent
+TEST(Loopback)
+{
+	int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+	int sender = socket(AF_INET, SOCK_DGRAM, 0);
+	CHECK(receiver >= 0 && sender >= 0);
+	if (receiver < 0 || sender < 0)
+		return;
+	sockaddr_in addr{};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0; // Any free port
+	socklen_t len = sizeof(addr);
+	bool bBound = bind(receiver, (sockaddr*)&addr, sizeof(addr)) == 0
+		&& getsockname(receiver, (sockaddr*)&addr, &len) == 0;
+	CHECK(bBound);
+	timeval timeout{};
+	timeout.tv_sec = 5;
+	setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	// A slider drag sent as a message and a bundle
+	std::vector<std::vector<uint8_t>> packets;
+	for (int k = 0; k < 4; k++) {
+		OscMessage msg;
+		msg.address = OscAddress("scene", "Line width");
+		msg.AddFloat(0.25f * (float)k);
+		std::vector<uint8_t> packet;
+		OscPacket::Encode(msg, packet);
+		packets.push_back(packet);
+	}
+	std::vector<uint8_t> bundle;
+	AddBundle(bundle, { packets[1], packets[2] });
+
+	std::vector<OscMessage> messages;
+	if (bBound) {
+		sendto(sender, packets[0].data(), packets[0].size(), 0, (sockaddr*)&addr, sizeof(addr));
+		sendto(sender, bundle.data(), bundle.size(), 0, (sockaddr*)&addr, sizeof(addr));
+		sendto(sender, packets[3].data(), packets[3].size(), 0, (sockaddr*)&addr, sizeof(addr));
+		uint8_t data[1536];
+		for (int n = 0; n < 3; n++) {
+			ssize_t size = recv(receiver, data, sizeof(data), 0);
+			if (size <= 0)
+				break;
+			OscPacket::Decode(data, (size_t)size, messages);
+		}
+	}
+	CHECK(messages.size() == 4);
+	bool bSame = true;
+	for (size_t k = 0; k < messages.size(); k++) {
+		if (messages[k].address != "/scene/Line_width" || messages[k].Float() != 0.25f * (float)k)
+			bSame = false;
+	}
+	CHECK(bSame);
+	close(sender);
+	close(receiver);
+}
+
+#endif
+
+TEST_MAIN
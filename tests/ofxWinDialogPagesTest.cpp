@@ -0,0 +1,86 @@
+//
+// Pages of controls (ofxWinDialogPages.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogPages.h"
+
+#include <vector>
+
+TEST(AddAndFind)
+{
+	PageSet pages;
+	CHECK(pages.Empty() && pages.GetCurrent() == -1);
+	CHECK(pages.Add("Colour") == 0);
+	CHECK(pages.Add("Size") == 1);
+	CHECK(pages.Add("Colour") == 0); // Existing page
+	CHECK(pages.Size() == 2 && pages.GetCurrent() == 0);
+	CHECK(pages.Find("Size") == 1 && pages.Find("None") == -1);
+	pages.AddControl(1, 4);
+	pages.AddControl(1, 5);
+	pages.AddControl(7, 6); // Not a page
+	CHECK(pages.GetControls(1).size() == 2 && pages.GetControls(1)[1] == 5);
+	CHECK(pages.GetControls(7).empty() && pages.GetName(7).empty());
+	CHECK(pages.GetName(1) == "Size");
+	// Controls not on a page are always shown
+	CHECK(pages.IsShown(-1) && pages.IsShown(0) && !pages.IsShown(1));
+}
+
+TEST(ShowCreatesOnce)
+{
+	PageSet pages;
+	pages.Add("A");
+	pages.Add("B");
+	PageSet::change c = pages.Show(0);
+	CHECK(c.bCreate && c.hide == -1 && c.destroy.empty());
+	c = pages.Show(1);
+	CHECK(c.bCreate && c.hide == 0 && pages.GetCurrent() == 1);
+	c = pages.Show(0);
+	CHECK(!c.bCreate && c.hide == 1);
+	CHECK(pages.IsCreated(0) && pages.IsCreated(1));
+	c = pages.Show(5); // Not a page
+	CHECK(!c.bCreate && c.hide == -1 && pages.GetCurrent() == 0);
+	CHECK(pages.GetCreations() == 2 && pages.GetEvictions() == 0);
+	// Windows destroyed with the dialog
+	pages.Reset();
+	CHECK(!pages.IsCreated(0) && pages.Show(0).bCreate);
+}
+
+TEST(LeastRecentlyShownDestroyed)
+{
+	PageSet pages;
+	for (const char* name : { "A", "B", "C", "D" })
+		pages.Add(name);
+	pages.SetMaxCreated(2);
+	pages.Show(0);
+	pages.Show(1);
+	pages.Show(0);
+	PageSet::change c = pages.Show(2);
+	// B was shown least recently
+	CHECK(c.bCreate && c.destroy.size() == 1 && c.destroy[0] == 1);
+	CHECK(pages.IsCreated(0) && !pages.IsCreated(1) && pages.IsCreated(2));
+	c = pages.Show(3);
+	CHECK(c.destroy.size() == 1 && c.destroy[0] == 0 && c.hide == 2);
+	CHECK(pages.GetCreations() == 4 && pages.GetEvictions() == 2);
+	// The current page is never destroyed
+	pages.SetMaxCreated(1);
+	c = pages.Show(3);
+	CHECK(!c.bCreate && c.destroy.size() == 1 && c.destroy[0] == 2);
+	CHECK(pages.IsCreated(3) && pages.GetMaxCreated() == 1);
+	pages.SetMaxCreated(-1);
+	CHECK(pages.GetMaxCreated() == 0);
+}
+
+TEST(SetCurrentBeforeOpen)
+{
+	PageSet pages;
+	pages.Add("A");
+	pages.Add("B");
+	pages.SetCurrent(1);
+	pages.SetCurrent(9);
+	CHECK(pages.GetCurrent() == 1 && !pages.IsCreated(1));
+	// The first show creates the current page and hides nothing
+	PageSet::change c = pages.Show(pages.GetCurrent());
+	CHECK(c.bCreate && c.hide == -1);
+}
+
+TEST_MAIN
@@ -0,0 +1,78 @@
+//
+// Dirty rectangles and back buffer sizing (ofxWinDialogPaint.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogPaint.h"
+
+TEST(Rects)
+{
+	PaintRect a, b;
+	a.right = 10; a.bottom = 10;
+	b.left = 10; b.right = 20; b.bottom = 10;
+	CHECK(!a.Intersects(b) && a.Touches(b));
+	CHECK(a.Area() == 100 && a.Union(b).Area() == 200);
+	PaintRect e;
+	CHECK(e.IsEmpty() && e.Area() == 0);
+}
+
+TEST(Merge)
+{
+	DirtyRegion region;
+	// Touching - merged with no added area
+	region.Add(0, 0, 10, 10);
+	region.Add(10, 0, 20, 10);
+	CHECK(region.GetRects().size() == 1 && region.GetRects()[0].right == 20);
+	// Far apart - kept separate
+	region.Add(100, 100, 110, 110);
+	CHECK(region.GetRects().size() == 2);
+	// Touching at a corner - the union would add too much area
+	region.Add(110, 110, 120, 120);
+	CHECK(region.GetRects().size() == 3);
+	// Merged with the first rectangle, as is a rectangle within it
+	region.Add(0, 10, 20, 20);
+	CHECK(region.GetRects().size() == 3);
+	region.Add(5, 5, 15, 15);
+	region.Add(0, 0, 0, 5); // Empty
+	CHECK(region.GetRects().size() == 3);
+	region.Clear();
+	CHECK(region.IsEmpty());
+}
+
+TEST(MaxRects)
+{
+	DirtyRegion region(4);
+	for (int i = 0; i < 5; i++)
+		region.Add(i * 100, 0, i * 100 + 10, 10);
+	CHECK(region.GetRects().size() == 1);
+	const PaintRect &r = region.GetRects()[0];
+	CHECK(r.left == 0 && r.right == 410 && r.bottom == 10);
+}
+
+TEST(Clip)
+{
+	DirtyRegion region;
+	region.Add(-10, -10, 20, 20);
+	region.Add(500, 500, 600, 600);
+	region.Clip(100, 100);
+	CHECK(region.GetRects().size() == 1);
+	const PaintRect &r = region.GetRects()[0];
+	CHECK(r.left == 0 && r.top == 0 && r.right == 20 && r.bottom == 20);
+}
+
+TEST(BackBuffer)
+{
+	BackBufferSize size(128);
+	CHECK(size.Resize(300, 200));
+	CHECK(size.GetBufferWidth() == 384 && size.GetBufferHeight() == 256);
+	// Resizing within the buffer does not allocate
+	CHECK(!size.Resize(380, 250) && !size.Resize(200, 130));
+	CHECK(size.GetWidth() == 200 && size.GetAllocations() == 1);
+	CHECK(size.Resize(385, 250) && size.GetBufferWidth() == 512);
+	// Much smaller - reduced
+	CHECK(size.Resize(100, 100) && size.GetBufferWidth() == 128);
+	size.Reset();
+	CHECK(size.Resize(100, 100) && size.GetAllocations() == 4);
+	CHECK(size.Resize(0, -5) == false && size.GetWidth() == 1);
+}
+
+TEST_MAIN
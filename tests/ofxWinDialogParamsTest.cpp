@@ -0,0 +1,190 @@
+//
+// Shared parameter store (ofxWinDialogParams.h) and the fan-out
+// of changes to bound controls
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogParams.h"
+#include "ofxWinDialogThread.h"
+#include "ofxWinDialogBench.h"
+
+#include <thread>
+#include <atomic>
+#include <string>
+
+TEST(Entries)
+{
+	ParamStore store;
+	bool bCreated = false;
+	int a = store.Add("Count", ParamStore::Int, 2.6, "", &bCreated);
+	CHECK(a == 0 && bCreated);
+	CHECK(store.Add("Count", ParamStore::Float, 9.0, "", &bCreated) == a && !bCreated);
+	CHECK(store.GetNumber(a) == 3.0); // Rounded
+	int t = store.Add("Name", ParamStore::Text, 0.0, "Line");
+	CHECK(store.Find("Name") == t && store.Find("Other") == -1);
+	CHECK(store.GetText(t) == "Line" && store.GetType(t) == ParamStore::Text);
+	CHECK(store.SetText(t, "12.5"));
+	CHECK(store.GetNumber(t) == 12.5);
+	CHECK(!store.SetText(t, "12.5")); // Not changed
+	CHECK(store.GetVersion(t) == 2);
+	// Text truncated to MaxText
+	CHECK(store.SetText(t, std::string(300, 'x')));
+	CHECK(store.GetText(t).size() == ParamStore::MaxText);
+	CHECK(store.Size() == 2 && store.GetKey(a) == "Count");
+	CHECK(store.GetNumber(5) == 0.0 && !store.SetNumber(5, 1.0));
+}
+
+TEST(Subscribers)
+{
+	ParamStore store;
+	int id = store.Add("Red", ParamStore::Float, 0.5);
+	std::vector<ParamStore::change> seen;
+	int s = store.Subscribe([&seen](const std::vector<ParamStore::change> &c) {
+		seen.insert(seen.end(), c.begin(), c.end());
+	});
+	int b1 = store.Bind(id, s, 10);
+	int b2 = store.Bind(id, s, 11);
+	CHECK(b1 >= 0 && b2 >= 0 && store.Bind(id, 5, 0) == -1);
+
+	// Not passed back to the source
+	CHECK(store.SetNumber(id, 0.75, b1));
+	CHECK(seen.size() == 1 && seen[0].tag == 11 && seen[0].number == 0.75);
+	// Not passed on if not changed
+	seen.clear();
+	CHECK(!store.SetNumber(id, 0.75));
+	CHECK(seen.empty());
+
+	// Passed on together by EndBatch
+	store.BeginBatch();
+	store.SetNumber(id, 0.1);
+	store.SetNumber(id, 0.2);
+	CHECK(seen.empty());
+	store.EndBatch();
+	CHECK(seen.size() == 4);
+
+	store.Unbind(b2);
+	seen.clear();
+	store.SetNumber(id, 0.3);
+	CHECK(seen.size() == 1 && seen[0].tag == 10);
+	store.Unsubscribe(s);
+	seen.clear();
+	store.SetNumber(id, 0.4);
+	CHECK(seen.empty());
+}
+
+// A subscriber that changes the store is not called again until it returns
+TEST(ChangeFromSubscriber)
+{
+	ParamStore store;
+	int a = store.Add("A", ParamStore::Int);
+	int b = store.Add("B", ParamStore::Int);
+	int depth = 0, maxdepth = 0, calls = 0;
+	int s = -1;
+	s = store.Subscribe([&](const std::vector<ParamStore::change> &c) {
+		depth++;
+		calls++;
+		if (depth > maxdepth)
+			maxdepth = depth;
+		for (size_t k = 0; k < c.size(); k++) {
+			if (c[k].id == a)
+				store.SetNumber(b, c[k].number);
+		}
+		depth--;
+	});
+	store.Bind(a, s, 0);
+	store.Bind(b, s, 1);
+	store.SetNumber(a, 4.0);
+	CHECK(maxdepth == 1 && calls == 2);
+	CHECK(store.GetNumber(b) == 4.0);
+}
+
+// Changes by other threads are queued for the thread that owns the
+// controls and applied in batches with the last value of each binding,
+// as by ofxWinDialog::ParamsChanged and ApplyParams
+TEST(OwnerThreadMarshal)
+{
+	ParamStore store;
+	const int bindings = 16;
+	const int writers = 4;
+	const int sets = 5000;
+	int id = store.Add("Shared", ParamStore::Int);
+	std::thread::id owner = std::this_thread::get_id();
+	CommandQueue<ParamStore::change> queue;
+	std::atomic<int> foreign{ 0 };
+	int s = store.Subscribe([&](const std::vector<ParamStore::change> &c) {
+		if (std::this_thread::get_id() != owner)
+			foreign++;
+		for (size_t k = 0; k < c.size(); k++)
+			queue.Push(c[k]);
+	});
+	for (int b = 0; b < bindings; b++)
+		store.Bind(id, s, b);
+
+	std::atomic<int> done{ 0 };
+	std::vector<std::thread> threads;
+	for (int w = 0; w < writers; w++) {
+		threads.push_back(std::thread([&, w]() {
+			for (int i = 1; i <= sets; i++)
+				store.SetNumber(id, (double)(w * sets + i));
+			done++;
+		}));
+	}
+
+	// The owning thread applies the changes to its controls
+	std::vector<double> controls(bindings, 0.0);
+	std::vector<ParamStore::change> batch;
+	CommandCollapse collapse;
+	bool bValid = true;
+	for (;;) {
+		bool bDone = done.load() == writers;
+		if (queue.Drain(batch) > 0) {
+			collapse.Apply(batch, [](const ParamStore::change &c) { return std::to_string(c.tag); });
+			for (size_t k = 0; k < batch.size(); k++) {
+				if (batch[k].tag < 0 || batch[k].tag >= bindings)
+					bValid = false;
+				else
+					controls[(size_t)batch[k].tag] = batch[k].number;
+			}
+		}
+		else if (bDone) {
+			break;
+		}
+	}
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+
+	CHECK(bValid);
+	CHECK(foreign.load() > 0);
+	// Every control has the last value of the store
+	double last = store.GetNumber(id);
+	for (int b = 0; b < bindings; b++)
+		CHECK(controls[(size_t)b] == last);
+}
+
+// Time for a change to reach all bound controls
+TEST(FanOutBenchmark)
+{
+	BenchResults results;
+	const int counts[4] = { 1, 16, 64, 256 };
+	for (int n = 0; n < 4; n++) {
+		ParamStore store;
+		int id = store.Add("fanout", ParamStore::Float);
+		size_t changes = 0;
+		int s = store.Subscribe([&changes](const std::vector<ParamStore::change> &c) { changes += c.size(); });
+		for (int b = 0; b < counts[n]; b++)
+			store.Bind(id, s, b);
+		double value = 0.0;
+		results.Run("fanout" + std::to_string(counts[n]), 20, (size_t)(100 * counts[n]), [&store, id, &value]() {
+			for (int k = 0; k < 100; k++)
+				store.SetNumber(id, value += 1.0);
+		});
+		// One untimed run and 20 timed runs
+		CHECK(changes == (size_t)21 * 100 * counts[n]);
+	}
+	for (size_t i = 0; i < results.Size(); i++) {
+		const BenchResults::result &r = results.GetResults()[i];
+		printf("  %-10s median %8.4f msec  %7.1f ns/control\n", r.name.c_str(), r.median,
+			r.median * 1e6 / (double)r.ops);
+	}
+}
+
+TEST_MAIN
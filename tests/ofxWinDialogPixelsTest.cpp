@@ -0,0 +1,65 @@
+//
+// Pixel copy and conversion for picture buttons
+// (ofxWinDialogPixels.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogPixels.h"
+
+#include <vector>
+
+TEST(Pitch)
+{
+	CHECK(DibPitch(1) == 4);
+	CHECK(DibPitch(4) == 12);
+	CHECK(DibPitch(5) == 16);
+}
+
+// 2 x 2 RGBA image : row 0 red, green - row 1 blue, white
+static const unsigned char rgba[16] = {
+	255, 0, 0, 9,  0, 255, 0, 9,
+	0, 0, 255, 9,  255, 255, 255, 9 };
+
+TEST(RgbaToBgr)
+{
+	int pitch = DibPitch(2);
+	std::vector<unsigned char> dib((size_t)pitch * 2, 0xAA);
+	CHECK(CopyPixelsToDib(dib.data(), pitch, rgba, 2, 2, 4, false, false));
+	// Red and green in BGR order, alpha ignored
+	CHECK(dib[0] == 0 && dib[1] == 0 && dib[2] == 255);
+	CHECK(dib[3] == 0 && dib[4] == 255 && dib[5] == 0);
+	// Row padding is not written
+	CHECK(dib[6] == 0xAA && dib[7] == 0xAA);
+	CHECK(dib[8] == 255 && dib[9] == 0 && dib[10] == 0);
+}
+
+TEST(Flip)
+{
+	int pitch = DibPitch(2);
+	std::vector<unsigned char> dib((size_t)pitch * 2, 0);
+	CHECK(CopyPixelsToDib(dib.data(), pitch, rgba, 2, 2, 4, true, false));
+	// First DIB row is the last image row
+	CHECK(dib[0] == 255 && dib[1] == 0 && dib[2] == 0); // Blue
+	CHECK(dib[pitch + 2] == 255 && dib[pitch + 0] == 0); // Red
+}
+
+TEST(SameOrder)
+{
+	const unsigned char bgr[6] = { 1, 2, 3, 4, 5, 6 };
+	unsigned char dib[8]{};
+	CHECK(CopyPixelsToDib(dib, DibPitch(2), bgr, 2, 1, 3, false, true));
+	CHECK(dib[0] == 1 && dib[2] == 3 && dib[5] == 6);
+	CHECK(CopyPixelsToDib(dib, DibPitch(2), rgba, 2, 1, 4, false, true));
+	CHECK(dib[0] == 255 && dib[1] == 0 && dib[4] == 255);
+}
+
+TEST(NotValid)
+{
+	unsigned char dib[16]{};
+	CHECK(!CopyPixelsToDib(nullptr, 8, rgba, 2, 2, 4, false, false));
+	CHECK(!CopyPixelsToDib(dib, 8, nullptr, 2, 2, 4, false, false));
+	CHECK(!CopyPixelsToDib(dib, 8, rgba, 0, 2, 4, false, false));
+	CHECK(!CopyPixelsToDib(dib, 8, rgba, 2, 2, 2, false, false));
+	CHECK(!CopyPixelsToDib(dib, 5, rgba, 2, 2, 4, false, false)); // Pitch too small
+}
+
+TEST_MAIN
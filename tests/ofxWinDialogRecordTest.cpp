@@ -0,0 +1,105 @@
+//
+// Binary trace of dialog events (ofxWinDialogRecord.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogRecord.h"
+
+#include <string>
+#include <climits>
+
+TEST(RoundTrip)
+{
+	EventTrace trace;
+	trace.Add(100, EventTrace::Event, "Red", "", 29);
+	trace.Add(150, EventTrace::SetSlider, "Red", "", 0, 0.29f);
+	trace.Add(2000000, EventTrace::SetEdit, "Name", "Text \xC3\xA9", 0);
+	trace.Add(2000010, EventTrace::SetSpin, "Count", "", -5);
+	trace.Add(2000020, EventTrace::SetSpin, "Count", "", INT_MIN);
+	trace.Add(2000030, EventTrace::SetListItem, "", "", INT_MAX);
+	std::string bytes;
+	trace.Write(bytes);
+	CHECK(bytes.compare(0, 4, "WDTR") == 0);
+
+	EventTrace read;
+	CHECK(read.Read(bytes) && read.Size() == trace.Size());
+	bool bSame = true;
+	for (size_t i = 0; i < trace.Size(); i++) {
+		const EventTrace::event &a = trace.GetEvents()[i];
+		const EventTrace::event &b = read.GetEvents()[i];
+		if (a.time != b.time || a.op != b.op || a.title != b.title
+			|| a.text != b.text || a.value != b.value || a.fvalue != b.fvalue)
+			bSame = false;
+	}
+	CHECK(bSame);
+}
+
+TEST(CompactRecords)
+{
+	EventTrace trace;
+	trace.Add(10, EventTrace::Event, "Red", "", 29);
+	std::string first;
+	trace.Write(first);
+	trace.Add(20, EventTrace::Event, "Red", "", -30);
+	std::string bytes;
+	trace.Write(bytes);
+	// Title written once, small negative values in one byte
+	CHECK(bytes.size() - first.size() == 5);
+	trace.Add(30, EventTrace::SetSlider, "Red", "", 0, 0.5f);
+	std::string slider;
+	trace.Write(slider);
+	CHECK(slider.size() - bytes.size() == 9);
+}
+
+TEST(TimesNeverGoBack)
+{
+	EventTrace trace;
+	trace.Add(500, EventTrace::Event, "A", "", 1);
+	trace.Add(400, EventTrace::Event, "A", "", 2);
+	std::string bytes;
+	trace.Write(bytes);
+	EventTrace read;
+	CHECK(read.Read(bytes) && read.GetEvents()[1].time == 500);
+}
+
+TEST(BadTraces)
+{
+	EventTrace trace;
+	trace.Add(100, EventTrace::SetEdit, "Name", "Text", 0);
+	trace.Add(200, EventTrace::SetSlider, "Red", "", 0, 0.5f);
+	std::string bytes;
+	trace.Write(bytes);
+	EventTrace read;
+	CHECK(read.Read(bytes.data(), 5) && read.Size() == 0);
+	// Cut inside the last record
+	CHECK(!read.Read(bytes.data(), bytes.size() - 1) && read.Size() == 0);
+	std::string bad = bytes;
+	bad[0] = 'X';
+	CHECK(!read.Read(bad));
+	bad = bytes;
+	bad[4] = 2; // Version
+	CHECK(!read.Read(bad));
+	bad = bytes;
+	bad[6] = (char)EventTrace::OpCount;
+	CHECK(!read.Read(bad));
+	bad = bytes;
+	bad[7] = 3; // Title not read yet
+	CHECK(!read.Read(bad));
+	CHECK(!read.Read("WDT", 3));
+}
+
+TEST(NextDelay)
+{
+	EventTrace trace;
+	trace.Add(1000, EventTrace::Event, "A", "", 0);
+	trace.Add(3000, EventTrace::Event, "A", "", 0);
+	trace.Add(3000, EventTrace::Event, "A", "", 0);
+	CHECK(trace.NextDelay(0, 1.0) == 1000);
+	CHECK(trace.NextDelay(1, 1.0) == 2000);
+	CHECK(trace.NextDelay(1, 2.0) == 1000);
+	CHECK(trace.NextDelay(2, 1.0) == 0);
+	// As fast as possible
+	CHECK(trace.NextDelay(1, 0.0) == 0);
+	CHECK(trace.NextDelay(5, 1.0) == 0);
+}
+
+TEST_MAIN
@@ -0,0 +1,179 @@
+//
+// Search index for combo and list box items (ofxWinDialogSearch.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogSearch.h"
+
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+
+TEST(Find)
+{
+	ItemIndex index;
+	index.Build({ "Banana", "apple", "Cherry", "Apple", "apricot" });
+	CHECK(index.Find("APPLE") == 1); // Lowest of equal items
+	CHECK(index.Find("cherry") == 2 && index.Find("grape") == -1);
+	std::vector<uint32_t> items;
+	CHECK(index.FindPrefix("Ap", items) == 3);
+	CHECK(items[0] == 1 && items[1] == 3 && items[2] == 4);
+	CHECK(index.FindPrefix("", items) == 5);
+	CHECK(index.FindContains("an", items) == 1 && items[0] == 0);
+	CHECK(index.Matches(2, "CH", false) && !index.Matches(2, "err", false));
+	CHECK(index.Matches(2, "ERR", true) && !index.Matches(9, "a", true));
+}
+
+TEST(Update)
+{
+	ItemIndex index(true);
+	index.Build({ "Red", "Green" });
+	index.Append("Blue");
+	CHECK(index.Find("blue") == 2 && index.Size() == 3);
+	CHECK(index.Replace(0, "Greenish"));
+	CHECK(index.Find("red") == -1);
+	std::vector<uint32_t> items;
+	CHECK(index.FindContains("reen", items) == 2 && items[0] == 0 && items[1] == 1);
+	CHECK(index.FindContains("red", items) == 0);
+	CHECK(!index.Replace(5, "x"));
+	// Trigrams present but not in order
+	index.Append("abcxbcd");
+	CHECK(index.FindContains("abcd", items) == 0);
+	CHECK(index.HasNgrams());
+}
+
+// The index gives the same results as a scan of the items
+TEST(RandomAgainstScan)
+{
+	std::mt19937 rng(7);
+	const char letters[] = "abAB";
+	auto word = [&]() {
+		std::string w;
+		size_t len = 1 + rng() % 6;
+		for (size_t i = 0; i < len; i++)
+			w += letters[rng() % 4];
+		return w;
+	};
+	for (int mode = 0; mode < 2; mode++) {
+		ItemIndex index(mode == 1);
+		std::vector<std::string> items;
+		for (int i = 0; i < 200; i++)
+			items.push_back(word());
+		index.Build(items);
+		bool bSame = true;
+		for (int n = 0; n < 500; n++) {
+			int op = (int)(rng() % 3);
+			if (op == 0) {
+				items.push_back(word());
+				index.Append(items.back());
+			}
+			else if (op == 1) {
+				size_t k = rng() % items.size();
+				items[k] = word();
+				index.Replace(k, items[k]);
+			}
+			std::string query = word();
+			std::string key = ItemIndex::Fold(query);
+			std::vector<uint32_t> prefix, contains, p, c;
+			int first = -1;
+			for (size_t i = 0; i < items.size(); i++) {
+				std::string folded = ItemIndex::Fold(items[i]);
+				if (folded.compare(0, key.size(), key) == 0)
+					p.push_back((uint32_t)i);
+				if (folded.find(key) != std::string::npos)
+					c.push_back((uint32_t)i);
+				if (first < 0 && folded == key)
+					first = (int)i;
+			}
+			index.FindPrefix(query, prefix);
+			index.FindContains(query, contains);
+			if (prefix != p || contains != c || index.Find(query) != first)
+				bSame = false;
+		}
+		CHECK(bSame);
+	}
+}
+
+TEST(PrefixLimit)
+{
+	ItemIndex index;
+	index.Build({ "delta", "Alpha", "beta", "alpine", "alps", "gamma" });
+	std::vector<uint32_t> items;
+	// All matches counted, the first in key order returned
+	CHECK(index.FindPrefix("al", items, 2) == 3);
+	CHECK(items.size() == 2 && items[0] == 1 && items[1] == 3);
+	CHECK(index.FindPrefix("al", items, 10) == 3 && items.size() == 3 && items[2] == 4);
+	CHECK(index.FindPrefix("zz", items, 10) == 0 && items.empty());
+	// A batch of changes is merged by the next search
+	index.Append("albatross");
+	index.Replace(0, "Alder");
+	index.Replace(0, "aloe");
+	index.Append("zeta");
+	CHECK(index.FindPrefix("al", items, 3) == 5);
+	CHECK(items[0] == 6 && items[1] == 0 && items[2] == 1);
+	CHECK(index.FindPrefix("al", items) == 5 && items[0] == 0 && items[4] == 6);
+	CHECK(index.Find("ZETA") == 7 && index.Find("delta") == -1);
+}
+
+// Type-ahead on 1M items. The query time must not depend on the number
+// of matches, so short prefixes matching most items are timed too.
+TEST(MillionItemsBenchmark)
+{
+	const size_t count = 1000000;
+	std::mt19937 rng(2033);
+	std::vector<std::string> items;
+	items.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		std::string item;
+		size_t len = 6 + rng() % 10;
+		for (size_t k = 0; k < len; k++)
+			item += (char)('a' + rng() % 26);
+		items.push_back(item);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	ItemIndex index;
+	index.Build(items);
+	double build = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	const char* queries[] = { "a", "m", "qu", "zeb", "hello", "nomatch" };
+	std::vector<uint32_t> found;
+	double worst = 0.0;
+	bool bValid = true;
+	for (const char* q : queries) {
+		std::vector<double> times;
+		for (int run = 0; run < 21; run++) {
+			start = std::chrono::steady_clock::now();
+			index.FindPrefix(q, found, 20);
+			index.Find(q);
+			times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+		std::sort(times.begin(), times.end());
+		worst = (std::max)(worst, times[times.size() / 2]);
+		for (size_t k = 0; k < found.size(); k++) {
+			if (!index.Matches(found[k], q, false) || (k > 0 && ItemIndex::Fold(items[found[k - 1]]) > ItemIndex::Fold(items[found[k]])))
+				bValid = false;
+		}
+	}
+	CHECK(bValid);
+
+	// A batch of 10000 appends and replacements, then one search
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < 5000; i++) {
+		index.Append("new" + std::to_string(i));
+		index.Replace(rng() % count, "renamed" + std::to_string(i));
+	}
+	index.FindPrefix("renamed", found, 20);
+	double batch = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	CHECK(found.size() == 20 && index.Matches(found[0], "renamed", false));
+
+	printf("  1M items : build %.0f ms, median query %.3f ms (slowest prefix), 10000 changes %.1f ms\n",
+		build, worst, batch);
+#ifdef NDEBUG
+	// Target for optimized builds
+	CHECK(worst < 1.0);
+#endif
+}
+
+TEST_MAIN
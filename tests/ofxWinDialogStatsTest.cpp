@@ -0,0 +1,92 @@
+//
+// Latency histograms (ofxWinDialogStats.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogStats.h"
+
+#include <vector>
+#include <random>
+
+TEST(Buckets)
+{
+	// A bucket each below 8 nsec
+	CHECK(LatencyHistogram::Bucket(0) == 0 && LatencyHistogram::Bucket(7) == 7);
+	CHECK(LatencyHistogram::Bucket(8) == 8 && LatencyHistogram::Bucket(15) == 15);
+	CHECK(LatencyHistogram::Bucket(16) == 16 && LatencyHistogram::Bucket(17) == 16);
+	CHECK(LatencyHistogram::Lowest(16) == 16 && LatencyHistogram::Highest(16) == 17);
+	// Times above the range are in the last bucket
+	const size_t last = LatencyHistogram::Buckets - 1;
+	CHECK(LatencyHistogram::Bucket(1ULL << 40) == last);
+	CHECK(LatencyHistogram::Bucket(UINT64_MAX) == last);
+	CHECK(LatencyHistogram::Highest(last) == UINT64_MAX);
+
+	// Every time is within its bucket and a bucket is within 12.5%
+	std::mt19937_64 rng(3);
+	bool bInside = true;
+	for (int i = 0; i < 100000; i++) {
+		uint64_t ns = rng() >> (rng() % 64);
+		size_t b = LatencyHistogram::Bucket(ns);
+		uint64_t low = LatencyHistogram::Lowest(b);
+		uint64_t high = LatencyHistogram::Highest(b);
+		if (ns < low || ns > high)
+			bInside = false;
+		if (b < last && (high - low) * 8 > low)
+			bInside = false;
+	}
+	CHECK(bInside);
+}
+
+TEST(Percentiles)
+{
+	LatencyHistogram h;
+	CHECK(h.Percentile(50.0) == 0 && h.Mean() == 0.0);
+	for (uint64_t ns = 1; ns <= 100; ns++)
+		h.Record(ns);
+	CHECK(h.Count() == 100 && h.Min() == 1 && h.Max() == 100);
+	CHECK(h.Mean() == 50.5);
+	CHECK(h.Percentile(0.0) == 1);
+	// Highest time of the bucket [48, 51]
+	CHECK(h.Percentile(50.0) == 51);
+	// Not above the maximum
+	CHECK(h.Percentile(100.0) == 100);
+	CHECK(h.Percentile(5.0) == 5);
+}
+
+TEST(MergeAndReset)
+{
+	LatencyHistogram a, b;
+	a.Record(10);
+	a.Record(20);
+	b.Record(5);
+	b.Record(1000);
+	a.Merge(b);
+	a.Merge(LatencyHistogram());
+	CHECK(a.Count() == 4 && a.Min() == 5 && a.Max() == 1000);
+	CHECK(a.Mean() == 258.75);
+	LatencyHistogram c;
+	c.Merge(b);
+	CHECK(c.Min() == 5 && c.Count() == 2);
+	a.Reset();
+	CHECK(a.Count() == 0 && a.Max() == 0 && a.Percentile(99.0) == 0);
+	a.Record(30);
+	CHECK(a.Min() == 30 && a.Percentile(50.0) == 30);
+}
+
+TEST(Table)
+{
+	LatencyTable table;
+	table.Record(0x0111, 100); // WM_COMMAND
+	table.Record(0x0111, 300);
+	table.Record(0x0114, 50);
+	CHECK(table.Size() == 2);
+	const LatencyHistogram* h = table.Find(0x0111);
+	CHECK(h && h->Count() == 2 && h->Max() == 300);
+	CHECK(table.Find(0x0200) == nullptr);
+	std::vector<uint32_t> keys;
+	table.Keys(keys);
+	CHECK(keys.size() == 2);
+	table.Reset();
+	CHECK(table.Size() == 0);
+}
+
+TEST_MAIN
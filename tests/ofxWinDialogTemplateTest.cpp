@@ -0,0 +1,137 @@
+//
+// In-memory dialog template (ofxWinDialogTemplate.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogTemplate.h"
+
+#include <string>
+
+static uint16_t WordAt(const std::vector<uint8_t> &data, size_t pos)
+{
+	return (uint16_t)(data[pos] | (data[pos + 1] << 8));
+}
+
+static uint32_t DwordAt(const std::vector<uint8_t> &data, size_t pos)
+{
+	return (uint32_t)WordAt(data, pos) | ((uint32_t)WordAt(data, pos + 2) << 16);
+}
+
+TEST(Header)
+{
+	DialogTemplate t;
+	t.Begin(0x80C80000, 0x100, 10, 20, 300, 200, "Dlg");
+	const std::vector<uint8_t> &d = t.Data();
+	CHECK(WordAt(d, 0) == 1 && WordAt(d, 2) == 0xFFFF);
+	CHECK(DwordAt(d, 8) == 0x100);
+	CHECK(DwordAt(d, 12) == 0x80C80000); // No DS_SETFONT without a font
+	CHECK(WordAt(d, 16) == 0 && t.GetCount() == 0);
+	CHECK((int16_t)WordAt(d, 18) == 10 && WordAt(d, 22) == 300);
+	CHECK(WordAt(d, 26) == 0 && WordAt(d, 28) == 0); // Menu and class
+	CHECK(WordAt(d, 30) == 'D' && WordAt(d, 34) == 'g' && WordAt(d, 36) == 0);
+	CHECK(t.Size() == 38);
+
+	// Font fields and DS_SETFONT
+	t.Begin(DialogTemplate::SetFont, 0, 0, 0, 100, 100, ""); // Removed without a font
+	CHECK(DwordAt(t.Data(), 12) == 0);
+	t.Begin(0, 0, 0, 0, 100, 100, "", 9, 700, "Tahoma");
+	CHECK(DwordAt(t.Data(), 12) == DialogTemplate::SetFont);
+	CHECK(WordAt(t.Data(), 32) == 9 && WordAt(t.Data(), 34) == 700);
+	CHECK(t.Data()[36] == 0 && t.Data()[37] == 1);
+	CHECK(WordAt(t.Data(), 38) == 'T');
+	CHECK(t.Size() == 38 + 7 * 2);
+}
+
+TEST(Items)
+{
+	DialogTemplate t;
+	t.Begin(0, 0, 0, 0, 100, 100, "A"); // 34 bytes, not aligned
+	t.AddItem(0x50010000, 0, 5, 6, 50, 14, 1001, DialogTemplate::Button, "OK");
+	const std::vector<uint8_t> &d = t.Data();
+	// Item aligned to a DWORD
+	size_t item = 36;
+	CHECK(d[34] == 0 && d[35] == 0);
+	CHECK(DwordAt(d, item + 8) == 0x50010000);
+	CHECK(WordAt(d, item + 12) == 5 && WordAt(d, item + 18) == 14);
+	CHECK(DwordAt(d, item + 20) == 1001);
+	CHECK(WordAt(d, item + 24) == 0xFFFF && WordAt(d, item + 26) == DialogTemplate::Button);
+	CHECK(WordAt(d, item + 28) == 'O' && WordAt(d, item + 32) == 0);
+	CHECK(WordAt(d, item + 34) == 0); // No creation data
+
+	size_t size = t.Size();
+	t.AddItem(0, 0, 0, 0, 10, 10, 1002, "msctls_trackbar32", "");
+	CHECK(t.GetCount() == 2 && WordAt(t.Data(), 16) == 2);
+	size_t second = (size + 3) & ~(size_t)3;
+	CHECK(WordAt(t.Data(), second + 24) == 'm');
+	CHECK((t.Size() - second) == 24 + 18 * 2 + 2 + 2);
+
+	// Positions are clamped to 16 bits
+	t.AddItem(0, 0, 40000, -40000, 0, 0, 1003, DialogTemplate::Static, "");
+	size_t third = t.Size() - 24 - 4 - 2 - 2;
+	CHECK((int16_t)WordAt(t.Data(), third + 12) == 32767);
+	CHECK((int16_t)WordAt(t.Data(), third + 14) == -32768);
+
+	t.Clear();
+	CHECK(t.Empty() && t.GetCount() == 0);
+}
+
+// Latin-1 as a code page for the converter test
+static bool Latin1ToUtf16(const char* data, const size_t* offsets, size_t count,
+	std::vector<uint16_t> &wide, std::vector<size_t> &woffsets)
+{
+	wide.clear();
+	woffsets.clear();
+	for (size_t i = 0; i < count; i++) {
+		woffsets.push_back(wide.size());
+		for (size_t k = offsets[i]; k < offsets[i + 1]; k++)
+			wide.push_back((uint8_t)data[k]);
+		wide.push_back(0);
+	}
+	return true;
+}
+
+TEST(Strings)
+{
+	DialogTemplate t;
+	// "é" and a character outside the BMP (surrogate pair)
+	t.Begin(0, 0, 0, 0, 10, 10, "\xC3\xA9\xF0\x9F\x98\x80");
+	CHECK(WordAt(t.Data(), 30) == 0x00E9);
+	CHECK(WordAt(t.Data(), 32) == 0xD83D && WordAt(t.Data(), 34) == 0xDE00);
+	CHECK(WordAt(t.Data(), 36) == 0);
+
+	// The same bytes in a single byte code page
+	t.SetConverter(Latin1ToUtf16);
+	t.Begin(0, 0, 0, 0, 10, 10, "\xC3\xA9");
+	CHECK(WordAt(t.Data(), 30) == 0x00C3 && WordAt(t.Data(), 32) == 0x00A9);
+	t.SetConverter(nullptr); // UTF-8 again
+	t.Begin(0, 0, 0, 0, 10, 10, "\xC3\xA9");
+	CHECK(WordAt(t.Data(), 30) == 0x00E9 && WordAt(t.Data(), 32) == 0);
+}
+
+TEST(DialogUnits)
+{
+	// 8 pixel horizontal base, 16 pixel vertical base
+	CHECK(DialogTemplate::PixelsToDialogUnits(100, 8, 4) == 50);
+	CHECK(DialogTemplate::PixelsToDialogUnits(101, 8, 4) == 51); // 50.5 rounded up
+	CHECK(DialogTemplate::PixelsToDialogUnits(-101, 8, 4) == -51);
+	CHECK(DialogTemplate::PixelsToDialogUnits(30, 16, 8) == 15);
+	CHECK(DialogTemplate::PixelsToDialogUnits(30, 0, 8) == 30);
+}
+
+TEST(Keys)
+{
+	TemplateKey a, b;
+	a.Add(std::string("ab"));
+	a.Add(std::string("c"));
+	b.Add(std::string("a"));
+	b.Add(std::string("bc"));
+	// The length of each text is part of the key
+	CHECK(a.Get() != b.Get());
+	TemplateKey c;
+	c.Add(std::string("ab"));
+	c.Add(std::string("c"));
+	CHECK(a.Get() == c.Get());
+	c.Reset();
+	CHECK(c.Get() == TemplateKey().Get());
+}
+
+TEST_MAIN
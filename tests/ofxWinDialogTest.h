@@ -0,0 +1,56 @@
+//
+// ofxWinDialogTest.h
+//
+// Minimal test runner for the portable headers of ofxWinDialog.
+// Each test file defines tests with TEST and ends with TEST_MAIN.
+// A failed CHECK prints the file, line and condition and the test
+// continues. The program returns 1 if any check failed.
+//
+#pragma once
+
+#include <vector>
+#include <cstdio>
+
+struct TestCase {
+	const char* name;
+	void (*fn)();
+};
+
+inline std::vector<TestCase> &TestCases() {
+	static std::vector<TestCase> cases;
+	return cases;
+}
+
+inline int &TestFailures() {
+	static int failures = 0;
+	return failures;
+}
+
+struct TestRegister {
+	TestRegister(const char* name, void (*fn)()) { TestCases().push_back(TestCase{ name, fn }); }
+};
+
+#define TEST(name) \
+	static void name(); \
+	static TestRegister name##_register(#name, name); \
+	static void name()
+
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+			TestFailures()++; \
+		} \
+	} while (0)
+
+inline int RunTests() {
+	for (size_t i = 0; i < TestCases().size(); i++) {
+		int failures = TestFailures();
+		TestCases()[i].fn();
+		printf("%s %s\n", TestFailures() == failures ? "ok  " : "FAIL", TestCases()[i].name);
+	}
+	printf("%d failed\n", TestFailures());
+	return TestFailures() == 0 ? 0 : 1;
+}
+
+#define TEST_MAIN int main() { return RunTests(); }
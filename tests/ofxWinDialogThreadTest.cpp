@@ -0,0 +1,262 @@
+//
+// Queues between ofApp and the dialog thread
+// (ofxWinDialogThread.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogThread.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <string>
+#include <atomic>
+
+// Messages posted to a thread, as PostMessage to a window
+class Mailbox {
+
+public:
+
+	void Post() {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Posts++;
+		m_Wake.notify_one();
+	}
+
+	// Returns false if no message was posted in time
+	bool Wait() {
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		if (!m_Wake.wait_for(lock, std::chrono::seconds(10), [this] { return m_Posts > 0; }))
+			return false;
+		m_Posts--;
+		return true;
+	}
+
+private:
+
+	std::mutex m_Mutex;
+	std::condition_variable m_Wake;
+	int m_Posts = 0;
+
+};
+
+TEST(BatchQueueBatches)
+{
+	BatchQueue<int> queue;
+	CHECK(queue.Push(1)); // First of a batch
+	CHECK(!queue.Push(2));
+	CHECK(queue.Size() == 2);
+	std::vector<int> items;
+	CHECK(queue.Drain(items) == 2 && items[0] == 1 && items[1] == 2);
+	CHECK(queue.Drain(items) == 0);
+	CHECK(queue.Push(3));
+	queue.Clear();
+	CHECK(queue.Size() == 0 && queue.Push(4));
+}
+
+TEST(CommandQueueBatches)
+{
+	CommandQueue<std::string> queue;
+	CHECK(queue.Empty());
+	CHECK(queue.Push(std::string("a")));
+	CHECK(!queue.Push(std::string("b")));
+	CHECK(!queue.Empty());
+	std::vector<std::string> items;
+	CHECK(queue.Drain(items) == 2 && items[0] == "a" && items[1] == "b");
+	CHECK(queue.Empty());
+	CHECK(queue.Push(std::string("c")));
+	// Items not drained are deleted with the queue
+}
+
+TEST(CollapseKeepsOrder)
+{
+	std::vector<std::pair<std::string, int>> items = {
+		{ "Red", 1 }, { "Green", 2 }, { "Red", 3 }, { "Blue", 4 }, { "Green", 5 } };
+	CommandCollapse collapse;
+	auto key = [](const std::pair<std::string, int> &item) { return item.first; };
+	CHECK(collapse.Apply(items, key) == 2);
+	CHECK(items.size() == 3);
+	CHECK(items[0].first == "Red" && items[0].second == 3);
+	CHECK(items[1].first == "Blue" && items[1].second == 4);
+	CHECK(items[2].first == "Green" && items[2].second == 5);
+	CHECK(collapse.Apply(items, key) == 0);
+}
+
+// Set functions from ofApp to the dialog thread (CommandQueue) and
+// control events back to ofApp (BatchQueue). Each side is woken only
+// for the first item of a batch, as by WM_DIALOG_COMMAND, so a lost
+// wake would stop the test with items left in a queue.
+TEST(RoundTrip)
+{
+	const int count = 100000;
+	CommandQueue<int> commands;
+	BatchQueue<DialogEvent> events;
+	Mailbox dialogMail, appMail;
+	int dialogWakes = 0;
+
+	std::thread dialog([&]() {
+		std::vector<int> batch;
+		int applied = 0;
+		while (applied < count) {
+			if (!dialogMail.Wait())
+				break;
+			dialogWakes++;
+			commands.Drain(batch);
+			for (size_t k = 0; k < batch.size(); k++) {
+				DialogEvent e;
+				e.title = "Slider";
+				e.value = batch[k];
+				if (events.Push(std::move(e)))
+					appMail.Post();
+			}
+			applied += (int)batch.size();
+		}
+	});
+
+	std::thread app([&]() {
+		for (int i = 0; i < count; i++) {
+			if (commands.Push(i))
+				dialogMail.Post();
+		}
+	});
+
+	// ofApp update - PollEvents
+	std::vector<DialogEvent> batch;
+	int received = 0;
+	int appWakes = 0;
+	bool bOrdered = true;
+	while (received < count) {
+		if (!appMail.Wait())
+			break;
+		appWakes++;
+		events.Drain(batch);
+		for (size_t k = 0; k < batch.size(); k++) {
+			if (batch[k].value != received)
+				bOrdered = false;
+			received++;
+		}
+	}
+	app.join();
+	dialog.join();
+
+	CHECK(received == count);
+	CHECK(bOrdered);
+	CHECK(commands.Empty() && events.Size() == 0);
+	CHECK(dialogWakes >= 1 && dialogWakes <= count);
+	CHECK(appWakes >= 1 && appWakes <= count);
+	printf("  %d commands : %d dialog wakes, %d ofApp wakes\n", count, dialogWakes, appWakes);
+}
+
+// Producers each push numbered commands while one reader drains
+struct StressItem {
+	int producer = 0;
+	int seq = 0;
+};
+
+struct StressResult {
+	std::vector<std::vector<int>> received; // Sequence numbers by producer
+	long long trues = 0; // Push returned true
+	long long batches = 0; // Drains that took items
+};
+
+static StressResult RunProducers(int producers, int pushes, CommandCollapse* collapse)
+{
+	CommandQueue<StressItem> queue;
+	StressResult result;
+	result.received.resize(producers);
+	std::atomic<int> done{ 0 };
+	std::atomic<long long> trues{ 0 };
+	std::atomic<bool> bStart{ false };
+
+	std::vector<std::thread> threads;
+	for (int p = 0; p < producers; p++) {
+		threads.push_back(std::thread([&, p]() {
+			while (!bStart.load())
+				std::this_thread::yield();
+			long long t = 0;
+			for (int i = 0; i < pushes; i++) {
+				StressItem item;
+				item.producer = p;
+				item.seq = i;
+				if (queue.Push(std::move(item)))
+					t++;
+				// Let the reader drain batches of all sizes
+				if ((i & 63) == 0)
+					std::this_thread::yield();
+			}
+			trues += t;
+			done++;
+		}));
+	}
+
+	bStart = true;
+	std::vector<StressItem> batch;
+	auto key = [](const StressItem &item) { return std::to_string(item.producer); };
+	for (;;) {
+		// Read "done" before draining so that the last items are taken
+		bool bDone = done.load() == producers;
+		if (queue.Drain(batch) > 0) {
+			result.batches++;
+			if (collapse)
+				collapse->Apply(batch, key);
+			for (size_t k = 0; k < batch.size(); k++)
+				result.received[batch[k].producer].push_back(batch[k].seq);
+		}
+		else if (bDone) {
+			break;
+		}
+	}
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+	result.trues = trues.load();
+	return result;
+}
+
+TEST(ProducersStress)
+{
+	const int producers = 8;
+	const int pushes = 50000;
+	auto start = std::chrono::steady_clock::now();
+	StressResult result = RunProducers(producers, pushes, nullptr);
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	// Each item once and in the order pushed by each producer
+	for (int p = 0; p < producers; p++) {
+		const std::vector<int> &seq = result.received[p];
+		CHECK(seq.size() == (size_t)pushes);
+		bool bOrdered = true;
+		for (size_t i = 0; i < seq.size(); i++) {
+			if (seq[i] != (int)i)
+				bOrdered = false;
+		}
+		CHECK(bOrdered);
+	}
+	// The first push after each drain returns true
+	CHECK(result.trues == result.batches);
+	printf("  %d x %d pushes : %lld batches, %.1f ms\n", producers, pushes, result.batches, ms);
+}
+
+TEST(ProducersCollapse)
+{
+	const int producers = 8;
+	const int pushes = 20000;
+	CommandCollapse collapse;
+	StressResult result = RunProducers(producers, pushes, &collapse);
+
+	// The last value of each producer is applied and values
+	// applied by later batches are never older
+	for (int p = 0; p < producers; p++) {
+		const std::vector<int> &seq = result.received[p];
+		CHECK(!seq.empty() && seq.back() == pushes - 1);
+		CHECK(seq.size() <= (size_t)result.batches);
+		bool bIncreasing = true;
+		for (size_t i = 1; i < seq.size(); i++) {
+			if (seq[i] <= seq[i - 1])
+				bIncreasing = false;
+		}
+		CHECK(bIncreasing);
+	}
+	CHECK(result.trues == result.batches);
+}
+
+TEST_MAIN
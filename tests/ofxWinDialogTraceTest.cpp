@@ -0,0 +1,153 @@
+//
+// Trace rings, the trace log and the Chrome trace export
+// (ofxWinDialogTrace.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogTrace.h"
+
+#include <thread>
+#include <string>
+
+TEST(RingCapacity)
+{
+	TraceRing ring;
+	ring.Init(5);
+	CHECK(ring.Capacity() == 8);
+	ring.Init(8);
+	CHECK(ring.Capacity() == 8);
+}
+
+TEST(RingOverflow)
+{
+	TraceRing ring;
+	ring.Init(4);
+	TraceEvent e;
+	for (int i = 0; i < 4; i++) {
+		e.start = (uint64_t)i;
+		CHECK(ring.Push(e));
+	}
+	// Full - dropped and the first spans are kept
+	e.start = 99;
+	CHECK(!ring.Push(e));
+	TraceEvent out;
+	CHECK(ring.Pop(out) && out.start == 0);
+	// Space for one more after a read
+	e.start = 4;
+	CHECK(ring.Push(e));
+	CHECK(!ring.Push(e));
+	for (uint64_t i = 1; i <= 4; i++)
+		CHECK(ring.Pop(out) && out.start == i);
+	CHECK(!ring.Pop(out));
+}
+
+TEST(EventTextTruncated)
+{
+	TraceEvent e;
+	e.Set("A name that is longer than the buffer", nullptr);
+	CHECK(strlen(e.name) == sizeof(e.name) - 1);
+	CHECK(e.detail[0] == 0);
+}
+
+TEST(LogDrops)
+{
+	TraceLog log;
+	log.Add("Before", "dialog", "", 0, 1); // Not started
+	log.Start(4);
+	for (int i = 0; i < 10; i++)
+		log.Add("Set", "dialog", "Red", (uint64_t)i, (uint64_t)i + 2);
+	CHECK(log.Dropped() == 6);
+	std::vector<TraceEvent> events;
+	CHECK(log.Drain(events) == 4);
+	CHECK(strcmp(events[0].name, "Set") == 0 && strcmp(events[0].detail, "Red") == 0);
+	CHECK(events[0].duration == 2 && events[3].start == 3);
+
+	// Not added while stopped, the count is reset by Start
+	log.Stop();
+	log.Add("After", "dialog", "", 0, 1);
+	CHECK(log.Drain(events) == 0);
+	log.Start(4);
+	CHECK(log.Dropped() == 0);
+	// End before start is a span of zero
+	log.Add("Back", "dialog", "", 5, 3);
+	CHECK(log.Drain(events) == 1 && events[0].duration == 0);
+}
+
+TEST(LogThreads)
+{
+	TraceLog log;
+	log.Start(1024);
+	const int spans = 500;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++) {
+		threads.push_back(std::thread([&log]() {
+			for (int i = 0; i < spans; i++)
+				log.Add("Span", "thread", "", (uint64_t)i, (uint64_t)i + 1);
+		}));
+	}
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+	std::vector<TraceEvent> events;
+	CHECK(log.Drain(events) == (size_t)spans * 4);
+	CHECK(log.Dropped() == 0);
+	// One ring for each thread, in order within each
+	size_t count[TraceLog::MaxThreads + 1]{};
+	uint64_t last[TraceLog::MaxThreads + 1]{};
+	bool bOrdered = true;
+	for (size_t i = 0; i < events.size(); i++) {
+		uint32_t t = events[i].thread;
+		if (t == 0 || t > TraceLog::MaxThreads)
+			continue;
+		if (count[t] > 0 && events[i].start <= last[t])
+			bOrdered = false;
+		last[t] = events[i].start;
+		count[t]++;
+	}
+	CHECK(bOrdered);
+	size_t rings = 0;
+	for (size_t t = 1; t <= TraceLog::MaxThreads; t++) {
+		if (count[t] > 0) {
+			CHECK(count[t] == (size_t)spans);
+			rings++;
+		}
+	}
+	CHECK(rings == 4);
+}
+
+TEST(ScopeSpan)
+{
+	TraceLog log;
+	{
+		TraceScope scope(log, "Stopped", "dialog");
+	}
+	log.Start(8);
+	{
+		TraceScope scope(log, "Open", "dialog", "Settings");
+	}
+	std::vector<TraceEvent> events;
+	CHECK(log.Drain(events) == 1);
+	CHECK(strcmp(events[0].name, "Open") == 0 && strcmp(events[0].category, "dialog") == 0);
+}
+
+TEST(ChromeJson)
+{
+	TraceEvent e;
+	e.Set("Open", "Line \"width\"\\");
+	e.category = "dialog";
+	e.start = 1200;
+	e.duration = 5300;
+	e.thread = 2;
+	std::string json;
+	TraceLog::AppendJson(json, e, true);
+	CHECK(json == "  { \"name\" : \"Open\", \"cat\" : \"dialog\", \"ph\" : \"X\", \"ts\" : 1200, "
+		"\"dur\" : 5300, \"pid\" : 1, \"tid\" : 2, \"args\" : { \"detail\" : \"Line \\\"width\\\"\\\\\" } }");
+
+	// Separator, no args without detail and control characters removed
+	TraceEvent f;
+	f.Set("Set\tSlider", "");
+	TraceLog::AppendJson(json, f, false, 3);
+	CHECK(json.find(",\n  { \"name\" : \"SetSlider\", \"cat\" : \"\", \"ph\" : \"X\", \"ts\" : 0, "
+		"\"dur\" : 0, \"pid\" : 3, \"tid\" : 0 }") != std::string::npos);
+	CHECK(json.find("args", json.find("SetSlider")) == std::string::npos);
+}
+
+TEST_MAIN
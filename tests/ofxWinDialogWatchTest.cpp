@@ -0,0 +1,119 @@
+//
+// File change detection and differences for hot reload
+// (ofxWinDialogWatch.h)
+//
+#include "ofxWinDialogTest.h"
+#include "ofxWinDialogWatch.h"
+
+#include <map>
+#include <string>
+
+TEST(Debounce)
+{
+	std::map<std::string, uint64_t> stamps;
+	stamps["a.ini"] = 1;
+	stamps["b.txt"] = 1;
+	auto stamp = [&stamps](const std::string &path, uint64_t &s) {
+		auto it = stamps.find(path);
+		if (it == stamps.end())
+			return false;
+		s = it->second;
+		return true;
+	};
+	FileWatch watch(200);
+	CHECK(watch.Add("a.ini", 1) == 0);
+	CHECK(watch.Add("b.txt", 1) == 1);
+	CHECK(watch.Add("a.ini", 5) == 0 && watch.Size() == 2);
+
+	std::vector<size_t> changed;
+	CHECK(watch.Poll(0, stamp, changed) == 0 && !watch.IsPending());
+
+	// Saved in several writes - reported once after the last
+	stamps["a.ini"] = 2;
+	CHECK(watch.Poll(100, stamp, changed) == 0 && watch.IsPending());
+	stamps["a.ini"] = 3;
+	CHECK(watch.Poll(250, stamp, changed) == 0);
+	CHECK(watch.Poll(449, stamp, changed) == 0);
+	CHECK(watch.Poll(450, stamp, changed) == 1 && changed[0] == 0);
+	CHECK(watch.Poll(900, stamp, changed) == 0 && !watch.IsPending());
+
+	// Removed and created again
+	stamps.erase("b.txt");
+	CHECK(watch.Poll(1000, stamp, changed) == 0);
+	CHECK(watch.Poll(2000, stamp, changed) == 0 && watch.IsPending());
+	stamps["b.txt"] = 7;
+	CHECK(watch.Poll(2100, stamp, changed) == 0);
+	CHECK(watch.Poll(2300, stamp, changed) == 1 && watch.GetPath(changed[0]) == "b.txt");
+}
+
+TEST(IniDiff)
+{
+	IniValues prev, next;
+	prev.Parse("; comment\r\n[Slider]\r\nRed = 0.50\r\nGreen=0.25\r\n[Edit]\r\nName=One\r\n");
+	std::string text;
+	CHECK(prev.Size() == 3);
+	CHECK(prev.Get("SLIDER", "red", text) && text == "0.50");
+	CHECK(!prev.Get("Slider", "Blue", text));
+
+	// Case of names is ignored, values removed are not changes
+	next.Parse("[slider]\nRED=0.50\nGreen=0.75\nBlue=1\n[Edit]\nnoequals\n");
+	std::vector<IniValues::value> changed;
+	CHECK(prev.Diff(next, changed) == 2);
+	CHECK(changed[0].key == "Green" && changed[0].value == "0.75");
+	CHECK(changed[1].key == "Blue" && changed[1].section == "slider");
+
+	prev.Set("Slider", "GREEN", "0.75");
+	CHECK(prev.Size() == 3 && prev.Get("Slider", "Green", text) && text == "0.75");
+}
+
+TEST(ReadStatements)
+{
+	std::vector<DescRecord> records;
+	CHECK(ReadStatements("Slider \"Red\" 0 1 0.5\nCombo \"Mode\" [ A B ] 1\n", records));
+	CHECK(records.size() == 2);
+	CHECK(records[0].keyword == "Slider" && records[0].args.size() == 4 && records[0].line == 1);
+	CHECK(records[0].kinds[0] == DescToken::Text && records[0].kinds[1] == DescToken::Number);
+	CHECK(records[1].args.size() == 6 && records[1].args[1] == "[" && records[1].args[4] == "]");
+
+	std::string error;
+	CHECK(!ReadStatements("Slider \"Red\nCombo", records, &error));
+	CHECK(records.empty() && error == "Line 1 : text without a closing quote");
+}
+
+// The last number of Slider and Combo is the value
+static bool IsValue(const DescRecord &r, size_t k)
+{
+	if (r.keyword == "Slider")
+		return k == 3;
+	if (r.keyword == "Combo")
+		return k + 1 == r.args.size();
+	return false;
+}
+
+static bool Diff(const std::string &a, const std::string &b, std::vector<size_t> &changed)
+{
+	std::vector<DescRecord> prev, next;
+	ReadStatements(a, prev);
+	ReadStatements(b, next);
+	return DiffStatements(prev, next, IsValue, changed);
+}
+
+TEST(DiffValues)
+{
+	const std::string base = "Static \"Title\"\nSlider \"Red\" 0 1 0.5\nCombo \"Mode\" [ A B ] 1\n";
+	std::vector<size_t> changed;
+	CHECK(Diff(base, base, changed) && changed.empty());
+
+	// Value changes only
+	CHECK(Diff(base, "Static \"Title\"\nSlider \"Red\" 0 1 0.7\nCombo \"Mode\" [ A B ] 0\n", changed));
+	CHECK(changed.size() == 2 && changed[0] == 1 && changed[1] == 2);
+
+	// Not values - the description is loaded again
+	CHECK(!Diff(base, "Static \"Title\"\nSlider \"Red\" 0 2 0.5\nCombo \"Mode\" [ A B ] 1\n", changed));
+	CHECK(!Diff(base, "Static \"Title\"\nSlider \"Red\" 0 1 0.5\nCombo \"Mode\" [ A B C ] 1\n", changed));
+	CHECK(!Diff(base, "Static \"Other\"\nSlider \"Red\" 0 1 0.5\nCombo \"Mode\" [ A B ] 1\n", changed));
+	CHECK(!Diff(base, "Slider \"Red\" 0 1 0.5\nCombo \"Mode\" [ A B ] 1\n", changed));
+	CHECK(!Diff(base, "Static \"Title\"\nCombo \"Mode\" [ A B ] 1\nSlider \"Red\" 0 1 0.5\n", changed));
+}
+
+TEST_MAIN